@@ -5,6 +5,8 @@
 #include "MultiArray.h"  //for TH3 alternative
 #include "Rossegger.h"
 
+#include <phool/PHThreadPool.h>
+
 #include <TCanvas.h>
 #include <TFile.h>
 #include <TH1.h>
@@ -17,15 +19,94 @@
 #include <TVector3.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>  // for assert
 #include <cmath>
+#include <complex>
 #include <cstdint>
 #include <cstdlib>
 #include <format>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #define ALMOST_ZERO 0.00001
 
+namespace
+{
+  // discrete fourier transform along phi, X[k] = sum_m x[m] exp(-2 pi i m k / n), or its inverse without the 1/n factor.
+  // mixed radix Cooley-Tukey, so that any number of phi bins can be used.  Prime factors are done as a plain DFT.
+  class PhiFFT
+  {
+   public:
+    explicit PhiFFT(int n)
+      : m_n(n)
+      , m_twiddle(n)
+    {
+      for (int i = 0; i < n; i++)
+      {
+        m_twiddle[i] = std::polar(1.0, -2 * M_PI * i / n);
+      }
+    }
+
+    // transforms data in place.  scratch must hold 2n values.
+    void transform(std::complex<double> *data, bool inverse, std::complex<double> *scratch) const
+    {
+      std::copy(data, data + m_n, scratch);
+      recurse(scratch, 1, data, m_n, inverse, scratch + m_n);
+    }
+
+   private:
+    // exp(-2 pi i e / n), or its conjugate for the inverse transform
+    std::complex<double> twiddle(long e, int n, bool inverse) const
+    {
+      const std::complex<double> &w = m_twiddle[(e * (m_n / n)) % m_n];
+      return inverse ? std::conj(w) : w;
+    }
+
+    void recurse(const std::complex<double> *in, int stride, std::complex<double> *out, int n, bool inverse, std::complex<double> *tmp) const
+    {
+      if (n == 1)
+      {
+        out[0] = in[0];
+        return;
+      }
+      int p = 2;  // smallest prime factor
+      while (n % p)
+      {
+        p++;
+      }
+      const int m = n / p;
+      // transform the p decimated sequences into consecutive blocks of out:
+      for (int q = 0; q < p; q++)
+      {
+        recurse(in + q * stride, stride * p, out + q * m, m, inverse, tmp);
+      }
+      // and combine them:  X[k+s*m] = sum_q w_n^(q*(k+s*m)) Y_q[k]
+      for (int k = 0; k < m; k++)
+      {
+        for (int s = 0; s < p; s++)
+        {
+          std::complex<double> sum = 0;
+          for (int q = 0; q < p; q++)
+          {
+            sum += out[q * m + k] * twiddle(static_cast<long>(q) * (k + s * m), n, inverse);
+          }
+          tmp[s] = sum;
+        }
+        for (int s = 0; s < p; s++)
+        {
+          out[k + s * m] = tmp[s];
+        }
+      }
+    }
+
+    int m_n;
+    std::vector<std::complex<double>> m_twiddle;
+  };
+}  // namespace
+
 AnnularFieldSim::AnnularFieldSim(float in_innerRadius, float in_outerRadius, float in_outerZ,
                                  int r, int roi_r0, int roi_r1, int /*in_rLowSpacing*/, int /*in_rHighSize*/,
                                  int phi, int roi_phi0, int roi_phi1, int /*in_phiLowSpacing*/, int /*in_phiHighSize*/,
@@ -296,6 +377,39 @@ AnnularFieldSim::AnnularFieldSim(float rin, float rout, float dz, int r, int phi
   return;
 }
 
+// needed here for unique_ptr to incomplete PHThreadPool in header
+AnnularFieldSim::~AnnularFieldSim() = default;
+
+void AnnularFieldSim::SetNThreads(int n)
+{
+  // the pool is (re)built the next time it is needed
+  nthreads = n;
+  threadPool.reset();
+  return;
+}
+
+PHThreadPool &AnnularFieldSim::GetThreadPool()
+{
+  if (!threadPool)
+  {
+    threadPool = std::make_unique<PHThreadPool>(nthreads);
+    std::cout << std::format("AnnularFieldSim::GetThreadPool:  using {} worker threads", threadPool->size()) << std::endl;
+  }
+  return *threadPool;
+}
+
+std::vector<double> AnnularFieldSim::GetCellCenterRadii()
+{
+  // the radii calc_unit_field will be asked about, both for 'at' and 'from' positions
+  std::vector<double> radii;
+  radii.reserve(nr);
+  for (int ir = 0; ir < nr; ir++)
+  {
+    radii.push_back(GetCellCenter(ir, 0, 0).Perp());
+  }
+  return radii;
+}
+
 TVector3 AnnularFieldSim::calc_unit_field(TVector3 at, TVector3 from)
 {
   // if(debugFlag()) print_need_cout("%d: AnnularFieldSim::calc_unit_field(at=(r=%f,phi=%f,z=%f))\n",__LINE__,at.Perp(),at.Phi(),at.Z());
@@ -1582,33 +1696,284 @@ void AnnularFieldSim::populate_fieldmap()
   unsigned long long percent = totalelements / 100 * debug_npercent;
   std::cout << std::format("total elements = {}", totalelements * nr * nphi * nz) << std::endl;
 
-  int el = 0;
-
-  TVector3 localF;  // holder for the summed field at the current position.
-  for (int ir = rmin_roi; ir < rmax_roi; ir++)
+  if (lookupCase == PhiSlice && fieldSumCase != LegacySum)
+  {
+    populate_phislice_fieldmap();
+  }
+  else
   {
-    for (int iphi = phimin_roi; iphi < phimax_roi; iphi++)
+    std::mutex print_mutex;
+    // one task per r slice of the roi.  el is the same running count as in a single loop over all cells.
+    auto sum_r_slice = [&](size_t task, unsigned int /*worker*/)
     {
-      for (int iz = zmin_roi; iz < zmax_roi; iz++)
+      const int ir = rmin_roi + task;
+      unsigned long long el = task * nphi_roi * nz_roi;
+      TVector3 localF;  // holder for the summed field at the current position.
+      for (int iphi = phimin_roi; iphi < phimax_roi; iphi++)
       {
-        localF = sum_field_at(ir, iphi, iz);  // asks in global coordinates
-        if (!(el % percent))
+        for (int iz = zmin_roi; iz < zmax_roi; iz++)
         {
-          std::cout << std::format("populate_fieldmap {}%:  ", static_cast<uint64_t>(debug_npercent) * el / percent);
+          localF = sum_field_at(ir, iphi, iz);  // asks in global coordinates
+          if (!(el % percent))
+          {
+            std::lock_guard<std::mutex> lock(print_mutex);
+            std::cout << std::format("populate_fieldmap {}%:  ", static_cast<uint64_t>(debug_npercent) * el / percent);
 
-          std::cout << std::format("sum_field_at (ir={}, iphi={}, iz={}) gives ({:E},{:E},{:E})", ir, iphi, iz, localF.X(), localF.Y(), localF.Z()) << std::endl;
+            std::cout << std::format("sum_field_at (ir={}, iphi={}, iz={}) gives ({:E},{:E},{:E})", ir, iphi, iz, localF.X(), localF.Y(), localF.Z()) << std::endl;
+          }
+          el++;
+
+          Efield->Set(ir - rmin_roi, iphi - phimin_roi, iz - zmin_roi, localF);  // sets in roi coordinates.
+                                                                                 // if (localF.Mag()>1e-9)
+                                                                                 // if(debugFlag()) print_need_cout("%d: AnnularFieldSim::populate_fieldmap fieldmap@ (%d,%d,%d) mag=%f\n",__LINE__,ir,iphi,iz,localF.Mag());
         }
-        el++;
+      }
+    };
 
-        Efield->Set(ir - rmin_roi, iphi - phimin_roi, iz - zmin_roi, localF);  // sets in roi coordinates.
-                                                                               // if (localF.Mag()>1e-9)
-                                                                               // if(debugFlag()) print_need_cout("%d: AnnularFieldSim::populate_fieldmap fieldmap@ (%d,%d,%d) mag=%f\n",__LINE__,ir,iphi,iz,localF.Mag());
+    // only the full3d and phislice sums are read-only.  The hybrid sum uses temporary member storage, and debugFlag() counts calls.
+    const bool threadsafe = (lookupCase == Full3D || lookupCase == PhiSlice || lookupCase == NoLookup) && debug_printActionEveryN <= 0;
+    if (threadsafe)
+    {
+      GetThreadPool().parallel_for(nr_roi, sum_r_slice);
+    }
+    else
+    {
+      for (int task = 0; task < nr_roi; task++)
+      {
+        sum_r_slice(task, 0);
       }
     }
   }
+
+  if (fieldsum_validation > 0)
+  {
+    validate_fieldmap(fieldsum_validation);
+  }
   return;
 }
 
+void AnnularFieldSim::populate_phislice_fieldmap()
+{
+  // same sum as sum_phislice_field_at, organized per (r,z) slice of the lookup:
+  // the slice is copied once to flat float storage, and then serves all the phi cells of the roi at that r and z.
+  // the charge is copied the same way, as [r][z][phi], so that the sum over source phi runs along contiguous memory.
+  // For the field at phi, the lookup entry at relative phi j multiplies the charge at j+phi, so the sum is a circular
+  // correlation along phi, which FFTSum computes as conj(lookup)*charge in fourier space.
+  std::cout << std::format("populate_phislice_fieldmap:  {} sum over ({}x{}) slices", fieldSumCase == FFTSum ? "FFT" : "flat", nr_roi, nz_roi) << std::endl;
+
+  MultiArray<float> charge(nr, nz, nphi);
+  for (int ir = 0; ir < nr; ir++)
+  {
+    for (int iz = 0; iz < nz; iz++)
+    {
+      float *qline = charge.GetPtr(ir, iz, 0);
+      for (int iphi = 0; iphi < nphi; iphi++)
+      {
+        qline[iphi] = q->GetChargeInBin(ir, iphi, iz);
+      }
+    }
+  }
+
+  // the fourier transform of the charge does not depend on where the field is measured, so it is done once:
+  std::unique_ptr<PhiFFT> fft;
+  std::vector<std::complex<double>> chargeHat;
+  if (fieldSumCase == FFTSum)
+  {
+    fft = std::make_unique<PhiFFT>(nphi);
+    chargeHat.resize(static_cast<size_t>(nr) * nz * nphi);
+    std::vector<std::complex<double>> scratch(2 * nphi);
+    for (int ir = 0; ir < nr; ir++)
+    {
+      for (int iz = 0; iz < nz; iz++)
+      {
+        std::complex<double> *qhat = &chargeHat[(static_cast<size_t>(ir) * nz + iz) * nphi];
+        const float *qline = charge.GetPtr(ir, iz, 0);
+        std::copy(qline, qline + nphi, qhat);
+        fft->transform(qhat, false, scratch.data());
+      }
+    }
+  }
+
+  // per worker storage: the lookup slice as [xyz][r][z][phi], and the FFT work space
+  PHThreadPool &pool = GetThreadPool();
+  std::vector<std::unique_ptr<MultiArray<float>>> slices(pool.nslots());
+  std::vector<std::vector<std::complex<double>>> workspace(pool.nslots());
+
+  const int nslices = nr_roi * nz_roi;
+  std::atomic<int> ndone{0};
+  std::mutex print_mutex;
+
+  auto sum_slice = [&](size_t task, unsigned int worker)
+  {
+    const int r = rmin_roi + task / nz_roi;
+    const int z = zmin_roi + task % nz_roi;
+    if (!slices[worker])
+    {
+      slices[worker] = std::make_unique<MultiArray<float>>(3, nr, nz, nphi);
+    }
+    MultiArray<float> &slice = *slices[worker];
+    for (int ir = 0; ir < nr; ir++)
+    {
+      for (int iz = 0; iz < nz; iz++)
+      {
+        float *ex = slice.GetPtr(0, ir, iz, 0);
+        float *ey = slice.GetPtr(1, ir, iz, 0);
+        float *ez = slice.GetPtr(2, ir, iz, 0);
+        for (int iphi = 0; iphi < nphi; iphi++)
+        {
+          const TVector3 *unitField = Epartial_phislice->GetPtr(r - rmin_roi, 0, z - zmin_roi, ir, iphi, iz);
+          ex[iphi] = unitField->X();
+          ey[iphi] = unitField->Y();
+          ez[iphi] = unitField->Z();
+        }
+      }
+    }
+    // dont' compute self-to-self field:
+    for (int i = 0; i < 3; i++)
+    {
+      *slice.GetPtr(i, r, z, 0) = 0;
+    }
+
+    // unrotated field at each phi of the roi, in the frame of the phi=0 slice:
+    std::vector<double> sum(3 * nphi_roi, 0);
+    if (fieldSumCase == FFTSum)
+    {
+      // x and y are transformed together as x+iy.  With f=x+iy and real charge, the correlation of f with the charge
+      // has the transform F[-k]*Q[k], and its real and imaginary parts are the x and y sums.  z is done the same way.
+      std::vector<std::complex<double>> &work = workspace[worker];
+      work.assign(5 * nphi, 0);
+      std::complex<double> *f = work.data();
+      std::complex<double> *scratch = f + nphi;
+      std::complex<double> *sumxy = f + 3 * nphi;
+      std::complex<double> *sumz = f + 4 * nphi;
+      for (int ir = 0; ir < nr; ir++)
+      {
+        for (int iz = 0; iz < nz; iz++)
+        {
+          const std::complex<double> *qhat = &chargeHat[(static_cast<size_t>(ir) * nz + iz) * nphi];
+          const float *ex = slice.GetPtr(0, ir, iz, 0);
+          const float *ey = slice.GetPtr(1, ir, iz, 0);
+          const float *ez = slice.GetPtr(2, ir, iz, 0);
+          for (int iphi = 0; iphi < nphi; iphi++)
+          {
+            f[iphi] = std::complex<double>(ex[iphi], ey[iphi]);
+          }
+          fft->transform(f, false, scratch);
+          for (int k = 0; k < nphi; k++)
+          {
+            sumxy[k] += f[(nphi - k) % nphi] * qhat[k];
+          }
+          std::copy(ez, ez + nphi, f);
+          fft->transform(f, false, scratch);
+          for (int k = 0; k < nphi; k++)
+          {
+            sumz[k] += f[(nphi - k) % nphi] * qhat[k];
+          }
+        }
+      }
+      fft->transform(sumxy, true, scratch);
+      fft->transform(sumz, true, scratch);
+      for (int phi = phimin_roi; phi < phimax_roi; phi++)
+      {
+        sum[3 * (phi - phimin_roi)] = sumxy[phi].real() / nphi;
+        sum[3 * (phi - phimin_roi) + 1] = sumxy[phi].imag() / nphi;
+        sum[3 * (phi - phimin_roi) + 2] = sumz[phi].real() / nphi;
+      }
+    }
+    else
+    {
+      for (int ir = 0; ir < nr; ir++)
+      {
+        for (int iz = 0; iz < nz; iz++)
+        {
+          const float *qline = charge.GetPtr(ir, iz, 0);
+          for (int i = 0; i < 3; i++)
+          {
+            const float *eline = slice.GetPtr(i, ir, iz, 0);
+            for (int phi = phimin_roi; phi < phimax_roi; phi++)
+            {
+              // source phi = relative phi + phi, wrapping around once:
+              double linesum = 0;
+              for (int j = 0; j < nphi - phi; j++)
+              {
+                linesum += eline[j] * qline[j + phi];
+              }
+              for (int j = nphi - phi; j < nphi; j++)
+              {
+                linesum += eline[j] * qline[j + phi - nphi];
+              }
+              sum[3 * (phi - phimin_roi) + i] += linesum;
+            }
+          }
+        }
+      }
+    }
+
+    for (int phi = phimin_roi; phi < phimax_roi; phi++)
+    {
+      TVector3 localF(sum[3 * (phi - phimin_roi)], sum[3 * (phi - phimin_roi) + 1], sum[3 * (phi - phimin_roi) + 2]);
+      TVector3 pos = GetRoiCellCenter(r - rmin_roi, phi - phimin_roi, z - zmin_roi);
+      TVector3 slicepos = GetRoiCellCenter(r - rmin_roi, 0, z - zmin_roi);
+      float rotphi = pos.Phi() - slicepos.Phi();
+      localF.RotateZ(rotphi);
+      localF += Eexternal->Get(r - rmin_roi, phi - phimin_roi, z - zmin_roi);
+      Efield->Set(r - rmin_roi, phi - phimin_roi, z - zmin_roi, localF);  // sets in roi coordinates.
+    }
+
+    const int done = ++ndone;
+    if (debug_npercent > 0 && (done * 100 / nslices) / debug_npercent != ((done - 1) * 100 / nslices) / debug_npercent)
+    {
+      std::lock_guard<std::mutex> lock(print_mutex);
+      std::cout << std::format("populate_phislice_fieldmap {}%:  last slice (ir={}, iz={})", done * 100 / nslices, r, z) << std::endl;
+    }
+  };
+  pool.parallel_for(nslices, sum_slice);
+  return;
+}
+
+float AnnularFieldSim::validate_fieldmap(int nsamples)
+{
+  // compare the fieldmap to sum_field_at in nsamples cells spread evenly through the roi.
+  // the deviation is relative to the spacecharge part of the direct sum, since the external field would hide it.
+  unsigned long long totalelements = nr_roi;
+  totalelements *= nphi_roi;
+  totalelements *= nz_roi;
+  if (static_cast<unsigned long long>(nsamples) > totalelements)
+  {
+    nsamples = totalelements;
+  }
+
+  float worst = 0;
+  int worst_r = 0;
+  int worst_phi = 0;
+  int worst_z = 0;
+  for (int i = 0; i < nsamples; i++)
+  {
+    unsigned long long el = i * totalelements / nsamples;
+    int ir = el / (nphi_roi * nz_roi);
+    int iphi = (el / nz_roi) % nphi_roi;
+    int iz = el % nz_roi;
+    TVector3 direct = sum_field_at(ir + rmin_roi, iphi + phimin_roi, iz + zmin_roi);
+    TVector3 spacecharge = direct - Eexternal->Get(ir, iphi, iz);
+    float deviation = (Efield->Get(ir, iphi, iz) - direct).Mag();
+    if (spacecharge.Mag() > 0)
+    {
+      deviation /= spacecharge.Mag();
+    }
+    if (deviation > worst)
+    {
+      worst = deviation;
+      worst_r = ir + rmin_roi;
+      worst_phi = iphi + phimin_roi;
+      worst_z = iz + zmin_roi;
+    }
+  }
+  std::cout << std::format("validate_fieldmap:  largest relative deviation from sum_field_at in {} cells is {:E}, at (ir={}, iphi={}, iz={})",
+                           nsamples, worst, worst_r, worst_phi, worst_z)
+            << std::endl;
+  return worst;
+}
+
 void AnnularFieldSim::populate_lookup()
 {
   // with 'f' being the position the field is being measured at, and 'o' being the position of the charge generating the field.
@@ -1664,47 +2029,51 @@ void AnnularFieldSim::populate_full3d_lookup()
   totalelements *= nz;  // breaking up this multiplication prevents a 32bit math overflow
   unsigned long long percent = totalelements / 100 * debug_npercent;
   std::cout << std::format("total elements = {}", totalelements) << std::endl;
-  TVector3 at(1, 0, 0);
-  TVector3 from(1, 0, 0);
-  TVector3 zero(0, 0, 0);
+  if (green != nullptr)
+  {
+    green->TabulateRnk(GetCellCenterRadii());  // the fortran Bessel functions can only be called from one thread at a time.
+  }
 
-  int el = 0;
-  for (int ifr = rmin_roi; ifr < rmax_roi; ifr++)
+  std::mutex print_mutex;
+  // one task per 'f' cell.  el is the same running count as in a single loop over all elements.
+  auto fill_cell = [&](size_t task, unsigned int /*worker*/)
   {
-    for (int ifphi = phimin_roi; ifphi < phimax_roi; ifphi++)
+    const int ifr = rmin_roi + task / (nphi_roi * nz_roi);
+    const int ifphi = phimin_roi + (task / nz_roi) % nphi_roi;
+    const int ifz = zmin_roi + task % nz_roi;
+    unsigned long long el = task * nr * nphi * nz;
+    TVector3 at = GetCellCenter(ifr, ifphi, ifz);
+    TVector3 from(1, 0, 0);
+    TVector3 zero(0, 0, 0);
+    for (int ior = 0; ior < nr; ior++)
     {
-      for (int ifz = zmin_roi; ifz < zmax_roi; ifz++)
+      for (int iophi = 0; iophi < nphi; iophi++)
       {
-        at = GetCellCenter(ifr, ifphi, ifz);
-        for (int ior = 0; ior < nr; ior++)
+        for (int ioz = 0; ioz < nz; ioz++)
         {
-          for (int iophi = 0; iophi < nphi; iophi++)
+          el++;
+          if (!(el % percent))
           {
-            for (int ioz = 0; ioz < nz; ioz++)
-            {
-              el++;
-              if (!(el % percent))
-              {
-                std::cout << std::format("populate_full3d_lookup {}%", static_cast<uint64_t>(debug_npercent) * el / percent) << std::endl;
-              }
-              from = GetCellCenter(ior, iophi, ioz);
+            std::lock_guard<std::mutex> lock(print_mutex);
+            std::cout << std::format("populate_full3d_lookup {}%", static_cast<uint64_t>(debug_npercent) * el / percent) << std::endl;
+          }
+          from = GetCellCenter(ior, iophi, ioz);
 
-              //*f[ifx][ify][ifz][iox][ioy][ioz]=cacl_unit_field(at,from);
-              // print_need_cout("calc_unit_field...\n");
-              if (ifr == ior && ifphi == iophi && ifz == ioz)
-              {
-                Epartial->Set(ifr - rmin_roi, ifphi - phimin_roi, ifz - zmin_roi, ior, iophi, ioz, zero);
-              }
-              else
-              {
-                Epartial->Set(ifr - rmin_roi, ifphi - phimin_roi, ifz - zmin_roi, ior, iophi, ioz, calc_unit_field(at, from));
-              }
-            }
+          //*f[ifx][ify][ifz][iox][ioy][ioz]=cacl_unit_field(at,from);
+          // print_need_cout("calc_unit_field...\n");
+          if (ifr == ior && ifphi == iophi && ifz == ioz)
+          {
+            Epartial->Set(ifr - rmin_roi, ifphi - phimin_roi, ifz - zmin_roi, ior, iophi, ioz, zero);
+          }
+          else
+          {
+            Epartial->Set(ifr - rmin_roi, ifphi - phimin_roi, ifz - zmin_roi, ior, iophi, ioz, calc_unit_field(at, from));
           }
         }
       }
     }
-  }
+  };
+  GetThreadPool().parallel_for(static_cast<size_t>(nr_roi) * nphi_roi * nz_roi, fill_cell);
   return;
 }
 
@@ -1993,60 +2362,64 @@ void AnnularFieldSim::populate_phislice_lookup()
   totalelements *= nz_roi;  // breaking up this multiplication prevents a 32bit math overflow
   unsigned long long percent = totalelements / 100 * debug_npercent;
   std::cout << std::format("total elements = {}", totalelements) << std::endl;
-  TVector3 at(1, 0, 0);
-  TVector3 from(1, 0, 0);
-  TVector3 zero(0, 0, 0);
+  if (green != nullptr)
+  {
+    green->TabulateRnk(GetCellCenterRadii());  // the fortran Bessel functions can only be called from one thread at a time.
+  }
 
-  int el = 0;
-  for (int ifr = rmin_roi; ifr < rmax_roi; ifr++)
+  std::mutex print_mutex;
+  // one task per (r,z) slice.  el is the same running count as in a single loop over all elements.
+  auto fill_slice = [&](size_t task, unsigned int /*worker*/)
   {
-    for (int ifz = zmin_roi; ifz < zmax_roi; ifz++)
+    const int ifr = rmin_roi + task / nz_roi;
+    const int ifz = zmin_roi + task % nz_roi;
+    unsigned long long el = task * nr * nphi * nz;
+    TVector3 at = GetCellCenter(ifr, 0, ifz);
+    TVector3 from(1, 0, 0);
+    TVector3 zero(0, 0, 0);
+    for (int ior = 0; ior < nr; ior++)
     {
-      at = GetCellCenter(ifr, 0, ifz);
-      for (int ior = 0; ior < nr; ior++)
+      for (int iophi = 0; iophi < nphi; iophi++)
       {
-        for (int iophi = 0; iophi < nphi; iophi++)
+        for (int ioz = 0; ioz < nz; ioz++)
         {
-          for (int ioz = 0; ioz < nz; ioz++)
+          el++;
+          from = GetCellCenter(ior, iophi, ioz);
+          //*f[ifx][ify][ifz][iox][ioy][ioz]=cacl_unit_field(at,from);
+          // print_need_cout("calc_unit_field...\n");
+          if (ifr == ior && 0 == iophi && ifz == ioz)
           {
-            el++;
-            from = GetCellCenter(ior, iophi, ioz);
-            //*f[ifx][ify][ifz][iox][ioy][ioz]=cacl_unit_field(at,from);
-            // print_need_cout("calc_unit_field...\n");
-            if (ifr == ior && 0 == iophi && ifz == ioz)
+            if (!(el % percent))
             {
-              if (!(el % percent))
-              {
-                std::cout << std::format("populate_phislice_lookup {}%:  ", static_cast<uint64_t>(debug_npercent) * el / percent);
+              std::lock_guard<std::mutex> lock(print_mutex);
+              std::cout << std::format("populate_phislice_lookup {}%:  ", static_cast<uint64_t>(debug_npercent) * el / percent);
 
-                std::cout << std::format("self-to-self is zero (ir={}, iphi={}, iz={}) to (or={}, ophi=0, oz={}) gives ({:E},{:E},{:E})",
-                                         ior, iophi, ioz, ifr, ifz, zero.X(), zero.Y(), zero.Z())
-                          << std::endl;
-              }
-              Epartial_phislice->Set(ifr - rmin_roi, 0, ifz - zmin_roi, ior, iophi, ioz, zero);
+              std::cout << std::format("self-to-self is zero (ir={}, iphi={}, iz={}) to (or={}, ophi=0, oz={}) gives ({:E},{:E},{:E})",
+                                       ior, iophi, ioz, ifr, ifz, zero.X(), zero.Y(), zero.Z())
+                        << std::endl;
             }
-            else
+            Epartial_phislice->Set(ifr - rmin_roi, 0, ifz - zmin_roi, ior, iophi, ioz, zero);
+          }
+          else
+          {
+            TVector3 unitf = calc_unit_field(at, from);
+            if (!(el % percent))
             {
-              TVector3 unitf = calc_unit_field(at, from);
-              if (true)
-              {
-                if (!(el % percent))
-                {
-                  std::cout << std::format("populate_phislice_lookup {}%:  ", static_cast<uint64_t>(debug_npercent) * el / percent);
+              std::lock_guard<std::mutex> lock(print_mutex);
+              std::cout << std::format("populate_phislice_lookup {}%:  ", static_cast<uint64_t>(debug_npercent) * el / percent);
 
-                  std::cout << std::format("calc_unit_field (ir={}, iphi={}, iz={}) to (or={}, ophi=0, oz={}) gives ({:E},{:E},{:E})",
-                                           ior, iophi, ioz, ifr, ifz, unitf.X(), unitf.Y(), unitf.Z())
-                            << std::endl;
-                }
-              }
-
-              Epartial_phislice->Set(ifr - rmin_roi, 0, ifz - zmin_roi, ior, iophi, ioz, unitf);  // the origin phi is relative to zero anyway.
+              std::cout << std::format("calc_unit_field (ir={}, iphi={}, iz={}) to (or={}, ophi=0, oz={}) gives ({:E},{:E},{:E})",
+                                       ior, iophi, ioz, ifr, ifz, unitf.X(), unitf.Y(), unitf.Z())
+                        << std::endl;
             }
+
+            Epartial_phislice->Set(ifr - rmin_roi, 0, ifz - zmin_roi, ior, iophi, ioz, unitf);  // the origin phi is relative to zero anyway.
           }
         }
       }
     }
-  }
+  };
+  GetThreadPool().parallel_for(static_cast<size_t>(nr_roi) * nz_roi, fill_slice);
   return;
 }
 
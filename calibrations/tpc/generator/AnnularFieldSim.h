@@ -4,10 +4,13 @@
 
 #include <cmath>
 #include <limits>
+#include <memory>
 #include <string>
+#include <vector>
 
 class AnalyticFieldModel;
 class ChargeMapReader;
+class PHThreadPool;
 class TH2;
 class TH3;
 class TTree;
@@ -46,6 +49,16 @@ class AnnularFieldSim
     NoSpacecharge
   };  // load from file, load from AnalyticFieldModel, or set to zero.
   // note that if we set to Zero, we skip the lookup step.
+  enum FieldSumCase
+  {
+    LegacySum,
+    FlatSum,
+    FFTSum
+  };
+  // LegacySum = sum_field_at in each cell, with TVector3 arithmetic.
+  // FlatSum = PhiSlice only: for each (r,z) slice of the lookup, copy it once to flat float storage and sum all phi cells from it.
+  // FFTSum = PhiSlice only: as FlatSum, but the sum over source phi is done as a circular correlation with FFTs along phi.
+  //     all three give the same field up to float rounding.  LegacySum is the default, the other lookup cases always use it.
 
   // constructors with history for backwards compatibility
   AnnularFieldSim(float rin, float rout, float dz, int r, int phi, int z, float vdr);  // abbr. constructor with roi=full region
@@ -68,6 +81,8 @@ class AnnularFieldSim
   explicit AnnularFieldSim(const AnnularFieldSim &) = delete;
   AnnularFieldSim &operator=(const AnnularFieldSim &) = delete;
 
+  ~AnnularFieldSim();
+
   // debug functions:
   void UpdateEveryN(int n)
   {
@@ -95,6 +110,19 @@ class AnnularFieldSim
     return;
   }
 
+  // multithreading of the lookup and fieldmap generation.  0 runs everything in the calling thread, negative uses all hardware threads.
+  void SetNThreads(int n);
+  void SetFieldSumCase(FieldSumCase x)
+  {
+    fieldSumCase = x;
+    return;
+  }
+  void SetFieldSumValidation(int nsamples)
+  {
+    fieldsum_validation = nsamples;
+    return;
+  }  // after populate_fieldmap, compare that many cells to the legacy sum_field_at.
+
   // getters for internal states:
   std::string GetLookupString();
   std::string GetGasString();
@@ -192,6 +220,7 @@ class AnnularFieldSim
   TVector3 GetWeightedCellCenter(int r, int phi, int z);
   TVector3 fieldIntegral(float zdest, const TVector3 &start, MultiArray<TVector3> *field);
   void populate_fieldmap();
+  float validate_fieldmap(int nsamples);  // returns the largest deviation from sum_field_at, relative to the spacecharge field
   // now handled by setting 'analytic' lookup:  void populate_analytic_fieldmap();
   void populate_lookup();
   void populate_full3d_lookup();
@@ -226,6 +255,10 @@ class AnnularFieldSim
   int GetPhiIndex(float pos);
   int GetZindex(float pos);
 
+  void populate_phislice_fieldmap();  // FlatSum and FFTSum implementations
+  std::vector<double> GetCellCenterRadii();
+  PHThreadPool &GetThreadPool();
+
   void UpdateOmegaTau()
   {
     omegatau_nominal = -Bnominal * vdrift / std::abs(Enominal);
@@ -349,4 +382,10 @@ class AnnularFieldSim
   MultiArray<double> *q_local;   // temporary holder of space charge in each f-bin and summed bin of the high-res region.
   MultiArray<double> *q_lowres;  // space charge in each l-bin. = sums over sets of f-bins.
   TH2 *hRdeltaRComponent{nullptr};
+
+  // multithreading and field summation:
+  int nthreads{0};
+  std::unique_ptr<PHThreadPool> threadPool;
+  FieldSumCase fieldSumCase{LegacySum};
+  int fieldsum_validation{0};
 };
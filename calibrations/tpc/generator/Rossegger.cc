@@ -12,6 +12,7 @@
 #include <format>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
 
@@ -21,6 +22,15 @@ extern "C"
   void dkia_(int *IFAC, double *X, double *A, double *DKI, double *DKID, int *IERRO);
   void dlia_(int *IFAC, double *X, double *A, double *DLI, double *DLID, int *IERRO);
 }
+
+namespace
+{
+  // the fortran routines above keep intermediate results in common blocks, so only one call at a time
+  std::mutex fortran_mutex;
+
+  // tolerance when matching a radius to the tabulated ones, in cm.  Covers the rounding of positions rebuilt from r and phi.
+  const double rnk_radius_tolerance = 1e-9;
+}  // namespace
 //
 
 // Bessel Function J_n(x):
@@ -350,6 +360,7 @@ double Rossegger::Limu(double mu, double x)
   int IERRO = 0;
 
   double X = x;
+  std::lock_guard<std::mutex> lock(fortran_mutex);
   dlia_(&IFAC, &X, &A, &DLI, &DERR, &IERRO);
   return DLI;
 }
@@ -362,6 +373,7 @@ double Rossegger::Kimu(double mu, double x)
   int IERRO = 0;
 
   double X = x;
+  std::lock_guard<std::mutex> lock(fortran_mutex);
   dkia_(&IFAC, &X, &A, &DKI, &DERR, &IERRO);
   return DKI;
 }
@@ -724,12 +736,51 @@ double Rossegger::Rnk(int n, int k, double r)
     ;
     return 0;
   }
+  // use the table if r is one of the tabulated radii:
+  if (!RnkRadii.empty())
+  {
+    auto iter = std::lower_bound(RnkRadii.begin(), RnkRadii.end(), r - rnk_radius_tolerance);
+    if (iter != RnkRadii.end() && std::abs(*iter - r) <= rnk_radius_tolerance)
+    {
+      return RnkTable[((iter - RnkRadii.begin()) * NumberOfOrders + n) * NumberOfOrders + k];
+    }
+  }
+
   //  Rossegger Equation 5.45
   //       Rnk(r) = Limu_nk (BetaN a) Kimu_nk (BetaN r) - Kimu_nk(BetaN a) Limu_nk (BetaN r)
 
   return liMunk_BetaN_a[n][k] * kimu(Munk[n][k], BetaN[n] * r) - kiMunk_BetaN_a[n][k] * limu(Munk[n][k], BetaN[n] * r);
 }
 
+void Rossegger::TabulateRnk(const std::vector<double> &radii)
+{
+  // compute the table with the fortran routines first, then make it visible to Rnk
+  std::vector<double> sorted = radii;
+  std::sort(sorted.begin(), sorted.end());
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+  RnkRadii.clear();
+  RnkTable.clear();
+  std::vector<double> table(sorted.size() * NumberOfOrders * NumberOfOrders, 0);
+  for (size_t i = 0; i < sorted.size(); i++)
+  {
+    for (int n = 0; n < NumberOfOrders; n++)
+    {
+      for (int k = 0; k < NumberOfOrders; k++)
+      {
+        table[(i * NumberOfOrders + n) * NumberOfOrders + k] = Rnk(n, k, sorted[i]);
+      }
+    }
+  }
+  RnkRadii = std::move(sorted);
+  RnkTable = std::move(table);
+  if (verbosity)
+  {
+    std::cout << std::format("Rossegger::TabulateRnk:  tabulated Rnk at {} radii", RnkRadii.size()) << std::endl;
+  }
+  return;
+}
+
 double Rossegger::Rnk_(int n, int k, double r)
 {
   //  Check input arguments for sanity...
@@ -23,6 +23,7 @@
 #include <limits>
 #include <map>
 #include <string>
+#include <vector>
 
 class TH2;
 class TH3;
@@ -54,6 +55,10 @@ class Rossegger
   double Limu(double mu, double x);  // Bessel functions of purely imaginary order
   double Kimu(double mu, double x);  // Bessel functions of purely imaginary order
 
+  // tabulate Rnk at a fixed set of radii (eg. the cell centers of a grid).  Rnk at those radii is then read back from the table
+  // instead of calling the fortran Limu/Kimu, which makes Ephi much faster there, and safe to call from several threads.
+  void TabulateRnk(const std::vector<double> &radii);
+
   double Ez(double r, double phi, double z, double r1, double phi1, double z1);
   double Er(double r, double phi, double z, double r1, double phi1, double z1);
   double Ephi(double r, double phi, double z, double r1, double phi1, double z1);
@@ -117,6 +122,9 @@ class Rossegger
   double sinh_Betamn_L[NumberOfOrders][NumberOfOrders]{};   // sinh(Betamn[m][n]*L)  as in Rossegger 5.64
   double sinh_pi_Munk[NumberOfOrders][NumberOfOrders]{};    // sinh(pi*Munk[n][k]) as in Rossegger 5.66
 
+  std::vector<double> RnkRadii;  // sorted radii at which Rnk is tabulated
+  std::vector<double> RnkTable;  // Rnk(n,k,RnkRadii[i]) stored at [(i*NumberOfOrders+n)*NumberOfOrders+k]
+
   TH2 *Tags {nullptr};
   std::map<std::string, TH3 *> Grid;
 };
@@ -25,9 +25,60 @@
 #include <fstream>
 #include <iostream>  // for operator<<, basic_ostream, endl
 #include <sstream>
+#include <system_error>
 #include <utility>  // for pair
 #include <vector>   // for vector
 
+namespace
+{
+  // read "domain url" pairs, as written by SphenixClient::DumpCalibrations
+  void read_calibrations(std::ifstream &calibsfile, std::map<std::string, std::string> &urls)
+  {
+    std::string line;
+    while (std::getline(calibsfile, line))
+    {
+      // Skip empty lines
+      if (line.empty())
+      {
+        continue;
+      }
+
+      // Skip comments
+      if (line[0] == '#')
+      {
+        continue;
+      }
+      std::istringstream iss(line);
+      std::string key;
+      std::string payload_url;
+      if (iss >> key >> payload_url)
+      {
+        urls.insert(std::make_pair(key, payload_url));
+      }
+    }
+  }
+
+  // global tags and domains are used as directory names
+  std::string cache_name(const std::string &name)
+  {
+    std::string result = name;
+    for (auto &c : result)
+    {
+      if (c == '/' || c == ' ')
+      {
+        c = '_';
+      }
+    }
+    return result;
+  }
+
+  // suffix for temporary files, unique across jobs sharing the cache
+  std::string temporary_suffix()
+  {
+    return std::string(".") + gSystem->HostName() + "." + std::to_string(gSystem->GetPid()) + ".tmp";
+  }
+}  // namespace
+
 CDBInterface *CDBInterface::__instance{nullptr};
 
 CDBInterface *CDBInterface::instance()
@@ -55,6 +106,13 @@ CDBInterface::~CDBInterface()
   delete cdbclient;
 }
 
+//____________________________________________________________________________..
+int CDBInterface::InitRun(PHCompositeNode * /*topNode*/)
+{
+  Prefetch();
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
 //____________________________________________________________________________..
 int CDBInterface::End(PHCompositeNode *topNode)
 {
@@ -153,10 +211,7 @@ std::string CDBInterface::getUrl(const std::string &domain, const std::string &f
     std::cout << "rc->set_uint64Flag(\"TIMESTAMP\",<64 bit timestamp>)" << std::endl;
     gSystem->Exit(1);
   }
-  if (cdbclient == nullptr)
-  {
-    cdbclient = new SphenixClient(rc->get_StringFlag("CDB_GLOBALTAG"));
-  }
+  Prefetch();
   uint64_t timestamp = rc->get_uint64Flag("TIMESTAMP");
   if (Verbosity() > 0)
   {
@@ -164,14 +219,14 @@ std::string CDBInterface::getUrl(const std::string &domain, const std::string &f
               << ", domain: " << domain_noconst
               << ", timestamp: " << timestamp;
   }
-  std::string return_url = cdbclient->getCalibration(domain_noconst, timestamp);
+  std::string return_url = getCalibration(domain_noconst, timestamp);
   if (return_url.empty())
   {
     if (!disable_default)
     {
       std::string domain_copy = domain_noconst;
       domain_noconst = domain_noconst + "_default";
-      return_url = cdbclient->getCalibration(domain_noconst, timestamp);
+      return_url = getCalibration(domain_noconst, timestamp);
       if (return_url.empty())
       {
         if (Verbosity() > 0)
@@ -206,6 +261,10 @@ std::string CDBInterface::getUrl(const std::string &domain, const std::string &f
       std::cout << PHWHERE << "not adding again " << domain_noconst << ", url: " << return_url
                 << ", time stamp: " << timestamp << std::endl;
     }
+    if (m_CacheLoaded && m_CopyPayloads)
+    {
+      return CachePayload(domain_noconst, return_url);
+    }
   }
   return return_url;
 }
@@ -225,12 +284,8 @@ void CDBInterface::DumpCalibrations(const std::string &filename)
     std::cout << "rc->set_uint64Flag(\"TIMESTAMP\",<64 bit timestamp>)" << std::endl;
     gSystem->Exit(1);
   }
-  if (cdbclient == nullptr)
-  {
-    cdbclient = new SphenixClient(rc->get_StringFlag("CDB_GLOBALTAG"));
-  }
   uint64_t timestamp = rc->get_uint64Flag("TIMESTAMP");
-  cdbclient->DumpCalibrations(timestamp, filename);
+  getClient()->DumpCalibrations(timestamp, filename);
   return;
 }
 
@@ -250,28 +305,7 @@ void CDBInterface::ReadCalibrationsFromFile(const std::string &filename)
   std::ifstream calibsfile(filename);
   if (calibsfile.is_open())
   {
-    std::string line;
-    while (std::getline(calibsfile, line))
-    {
-      // Skip empty lines
-      if (line.empty())
-      {
-        continue;
-      }
-
-      // Skip comments
-      if (line[0] == '#')
-      {
-        continue;
-      }
-      std::istringstream iss(line);
-      std::string key;
-      std::string payload_url;
-      if (iss >> key >> payload_url)
-      {
-        m_Payload_Url_Cache.insert(std::make_pair(key, payload_url));
-      }
-    }
+    read_calibrations(calibsfile, m_Payload_Url_Cache);
     m_Read_From_File_Flag = true;
   }
   else
@@ -280,3 +314,143 @@ void CDBInterface::ReadCalibrationsFromFile(const std::string &filename)
   }
   return;
 }
+
+void CDBInterface::SetPayloadCache(const std::string &dir, bool copy_payloads)
+{
+  m_CacheDir = dir;
+  m_CopyPayloads = copy_payloads;
+  m_CacheTried = false;
+  m_CacheLoaded = false;
+  m_Cached_Urls.clear();
+}
+
+bool CDBInterface::Prefetch()
+{
+  if (m_CacheDir.empty() || disable || m_Read_From_File_Flag)
+  {
+    return false;
+  }
+  recoConsts *rc = recoConsts::instance();
+  if (!rc->FlagExist("CDB_GLOBALTAG") || !rc->FlagExist("TIMESTAMP"))
+  {
+    return false;
+  }
+  const std::string globaltag = rc->get_StringFlag("CDB_GLOBALTAG");
+  const uint64_t timestamp = rc->get_uint64Flag("TIMESTAMP");
+  // a failed attempt is not repeated for the same global tag and timestamp
+  if (m_CacheTried && globaltag == m_CacheGlobalTag && timestamp == m_CacheTimestamp)
+  {
+    return m_CacheLoaded;
+  }
+
+  m_CacheTried = true;
+  m_CacheLoaded = false;
+  m_Cached_Urls.clear();
+  m_CacheGlobalTag = globaltag;
+  m_CacheTimestamp = timestamp;
+  m_CacheKeyDir = m_CacheDir / cache_name(globaltag) / std::to_string(timestamp);
+
+  std::error_code ec;
+  std::filesystem::path calibfile = m_CacheKeyDir / "calibrations.txt";
+  if (!std::filesystem::exists(calibfile, ec))
+  {
+    // one query for all domains, valid for this timestamp
+    std::filesystem::create_directories(m_CacheKeyDir, ec);
+    if (ec)
+    {
+      std::cout << PHWHERE << " cannot create payload cache directory " << m_CacheKeyDir
+                << ": " << ec.message() << std::endl;
+      return false;
+    }
+    std::filesystem::path tmpfile = calibfile;
+    tmpfile += temporary_suffix();
+    getClient()->DumpCalibrations(timestamp, tmpfile.string());
+    if (!std::filesystem::exists(tmpfile, ec))
+    {
+      std::cout << PHWHERE << " could not fill payload cache " << calibfile
+                << ", querying the database directly" << std::endl;
+      return false;
+    }
+    // if another job was faster, its identical file is replaced
+    std::filesystem::rename(tmpfile, calibfile, ec);
+    if (ec)
+    {
+      std::filesystem::remove(tmpfile, ec);
+    }
+  }
+
+  std::ifstream calibsfile(calibfile);
+  if (!calibsfile.is_open())
+  {
+    std::cout << PHWHERE << " could not open " << calibfile << std::endl;
+    return false;
+  }
+  read_calibrations(calibsfile, m_Cached_Urls);
+  m_CacheLoaded = true;
+  if (Verbosity() > 0)
+  {
+    std::cout << "CDBInterface: " << m_Cached_Urls.size() << " payload urls cached in "
+              << calibfile << std::endl;
+  }
+  return true;
+}
+
+SphenixClient *CDBInterface::getClient()
+{
+  if (cdbclient == nullptr)
+  {
+    recoConsts *rc = recoConsts::instance();
+    cdbclient = new SphenixClient(rc->get_StringFlag("CDB_GLOBALTAG"));
+  }
+  return cdbclient;
+}
+
+std::string CDBInterface::getCalibration(const std::string &domain, uint64_t timestamp)
+{
+  if (m_CacheLoaded)
+  {
+    auto iter = m_Cached_Urls.find(domain);
+    return iter == m_Cached_Urls.end() ? "" : iter->second;
+  }
+  return getClient()->getCalibration(domain, timestamp);
+}
+
+std::string CDBInterface::CachePayload(const std::string &domain, const std::string &url)
+{
+  // only local files are copied, remote urls are used as they are
+  std::error_code ec;
+  const std::filesystem::path source = url;
+  if (!std::filesystem::is_regular_file(source, ec))
+  {
+    return url;
+  }
+  const std::filesystem::path target = m_CacheKeyDir / "payloads" / cache_name(domain) / source.filename();
+  const auto size = std::filesystem::file_size(source, ec);
+  if (std::filesystem::exists(target, ec) && std::filesystem::file_size(target, ec) == size)
+  {
+    return target.string();
+  }
+
+  std::filesystem::create_directories(target.parent_path(), ec);
+  std::filesystem::path tmpfile = target;
+  tmpfile += temporary_suffix();
+  std::filesystem::copy_file(source, tmpfile, std::filesystem::copy_options::overwrite_existing, ec);
+  if (!ec)
+  {
+    std::filesystem::rename(tmpfile, target, ec);
+  }
+  if (ec)
+  {
+    if (Verbosity() > 0)
+    {
+      std::cout << PHWHERE << " could not cache " << url << ": " << ec.message() << std::endl;
+    }
+    std::filesystem::remove(tmpfile, ec);
+    return url;
+  }
+  if (Verbosity() > 1)
+  {
+    std::cout << "CDBInterface: cached " << url << " as " << target << std::endl;
+  }
+  return target.string();
+}
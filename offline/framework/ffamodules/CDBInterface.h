@@ -6,6 +6,7 @@
 #include <fun4all/SubsysReco.h>
 
 #include <cstdint>  // for uint64_t
+#include <filesystem>
 #include <map>
 #include <set>
 #include <string>
@@ -20,6 +21,9 @@ class CDBInterface : public SubsysReco
 
   ~CDBInterface() override;
 
+  /// Fills the payload cache (if enabled) for the current global tag and timestamp
+  int InitRun(PHCompositeNode *topNode) override;
+
   /// Called at the end of all processing.
   int End(PHCompositeNode *topNode) override;
 
@@ -38,9 +42,26 @@ class CDBInterface : public SubsysReco
   void DumpCalibrations(const std::string &filename);
   void ReadCalibrationsFromFile(const std::string &filename);
 
+  /// Local on-disk cache of payload urls and payload files, shared between jobs running on the same run
+  /// <dir>/<global tag>/<timestamp>/calibrations.txt: urls of all domains, same format as DumpCalibrations
+  /// <dir>/<global tag>/<timestamp>/payloads/<domain>/<file>: copies of payload files (if copy_payloads is set)
+  /// The first job fills calibrations.txt with a single database query, later jobs read it
+  /// and do not contact the database at all. A directory filled by hand can therefore stand in
+  /// for the database in tests. Files are written under a temporary name and renamed, so that
+  /// concurrent jobs never see partial files. Urls saved on the DST are always the database ones
+  void SetPayloadCache(const std::string &dir, bool copy_payloads = true);
+
+  /// read (or create) the cache for the current global tag and timestamp. Done at InitRun
+  /// and on the first getUrl, returns false if there is no usable cache
+  bool Prefetch();
+
  private:
   CDBInterface(const std::string &name = "CDBInterface");
 
+  SphenixClient *getClient();
+  std::string getCalibration(const std::string &domain, uint64_t timestamp);
+  std::string CachePayload(const std::string &domain, const std::string &url);
+
   static CDBInterface *__instance;
   SphenixClient *cdbclient{nullptr};
   bool disable{false};
@@ -48,6 +69,16 @@ class CDBInterface : public SubsysReco
   bool m_Read_From_File_Flag{false};
   std::map<std::string, std::string> m_Payload_Url_Cache;
   std::set<std::tuple<std::string, std::string, uint64_t>> m_UrlVector;
+
+  // payload cache
+  std::filesystem::path m_CacheDir;
+  bool m_CopyPayloads{true};
+  bool m_CacheTried{false};
+  bool m_CacheLoaded{false};
+  std::string m_CacheGlobalTag;
+  uint64_t m_CacheTimestamp{0};
+  std::filesystem::path m_CacheKeyDir;
+  std::map<std::string, std::string> m_Cached_Urls;
 };
 
 #endif  // FFAMODULES_CDBINTERFACE_H
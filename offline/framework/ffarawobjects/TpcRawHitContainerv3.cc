@@ -1,9 +1,12 @@
 #include "TpcRawHitContainerv3.h"
 #include "TpcRawHitv3.h"
+#include "TpcRawHitv4.h"
 
 #include <TClonesArray.h>
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 static const int NTPCHITS = 10000;
 
@@ -63,6 +66,32 @@ TpcRawHit *TpcRawHitContainerv3::AddHit(TpcRawHit *tpchit)
     return newhit;
   }
 
+  if (tpchit->IsA() == TpcRawHitv4::Class())
+  {
+    // hits from the time frame builder: copy each waveform of the arena segment
+    TpcRawHitv3 *newhit = new ((*TpcRawHitsTCArray)[TpcRawHitsTCArray->GetLast() + 1]) TpcRawHitv3();
+    newhit->set_bco(tpchit->get_bco());
+    newhit->set_packetid(tpchit->get_packetid());
+    newhit->set_fee(tpchit->get_fee());
+    newhit->set_channel(tpchit->get_channel());
+    newhit->set_type(tpchit->get_type());
+    newhit->set_checksumerror(tpchit->get_checksumerror());
+    newhit->set_parityerror(tpchit->get_parityerror());
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+    const TpcRawHitv4 *source = static_cast<TpcRawHitv4 *>(tpchit);
+    const uint16_t *data = source->get_adc_data();
+    const uint32_t length = source->get_adc_length();
+    uint32_t position = 0;
+    while (data && position + 2 <= length)
+    {
+      const uint32_t nsamples = std::min<uint32_t>(data[position], length - position - 2);
+      newhit->move_adc_waveform(data[position + 1], std::vector<uint16_t>(data + position + 2, data + position + 2 + nsamples));
+      position += 2U + nsamples;
+    }
+    return newhit;
+  }
+
   std::cout << __PRETTY_FUNCTION__ << "WARNING: input hit is not of type TpcRawHitv3. This is slow, please avoid." << std::endl;
   TpcRawHit *newhit = new ((*TpcRawHitsTCArray)[TpcRawHitsTCArray->GetLast() + 1]) TpcRawHitv3(tpchit);
   return newhit;
@@ -0,0 +1,142 @@
+#include "TpcRawHitContainerv4.h"
+#include "TpcRawHitv3.h"
+#include "TpcRawHitv4.h"
+
+#include <TClonesArray.h>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+static const int NTPCHITS = 10000;
+
+TpcRawHitContainerv4::TpcRawHitContainerv4()
+  : TpcRawHitsTCArray(new TClonesArray("TpcRawHitv4", NTPCHITS))
+{
+}
+
+TpcRawHitContainerv4::~TpcRawHitContainerv4()
+{
+  TpcRawHitsTCArray->Clear("C");
+  delete TpcRawHitsTCArray;
+}
+
+void TpcRawHitContainerv4::Reset()
+{
+  TpcRawHitsTCArray->Clear("C");
+  TpcRawHitsTCArray->Expand(NTPCHITS);
+
+  // keep allocated memory for next event
+  m_adc.clear();
+}
+
+void TpcRawHitContainerv4::identify(std::ostream &os) const
+{
+  os << "TpcRawHitContainerv4" << std::endl;
+  os << "containing " << TpcRawHitsTCArray->GetEntriesFast() << " Tpc hits"
+     << " and " << m_adc.size() << " adc words" << std::endl;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+  TpcRawHit *tpchit = static_cast<TpcRawHit *>(TpcRawHitsTCArray->At(0));
+  if (tpchit)
+  {
+    os << "for beam clock: " << std::hex << tpchit->get_bco() << std::dec << std::endl;
+  }
+}
+
+int TpcRawHitContainerv4::isValid() const
+{
+  return TpcRawHitsTCArray->GetSize();
+}
+
+unsigned int TpcRawHitContainerv4::get_nhits()
+{
+  return TpcRawHitsTCArray->GetEntriesFast();
+}
+
+TpcRawHit *TpcRawHitContainerv4::AddHit(TpcRawHit *tpchit)
+{
+  TpcRawHitv4 *newhit = new ((*TpcRawHitsTCArray)[TpcRawHitsTCArray->GetLast() + 1]) TpcRawHitv4();
+  newhit->copy_header(*tpchit);
+
+  if (tpchit->IsA() == TpcRawHitv4::Class())
+  {
+    // fast add: single copy of the source arena segment
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+    const TpcRawHitv4 *source = static_cast<TpcRawHitv4 *>(tpchit);
+    const uint32_t offset = append_adc(source->get_adc_data(), source->get_adc_length());
+    newhit->set_adc_data(&m_adc, offset, source->get_adc_length());
+    return newhit;
+  }
+
+  const uint32_t offset = m_adc.size();
+  if (tpchit->IsA() == TpcRawHitv3::Class())
+  {
+    // copy waveforms, without intermediate allocation
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+    for (const auto &[start_time, adcs] : static_cast<TpcRawHitv3 *>(tpchit)->get_adc_waveforms())
+    {
+      m_adc.push_back(static_cast<uint16_t>(adcs.size()));
+      m_adc.push_back(start_time);
+      m_adc.insert(m_adc.end(), adcs.begin(), adcs.end());
+    }
+  }
+  else
+  {
+    // generic case: group consecutive time bins into waveforms
+    std::cout << __PRETTY_FUNCTION__ << "WARNING: input hit is not of type TpcRawHitv3 or TpcRawHitv4. This is slow, please avoid." << std::endl;
+    std::size_t header = 0;
+    uint16_t next_time_bin = 0;
+    bool first = true;
+    for (std::unique_ptr<TpcRawHit::AdcIterator> adc_iterator(tpchit->CreateAdcIterator());
+         !adc_iterator->IsDone();
+         adc_iterator->Next())
+    {
+      const uint16_t time_bin = adc_iterator->CurrentTimeBin();
+      if (first || time_bin != next_time_bin)
+      {
+        // new waveform
+        header = m_adc.size();
+        m_adc.push_back(0);
+        m_adc.push_back(time_bin);
+        first = false;
+      }
+      m_adc.push_back(adc_iterator->CurrentAdc());
+      ++m_adc[header];
+      next_time_bin = time_bin + 1;
+    }
+  }
+  newhit->set_adc_data(&m_adc, offset, m_adc.size() - offset);
+  return newhit;
+}
+
+TpcRawHit *TpcRawHitContainerv4::get_hit(unsigned int index)
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+  TpcRawHitv4 *hit = static_cast<TpcRawHitv4 *>(TpcRawHitsTCArray->At(index));
+  if (hit)
+  {
+    // arena pointer is not persistent
+    hit->set_arena(&m_adc);
+  }
+  return hit;
+}
+
+uint32_t TpcRawHitContainerv4::append_adc(const uint16_t *data, const uint32_t length)
+{
+  const uint32_t offset = m_adc.size();
+  if (!data || length == 0)
+  {
+    return offset;
+  }
+
+  // source may be a segment of this arena, which can move when the arena grows
+  const bool in_arena = data >= m_adc.data() && data < m_adc.data() + m_adc.size();
+  const std::size_t source_offset = in_arena ? data - m_adc.data() : 0;
+  m_adc.resize(offset + length);
+  if (in_arena)
+  {
+    data = m_adc.data() + source_offset;
+  }
+  std::copy(data, data + length, m_adc.begin() + offset);
+  return offset;
+}
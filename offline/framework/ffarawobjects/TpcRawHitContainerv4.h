@@ -0,0 +1,62 @@
+#ifndef FUN4ALLRAW_TPCHITRAWCONTAINERv4_H
+#define FUN4ALLRAW_TPCHITRAWCONTAINERv4_H
+
+#include "TpcRawHitContainer.h"
+
+#include <cstdint>
+#include <vector>
+
+class TpcRawHit;
+class TClonesArray;
+
+//! TPC raw hit container with contiguous ADC storage
+/*!
+ * hits are TpcRawHitv4 objects, which only store the offset and length of their waveforms
+ * in a single ADC array owned by the container. The array is cleared in one go in Reset,
+ * keeping its allocated memory for the next event.
+ */
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+class TpcRawHitContainerv4 : public TpcRawHitContainer
+{
+ public:
+  TpcRawHitContainerv4();
+  ~TpcRawHitContainerv4() override;
+
+  /// Clear Event
+  void Reset() override;
+
+  /** identify Function from PHObject
+      @param os Output Stream
+   */
+  void identify(std::ostream &os = std::cout) const override;
+
+  /// isValid returns non zero if object contains vailid data
+  int isValid() const override;
+
+  //! hits are only added as copies, AddHit() without argument is not supported and returns nullptr
+  TpcRawHit *AddHit(TpcRawHit *tpchit) override;
+  unsigned int get_nhits() override;
+  TpcRawHit *get_hit(unsigned int index) override;
+  void setStatus(const unsigned int i) override { status = i; }
+  unsigned int getStatus() const override { return status; }
+  void setBco(const uint64_t i) override { bco = i; }
+  uint64_t getBco() const override { return bco; }
+
+  //! total number of adc data words
+  std::size_t get_adc_size() const { return m_adc.size(); }
+
+ private:
+  //! append adc data words to the arena, return offset of first word
+  uint32_t append_adc(const uint16_t *data, const uint32_t length);
+
+  TClonesArray *TpcRawHitsTCArray{nullptr};
+  uint64_t bco{0};
+  unsigned int status{0};
+
+  //! adc data of all hits
+  std::vector<uint16_t> m_adc;
+
+  ClassDefOverride(TpcRawHitContainerv4, 1)
+};
+
+#endif
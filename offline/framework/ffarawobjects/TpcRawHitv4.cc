@@ -0,0 +1,63 @@
+#include "TpcRawHitv4.h"
+
+#include <iostream>
+
+void TpcRawHitv4::identify(std::ostream &os) const
+{
+  os << "BCO: 0x" << std::hex << bco << std::dec << std::endl;
+  os << " packet id: " << packetid << std::endl;
+
+  const uint16_t *data = get_adc_data();
+  uint32_t position = 0;
+  while (data && position + 2 <= m_length)
+  {
+    const uint16_t nsamples = data[position];
+    os << " start time: " << data[position + 1] << " | ADCs: ";
+    for (uint16_t i = 0; i < nsamples; ++i)
+    {
+      os << data[position + 2 + i] << " ";
+    }
+    os << std::endl;
+    position += 2U + nsamples;
+  }
+}
+
+uint16_t TpcRawHitv4::get_adc(const uint16_t sample) const
+{
+  const uint16_t *data = get_adc_data();
+  uint32_t position = 0;
+  while (data && position + 2 <= m_length)
+  {
+    const uint16_t nsamples = data[position];
+    const uint16_t start_time = data[position + 1];
+    if (sample >= start_time && sample < start_time + nsamples)
+    {
+      return data[position + 2 + sample - start_time];
+    }
+    position += 2U + nsamples;
+  }
+  return 0;
+}
+
+void TpcRawHitv4::Clear(Option_t * /*unused*/)
+{
+  // quick reset. The arena is not owned
+  fee = std::numeric_limits<uint16_t>::max();
+  channel = std::numeric_limits<uint16_t>::max();
+  checksumerror = true;
+  parityerror = true;
+  m_offset = 0;
+  m_length = 0;
+  m_arena = nullptr;
+}
+
+void TpcRawHitv4::copy_header(const TpcRawHit &source)
+{
+  set_bco(source.get_bco());
+  set_packetid(source.get_packetid());
+  set_fee(source.get_fee());
+  set_channel(source.get_channel());
+  set_type(source.get_type());
+  set_checksumerror(source.get_checksumerror());
+  set_parityerror(source.get_parityerror());
+}
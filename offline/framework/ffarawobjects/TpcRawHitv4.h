@@ -0,0 +1,197 @@
+#ifndef FUN4ALLRAW_TPCRAWTHITv4_H
+#define FUN4ALLRAW_TPCRAWTHITv4_H
+
+#include "TpcRawHit.h"
+
+#include <phool/PHObject.h>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+//! TPC raw hit whose ADC waveforms are stored in an external, contiguous arena
+/*!
+ * The hit only stores an offset and a length in the arena. The arena is owned
+ * by the hit container (TpcRawHitContainerv4) or, during unpacking, by the time frame
+ * builder, and is shared by all hits of a time frame, so that creating or deleting a hit
+ * does not allocate or free memory for ADC samples.
+ * Waveforms are stored in the arena with the same layout as the FEE data:
+ * (N samples) (start time) (1st sample) ... (Nth sample), repeated for each waveform of the hit.
+ * The arena pointer is transient and must be set by the owner, after reading from file.
+ */
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+class TpcRawHitv4 : public TpcRawHit
+{
+ public:
+  TpcRawHitv4() = default;
+
+  ~TpcRawHitv4() override = default;
+
+  /** identify Function from PHObject
+      @param os Output Stream
+   */
+  void identify(std::ostream &os = std::cout) const override;
+
+  void Clear(Option_t * /*unused*/) override;
+
+  uint64_t get_bco() const override { return bco; }
+  // cppcheck-suppress virtualCallInConstructor
+  void set_bco(const uint64_t val) override { bco = val; }
+
+  int32_t get_packetid() const override { return packetid; }
+  // cppcheck-suppress virtualCallInConstructor
+  void set_packetid(const int32_t val) override { packetid = val; }
+
+  uint16_t get_fee() const override { return fee; }
+  // cppcheck-suppress virtualCallInConstructor
+  void set_fee(const uint16_t val) override { fee = val; }
+
+  uint16_t get_channel() const override { return channel; }
+  // cppcheck-suppress virtualCallInConstructor
+  void set_channel(const uint16_t val) override { channel = val; }
+
+  uint16_t get_sampaaddress() const override
+  {
+    return static_cast<uint16_t>(channel >> 5U) & 0xfU;
+  }
+
+  uint16_t get_sampachannel() const override { return channel & 0x1fU; }
+
+  uint16_t get_samples() const override { return 1024U; }
+
+  //! adc value for a given time bin, zero if not found. This is slow, prefer CreateAdcIterator
+  uint16_t get_adc(const uint16_t sample) const override;
+
+  uint16_t get_type() const override { return type; }
+  void set_type(const uint16_t i) override { type = i; }
+
+  bool get_checksumerror() const override { return checksumerror; }
+  void set_checksumerror(const bool b) override { checksumerror = b; }
+
+  bool get_parityerror() const override { return parityerror; }
+  void set_parityerror(const bool b) override { parityerror = b; }
+
+  //! copy all hit information except adc data
+  void copy_header(const TpcRawHit &source);
+
+  //! set arena and adc data location
+  void set_adc_data(const std::vector<uint16_t> *arena, const uint32_t offset, const uint32_t length)
+  {
+    m_arena = arena;
+    m_offset = offset;
+    m_length = length;
+  }
+
+  //! set arena only, e.g. after reading from file
+  void set_arena(const std::vector<uint16_t> *arena) { m_arena = arena; }
+
+  //! adc data location in arena
+  uint32_t get_adc_offset() const { return m_offset; }
+  uint32_t get_adc_length() const { return m_length; }
+
+  //! pointer to first adc data word, nullptr if none
+  const uint16_t *get_adc_data() const
+  {
+    return (m_arena && m_length > 0) ? m_arena->data() + m_offset : nullptr;
+  }
+
+  class AdcIteratorv4 : public AdcIterator
+  {
+   private:
+    const uint16_t *m_data = nullptr;
+    uint32_t m_length = 0;
+
+    // position of current waveform header in data
+    uint32_t m_waveform_position = 0;
+
+    // position of current sample in waveform
+    uint16_t m_sample = 0;
+
+    // skip empty waveforms
+    void skip_empty()
+    {
+      while (m_waveform_position + 2 <= m_length && m_data[m_waveform_position] == 0)
+      {
+        m_waveform_position += 2;
+      }
+    }
+
+   public:
+    AdcIteratorv4(const uint16_t *data, const uint32_t length)
+      : m_data(data)
+      , m_length(data ? length : 0)
+    {
+      skip_empty();
+    }
+
+    void First() override
+    {
+      m_waveform_position = 0;
+      m_sample = 0;
+      skip_empty();
+    }
+
+    void Next() override
+    {
+      if (IsDone())
+      {
+        return;
+      }
+
+      if (m_sample + 1U < m_data[m_waveform_position])
+      {
+        ++m_sample;
+      }
+      else
+      {
+        // advance to the next non empty waveform
+        m_waveform_position += 2U + m_data[m_waveform_position];
+        m_sample = 0;
+        skip_empty();
+      }
+    }
+
+    bool IsDone() const override { return m_waveform_position + 2 > m_length; }
+
+    uint16_t CurrentTimeBin() const override
+    {
+      if (!IsDone())
+      {
+        return m_data[m_waveform_position + 1] + m_sample;
+      }
+      return std::numeric_limits<uint16_t>::max();
+    }
+
+    uint16_t CurrentAdc() const override
+    {
+      if (!IsDone())
+      {
+        return m_data[m_waveform_position + 2 + m_sample];
+      }
+      return std::numeric_limits<uint16_t>::max();
+    }
+  };
+
+  AdcIterator *CreateAdcIterator() const override { return new AdcIteratorv4(get_adc_data(), m_length); }
+
+ private:
+  uint64_t bco{std::numeric_limits<uint64_t>::max()};
+  int32_t packetid{std::numeric_limits<int32_t>::max()};
+  uint16_t fee{std::numeric_limits<uint16_t>::max()};
+  uint16_t channel{std::numeric_limits<uint16_t>::max()};
+  uint16_t type{std::numeric_limits<uint16_t>::max()};
+
+  bool checksumerror{true};
+  bool parityerror{true};
+
+  //! adc data location in arena
+  uint32_t m_offset{0};
+  uint32_t m_length{0};
+
+  //! adc data arena
+  const std::vector<uint16_t> *m_arena{nullptr};  //!
+
+  ClassDefOverride(TpcRawHitv4, 1)
+};
+
+#endif
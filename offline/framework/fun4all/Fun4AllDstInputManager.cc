@@ -18,6 +18,7 @@
 #include <phool/phool.h>  // for PHWHERE, PHReadOnly, PHRunTree
 #include <phool/phooldefs.h>
 
+#include <TROOT.h>
 #include <TSystem.h>
 
 #include <boost/algorithm/string.hpp>
@@ -136,6 +137,10 @@ int Fun4AllDstInputManager::fileopen(const std::string &filenam)
     {
       m_IManager->DisableReadCache();
     }
+    else if (m_ReadAheadEntries > 0)
+    {
+      m_IManager->ReadAhead(m_ReadAheadEntries);
+    }
     if (m_IManager->NodeExist(syncdefs::SYNCNODENAME))
     {
       m_HaveSyncObject = 1;
@@ -654,3 +659,16 @@ int Fun4AllDstInputManager::HasSyncObject() const
   }
   return 0;
 }
+
+void Fun4AllDstInputManager::ReadAhead(unsigned int nentries, unsigned int nthreads)
+{
+  m_ReadAheadEntries = nentries;
+  if (nentries > 0 && nthreads > 0 && !ROOT::IsImplicitMTEnabled())
+  {
+    ROOT::EnableImplicitMT(nthreads);
+  }
+  if (m_IManager && !ReadCacheDisabled())
+  {
+    m_IManager->ReadAhead(m_ReadAheadEntries);
+  }
+}
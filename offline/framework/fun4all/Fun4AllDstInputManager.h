@@ -27,6 +27,10 @@ class Fun4AllDstInputManager : public Fun4AllInputManager
   int BranchSelect(const std::string &branch, const int iflag) override;
   int setBranches() override;
   void CacheSize(uint64_t size) { m_IManager->CacheSize(size); }
+  // decompress the next nentries entries of the selected branches ahead of time
+  // (see PHNodeIOManager::ReadAhead), using nthreads threads of ROOT's implicit MT pool.
+  // Implicit MT is only enabled here if it is not on already. Ignored if the read cache is disabled
+  void ReadAhead(unsigned int nentries, unsigned int nthreads = 1);
   virtual int setSyncBranches(PHNodeIOManager *iman);
   void Print(const std::string &what = "ALL") const override;
   int PushBackEvents(const int i) override;
@@ -58,6 +62,7 @@ class Fun4AllDstInputManager : public Fun4AllInputManager
   int events_thisfile{0};
   int events_skipped_during_sync{0};
   int m_HaveSyncObject{0};
+  unsigned int m_ReadAheadEntries{0};
   std::map<const std::string, int> branchread;
   std::string syncbranchname;
   std::string RunNode{"RUN"};
@@ -3,12 +3,18 @@
 #include "Fun4AllServer.h"
 
 #include <phool/PHCompositeNode.h>
+#include <phool/PHIODataNode.h>
 #include <phool/PHNode.h>
 #include <phool/PHNodeIOManager.h>
 #include <phool/PHNodeIterator.h>
+#include <phool/PHObject.h>
+#include <phool/PHPointerListIterator.h>
 #include <phool/phool.h>  // for PHWHERE, PHReadOnly, PHRunTree
+#include <phool/phooldefs.h>
 #include <phool/recoConsts.h>
 
+#include <TClass.h>
+#include <TROOT.h>
 #include <TSystem.h>
 
 #include <cstdlib>
@@ -23,8 +29,15 @@ Fun4AllDstOutputManager::Fun4AllDstOutputManager(const std::string &myname, cons
   return;
 }
 
+namespace
+{
+  // number of events which can be queued for the writer thread
+  const size_t max_queued_events = 2;
+}  // namespace
+
 Fun4AllDstOutputManager::~Fun4AllDstOutputManager()
 {
+  StopWriter();
   delete dstOut;
   return;
 }
@@ -171,7 +184,26 @@ int Fun4AllDstOutputManager::Write(PHCompositeNode *startNode)
       }
     }
   }
-  dstOut->write(startNode);
+  if (m_AsyncWrite)
+  {
+    PHCompositeNode *snapshot = Snapshot(startNode);
+    if (snapshot)
+    {
+      QueueWrite(snapshot);
+    }
+    else
+    {
+      // the node tree cannot be copied, fall back to writing in this thread from now on
+      std::cout << PHWHERE << Name() << ": switching to synchronous writing" << std::endl;
+      StopWriter();
+      m_AsyncWrite = false;
+      dstOut->write(startNode);
+    }
+  }
+  else
+  {
+    dstOut->write(startNode);
+  }
   // to save some cpu cycles we only make it globally transient if
   // all nodes have been written (savenodes set is empty)
   // else we only make the nodes transient which we have written (all
@@ -197,6 +229,8 @@ int Fun4AllDstOutputManager::Write(PHCompositeNode *startNode)
 
 int Fun4AllDstOutputManager::WriteNode(PHCompositeNode *thisNode)
 {
+  // all events have to be in the file before it is closed
+  FlushWrites();
   if (!m_SaveRunNodeFlag)
   {
     dstOut = nullptr;
@@ -311,6 +345,7 @@ int Fun4AllDstOutputManager::WriteNode(PHCompositeNode *thisNode)
 
 int Fun4AllDstOutputManager::outfile_open_first_write()
 {
+  FlushWrites();
   delete dstOut;
   SetEventsWritten(1);  // this is the first event we write, need to set the number to 1
   std::filesystem::path p = OutFileName();
@@ -382,3 +417,168 @@ void Fun4AllDstOutputManager::InitializeLastEvent(int eventnumber)
   SetLastEventNumber(firstevent * GetEventNumberRollover() + GetEventNumberRollover() - 1);
   return;
 }
+
+void Fun4AllDstOutputManager::AsyncWrite(const bool b, const unsigned int nthreads)
+{
+  if (!b)
+  {
+    StopWriter();
+    m_AsyncWrite = false;
+    return;
+  }
+  // the writer threads and the event loop all use ROOT
+  ROOT::EnableThreadSafety();
+  if (nthreads > 0 && !ROOT::IsImplicitMTEnabled())
+  {
+    ROOT::EnableImplicitMT(nthreads);
+  }
+  m_AsyncWrite = true;
+}
+
+// copy of the persistent nodes below startNode, owned by the caller
+// returns nullptr if a persistent node does not hold a PHObject or cannot be copied
+// NOLINTNEXTLINE(misc-no-recursion)
+PHCompositeNode *Fun4AllDstOutputManager::Snapshot(PHCompositeNode *startNode, const std::string &path)
+{
+  const std::string nodepath = path + phooldefs::branchpathdelim + startNode->getName();
+  PHCompositeNode *snapshot = new PHCompositeNode(startNode->getName());
+  PHNodeIterator nodeiter(startNode);
+  PHPointerListIterator<PHNode> iterat(nodeiter.ls());
+  PHNode *thisNode;
+  while ((thisNode = iterat()))
+  {
+    if ((thisNode->getType() == "PHCompositeNode"))
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+      PHCompositeNode *subnode = Snapshot(static_cast<PHCompositeNode *>(thisNode), nodepath);
+      if (!subnode)
+      {
+        delete snapshot;
+        return nullptr;
+      }
+      snapshot->addNode(subnode);
+      continue;
+    }
+    if (thisNode->getType() != "PHIODataNode" || !thisNode->isPersistent())
+    {
+      continue;
+    }
+    if (thisNode->getObjectType() != "PHObject")
+    {
+      std::cout << PHWHERE << Name() << ": cannot copy node " << thisNode->getName()
+                << " of type " << thisNode->getObjectType() << std::endl;
+      delete snapshot;
+      return nullptr;
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+    PHIODataNode<PHObject> *datanode = static_cast<PHIODataNode<PHObject> *>(thisNode);
+    PHObject *object = datanode->getData();
+    const std::string branchpath = nodepath + phooldefs::branchpathdelim + thisNode->getName();
+    PHObject *copy = nullptr;
+    if (!object)
+    {
+      // the branch of a node written before still points into the snapshot of a previous event,
+      // write an empty object of the same class instead
+      auto iter = m_SnapshotClasses.find(branchpath);
+      if (iter == m_SnapshotClasses.end())
+      {
+        continue;
+      }
+      TClass *cl = TClass::GetClass(iter->second.c_str());
+      copy = cl ? static_cast<PHObject *>(cl->New()) : nullptr;
+    }
+    else
+    {
+      if (!m_StreamerCopyClasses.contains(object->ClassName()))
+      {
+        copy = object->CloneMe();
+        // CloneMe() may not be implemented, or return a different (base) class which would then
+        // be written instead. Use the streamer copy for this class from now on
+        if (copy && copy->IsA() != object->IsA())
+        {
+          std::cout << PHWHERE << Name() << ": " << object->ClassName() << "::CloneMe() returns a "
+                    << copy->ClassName() << ", using streamer copy" << std::endl;
+          delete copy;
+          copy = nullptr;
+        }
+        if (!copy)
+        {
+          m_StreamerCopyClasses.insert(object->ClassName());
+        }
+      }
+      if (!copy)
+      {
+        copy = dynamic_cast<PHObject *>(object->TObject::Clone());
+      }
+    }
+    if (!copy)
+    {
+      std::cout << PHWHERE << Name() << ": cannot copy node " << thisNode->getName() << std::endl;
+      delete snapshot;
+      return nullptr;
+    }
+    m_SnapshotClasses[branchpath] = copy->ClassName();
+    PHIODataNode<PHObject> *newnode = new PHIODataNode<PHObject>(copy, thisNode->getName(), thisNode->getObjectType());
+    newnode->BufferSize(datanode->BufferSize());
+    newnode->SplitLevel(datanode->SplitLevel());
+    snapshot->addNode(newnode);
+  }
+  return snapshot;
+}
+
+void Fun4AllDstOutputManager::QueueWrite(PHCompositeNode *snapshot)
+{
+  std::unique_lock<std::mutex> lock(m_WriterMutex);
+  if (!m_WriterThread.joinable())
+  {
+    m_WriterStop = false;
+    m_WriterThread = std::thread(&Fun4AllDstOutputManager::WriterLoop, this);
+  }
+  m_WriterCondition.wait(lock, [this]
+                         { return m_WriteQueue.size() < max_queued_events; });
+  m_WriteQueue.emplace_back(dstOut, snapshot);
+  m_WriterCondition.notify_all();
+}
+
+void Fun4AllDstOutputManager::FlushWrites()
+{
+  std::unique_lock<std::mutex> lock(m_WriterMutex);
+  m_WriterCondition.wait(lock, [this]
+                         { return m_WriteQueue.empty(); });
+}
+
+void Fun4AllDstOutputManager::StopWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_WriterMutex);
+    m_WriterStop = true;
+  }
+  m_WriterCondition.notify_all();
+  if (m_WriterThread.joinable())
+  {
+    m_WriterThread.join();
+  }
+}
+
+void Fun4AllDstOutputManager::WriterLoop()
+{
+  std::unique_lock<std::mutex> lock(m_WriterMutex);
+  while (true)
+  {
+    m_WriterCondition.wait(lock, [this]
+                           { return m_WriterStop || !m_WriteQueue.empty(); });
+    // queued events are written before stopping
+    if (m_WriteQueue.empty())
+    {
+      return;
+    }
+    auto [iomanager, snapshot] = m_WriteQueue.front();
+    lock.unlock();
+    iomanager->write(snapshot);
+    delete snapshot;
+    lock.lock();
+    // only removed once written, so that FlushWrites waits for it
+    m_WriteQueue.pop_front();
+    m_WriterCondition.notify_all();
+  }
+}
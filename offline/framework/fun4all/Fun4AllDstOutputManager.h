@@ -5,8 +5,14 @@
 
 #include "Fun4AllOutputManager.h"
 
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
+#include <utility>
 
 class PHNodeIOManager;
 class PHCompositeNode;
@@ -36,9 +42,25 @@ class Fun4AllDstOutputManager : public Fun4AllOutputManager
   const std::string &UsedOutFileName() const { return m_UsedOutFileName; }
   void CompressionSetting(const int i) override { m_CompressionSetting = i; }
   void InitializeLastEvent(int eventnumber) override;
-  
+
+  // asynchronous writing: Write() copies the persistent nodes of the event and hands the copy
+  // to a writer thread, which serializes and fills the tree while the next event is processed.
+  // At most two events are queued. Baskets are compressed on ROOT's implicit MT pool,
+  // enabled with nthreads threads if it is not on already. Events are written in order,
+  // the queue is drained before the run node is written or a new file is opened.
+  // Objects are copied with CloneMe(), or with their streamer if CloneMe() is not implemented
+  // or returns another class. Nodes without data are written as an empty object of their last class.
+  // Must be called before the first event is written
+  void AsyncWrite(const bool b = true, const unsigned int nthreads = 1);
+
  private:
   int outfile_open_first_write();
+  PHCompositeNode *Snapshot(PHCompositeNode *startNode, const std::string &path = "");
+  void QueueWrite(PHCompositeNode *snapshot);
+  void FlushWrites();
+  void StopWriter();
+  void WriterLoop();
+
   PHNodeIOManager *dstOut{nullptr};
   int m_SaveRunNodeFlag{1};
   int m_SaveDstNodeFlag{1};
@@ -51,6 +73,17 @@ class Fun4AllDstOutputManager : public Fun4AllOutputManager
   std::set<std::string> m_StripCompositeNodes;
   std::set<std::string> stripnodes;
   std::set<std::string> striprunnodes;
+
+  // asynchronous writing
+  bool m_AsyncWrite{false};
+  bool m_WriterStop{false};
+  std::set<std::string> m_StreamerCopyClasses;
+  // class of the last object written to each branch, to write empty objects for nodes without data
+  std::map<std::string, std::string> m_SnapshotClasses;
+  std::deque<std::pair<PHNodeIOManager *, PHCompositeNode *>> m_WriteQueue;
+  std::mutex m_WriterMutex;
+  std::condition_variable m_WriterCondition;
+  std::thread m_WriterThread;
 };
 
 #endif
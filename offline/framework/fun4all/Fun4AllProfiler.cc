@@ -0,0 +1,258 @@
+#include "Fun4AllProfiler.h"
+
+#include <phool/phool.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <type_traits>
+
+namespace
+{
+  // flush records to file once this many are buffered
+  const size_t max_buffered_records = 4096;
+
+  const uint32_t binary_version = 1;
+  const uint32_t tag_slot = 1;
+  const uint32_t tag_record = 2;
+
+  static_assert(std::is_trivially_copyable_v<Fun4AllProfiler::Record>);
+
+  // escape quotes and backslashes for json strings
+  std::string json_escape(const std::string &name)
+  {
+    std::string out;
+    out.reserve(name.size());
+    for (const char c : name)
+    {
+      if (c == '"' || c == '\\')
+      {
+        out += '\\';
+      }
+      out += c;
+    }
+    return out;
+  }
+
+  template <class T>
+  void write_binary(std::ofstream &out, const T &value)
+  {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+}  // namespace
+
+Fun4AllProfiler::Fun4AllProfiler(const std::string &filename, const Format format, const unsigned int sampling)
+  : Fun4AllBase("Fun4AllProfiler")
+  , m_Format(format)
+  , m_Sampling(std::max(sampling, 1U))
+  , m_Origin(std::chrono::steady_clock::now())
+{
+  m_OutFile.open(filename, m_Format == BINARY ? std::ios::out | std::ios::trunc | std::ios::binary : std::ios::out | std::ios::trunc);
+  if (!m_OutFile.is_open())
+  {
+    std::cout << PHWHERE << " could not open profiler output file " << filename << std::endl;
+    exit(1);
+  }
+  if (m_Format == BINARY)
+  {
+    m_OutFile.write("F4AP", 4);
+    write_binary(m_OutFile, binary_version);
+  }
+  else
+  {
+    m_OutFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  }
+
+  m_StatmFd = open("/proc/self/statm", O_RDONLY);
+  const long pagesize = sysconf(_SC_PAGESIZE);
+  if (pagesize > 0)
+  {
+    m_PageSizeKb = pagesize / 1024;
+  }
+
+  // slot 0 is for the event span
+  AddSlot("process_event");
+  m_Records.reserve(max_buffered_records);
+}
+
+Fun4AllProfiler::~Fun4AllProfiler()
+{
+  Close();
+  if (m_StatmFd >= 0)
+  {
+    close(m_StatmFd);
+  }
+}
+
+Fun4AllProfiler::Format Fun4AllProfiler::FormatFromFileName(const std::string &filename)
+{
+  const std::string extension = ".json";
+  if (filename.size() >= extension.size() && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0)
+  {
+    return JSON;
+  }
+  return BINARY;
+}
+
+unsigned int Fun4AllProfiler::AddSlot(const std::string &name)
+{
+  auto iter = std::find(m_SlotNames.begin(), m_SlotNames.end(), name);
+  if (iter != m_SlotNames.end())
+  {
+    return iter - m_SlotNames.begin();
+  }
+  m_SlotNames.push_back(name);
+  const unsigned int slot = m_SlotNames.size() - 1;
+  WriteSlot(slot);
+  return slot;
+}
+
+void Fun4AllProfiler::BeginEvent(const int event)
+{
+  FinishEvent();
+  m_InEvent = true;
+  m_Event = event;
+  m_LastRetCode = 0;
+  Snapshot(m_EventStart);
+  m_LastStop = m_EventStart;
+}
+
+void Fun4AllProfiler::FinishEvent()
+{
+  // the event span ends with the last module called
+  if (m_InEvent)
+  {
+    AddRecord(0, m_EventStart, m_LastStop, m_LastRetCode);
+    m_InEvent = false;
+  }
+}
+
+void Fun4AllProfiler::StopModule(const unsigned int slot, const int retcode)
+{
+  Snapshot(m_LastStop);
+  m_LastRetCode = retcode;
+  AddRecord(slot, m_ModuleStart, m_LastStop, retcode);
+}
+
+void Fun4AllProfiler::Snapshot(Sample &sample) const
+{
+  sample.wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Origin).count();
+  timespec ts{};
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  sample.cpu_ns = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+  sample.rss_kb = GetRSS();
+}
+
+int64_t Fun4AllProfiler::GetRSS() const
+{
+  // second field of /proc/self/statm is the resident set size in pages
+  if (m_StatmFd < 0)
+  {
+    return 0;
+  }
+  char buffer[128];
+  const ssize_t size = pread(m_StatmFd, buffer, sizeof(buffer) - 1, 0);
+  if (size <= 0)
+  {
+    return 0;
+  }
+  buffer[size] = 0;
+  char *end = nullptr;
+  std::strtoll(buffer, &end, 10);
+  return std::strtoll(end, nullptr, 10) * m_PageSizeKb;
+}
+
+void Fun4AllProfiler::AddRecord(const unsigned int slot, const Sample &start, const Sample &stop, const int retcode)
+{
+  Record record{};
+  record.event = m_Event;
+  record.slot = slot;
+  record.start_ns = start.wall_ns;
+  record.wall_ns = stop.wall_ns - start.wall_ns;
+  record.cpu_ns = stop.cpu_ns - start.cpu_ns;
+  record.rss_delta_kb = stop.rss_kb - start.rss_kb;
+  record.retcode = retcode;
+  m_Records.push_back(record);
+  if (m_Records.size() >= max_buffered_records)
+  {
+    Flush();
+  }
+}
+
+void Fun4AllProfiler::WriteSlot(const unsigned int slot)
+{
+  // json records carry the module name, only the binary format needs slot definitions
+  if (m_Format != BINARY || !m_OutFile.is_open())
+  {
+    return;
+  }
+  const std::string &name = m_SlotNames[slot];
+  write_binary(m_OutFile, tag_slot);
+  write_binary(m_OutFile, static_cast<uint32_t>(slot));
+  write_binary(m_OutFile, static_cast<uint32_t>(name.size()));
+  m_OutFile.write(name.data(), name.size());
+}
+
+void Fun4AllProfiler::Flush()
+{
+  if (!m_OutFile.is_open())
+  {
+    m_Records.clear();
+    return;
+  }
+  if (m_Format == BINARY)
+  {
+    for (const auto &record : m_Records)
+    {
+      write_binary(m_OutFile, tag_record);
+      write_binary(m_OutFile, record);
+    }
+  }
+  else
+  {
+    m_OutFile << std::fixed << std::setprecision(3);
+    for (const auto &record : m_Records)
+    {
+      if (!m_FirstJsonRecord)
+      {
+        m_OutFile << ",";
+      }
+      m_FirstJsonRecord = false;
+      m_OutFile << "\n{\"name\":\"" << json_escape(m_SlotNames[record.slot]) << "\""
+                << ",\"cat\":\"" << (record.slot ? "module" : "event") << "\""
+                << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << (record.slot ? 2 : 1)
+                << ",\"ts\":" << record.start_ns * 1e-3
+                << ",\"dur\":" << record.wall_ns * 1e-3
+                << ",\"args\":{\"event\":" << record.event
+                << ",\"cpu_ms\":" << record.cpu_ns * 1e-6
+                << ",\"rss_delta_kb\":" << record.rss_delta_kb
+                << ",\"retcode\":" << record.retcode << "}}";
+    }
+  }
+  m_Records.clear();
+}
+
+void Fun4AllProfiler::Close()
+{
+  if (!m_OutFile.is_open())
+  {
+    return;
+  }
+  FinishEvent();
+  Flush();
+  if (m_Format == JSON)
+  {
+    m_OutFile << "\n]}" << std::endl;
+  }
+  m_OutFile.close();
+  if (Verbosity() > 0)
+  {
+    std::cout << "Fun4AllProfiler::Close - profiled " << (m_EventCounter + m_Sampling - 1) / m_Sampling
+              << " out of " << m_EventCounter << " events" << std::endl;
+  }
+}
@@ -0,0 +1,117 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef FUN4ALL_FUN4ALLPROFILER_H
+#define FUN4ALL_FUN4ALLPROFILER_H
+
+#include "Fun4AllBase.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Per event, per module profiler used by the Fun4AllServer
+// for each sampled event it records, for every module: wall time, cpu time,
+// resident memory change and return code, plus one span for the whole event.
+// Modules get a slot number at registration, so no string is built or looked up per event.
+// Records are buffered and streamed to the output file in one of two formats:
+//  - JSON: chrome trace format (https://ui.perfetto.dev or chrome://tracing),
+//    one complete event ("ph":"X") per module and per event, details in "args"
+//  - BINARY: "F4AP" magic and uint32_t version, followed by tagged entries, each starting with a uint32_t tag
+//    tag 1: slot definition - uint32_t slot, uint32_t name length, name characters
+//    tag 2: Fun4AllProfiler::Record
+// The event span uses slot 0 ("process_event") and the return code of the last module run.
+// Only one event every "sampling" events is recorded, other events cost a single counter check.
+class Fun4AllProfiler : public Fun4AllBase
+{
+ public:
+  enum Format
+  {
+    JSON = 0,
+    BINARY = 1
+  };
+
+  struct Record
+  {
+    int32_t event;
+    uint32_t slot;
+    uint64_t start_ns;      // wall clock since profiler creation
+    uint64_t wall_ns;
+    uint64_t cpu_ns;        // process cpu time, includes worker threads
+    int64_t rss_delta_kb;
+    int32_t retcode;
+    int32_t padding;
+  };
+
+  Fun4AllProfiler(const std::string &filename, const Format format = JSON, const unsigned int sampling = 1);
+  ~Fun4AllProfiler() override;
+
+  //! format from file extension, JSON for .json, BINARY otherwise
+  static Format FormatFromFileName(const std::string &filename);
+
+  //! get slot for a module, reuses existing slot with same name
+  unsigned int AddSlot(const std::string &name);
+
+  //! start new event, returns true if it is sampled
+  bool StartEvent(const int event)
+  {
+    if (m_EventCounter++ % m_Sampling)
+    {
+      return false;
+    }
+    BeginEvent(event);
+    return true;
+  }
+
+  //! called right before SubsysReco::process_event, for sampled events only
+  void StartModule() { Snapshot(m_ModuleStart); }
+
+  //! called right after SubsysReco::process_event, for sampled events only
+  void StopModule(const unsigned int slot, const int retcode);
+
+  //! write remaining records and close output file
+  void Close();
+
+ private:
+  struct Sample
+  {
+    uint64_t wall_ns = 0;
+    uint64_t cpu_ns = 0;
+    int64_t rss_kb = 0;
+  };
+
+  void BeginEvent(const int event);
+  void FinishEvent();
+  void Snapshot(Sample &sample) const;
+  int64_t GetRSS() const;
+  void AddRecord(const unsigned int slot, const Sample &start, const Sample &stop, const int retcode);
+  void WriteSlot(const unsigned int slot);
+  void Flush();
+
+  Format m_Format{JSON};
+  unsigned int m_Sampling{1};
+  uint64_t m_EventCounter{0};
+
+  std::ofstream m_OutFile;
+  bool m_FirstJsonRecord{true};
+
+  // /proc/self/statm, kept open since reading it is cheap but opening it is not
+  int m_StatmFd{-1};
+  int64_t m_PageSizeKb{4};
+
+  std::chrono::steady_clock::time_point m_Origin;
+
+  std::vector<std::string> m_SlotNames;
+  std::vector<Record> m_Records;
+
+  // current event
+  bool m_InEvent{false};
+  int m_Event{0};
+  int m_LastRetCode{0};
+  Sample m_EventStart;
+  Sample m_LastStop;
+  Sample m_ModuleStart;
+};
+
+#endif
@@ -7,6 +7,7 @@
 #include "Fun4AllMemoryTracker.h"
 #include "Fun4AllMonitoring.h"
 #include "Fun4AllOutputManager.h"
+#include "Fun4AllProfiler.h"
 #include "Fun4AllReturnCodes.h"
 #include "Fun4AllSyncManager.h"
 #include "SubsysReco.h"
@@ -66,6 +67,7 @@ Fun4AllServer::~Fun4AllServer()
 {
   Reset();
   delete beginruntimestamp;
+  delete m_Profiler;
   while (Subsystems.begin() != Subsystems.end())
   {
     if (Verbosity() >= VERBOSITY_MORE)
@@ -266,13 +268,16 @@ int Fun4AllServer::registerSubsystem(SubsysReco *subsystem, const std::string &t
     std::cout << "Registering Subsystem " << subsystem->Name() << std::endl;
   }
   Subsystems.push_back(newsubsyspair);
-  std::string timer_name;
-  timer_name = subsystem->Name() + "_" + topnodename;
-  PHTimer timer(timer_name);
-  if (!timer_map.contains(timer_name))
+  SubsystemInfo info;
+  info.timer_name = subsystem->Name() + "_" + topnodename;
+  info.dirname = subsystopNode->getName() + "/" + subsystem->Name();
+  // map nodes are stable, the timer pointer stays valid
+  info.timer = &timer_map.try_emplace(info.timer_name, info.timer_name).first->second;
+  if (m_Profiler)
   {
-    timer_map.insert(make_pair(timer_name, timer));
+    info.profiler_slot = m_Profiler->AddSlot(info.timer_name);
   }
+  SubsystemInfos.push_back(info);
   RetCodes.push_back(iret);  // vector with return codes
   return 0;
 }
@@ -321,6 +326,7 @@ int Fun4AllServer::unregisterSubsystemsNow()
     delete (*removeiter).first;
     // also update the vector with return codes
     RetCodes.erase(RetCodes.begin() + index);
+    SubsystemInfos.erase(SubsystemInfos.begin() + index);
     std::vector<Fun4AllOutputManager *>::iterator outiter;
     for (outiter = OutputManager.begin(); outiter != OutputManager.end(); ++outiter)
     {
@@ -532,13 +538,15 @@ int Fun4AllServer::process_event()
   }
   gROOT->cd(default_Tdirectory.c_str());
   std::string currdir = gDirectory->GetPath();
+  const bool profile_event = m_Profiler && m_Profiler->StartEvent(eventnumber);
   for (auto &Subsystem : Subsystems)
   {
     if (Verbosity() >= VERBOSITY_MORE)
     {
       std::cout << "Fun4AllServer::process_event processing " << Subsystem.first->Name() << std::endl;
     }
-    std::string newdirname = Subsystem.second->getName() + "/" + Subsystem.first->Name();
+    const SubsystemInfo &info = SubsystemInfos[icnt];
+    const std::string &newdirname = info.dirname;
     if (!gROOT->cd(newdirname.c_str()))
     {
       std::cout << PHWHERE << "Unexpected TDirectory Problem cd'ing to "
@@ -559,24 +567,20 @@ int Fun4AllServer::process_event()
 
     try
     {
-      std::string timer_name;
-      timer_name = Subsystem.first->Name() + "_" + Subsystem.second->getName();
-      std::map<const std::string, PHTimer>::iterator titer = timer_map.find(timer_name);
-      bool timer_found = false;
-      if (titer != timer_map.end())
-      {
-        timer_found = true;
-        titer->second.restart();
-      }
-      else
-      {
-        std::cout << "could not find timer for " << timer_name << std::endl;
-      }
+      info.timer->restart();
 #ifdef FFAMEMTRACKER
-      ffamemtracker->Start(timer_name, "SubsysReco");
+      ffamemtracker->Start(info.timer_name, "SubsysReco");
       ffamemtracker->Snapshot("Fun4AllServerProcessEvent");
 #endif
+      if (profile_event)
+      {
+        m_Profiler->StartModule();
+      }
       int retcode = Subsystem.first->process_event(Subsystem.second);
+      if (profile_event)
+      {
+        m_Profiler->StopModule(info.profiler_slot, retcode);
+      }
       std::cout.copyfmt(m_saved_cout_state); // restore cout to default formatting
 #ifdef FFAMEMTRACKER
       ffamemtracker->Snapshot("Fun4AllServerProcessEvent");
@@ -596,12 +600,9 @@ int Fun4AllServer::process_event()
         std::cout << "error: " << e.what() << std::endl;
         gSystem->Exit(1);
       }
-      if (timer_found)
-      {
-        titer->second.stop();
-      }
+      info.timer->stop();
 #ifdef FFAMEMTRACKER
-      ffamemtracker->Stop(timer_name, "SubsysReco");
+      ffamemtracker->Stop(info.timer_name, "SubsysReco");
 #endif
     }
     catch (const std::exception &e)
@@ -1179,6 +1180,10 @@ int Fun4AllServer::End()
   // close output files (check for existing output managers is
   // done inside outfileclose())
   outfileclose();
+  if (m_Profiler)
+  {
+    m_Profiler->Close();
+  }
   for (auto &histit : HistoManager)
   {
     if (histit->ApplyFileRule())
@@ -1783,6 +1788,18 @@ void Fun4AllServer::NodeIdentify(const std::string &name)
   return;
 }
 
+void Fun4AllServer::EnableProfiler(const std::string &filename, const unsigned int sampling)
+{
+  delete m_Profiler;
+  m_Profiler = new Fun4AllProfiler(filename, Fun4AllProfiler::FormatFromFileName(filename), sampling);
+  m_Profiler->Verbosity(Verbosity());
+  // modules which are already registered
+  for (auto &info : SubsystemInfos)
+  {
+    info.profiler_slot = m_Profiler->AddSlot(info.timer_name);
+  }
+}
+
 void Fun4AllServer::PrintTimer(const std::string &name)
 {
   std::map<const std::string, PHTimer>::const_iterator iter;
@@ -20,6 +20,7 @@ class Fun4AllInputManager;
 class Fun4AllMemoryTracker;
 class Fun4AllSyncManager;
 class Fun4AllOutputManager;
+class Fun4AllProfiler;
 class PHCompositeNode;
 class PHTimeStamp;
 class SubsysReco;
@@ -111,6 +112,12 @@ class Fun4AllServer : public Fun4AllBase
   void NodeIdentify(const std::string &name);
   void KeepDBConnection(const int i = 1) { keep_db_connected = i; }
   void PrintTimer(const std::string &name = "");
+  //! record per event, per module wall time, cpu time, memory and return code to filename
+  /**
+   * file is written in chrome trace json format if filename ends with .json, in compact binary format otherwise
+   * (see Fun4AllProfiler.h). Only one event out of every "sampling" events is recorded
+   */
+  void EnableProfiler(const std::string &filename, const unsigned int sampling = 1);
   static void PrintMemoryTracker(const std::string &name = "");
   int RunNumber() const { return runnumber; }
   int EventCounter() const { return eventcounter; }
@@ -127,6 +134,14 @@ class Fun4AllServer : public Fun4AllBase
   int UpdateEventSelector(Fun4AllOutputManager *manager);
   int unregisterSubsystemsNow();
   int setRun(const int runno);
+  //! per module bookkeeping, computed at registration rather than every event. Same order as Subsystems
+  struct SubsystemInfo
+  {
+    std::string timer_name;
+    std::string dirname;
+    PHTimer *timer{nullptr};
+    unsigned int profiler_slot{0};
+  };
   static Fun4AllServer *__instance;
   TH1 *FrameWorkVars{nullptr};
   Fun4AllMemoryTracker *ffamemtracker{nullptr};
@@ -134,6 +149,7 @@ class Fun4AllServer : public Fun4AllBase
   PHTimeStamp *beginruntimestamp{nullptr};
   PHCompositeNode *TopNode{nullptr};
   Fun4AllSyncManager *defaultSyncManager{nullptr};
+  Fun4AllProfiler *m_Profiler{nullptr};
 
   int OutNodeCount{0};
   int bortime_override{0};
@@ -151,6 +167,7 @@ class Fun4AllServer : public Fun4AllBase
   std::vector<std::pair<SubsysReco *, PHCompositeNode *>> DeleteSubsystems;
   std::deque<std::pair<SubsysReco *, std::string>> NewSubsystems;
   std::vector<int> RetCodes;
+  std::vector<SubsystemInfo> SubsystemInfos;
   std::vector<Fun4AllOutputManager *> OutputManager;
   std::vector<TDirectory *> TDirCollection;
   std::vector<Fun4AllHistoManager *> HistoManager;
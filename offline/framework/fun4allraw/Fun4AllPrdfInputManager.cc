@@ -81,6 +81,22 @@ int Fun4AllPrdfInputManager::fileopen(const std::string &filenam)
   }
   std::pair<int, int> runseg = Fun4AllUtils::GetRunSegment(fname);
   m_Segment = runseg.second;
+  m_FilePosition = 0;
+  m_IndexLoaded = false;
+  m_BuildIndex = false;
+  m_Index.clear();
+  if (m_UseIndex)
+  {
+    m_IndexFileName = PrdfEventIndex::IndexFileName(fname, m_IndexDirectory);
+    m_IndexLoaded = m_Index.Read(m_IndexFileName, fname);
+    // index files are only written to an explicitly given directory, never next to the raw data.
+    // The new index is tied to the current size and modification time of the file, without them it is not built
+    m_BuildIndex = !m_IndexLoaded && !m_IndexDirectory.empty() && m_Index.SetFile(fname);
+    if (Verbosity() > 0)
+    {
+      std::cout << Name() << ": " << (m_IndexLoaded ? "using event index " : (m_BuildIndex ? "building event index " : "no event index ")) << m_IndexFileName << std::endl;
+    }
+  }
   IsOpen(1);
   AddToFileOpened(fname);  // add file to the list of files which were opened
   return 0;
@@ -89,6 +105,10 @@ int Fun4AllPrdfInputManager::fileopen(const std::string &filenam)
 int Fun4AllPrdfInputManager::run(const int /*nevents*/)
 {
 readagain:
+  if (m_RangeDone)
+  {
+    return -1;
+  }
   if (!IsOpen())
   {
     if (FileListEmpty())
@@ -123,7 +143,7 @@ readagain:
   }
   else
   {
-    m_Event = m_EventIterator->getNextEvent();
+    m_Event = NextEvent();
   }
   if (!m_Event || m_Event->getEvtType() == ENDRUNEVENT)
   {
@@ -132,6 +152,40 @@ readagain:
     // NOLINTNEXTLINE(hicpp-avoid-goto)
     goto readagain;
   }
+  if (m_Event->getEvtType() == DATAEVENT)
+  {
+    if (m_LastEvent >= 0 && m_Event->getEvtSequence() > m_LastEvent)
+    {
+      // past the requested event range, this input is done
+      PrdfNode->setData(nullptr);
+      delete m_Event;
+      m_Event = nullptr;
+      m_RangeDone = true;
+      return -1;
+    }
+    if (m_FirstEvent >= 0 && m_Event->getEvtSequence() < m_FirstEvent)
+    {
+      delete m_Event;
+      m_Event = nullptr;
+      // with an index, go straight to the first event of the range,
+      // or to the next file if this one does not reach it
+      if (m_IndexLoaded)
+      {
+        const long position = m_Index.FindFirst(m_FirstEvent, m_FilePosition);
+        if (position < 0)
+        {
+          PrdfNode->setData(nullptr);
+          fileclose();
+        }
+        else
+        {
+          DiscardEvents(position - m_FilePosition);
+        }
+      }
+      // NOLINTNEXTLINE(hicpp-avoid-goto)
+      goto readagain;
+    }
+  }
   PrdfNode->setData(m_Event);
   if (Verbosity() > 1)
   {
@@ -219,29 +273,89 @@ int Fun4AllPrdfInputManager::PushBackEvents(const int i)
   // pushing a negative number of events on the stack, so in order to implement
   // the skipping of events we read -i events.
   int nevents = -i;  // negative number of events to push back -> skip num events
-  int errorflag = 0;
-  while (nevents > 0 && !errorflag)
+
+  // files whose index shows they only hold events to skip are closed without reading them
+  while (m_IndexLoaded && nevents > 0 && m_Index.CountEvents(m_FilePosition) <= static_cast<size_t>(nevents))
   {
-    m_Event = m_EventIterator->getNextEvent();
-    if (!m_Event)
+    nevents -= m_Index.CountEvents(m_FilePosition);
+    if (Verbosity() > 1)
+    {
+      std::cout << Name() << ": skipping the rest of " << FileName() << " using its event index" << std::endl;
+    }
+    fileclose();
+    if (nevents == 0)
+    {
+      return 0;
+    }
+    if (FileListEmpty() || OpenNextFile() == InputFileHandlerReturnCodes::FAILURE)
     {
-      std::cout << "Error after skipping " << i - nevents
+      std::cout << "Error after skipping " << -i - nevents
                 << " file exhausted?" << std::endl;
-      errorflag = -1;
-      fileclose();
+      return -1;
+    }
+  }
+
+  // no index, or the remaining events to skip are in this file: read them
+  const int ndiscarded = DiscardEvents(nevents);
+  if (ndiscarded < nevents)
+  {
+    std::cout << "Error after skipping " << -i - nevents + ndiscarded
+              << " file exhausted?" << std::endl;
+    fileclose();
+    return -1;
+  }
+  return 0;
+}
+
+Event *Fun4AllPrdfInputManager::NextEvent()
+{
+  Event *evt = m_EventIterator->getNextEvent();
+  if (evt)
+  {
+    ++m_FilePosition;
+  }
+  if (m_BuildIndex)
+  {
+    if (evt)
+    {
+      m_Index.add(evt->getEvtSequence(), evt->getEvtType());
     }
-    else
+    // file was read up to its end, the index is complete
+    if (!evt || evt->getEvtType() == ENDRUNEVENT)
     {
-      if (Verbosity() > 3)
+      m_BuildIndex = false;
+      m_IndexLoaded = m_Index.Write(m_IndexFileName);
+      if (!m_IndexLoaded)
+      {
+        std::cout << PHWHERE << Name() << " could not write event index " << m_IndexFileName << std::endl;
+      }
+      else if (Verbosity() > 0)
       {
-        std::cout << "Skipping evt no: " << m_Event->getEvtSequence() << std::endl;
+        std::cout << Name() << ": wrote event index " << m_IndexFileName << " with " << m_Index.size() << " events" << std::endl;
       }
     }
-    delete m_Event;
-    m_Event = nullptr;
-    nevents--;
   }
-  return errorflag;
+  return evt;
+}
+
+int Fun4AllPrdfInputManager::DiscardEvents(const int nevents)
+{
+  int ndiscarded = 0;
+  while (ndiscarded < nevents)
+  {
+    Event *evt = NextEvent();
+    if (!evt)
+    {
+      break;
+    }
+    if (Verbosity() > 3)
+    {
+      std::cout << "Skipping evt no: " << evt->getEvtSequence() << std::endl;
+    }
+    delete evt;
+    ++ndiscarded;
+  }
+  return ndiscarded;
 }
 
 int Fun4AllPrdfInputManager::GetSyncObject(SyncObject **mastersync)
@@ -3,6 +3,8 @@
 #ifndef FUN4ALLRAW_FUN4ALLPRDFINPUTMANAGER_H
 #define FUN4ALLRAW_FUN4ALLPRDFINPUTMANAGER_H
 
+#include "PrdfEventIndex.h"
+
 #include <fun4all/Fun4AllInputManager.h>
 
 #include <string>
@@ -31,7 +33,32 @@ class Fun4AllPrdfInputManager : public Fun4AllInputManager
   int HasSyncObject() const override { return 1; }
   std::string GetString(const std::string &what) const override;
 
+  //! use the event index of the input files (see PrdfEventIndex::Build).
+  //! Without directory, existing index files next to the input files are used, and missing ones are not written.
+  //! With directory, index files are read from it, and written to it after the first full read of a file
+  void UseEventIndex(const std::string &directory = "")
+  {
+    m_UseIndex = true;
+    m_IndexDirectory = directory;
+  }
+
+  //! only process data events with sequence numbers in [first, last], negative means no limit.
+  //! Events of a file before the range are still read and discarded (PRDF files cannot be entered at an event),
+  //! the index only lets files which end before the range be closed without reading them.
+  //! Splitting one file in event ranges over several jobs therefore does not speed up reading yet
+  void SetEventRange(const int first, const int last)
+  {
+    m_FirstEvent = first;
+    m_LastEvent = last;
+  }
+
  private:
+  //! next event of the current file, adds it to the event index if it is being built
+  Event *NextEvent();
+
+  //! read and discard events of the current file, returns the number of events actually discarded
+  int DiscardEvents(const int nevents);
+
   int m_Segment = -999;
   int m_EventsTotal = 0;
   int m_EventsThisFile = 0;
@@ -41,6 +68,20 @@ class Fun4AllPrdfInputManager : public Fun4AllInputManager
   Eventiterator *m_EventIterator = nullptr;
   SyncObject *m_SyncObject = nullptr;
   std::string m_PrdfNodeName;
+
+  // event index
+  bool m_UseIndex = false;
+  bool m_IndexLoaded = false;  // index of the current file was read from its index file
+  bool m_BuildIndex = false;   // index of the current file is being built while reading it
+  size_t m_FilePosition = 0;   // number of events read from the current file
+  PrdfEventIndex m_Index;
+  std::string m_IndexDirectory;
+  std::string m_IndexFileName;
+
+  // event range
+  int m_FirstEvent = -1;
+  int m_LastEvent = -1;
+  bool m_RangeDone = false;
 };
 
 #endif /* FUN4ALL_FUN4ALLPRDFINPUTMANAGER_H */
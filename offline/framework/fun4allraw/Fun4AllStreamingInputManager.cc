@@ -31,6 +31,7 @@
 #include <qautils/QAUtil.h>
 
 #include <phool/PHObject.h>  // for PHObject
+#include <phool/PHThreadPool.h>
 #include <phool/getClass.h>
 #include <phool/phool.h>  // for PHWHERE
 #include <boost/format.hpp>
@@ -48,6 +49,8 @@
 #include <sstream>
 #include <utility>   // for pair
 
+thread_local Fun4AllStreamingInputManager::UnpackBuffer *Fun4AllStreamingInputManager::m_CurrentUnpackBuffer = nullptr;
+
 Fun4AllStreamingInputManager::Fun4AllStreamingInputManager(const std::string &name, const std::string &dstnodename, const std::string &topnodename)
   : Fun4AllInputManager(name, dstnodename, topnodename)
   , m_SyncObject(new SyncObjectv1())
@@ -485,6 +488,11 @@ void Fun4AllStreamingInputManager::registerStreamingInput(SingleStreamingInput *
 
 void Fun4AllStreamingInputManager::AddGl1RawHit(uint64_t bclk, Gl1Packet *hit)
 {
+  if (m_CurrentUnpackBuffer)
+  {
+    m_CurrentUnpackBuffer->Gl1RawHits.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding gl1 hit to bclk 0x"
@@ -495,6 +503,11 @@ void Fun4AllStreamingInputManager::AddGl1RawHit(uint64_t bclk, Gl1Packet *hit)
 
 void Fun4AllStreamingInputManager::AddMvtxRawHit(uint64_t bclk, MvtxRawHit *hit)
 {
+  if (m_CurrentUnpackBuffer)
+  {
+    m_CurrentUnpackBuffer->MvtxRawHits.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding mvtx hit to bclk 0x"
@@ -505,6 +518,11 @@ void Fun4AllStreamingInputManager::AddMvtxRawHit(uint64_t bclk, MvtxRawHit *hit)
 
 void Fun4AllStreamingInputManager::AddMvtxFeeIdInfo(uint64_t bclk, uint16_t feeid, uint32_t detField)
 {
+  if (m_CurrentUnpackBuffer)
+  {
+    m_CurrentUnpackBuffer->MvtxFeeIds.push_back({bclk, feeid, detField});
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding mvtx feeid info to bclk 0x"
@@ -519,6 +537,11 @@ void Fun4AllStreamingInputManager::AddMvtxFeeIdInfo(uint64_t bclk, uint16_t feei
 
 void Fun4AllStreamingInputManager::AddMvtxL1TrgBco(uint64_t bclk, uint64_t lv1Bco)
 {
+  if (m_CurrentUnpackBuffer)
+  {
+    m_CurrentUnpackBuffer->MvtxL1TrgBcos.emplace_back(bclk, lv1Bco);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding mvtx L1Trg to bclk 0x"
@@ -529,6 +552,11 @@ void Fun4AllStreamingInputManager::AddMvtxL1TrgBco(uint64_t bclk, uint64_t lv1Bc
 
 void Fun4AllStreamingInputManager::AddInttRawHit(uint64_t bclk, InttRawHit *hit)
 {
+  if (m_CurrentUnpackBuffer)
+  {
+    m_CurrentUnpackBuffer->InttRawHits.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding intt hit to bclk 0x"
@@ -540,6 +568,11 @@ void Fun4AllStreamingInputManager::AddInttRawHit(uint64_t bclk, InttRawHit *hit)
 
 void Fun4AllStreamingInputManager::AddMicromegasRawHit(uint64_t bclk, MicromegasRawHit *hit)
 {
+  if (m_CurrentUnpackBuffer)
+  {
+    m_CurrentUnpackBuffer->MicromegasRawHits.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding micromegas hit to bclk 0x"
@@ -550,6 +583,11 @@ void Fun4AllStreamingInputManager::AddMicromegasRawHit(uint64_t bclk, Micromegas
 
 void Fun4AllStreamingInputManager::AddTpcRawHit(uint64_t bclk, TpcRawHit *hit)
 {
+  if (m_CurrentUnpackBuffer)
+  {
+    m_CurrentUnpackBuffer->TpcRawHits.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding tpc hit to bclk 0x"
@@ -1406,18 +1444,16 @@ int Fun4AllStreamingInputManager::FillInttPool()
   {
     ref_bco_minus_range = m_RefBCO - m_intt_negative_bco;
   }
-  for (auto *iter : m_InttInputVector)
+  if (!m_gl1_registered_flag)
   {
-    if (!m_gl1_registered_flag)
+    for (auto *iter : m_InttInputVector)
     {
       iter->SetStandaloneMode(true);
     }
-    if (Verbosity() > 0)
-    {
-      std::cout << "Fun4AllStreamingInputManager::FillInttPool - fill pool for " << iter->Name() << std::endl;
-    }
-    iter->FillPool(ref_bco_minus_range);
-    // iter->FillPool();
+  }
+  FillPools(m_InttInputVector, ref_bco_minus_range);
+  for (auto *iter : m_InttInputVector)
+  {
     if (m_RunNumber == 0)
     {
       m_RunNumber = iter->RunNumber();
@@ -1453,13 +1489,9 @@ int Fun4AllStreamingInputManager::FillTpcPool()
     ref_bco_minus_range = m_RefBCO - m_tpc_negative_bco;
   }
 
+  FillPools(m_TpcInputVector, ref_bco_minus_range);
   for (auto *iter : m_TpcInputVector)
   {
-    if (Verbosity() > 0)
-    {
-      std::cout << "Fun4AllStreamingInputManager::FillTpcPool - fill pool for " << iter->Name() << std::endl;
-    }
-    iter->FillPool(ref_bco_minus_range);
     const int fill_pool_status = iter->FillPoolStatus();
     if (fill_pool_status < 0)
     {
@@ -1501,13 +1533,9 @@ int Fun4AllStreamingInputManager::FillMicromegasPool()
     ref_bco_minus_range = m_RefBCO - m_micromegas_negative_bco;
   }
 
+  FillPools(m_MicromegasInputVector, ref_bco_minus_range);
   for (auto *iter : m_MicromegasInputVector)
   {
-    if (Verbosity() > 0)
-    {
-      std::cout << "Fun4AllStreamingInputManager::FillMicromegasPool - fill pool for " << iter->Name() << std::endl;
-    }
-    iter->FillPool(ref_bco_minus_range);
     if (m_RunNumber == 0)
     {
       m_RunNumber = iter->RunNumber();
@@ -1538,13 +1566,9 @@ int Fun4AllStreamingInputManager::FillMicromegasPool()
 int Fun4AllStreamingInputManager::FillMvtxPool()
 {
   uint64_t ref_bco_minus_range = m_RefBCO < m_mvtx_negative_bco ? m_mvtx_negative_bco : m_RefBCO - m_mvtx_negative_bco;
+  FillPools(m_MvtxInputVector, ref_bco_minus_range, 3);
   for (auto *iter : m_MvtxInputVector)
   {
-    if (Verbosity() > 3)
-    {
-      std::cout << "Fun4AllStreamingInputManager::FillMvtxPool - fill pool for " << iter->Name() << std::endl;
-    }
-    iter->FillPool(ref_bco_minus_range);
     if (m_RunNumber == 0)
     {
       m_RunNumber = iter->RunNumber();
@@ -1571,6 +1595,110 @@ int Fun4AllStreamingInputManager::FillMvtxPool()
   }
   return 0;
 }
+void Fun4AllStreamingInputManager::EnableParallelUnpacking(bool b, const int nthreads)
+{
+  m_ParallelUnpacking = b;
+  m_UnpackThreads = nthreads;
+  m_UnpackThreadPool.reset();
+}
+
+void Fun4AllStreamingInputManager::FillPools(const std::vector<SingleStreamingInput *> &inputs, const uint64_t ref_bco, const int verbosity_threshold)
+{
+  if (!m_ParallelUnpacking || inputs.size() < 2)
+  {
+    for (auto *iter : inputs)
+    {
+      if (Verbosity() > verbosity_threshold)
+      {
+        std::cout << "Fun4AllStreamingInputManager::FillPools - fill pool for " << iter->Name() << std::endl;
+      }
+      iter->FillPool(ref_bco);
+    }
+    return;
+  }
+
+  // threads are started on first use
+  if (!m_UnpackThreadPool)
+  {
+    m_UnpackThreadPool = std::make_unique<PHThreadPool>(m_UnpackThreads);
+    if (Verbosity() > 0)
+    {
+      std::cout << "Fun4AllStreamingInputManager::FillPools - parallel unpacking with "
+                << m_UnpackThreadPool->size() << " threads" << std::endl;
+    }
+  }
+
+  // each input writes to its own buffer, so no locking is needed
+  if (m_UnpackBuffers.size() < inputs.size())
+  {
+    m_UnpackBuffers.resize(inputs.size());
+  }
+  m_UnpackThreadPool->parallel_for(inputs.size(), [this, &inputs, ref_bco](std::size_t i, unsigned int /*worker*/)
+                                   {
+    m_CurrentUnpackBuffer = &m_UnpackBuffers[i];
+    try
+    {
+      inputs[i]->FillPool(ref_bco);
+    }
+    catch (...)
+    {
+      m_CurrentUnpackBuffer = nullptr;
+      throw;
+    }
+    m_CurrentUnpackBuffer = nullptr; });
+
+  // add hits to the raw hit maps in input order, same as sequential unpacking
+  for (std::size_t i = 0; i < inputs.size(); ++i)
+  {
+    if (Verbosity() > verbosity_threshold)
+    {
+      std::cout << "Fun4AllStreamingInputManager::FillPools - filled pool for " << inputs[i]->Name() << std::endl;
+    }
+    FlushUnpackBuffer(m_UnpackBuffers[i]);
+  }
+}
+
+void Fun4AllStreamingInputManager::FlushUnpackBuffer(UnpackBuffer &buffer)
+{
+  for (const auto &[bclk, hit] : buffer.Gl1RawHits)
+  {
+    AddGl1RawHit(bclk, hit);
+  }
+  for (const auto &[bclk, hit] : buffer.InttRawHits)
+  {
+    AddInttRawHit(bclk, hit);
+  }
+  for (const auto &[bclk, hit] : buffer.MicromegasRawHits)
+  {
+    AddMicromegasRawHit(bclk, hit);
+  }
+  for (const auto &[bclk, hit] : buffer.MvtxRawHits)
+  {
+    AddMvtxRawHit(bclk, hit);
+  }
+  for (const auto &feeid : buffer.MvtxFeeIds)
+  {
+    AddMvtxFeeIdInfo(feeid.bclk, feeid.feeid, feeid.detField);
+  }
+  for (const auto &[bclk, lv1Bco] : buffer.MvtxL1TrgBcos)
+  {
+    AddMvtxL1TrgBco(bclk, lv1Bco);
+  }
+  for (const auto &[bclk, hit] : buffer.TpcRawHits)
+  {
+    AddTpcRawHit(bclk, hit);
+  }
+
+  // clear but keep allocated memory for next call
+  buffer.Gl1RawHits.clear();
+  buffer.InttRawHits.clear();
+  buffer.MicromegasRawHits.clear();
+  buffer.MvtxRawHits.clear();
+  buffer.MvtxFeeIds.clear();
+  buffer.MvtxL1TrgBcos.clear();
+  buffer.TpcRawHits.clear();
+}
+
 void Fun4AllStreamingInputManager::createQAHistos()
 {
   auto *hm = QAHistManagerDef::getHistoManager();
@@ -8,8 +8,10 @@
 #include <fun4all/Fun4AllInputManager.h>
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include <cinttypes>
 
@@ -20,6 +22,7 @@ class MicromegasRawHit;
 class MvtxRawHit;
 class MvtxFeeIdInfo;
 class PHCompositeNode;
+class PHThreadPool;
 class SyncObject;
 class TpcRawHit;
 class TH1;
@@ -71,6 +74,12 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
 
   void runMvtxTriggered(bool b = true) { m_mvtx_is_triggered = b; }
 
+  // decode the inputs of a given subsystem concurrently, one input per task
+  // nthreads < 0 uses the number of hardware threads
+  // hits are buffered per input and added to the raw hit maps in input order,
+  // so that the output is identical to the sequential unpacking
+  void EnableParallelUnpacking(bool b = true, const int nthreads = -1);
+
   // configuration for INTT hit carry-over issue mitigation (hit duplication)
   void EnableInttHitDuplication(bool b = true) { m_InttHitDuplication = b; }
   void SetIsRejectInttNoiseCrossings(bool b = true) {m_IsRejectInttNoiseCrossings = b;}
@@ -115,8 +124,33 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
     unsigned int EventFoundCounter{0};
   };
 
+  //! hits decoded by one input during parallel unpacking
+  struct UnpackBuffer
+  {
+    struct MvtxFeeId
+    {
+      uint64_t bclk{0};
+      uint16_t feeid{0};
+      uint32_t detField{0};
+    };
+
+    std::vector<std::pair<uint64_t, Gl1Packet *>> Gl1RawHits;
+    std::vector<std::pair<uint64_t, InttRawHit *>> InttRawHits;
+    std::vector<std::pair<uint64_t, MicromegasRawHit *>> MicromegasRawHits;
+    std::vector<std::pair<uint64_t, MvtxRawHit *>> MvtxRawHits;
+    std::vector<MvtxFeeId> MvtxFeeIds;
+    std::vector<std::pair<uint64_t, uint64_t>> MvtxL1TrgBcos;
+    std::vector<std::pair<uint64_t, TpcRawHit *>> TpcRawHits;
+  };
+
   void createQAHistos();
 
+  //! run FillPool for all inputs, concurrently if parallel unpacking is enabled. Per input printout above verbosity_threshold
+  void FillPools(const std::vector<SingleStreamingInput *> &inputs, const uint64_t ref_bco, const int verbosity_threshold = 0);
+
+  //! add buffered hits to the raw hit maps
+  void FlushUnpackBuffer(UnpackBuffer &buffer);
+
   SyncObject *m_SyncObject{nullptr};
   PHCompositeNode *m_topNode{nullptr};
 
@@ -152,6 +186,15 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
   std::map<uint64_t, TpcRawHitInfo> m_TpcRawHitMap;
   std::map<int, std::map<int, uint64_t>> m_InttPacketFeeBcoMap;
 
+  // parallel unpacking
+  bool m_ParallelUnpacking{false};
+  int m_UnpackThreads{-1};
+  std::unique_ptr<PHThreadPool> m_UnpackThreadPool;
+  std::vector<UnpackBuffer> m_UnpackBuffers;
+
+  //! buffer receiving the hits of the input being unpacked by the current thread, if any
+  static thread_local UnpackBuffer *m_CurrentUnpackBuffer;
+
   // QA histos
   TH1 *h_refbco_mvtx[12]{nullptr};
   TH1 *h_taggedAllFelixes_mvtx{nullptr};
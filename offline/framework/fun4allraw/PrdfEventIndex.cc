@@ -0,0 +1,192 @@
+#include "PrdfEventIndex.h"
+
+#include <phool/phool.h>  // for PHWHERE
+
+#include <Event/Event.h>
+#include <Event/EventTypes.h>
+#include <Event/Eventiterator.h>
+#include <Event/fileEventiterator.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+  const char index_magic[4] = {'P', 'E', 'V', 'I'};
+  const uint32_t index_version = 2;
+
+  bool file_stat(const std::string &filename, uint64_t &size, int64_t &mtime)
+  {
+    struct stat buf
+    {
+    };
+    if (stat(filename.c_str(), &buf))
+    {
+      return false;
+    }
+    size = buf.st_size;
+    mtime = buf.st_mtime;
+    return true;
+  }
+
+  template <class T>
+  void write_binary(std::ofstream &out, const T &value)
+  {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <class T>
+  bool read_binary(std::ifstream &in, T &value)
+  {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+  }
+}  // namespace
+
+long PrdfEventIndex::FindFirst(const int sequence, const size_t from) const
+{
+  for (size_t position = from; position < m_Entries.size(); ++position)
+  {
+    if (m_Entries[position].type == DATAEVENT && m_Entries[position].sequence >= sequence)
+    {
+      return position;
+    }
+  }
+  return -1;
+}
+
+size_t PrdfEventIndex::CountEvents(const size_t from) const
+{
+  size_t nevents = 0;
+  for (size_t position = from; position < m_Entries.size(); ++position)
+  {
+    if (m_Entries[position].type != ENDRUNEVENT)
+    {
+      ++nevents;
+    }
+  }
+  return nevents;
+}
+
+bool PrdfEventIndex::SetFile(const std::string &prdffile)
+{
+  return file_stat(prdffile, m_FileSize, m_FileTime);
+}
+
+bool PrdfEventIndex::Read(const std::string &indexfile, const std::string &prdffile)
+{
+  m_Entries.clear();
+  std::ifstream in(indexfile, std::ios::binary);
+  if (!in.is_open())
+  {
+    return false;
+  }
+  char magic[4];
+  uint32_t version = 0;
+  uint64_t filesize = 0;
+  int64_t filetime = 0;
+  uint64_t nevents = 0;
+  if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), index_magic) ||
+      !read_binary(in, version) || version != index_version ||
+      !read_binary(in, filesize) || !read_binary(in, filetime) || !read_binary(in, nevents))
+  {
+    std::cout << PHWHERE << " invalid event index " << indexfile << ", ignoring it" << std::endl;
+    return false;
+  }
+  if (!SetFile(prdffile) || filesize != m_FileSize || filetime != m_FileTime)
+  {
+    std::cout << PHWHERE << " event index " << indexfile << " does not match " << prdffile << ", ignoring it" << std::endl;
+    return false;
+  }
+  m_Entries.reserve(nevents);
+  for (uint64_t i = 0; i < nevents; ++i)
+  {
+    int32_t sequence = 0;
+    int32_t type = 0;
+    if (!read_binary(in, sequence) || !read_binary(in, type))
+    {
+      std::cout << PHWHERE << " truncated event index " << indexfile << ", ignoring it" << std::endl;
+      m_Entries.clear();
+      return false;
+    }
+    m_Entries.push_back({sequence, type});
+  }
+  return true;
+}
+
+bool PrdfEventIndex::Write(const std::string &indexfile) const
+{
+  // written to a temporary file first, so that concurrent jobs never read a partial index
+  const std::string tmpfile = indexfile + ".tmp" + std::to_string(getpid());
+  std::ofstream out(tmpfile, std::ios::binary | std::ios::trunc);
+  if (!out.is_open())
+  {
+    return false;
+  }
+  out.write(index_magic, sizeof(index_magic));
+  write_binary(out, index_version);
+  write_binary(out, m_FileSize);
+  write_binary(out, m_FileTime);
+  write_binary(out, static_cast<uint64_t>(m_Entries.size()));
+  for (const auto &entry : m_Entries)
+  {
+    write_binary(out, static_cast<int32_t>(entry.sequence));
+    write_binary(out, static_cast<int32_t>(entry.type));
+  }
+  out.close();
+  if (!out || std::rename(tmpfile.c_str(), indexfile.c_str()))
+  {
+    std::remove(tmpfile.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::string PrdfEventIndex::IndexFileName(const std::string &prdffile, const std::string &directory)
+{
+  if (directory.empty())
+  {
+    return prdffile + ".evtidx";
+  }
+  const size_t slash = prdffile.find_last_of('/');
+  const std::string basename = (slash == std::string::npos) ? prdffile : prdffile.substr(slash + 1);
+  return directory + "/" + basename + ".evtidx";
+}
+
+long PrdfEventIndex::Build(const std::string &prdffile, const std::string &directory)
+{
+  int status = 0;
+  Eventiterator *eventiterator = new fileEventiterator(prdffile.c_str(), status);
+  if (status)
+  {
+    delete eventiterator;
+    std::cout << PHWHERE << " could not open file " << prdffile << std::endl;
+    return -1;
+  }
+  PrdfEventIndex index;
+  if (!index.SetFile(prdffile))
+  {
+    delete eventiterator;
+    std::cout << PHWHERE << " could not stat file " << prdffile << std::endl;
+    return -1;
+  }
+  while (Event *evt = eventiterator->getNextEvent())
+  {
+    index.add(evt->getEvtSequence(), evt->getEvtType());
+    delete evt;
+  }
+  delete eventiterator;
+
+  const std::string indexfile = IndexFileName(prdffile, directory);
+  if (!index.Write(indexfile))
+  {
+    std::cout << PHWHERE << " could not write event index " << indexfile << std::endl;
+    return -1;
+  }
+  return index.size();
+}
@@ -0,0 +1,62 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef FUN4ALLRAW_PRDFEVENTINDEX_H
+#define FUN4ALLRAW_PRDFEVENTINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Sidecar index of a PRDF file: event sequence number and event type of all events, in file order.
+// It is written by PrdfEventIndex::Build, next to the PRDF file or in a given directory, as <file>.evtidx,
+// or by the Fun4AllPrdfInputManager the first time a file is read to the end, if it was given an index directory.
+// Events are indexed by their position in the file, not by byte offset, since the Eventiterator cannot seek
+// Binary format: "PEVI" magic, uint32_t version, uint64_t PRDF file size, int64_t PRDF file modification time,
+// uint64_t number of events, followed by one (int32_t sequence, int32_t type) pair per event.
+// An index whose PRDF size or modification time does not match the PRDF file is ignored (and rebuilt, see above)
+class PrdfEventIndex
+{
+ public:
+  struct Entry
+  {
+    int sequence{0};
+    int type{0};
+  };
+
+  PrdfEventIndex() = default;
+
+  void clear() { m_Entries.clear(); }
+
+  //! record size and modification time of the indexed PRDF file, written to the index header. False if the file cannot be accessed
+  bool SetFile(const std::string &prdffile);
+  void add(const int sequence, const int type) { m_Entries.push_back({sequence, type}); }
+  size_t size() const { return m_Entries.size(); }
+  bool empty() const { return m_Entries.empty(); }
+  const Entry &at(const size_t position) const { return m_Entries.at(position); }
+
+  //! position of the first data event at or after "from" with sequence number >= sequence, -1 if there is none
+  long FindFirst(const int sequence, const size_t from = 0) const;
+
+  //! number of events at or after "from", end run events excluded
+  size_t CountEvents(const size_t from = 0) const;
+
+  //! read index from file, false if missing, corrupted or not matching size and modification time of prdffile
+  bool Read(const std::string &indexfile, const std::string &prdffile);
+
+  //! write index to file
+  bool Write(const std::string &indexfile) const;
+
+  //! index file name for a PRDF file, placed in directory if given, next to the PRDF file otherwise
+  static std::string IndexFileName(const std::string &prdffile, const std::string &directory = "");
+
+  //! standalone index building: read all events of a PRDF file and write its index, returns the number of events, -1 on error
+  static long Build(const std::string &prdffile, const std::string &directory = "");
+
+ private:
+  uint64_t m_FileSize{0};
+  int64_t m_FileTime{0};
+  std::vector<Entry> m_Entries;
+};
+
+#endif
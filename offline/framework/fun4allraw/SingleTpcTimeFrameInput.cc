@@ -8,6 +8,7 @@
 #include <qautils/QAHistManagerDef.h>
 
 #include <ffarawobjects/TpcRawHitContainerv3.h>
+#include <ffarawobjects/TpcRawHitContainerv4.h>
 #include <ffarawobjects/TpcRawHitv3.h>
 
 #include <fun4all/Fun4AllHistoManager.h>
@@ -32,6 +33,7 @@
 #include <Event/Eventiterator.h>
 #include <Event/fileEventiterator.h>
 
+#include <atomic>
 #include <memory>
 #include <set>
 
@@ -118,11 +120,9 @@ void SingleTpcTimeFrameInput::FillPool(const uint64_t targetBCO)
 {
   m_FillPoolStatus = Fun4AllReturnCodes::EVENT_OK;
   {
-    static bool first = true;
-    if (first)
+    static std::atomic<bool> first = true;
+    if (first.exchange(false))
     {
-      first = false;
-
       if (!m_SelectedPacketIDs.empty())
       {
         std::cout << "SingleTpcTimeFrameInput::" << Name() << " : note, only processing packets with ID: ";
@@ -451,7 +451,14 @@ void SingleTpcTimeFrameInput::CreateDSTNode(PHCompositeNode *topNode)
   TpcRawHitContainer *tpchitcont = findNode::getClass<TpcRawHitContainer>(detNode, m_rawHitContainerName);
   if (!tpchitcont)
   {
-    tpchitcont = new TpcRawHitContainerv3();
+    if (m_UseRawHitContainerv4)
+    {
+      tpchitcont = new TpcRawHitContainerv4();
+    }
+    else
+    {
+      tpchitcont = new TpcRawHitContainerv3();
+    }
     PHIODataNode<PHObject> *newNode = new PHIODataNode<PHObject>(tpchitcont, m_rawHitContainerName, "PHObject");
     detNode->addNode(newNode);
   }
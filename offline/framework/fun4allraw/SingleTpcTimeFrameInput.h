@@ -38,6 +38,10 @@ class SingleTpcTimeFrameInput : public SingleStreamingInput
 
   void AddPacketID(const int packetID) { m_SelectedPacketIDs.insert(packetID); }
 
+  //! write TpcRawHitContainerv4 (contiguous adc storage) instead of TpcRawHitContainerv3 to the DST.
+  //! This changes the raw hit classes stored in the output, readers need the v4 classes
+  void UseRawHitContainerv4(const bool b = true) { m_UseRawHitContainerv4 = b; }
+
   void setDigitalCurrentDebugTTreeName(const std::string &name)
   {
     m_digitalCurrentDebugTTreeName = name;
@@ -58,6 +62,7 @@ class SingleTpcTimeFrameInput : public SingleStreamingInput
   unsigned int m_NumSpecialEvents{0};
   unsigned int m_BcoRange{0};
   unsigned int m_NegativeBco{0};
+  bool m_UseRawHitContainerv4{false};
 
   //! packet ID -> TimeFrame builder
   std::map<int, TpcTimeFrameBuilderBase *> m_TpcTimeFrameBuilderMap;
@@ -6,7 +6,7 @@
 #include <qautils/QAHistManagerDef.h>
 
 #include <ffarawobjects/TpcRawHitv2.h>
-#include <ffarawobjects/TpcRawHitv3.h>
+#include <ffarawobjects/TpcRawHitv4.h>
 
 #include <cdbobjects/CDBTTree.h>
 #include <ffamodules/CDBInterface.h>
@@ -24,6 +24,7 @@
 #include <TTree.h>
 #include <TVector3.h>
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <limits>
@@ -186,6 +187,42 @@ TpcTimeFrameBuilder::~TpcTimeFrameBuilder()
   delete m_digitalCurrentDebugTTree;
 }
 
+std::vector<uint16_t>& TpcTimeFrameBuilder::getAdcArena(const uint64_t& gtm_bco)
+{
+  auto it = m_timeFrameAdcMap.find(gtm_bco);
+  if (it != m_timeFrameAdcMap.end())
+  {
+    return it->second;
+  }
+
+  // reuse a released arena if any
+  if (m_freeAdcArenas.empty())
+  {
+    return m_timeFrameAdcMap[gtm_bco];
+  }
+
+  std::vector<uint16_t>& arena = m_timeFrameAdcMap.emplace(gtm_bco, std::move(m_freeAdcArenas.back())).first->second;
+  m_freeAdcArenas.pop_back();
+  return arena;
+}
+
+void TpcTimeFrameBuilder::releaseAdcArena(const uint64_t& gtm_bco)
+{
+  auto it = m_timeFrameAdcMap.find(gtm_bco);
+  if (it == m_timeFrameAdcMap.end())
+  {
+    return;
+  }
+
+  // keep a few arenas, with their memory, for the next time frames
+  if (m_freeAdcArenas.size() < kMaxFreeAdcArenas)
+  {
+    it->second.clear();
+    m_freeAdcArenas.push_back(std::move(it->second));
+  }
+  m_timeFrameAdcMap.erase(it);
+}
+
 void TpcTimeFrameBuilder::setVerbosity(const int i)
 {
   m_verbosity = i;
@@ -271,6 +308,7 @@ std::vector<TpcRawHit*>& TpcTimeFrameBuilder::getTimeFrame(const uint64_t& gtm_b
       {
         delete hit;
       }
+      releaseAdcArena(it->first);
       it = m_timeFrameMap.erase(it);
     }
     else if (it->first < bclk_rollover_corrected + GL1_BCO_MATCH_WINDOW)
@@ -371,6 +409,7 @@ void TpcTimeFrameBuilder::CleanupUsedPackets(const uint64_t& bclk)
         delete it->second.back();
         it->second.pop_back();
       }
+      releaseAdcArena(it->first);
       m_timeFrameMap.erase(it);
     }
   }
@@ -402,6 +441,7 @@ void TpcTimeFrameBuilder::CleanupUsedPackets(const uint64_t& bclk)
                   << bclk_rollover_corrected << std::dec
                   << " Diff:" << int64_t(it->first) - int64_t(bclk_rollover_corrected) << std::endl;
       }
+      releaseAdcArena(it->first);
       m_timeFrameMap.erase(it++);
     }
     else
@@ -413,8 +453,9 @@ void TpcTimeFrameBuilder::CleanupUsedPackets(const uint64_t& bclk)
 
 int TpcTimeFrameBuilder::ProcessPacket(Packet* packet)
 {
-  static size_t call_count = 0;
-  ++call_count;
+  // shared by all builders, which can run on different threads
+  static std::atomic<size_t> s_call_count{0};
+  const size_t call_count = ++s_call_count;
 
   if (m_verbosity > 1)
   {
@@ -654,6 +695,7 @@ int TpcTimeFrameBuilder::ProcessPacket(Packet* packet)
         delete timeframe.second.back();
         timeframe.second.pop_back();
       }
+      releaseAdcArena(timeframe.first);
     }
   }
 
@@ -922,6 +964,16 @@ void TpcTimeFrameBuilder::process_fee_data_waveform(const unsigned int& fee, std
   {
     m_hFEEDataStream->Fill(fee, "RawHit", 1);
 
+    // waveforms are decoded directly in the time frame ADC arena, with the same format,
+    // except for heartbeats which do not create hits
+    const bool is_heartbeat = (payload.type == TpcTimeFrameBuilder::BcoMatchingInformation::HEARTBEAT_T);
+    if (is_heartbeat)
+    {
+      m_heartbeatAdcBuffer.clear();
+    }
+    std::vector<uint16_t>& adc_arena = is_heartbeat ? m_heartbeatAdcBuffer : getAdcArena(payload.gtm_bco);
+    const size_t adc_offset = adc_arena.size();
+
     // Format is (N sample) (start time), (1st sample)... (Nth sample)
     size_t pos = HEADER_LENGTH;
     std::deque<uint16_t>::const_iterator data_buffer_iterator = data_buffer.cbegin();
@@ -961,18 +1013,18 @@ void TpcTimeFrameBuilder::process_fee_data_waveform(const unsigned int& fee, std
       }
 
       const unsigned int fee_sampa_address = fee * MAX_SAMPA + payload.sampa_address;
-      std::vector<uint16_t> adc(nsamp);
+      adc_arena.push_back(nsamp);
+      adc_arena.push_back(start_t);
       for (int j = 0; j < nsamp; j++)
       {
         const uint16_t& adc_value = *data_buffer_iterator;
 
-        adc[j] = adc_value;
+        adc_arena.push_back(adc_value);
         m_hFEESAMPAADC->Fill(start_t + j, fee_sampa_address, adc_value);
 
         ++pos;
         ++data_buffer_iterator;  // data_buffer[pos++];
       }
-      payload.waveforms.emplace_back(start_t, std::move(adc));
 
       //   // an exception to deal with the last sample that is missing in the current hit format
       //   if (pos + 1 == pkt_length) break;
@@ -990,9 +1042,9 @@ void TpcTimeFrameBuilder::process_fee_data_waveform(const unsigned int& fee, std
     }
 
     // valid packet in the buffer, create a new hit
-    if (payload.type != TpcTimeFrameBuilder::BcoMatchingInformation::HEARTBEAT_T)
+    if (!is_heartbeat)
     {
-      TpcRawHitv3* hit = new TpcRawHitv3();
+      TpcRawHitv4* hit = new TpcRawHitv4();
       m_timeFrameMap[payload.gtm_bco].push_back(hit);
 
       hit->set_bco(payload.bx_timestamp);
@@ -1004,11 +1056,7 @@ void TpcTimeFrameBuilder::process_fee_data_waveform(const unsigned int& fee, std
       hit->set_checksumerror(payload.data_crc != payload.calc_crc);
       // hit->set_parity(payload.data_parity);
       hit->set_parityerror(payload.data_parity != payload.calc_parity);
-
-      for (std::pair<uint16_t, std::vector<uint16_t>>& waveform : payload.waveforms)
-      {
-        hit->move_adc_waveform(waveform.first, std::move(waveform.second));
-      }
+      hit->set_adc_data(&adc_arena, adc_offset, adc_arena.size() - adc_offset);
     }
   }  //     if (not m_fastBCOSkip)
 
@@ -120,8 +120,6 @@ class TpcTimeFrameBuilder : public TpcTimeFrameBuilderBase
 
     uint16_t data_parity = 0;
     uint16_t calc_parity = 0;
-
-    std::vector<std::pair<uint16_t, std::vector<uint16_t>>> waveforms;
   };
 
   struct digital_current_payload
@@ -389,6 +387,23 @@ class TpcTimeFrameBuilder : public TpcTimeFrameBuilderBase
   //! This is used to organize hits into time frames based on their BCO values
   std::map<uint64_t, std::vector<TpcRawHit *>> m_timeFrameMap;
   static const size_t kMaxRawHitLimit = 10000;  // 10k hits per event > 256ch/fee * 26fee
+
+  //! GTM BCO -> ADC data of all hits in the time frame
+  //! hits only store offset and length in this arena, which is released together with the time frame hits
+  std::map<uint64_t, std::vector<uint16_t>> m_timeFrameAdcMap;
+
+  //! released arenas, kept to be reused by the next time frames without new allocation
+  std::vector<std::vector<uint16_t>> m_freeAdcArenas;
+  static const size_t kMaxFreeAdcArenas = 16;
+
+  //! scratch buffer for heartbeat waveforms, which do not create hits
+  std::vector<uint16_t> m_heartbeatAdcBuffer;
+
+  //! ADC data arena for a given time frame, created if needed
+  std::vector<uint16_t> &getAdcArena(const uint64_t &gtm_bco);
+
+  //! release ADC data arena for a given time frame. Must be called once all hits of the time frame are deleted
+  void releaseAdcArena(const uint64_t &gtm_bco);
   std::queue<uint64_t> m_UsedTimeFrameSet;
 
   //! fast skip mode when searching for particular GL1 BCO over long segment of files
@@ -24,6 +24,7 @@
 #include <TTree.h>
 #include <TVector3.h>
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <limits>
@@ -1260,8 +1261,9 @@ void TpcTimeFrameBuilderRun3::CleanupUsedPackets(const uint64_t& bclk)
 
 int TpcTimeFrameBuilderRun3::ProcessPacket(Packet* packet)
 {
-  static size_t call_count = 0;
-  ++call_count;
+  // shared by all builders, which can run on different threads
+  static std::atomic<size_t> s_call_count{0};
+  const size_t call_count = ++s_call_count;
 
   if (m_verbosity > 1)
   {
@@ -28,6 +28,8 @@ class PHIODataNode : public PHDataNode<T>
   typedef PHTypedNodeIterator<T> iterator;
   void BufferSize(int size) { buffersize = size; }
   void SplitLevel(int split) { splitlevel = split; }
+  int BufferSize() const { return buffersize; }
+  int SplitLevel() const { return splitlevel; }
 
  protected:
   bool write(PHIOManager *, const std::string & = "") override;
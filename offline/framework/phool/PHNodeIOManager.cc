@@ -23,6 +23,7 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <iostream>
@@ -294,7 +295,14 @@ bool PHNodeIOManager::readEventFromFile(size_t requestedEvent)
   TFile* file_ptr = gFile;  // save current gFile
   file->cd();
   
-  if (m_cacheSize != std::numeric_limits<uint64_t>::max())
+  if (m_ReadAheadEntries > 0)
+  {
+    if (m_ReadCacheChanged)
+    {
+      setupReadCache();
+    }
+  }
+  else if (m_cacheSize != std::numeric_limits<uint64_t>::max())
   {
     tree->SetCacheSize(m_cacheSize);
   }
@@ -327,6 +335,48 @@ bool PHNodeIOManager::readEventFromFile(size_t requestedEvent)
   return true;
 }
 
+void PHNodeIOManager::setupReadCache()
+{
+  m_ReadCacheChanged = false;
+
+  Long64_t cachesize = 0;
+  if (m_cacheSize != std::numeric_limits<uint64_t>::max())
+  {
+    cachesize = m_cacheSize;
+  }
+  else
+  {
+    // average compressed size of the selected branches, for the requested number
+    // of entries but at least one cluster, so that all baskets of a cluster fit
+    Long64_t zipbytes = 0;
+    TObjArray* branchArray = tree->GetListOfBranches();
+    for (int i = 0; i < branchArray->GetEntriesFast(); i++)
+    {
+      TBranch* thisBranch = dynamic_cast<TBranch*>(branchArray->At(i));
+      if (thisBranch && tree->GetBranchStatus(thisBranch->GetName()))
+      {
+        zipbytes += thisBranch->GetZipBytes("*");
+      }
+    }
+    Long64_t nentries = std::max<Long64_t>(m_ReadAheadEntries, tree->GetAutoFlush());
+    cachesize = zipbytes / std::max<Long64_t>(tree->GetEntries(), 1) * nentries;
+    cachesize = std::max<Long64_t>(cachesize, 1024 * 1024);
+  }
+
+  // the unzip cache has to be selected before the cache is created.
+  // Branches are still streamed serially, only the basket decompression runs in parallel
+  tree->SetParallelUnzip(true);
+  tree->SetImplicitMT(false);
+  tree->SetCacheSize(cachesize);
+
+  // learn the (new) set of selected branches from the next entries
+  TTreeCache* cache = dynamic_cast<TTreeCache*>(tree->GetReadCache(file));
+  if (cache)
+  {
+    cache->StartLearningPhase();
+  }
+}
+
 int PHNodeIOManager::readSpecific(size_t requestedEvent, const std::string& objectName)
 {
   // objectName should be one of the valid branch name of the "T" TTree, and
@@ -509,6 +559,7 @@ PHNodeIOManager::reconstructNodeTree(PHCompositeNode* topNode)
 void PHNodeIOManager::selectObjectToRead(const std::string& objectName, bool readit)
 {
   objectToRead[objectName] = readit;
+  m_ReadCacheChanged = true;
 
   // If tree is already open, loop over map and set branch status
   if (tree)
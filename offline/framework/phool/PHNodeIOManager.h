@@ -59,16 +59,30 @@ class PHNodeIOManager : public PHIOManager
   
   void DisableReadCache();
 
+  //! read ahead: the TTreeCache is sized for nentries entries (at least one cluster) of the selected
+  //! branches, relearns the branch set when the selection changes, and its baskets are unzipped ahead
+  //! of time on ROOT's implicit multithreading pool (if enabled). Entries are still read and streamed
+  //! on the calling thread, in the same order. 0 (default) keeps the ROOT default cache
+  void ReadAhead(unsigned int nentries)
+  {
+    m_ReadAheadEntries = nentries;
+    m_ReadCacheChanged = true;
+  }
+  unsigned int ReadAhead() const { return m_ReadAheadEntries; }
+
 private:
   int FillBranchMap();
   PHCompositeNode *reconstructNodeTree(PHCompositeNode *);
   bool readEventFromFile(size_t requestedEvent);
+  void setupReadCache();
   static std::string getBranchClassName(TBranch *);
 
   TFile *file{nullptr};
   TTree *tree{nullptr};
   std::string TreeName{"T"};
   uint64_t m_cacheSize = std::numeric_limits<uint64_t>::max();
+  unsigned int m_ReadAheadEntries{0};
+  bool m_ReadCacheChanged{true};
   int accessMode{PHReadOnly};
   int m_CompressionSetting{505};  // ZSTD
   int isFunctionalFlag{0};        // flag to tell if that object initialized properly
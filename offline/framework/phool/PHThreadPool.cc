@@ -0,0 +1,123 @@
+#include "PHThreadPool.h"
+
+//_____________________________________________________________________________
+PHThreadPool::PHThreadPool(int nthreads)
+{
+  if (nthreads < 0)
+  {
+    nthreads = std::thread::hardware_concurrency();
+  }
+
+  m_threads.reserve(nthreads);
+  for (int i = 0; i < nthreads; ++i)
+  {
+    m_threads.emplace_back(&PHThreadPool::run, this, i);
+  }
+}
+
+//_____________________________________________________________________________
+PHThreadPool::~PHThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_start_condition.notify_all();
+  for (auto& thread : m_threads)
+  {
+    thread.join();
+  }
+}
+
+//_____________________________________________________________________________
+void PHThreadPool::parallel_for(std::size_t ntasks, const Task& task)
+{
+  if (ntasks == 0)
+  {
+    return;
+  }
+
+  // no worker thread, run everything here
+  if (m_threads.empty())
+  {
+    for (std::size_t i = 0; i < ntasks; ++i)
+    {
+      task(i, 0);
+    }
+    return;
+  }
+
+  std::lock_guard<std::mutex> submit_lock(m_submit_mutex);
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_task = &task;
+  m_ntasks = ntasks;
+  m_next = 0;
+  m_running = m_threads.size();
+  m_exception = nullptr;
+  ++m_generation;
+  m_start_condition.notify_all();
+
+  // wait for all workers to be done with this job
+  m_done_condition.wait(lock, [this]
+                        { return m_running == 0; });
+  m_task = nullptr;
+
+  if (m_exception)
+  {
+    std::exception_ptr exception;
+    std::swap(exception, m_exception);
+    std::rethrow_exception(exception);
+  }
+}
+
+//_____________________________________________________________________________
+void PHThreadPool::run(unsigned int worker)
+{
+  unsigned long generation = 0;
+  while (true)
+  {
+    const Task* task = nullptr;
+    std::size_t ntasks = 0;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_start_condition.wait(lock, [this, generation]
+                             { return m_stop || m_generation != generation; });
+      if (m_stop)
+      {
+        return;
+      }
+      generation = m_generation;
+      task = m_task;
+      ntasks = m_ntasks;
+    }
+
+    // process tasks until none is left
+    std::exception_ptr exception;
+    for (std::size_t i = m_next++; i < ntasks; i = m_next++)
+    {
+      try
+      {
+        (*task)(i, worker);
+      }
+      catch (...)
+      {
+        if (!exception)
+        {
+          exception = std::current_exception();
+        }
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (exception && !m_exception)
+      {
+        m_exception = exception;
+      }
+      if (--m_running == 0)
+      {
+        m_done_condition.notify_one();
+      }
+    }
+  }
+}
@@ -0,0 +1,78 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef PHOOL_PHTHREADPOOL_H
+#define PHOOL_PHTHREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! persistent pool of worker threads
+/*!
+ * threads are started once (typically in InitRun) and kept alive until the pool is destroyed.
+ * work is submitted as a range of task indices with parallel_for, which blocks until all
+ * tasks are done. Each task also receives the index of the worker that runs it, so that callers
+ * can keep per-worker buffers and merge them afterwards without any locking.
+ * A pool with zero threads runs all tasks in the calling thread.
+ */
+class PHThreadPool
+{
+ public:
+  //! task signature: task index, worker index
+  using Task = std::function<void(std::size_t, unsigned int)>;
+
+  //! constructor. If nthreads is negative, use the number of hardware threads
+  explicit PHThreadPool(int nthreads = -1);
+
+  //! destructor. Stops and joins all threads
+  ~PHThreadPool();
+
+  // no copy, no move
+  PHThreadPool(const PHThreadPool&) = delete;
+  PHThreadPool& operator=(const PHThreadPool&) = delete;
+  PHThreadPool(PHThreadPool&&) = delete;
+  PHThreadPool& operator=(PHThreadPool&&) = delete;
+
+  //! number of worker threads
+  unsigned int size() const { return m_threads.size(); }
+
+  //! number of distinct worker indices passed to tasks (at least one)
+  unsigned int nslots() const { return m_threads.empty() ? 1 : m_threads.size(); }
+
+  //! run task(i, worker) for i in [0,ntasks) and wait for completion
+  /*! the first exception thrown by a task, if any, is rethrown in the calling thread */
+  void parallel_for(std::size_t ntasks, const Task& task);
+
+ private:
+  //! worker main loop
+  void run(unsigned int worker);
+
+  //! worker threads
+  std::vector<std::thread> m_threads;
+
+  //! serializes concurrent calls to parallel_for
+  std::mutex m_submit_mutex;
+
+  //! protects the job state below
+  std::mutex m_mutex;
+  std::condition_variable m_start_condition;
+  std::condition_variable m_done_condition;
+
+  //! current job
+  const Task* m_task = nullptr;
+  std::size_t m_ntasks = 0;
+  unsigned long m_generation = 0;
+  unsigned int m_running = 0;
+  bool m_stop = false;
+  std::exception_ptr m_exception;
+
+  //! next task index to be processed
+  std::atomic<std::size_t> m_next{0};
+};
+
+#endif
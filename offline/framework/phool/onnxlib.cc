@@ -1,5 +1,7 @@
 #include "onnxlib.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 
 namespace onnxlib
@@ -149,3 +151,110 @@ std::vector<float> onnxInference(Ort::Session *session, std::vector<float> &inpu
 
   return outputTensorValues;
 }
+
+onnxlib::Context::Context(const std::string &modelfile, int intra_op_threads, int verbosity)
+  : m_env(OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING, "fit")
+  , m_memoryInfo(Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault))
+{
+  Ort::SessionOptions sessionOptions;
+  sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+  sessionOptions.SetIntraOpNumThreads(std::max(intra_op_threads, 1));
+  m_session = std::make_unique<Ort::Session>(m_env, modelfile.c_str(), sessionOptions);
+
+#if ORT_API_VERSION == 12
+  Ort::AllocatorWithDefaultOptions allocator;
+  char *name = m_session->GetInputName(0, allocator);
+  m_input_name = name;
+  allocator.Free(name);
+  name = m_session->GetOutputName(0, allocator);
+  m_output_name = name;
+  allocator.Free(name);
+#elif ORT_API_VERSION == 22
+  m_input_name = m_session->GetInputNames().at(0);
+  m_output_name = m_session->GetOutputNames().at(0);
+#else
+#define XSTR(x) STR(x)
+#define STR(x) #x
+#pragma message "ORT_API_VERSION " XSTR(ORT_API_VERSION) " not implemented"
+#endif
+
+  m_input_shape = m_session->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+  m_output_shape = m_session->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+  if (m_input_shape.size() < 2 || m_output_shape.size() < 2)
+  {
+    std::cout << "onnxlib::Context - model " << modelfile << " needs a batch dimension in its input and output" << std::endl;
+    exit(1);
+  }
+  m_n_input = 1;
+  for (auto dim = m_input_shape.begin() + 1; dim != m_input_shape.end(); ++dim)
+  {
+    m_n_input *= *dim;
+  }
+  m_n_output = 1;
+  for (auto dim = m_output_shape.begin() + 1; dim != m_output_shape.end(); ++dim)
+  {
+    m_n_output *= *dim;
+  }
+  if (m_n_input <= 0 || m_n_output <= 0)
+  {
+    std::cout << "onnxlib::Context - model " << modelfile << " has dynamic dimensions other than the batch dimension" << std::endl;
+    exit(1);
+  }
+  m_fixed_batch = (m_input_shape[0] > 0) ? m_input_shape[0] : 0;
+
+  if (verbosity > 0)
+  {
+    std::cout << "onnxlib: using model " << modelfile << std::endl;
+    std::cout << "Number of Inputs: " << m_n_input << std::endl;
+    std::cout << "Number of Outputs: " << m_n_output << std::endl;
+    std::cout << "Batch size: " << (m_fixed_batch ? std::to_string(m_fixed_batch) : "free")
+              << ", intra op threads: " << std::max(intra_op_threads, 1) << std::endl;
+  }
+}
+
+float *onnxlib::Context::input(int nsamples)
+{
+  m_nsamples = std::max(nsamples, 0);
+
+  // models with fixed batch size get their last chunk padded with zeros
+  int nrows = m_nsamples;
+  if (m_fixed_batch > 0)
+  {
+    nrows = ((m_nsamples + m_fixed_batch - 1) / m_fixed_batch) * m_fixed_batch;
+  }
+  m_input.resize(static_cast<size_t>(nrows) * m_n_input);
+  std::fill(m_input.begin() + static_cast<size_t>(m_nsamples) * m_n_input, m_input.end(), 0.F);
+  return m_input.data();
+}
+
+const std::vector<float> &onnxlib::Context::run()
+{
+  const char *inputNames[] = {m_input_name.c_str()};
+  const char *outputNames[] = {m_output_name.c_str()};
+
+  const int nrows = m_input.size() / m_n_input;
+  const int batch = (m_fixed_batch > 0) ? m_fixed_batch : nrows;
+  m_output.resize(static_cast<size_t>(nrows) * m_n_output);
+  for (int first = 0; first < m_nsamples; first += batch)
+  {
+    float *input = m_input.data() + static_cast<size_t>(first) * m_n_input;
+    float *output = m_output.data() + static_cast<size_t>(first) * m_n_output;
+    if (input != m_bound_input || output != m_bound_output || batch != m_bound_batch)
+    {
+      m_input_shape[0] = batch;
+      m_output_shape[0] = batch;
+      m_input_tensors.clear();
+      m_output_tensors.clear();
+      m_input_tensors.push_back(Ort::Value::CreateTensor<float>(m_memoryInfo, input, static_cast<size_t>(batch) * m_n_input, m_input_shape.data(), m_input_shape.size()));
+      m_output_tensors.push_back(Ort::Value::CreateTensor<float>(m_memoryInfo, output, static_cast<size_t>(batch) * m_n_output, m_output_shape.data(), m_output_shape.size()));
+      m_bound_input = input;
+      m_bound_output = output;
+      m_bound_batch = batch;
+    }
+    m_session->Run(Ort::RunOptions{nullptr}, inputNames, m_input_tensors.data(), 1, outputNames, m_output_tensors.data(), 1);
+  }
+
+  // drop padding
+  m_output.resize(static_cast<size_t>(m_nsamples) * m_n_output);
+  return m_output;
+}
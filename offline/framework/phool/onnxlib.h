@@ -3,6 +3,11 @@
 
 #include <onnxruntime_c_api.h>
 #include <onnxruntime_cxx_api.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
 // This is a stub for some ONNX code refactoring
 
 Ort::Session *onnxSession(std::string &modelfile, int verbosity = 0);
@@ -15,6 +20,59 @@ namespace onnxlib
 {
   extern int n_input;
   extern int n_output;
+
+  // Reusable inference context for single input, single output models.
+  // Names and shapes are read from the model once, input and output buffers
+  // and the tensors bound to them are kept between calls, and any number of
+  // samples is run in one go along the first (batch) dimension.
+  // Models with a fixed batch size are run in chunks of that size.
+  class Context
+  {
+   public:
+    explicit Context(const std::string &modelfile, int intra_op_threads = 1, int verbosity = 0);
+    ~Context() = default;
+
+    Context(const Context &) = delete;
+    Context &operator=(const Context &) = delete;
+
+    //! number of values per sample, product of all model input/output dimensions but the first
+    int n_input() const { return m_n_input; }
+    int n_output() const { return m_n_output; }
+
+    //! input buffer for nsamples samples of n_input() values, to be filled before run()
+    float *input(int nsamples);
+
+    //! run the model on the samples of the input buffer, returns nsamples * n_output() values
+    const std::vector<float> &run();
+
+   private:
+    Ort::Env m_env;
+    Ort::MemoryInfo m_memoryInfo;
+    std::unique_ptr<Ort::Session> m_session;
+
+    std::string m_input_name;
+    std::string m_output_name;
+
+    // model shapes, the first dimension is set per call
+    std::vector<int64_t> m_input_shape;
+    std::vector<int64_t> m_output_shape;
+    int m_n_input{0};
+    int m_n_output{0};
+
+    // batch size fixed by the model, 0 if free
+    int m_fixed_batch{0};
+
+    int m_nsamples{0};
+    std::vector<float> m_input;
+    std::vector<float> m_output;
+
+    // tensors bound to m_input and m_output, remade when the batch size or the buffers change
+    std::vector<Ort::Value> m_input_tensors;
+    std::vector<Ort::Value> m_output_tensors;
+    const float *m_bound_input{nullptr};
+    const float *m_bound_output{nullptr};
+    int m_bound_batch{0};
+  };
 }  // namespace onnxlib
 
 #endif
@@ -75,6 +75,7 @@ int CaloTowerBuilder::InitRun(PHCompositeNode *topNode)
   {
     WaveformProcessing->set_bitFlipRecovery(m_dobitfliprecovery);
   }
+  WaveformProcessing->set_templatefit_native(m_templatefit_native);
 
   // Set functional fit parameters
   if (_processingtype == CaloWaveformProcessing::FUNCFIT)
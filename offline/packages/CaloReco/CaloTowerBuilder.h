@@ -94,6 +94,12 @@ public:
     m_dobitfliprecovery = dobitfliprecovery;
   }
 
+  // use native template fit instead of ROOT fitter (default), see CaloWaveformFitting
+  void set_templatefit_native(bool native = true)
+  {
+    m_templatefit_native = native;
+  }
+
   // Functional fit options: 0 = PowerLawExp, 1 = PowerLawDoubleExp
   void set_funcfit_type(int type)
   {
@@ -162,6 +168,7 @@ private:
   float m_timeLim_low{-3.0};
   float m_timeLim_high{4.0};
   bool m_dobitfliprecovery{false};
+  bool m_templatefit_native{false};
 
   int m_saturation{16383};
   std::string calibdir;
@@ -15,6 +15,7 @@
 #include <Math/WrappedMultiTF1.h>
 #include <Math/WrappedTF1.h>
 #include <ROOT/TThreadExecutor.hxx>
+#include <ROOT/TSeq.hxx>
 #include <ROOT/TThreadedObject.hxx>
 
 #include <pthread.h>
@@ -45,6 +46,17 @@ void CaloWaveformFitting::initialize_processing(const std::string &templatefile)
   fin->Close();
   delete fin;
   m_peakTimeTemp = h_template->GetBinCenter(h_template->GetMaximumBin());
+
+  // tabulate template for the native fit
+  std::vector<double> contents;
+  contents.reserve(h_template->GetNbinsX());
+  for (int i = 1; i <= h_template->GetNbinsX(); ++i)
+  {
+    contents.push_back(h_template->GetBinContent(i));
+  }
+  m_templatefit.set_template(contents, h_template->GetBinCenter(1), h_template->GetBinWidth(1));
+  m_templatefit_workspaces.clear();
+
   t = new ROOT::TThreadExecutor(_nthreads);
 }
 
@@ -67,61 +79,18 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
     int size1 = v.size() - 1;
     if (size1 == _nzerosuppresssamples)
     {
-      v.push_back(v.at(1) - v.at(0));                        // returns peak sample - pedestal sample
-      v.push_back(std::numeric_limits<float>::quiet_NaN());  // set time to qnan for ZS
-      v.push_back(v.at(0));
-      if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
-      {
-        v.push_back(1000000);
-      }
-      else
-      {
-        v.push_back(std::numeric_limits<float>::quiet_NaN());
-      }
-      v.push_back(0);
-      v.push_back(0);
+      fill_zero_suppressed(v, v.at(1) - v.at(0));  // returns peak sample - pedestal sample
     }
     else
     {
       float maxheight = 0;
       int maxbin = 0;
-      for (int i = 0; i < size1; i++)
-      {
-        if (v.at(i) > maxheight)
-        {
-          maxheight = v.at(i);
-          maxbin = i;
-        }
-      }
       float pedestal = 1500;
-      if (maxbin > 4)
-      {
-        pedestal = 0.5 * (v.at(maxbin - 4) + v.at(maxbin - 5));
-      }
-      else if (maxbin > 3)
-      {
-        pedestal = (v.at(maxbin - 4));
-      }
-      else
-      {
-        pedestal = 0.5 * (v.at(size1 - 3) + v.at(size1 - 2));
-      }
+      find_peak_and_pedestal(v, size1, maxheight, maxbin, pedestal);
 
       if ((_bdosoftwarezerosuppression && v.at(6) - v.at(0) < _nsoftwarezerosuppression) || (_maxsoftwarezerosuppression && maxheight - pedestal < _nsoftwarezerosuppression))
       {
-        v.push_back(v.at(6) - v.at(0));
-        v.push_back(std::numeric_limits<float>::quiet_NaN());
-        v.push_back(v.at(0));
-        if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
-        {
-          v.push_back(1000000);
-        }
-        else
-        {
-          v.push_back(std::numeric_limits<float>::quiet_NaN());
-        }
-        v.push_back(0);
-        v.push_back(0);
+        fill_zero_suppressed(v, v.at(6) - v.at(0));
       }
       else
       {
@@ -187,50 +156,14 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
         if (chi2min > _chi2threshold && (f->GetParameter(2) < _bfr_highpedestalthreshold || pedestal < _bfr_highpedestalthreshold) && (f->GetParameter(2) > _bfr_lowpedestalthreshold || pedestal > _bfr_lowpedestalthreshold) && _dobitfliprecovery)
         {
           std::vector<float> rv;  // temporary recovered waveform
-          rv.reserve(size1);
-          for (int i = 0; i < size1; i++)
-          {
-            rv.push_back(v.at(i));
-          }
-          unsigned int bits[3] = {8192, 4096, 2048};
-          for (auto bit : bits)
-          {
-            for (int i = 0; i < size1; i++)
-            {
-              if (((unsigned int) rv.at(i) & bit) && ((unsigned int) rv.at(i) % bit > _bfr_lowpedestalthreshold))
-              {
-                rv.at(i) = rv.at(i) - bit;
-              }
-            }
-          }
+          bitflip_recovered_waveform(v, size1, rv);
           for (int i = 0; i < size1; i++)
           {
             h->SetBinContent(i + 1, rv.at(i));
             h->SetBinError(i + 1, 1);
           }
 
-          maxheight = 0;
-          maxbin = 0;
-          for (int i = 0; i < size1; i++)
-          {
-            if (rv.at(i) > maxheight)
-            {
-              maxheight = rv.at(i);
-              maxbin = i;
-            }
-          }
-          if (maxbin > 4)
-          {
-            pedestal = 0.5 * (rv.at(maxbin - 4) + rv.at(maxbin - 5));
-          }
-          else if (maxbin > 3)
-          {
-            pedestal = (rv.at(maxbin - 4));
-          }
-          else
-          {
-            pedestal = 0.5 * (rv.at(size1 - 3) + rv.at(size1 - 2));
-          }
+          find_peak_and_pedestal(rv, size1, maxheight, maxbin, pedestal);
 
           auto *recover_f = new TF1(std::string("recover_f_" + std::to_string((int) round(v.at(size1)))).c_str(), this, &CaloWaveformFitting::template_function, 0, 31, 3, "CaloWaveformFitting", "template_function");
           ROOT::Math::WrappedMultiTF1 *recoverFitFunction = new ROOT::Math::WrappedMultiTF1(*recover_f, 3);
@@ -295,7 +228,33 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
     }
   };
 
-  t->Foreach(func, chnlvector);
+  if (m_templatefit_native)
+  {
+    // process channels by batches, each with its own fit workspace, re-used from one event to the next
+    const unsigned int nchannels = chnlvector.size();
+    const unsigned int nbatches = (nchannels + m_templatefit_batch_size - 1) / m_templatefit_batch_size;
+    if (m_templatefit_workspaces.size() < nbatches)
+    {
+      m_templatefit_workspaces.resize(nbatches, m_templatefit);
+    }
+
+    auto batch_func = [&](unsigned int ibatch)
+    {
+      CaloWaveformTemplateFit &fitter = m_templatefit_workspaces[ibatch];
+      const unsigned int first = ibatch * m_templatefit_batch_size;
+      const unsigned int last = std::min(nchannels, first + m_templatefit_batch_size);
+      for (unsigned int ichannel = first; ichannel < last; ++ichannel)
+      {
+        templatefit_native(chnlvector[ichannel], fitter);
+      }
+    };
+    t->Foreach(batch_func, ROOT::TSeq<unsigned int>(nbatches));
+  }
+  else
+  {
+    t->Foreach(func, chnlvector);
+  }
+
   int size3 = chnlvector.size();
   std::vector<std::vector<float>> fit_params;
   std::vector<float> fit_params_tmp;
@@ -314,6 +273,145 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
   return fit_params;
 }
 
+void CaloWaveformFitting::find_peak_and_pedestal(const std::vector<float> &v, int size1, float &maxheight, int &maxbin, float &pedestal)
+{
+  maxheight = 0;
+  maxbin = 0;
+  for (int i = 0; i < size1; i++)
+  {
+    if (v.at(i) > maxheight)
+    {
+      maxheight = v.at(i);
+      maxbin = i;
+    }
+  }
+  if (maxbin > 4)
+  {
+    pedestal = 0.5 * (v.at(maxbin - 4) + v.at(maxbin - 5));
+  }
+  else if (maxbin > 3)
+  {
+    pedestal = (v.at(maxbin - 4));
+  }
+  else
+  {
+    pedestal = 0.5 * (v.at(size1 - 3) + v.at(size1 - 2));
+  }
+}
+
+void CaloWaveformFitting::fill_zero_suppressed(std::vector<float> &v, float amplitude)
+{
+  v.push_back(amplitude);
+  v.push_back(std::numeric_limits<float>::quiet_NaN());  // set time to qnan for ZS
+  v.push_back(v.at(0));
+  if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
+  {
+    v.push_back(1000000);
+  }
+  else
+  {
+    v.push_back(std::numeric_limits<float>::quiet_NaN());
+  }
+  v.push_back(0);
+  v.push_back(0);
+}
+
+void CaloWaveformFitting::bitflip_recovered_waveform(const std::vector<float> &v, int size1, std::vector<float> &rv) const
+{
+  rv.assign(v.begin(), v.begin() + size1);
+  unsigned int bits[3] = {8192, 4096, 2048};
+  for (auto bit : bits)
+  {
+    for (int i = 0; i < size1; i++)
+    {
+      if (((unsigned int) rv.at(i) & bit) && ((unsigned int) rv.at(i) % bit > _bfr_lowpedestalthreshold))
+      {
+        rv.at(i) = rv.at(i) - bit;
+      }
+    }
+  }
+}
+
+void CaloWaveformFitting::templatefit_native(std::vector<float> &v, CaloWaveformTemplateFit &fitter) const
+{
+  // same logic as the ROOT based fit in calo_processing_templatefit
+  int size1 = v.size() - 1;
+  if (size1 == _nzerosuppresssamples)
+  {
+    fill_zero_suppressed(v, v.at(1) - v.at(0));  // returns peak sample - pedestal sample
+    return;
+  }
+
+  float maxheight = 0;
+  int maxbin = 0;
+  float pedestal = 1500;
+  find_peak_and_pedestal(v, size1, maxheight, maxbin, pedestal);
+
+  if ((_bdosoftwarezerosuppression && v.at(6) - v.at(0) < _nsoftwarezerosuppression) || (_maxsoftwarezerosuppression && maxheight - pedestal < _nsoftwarezerosuppression))
+  {
+    fill_zero_suppressed(v, v.at(6) - v.at(0));
+    return;
+  }
+
+  fitter.clear_data();
+  for (int i = 0; i < size1; ++i)
+  {
+    if ((v.at(i) == 16383) && _handleSaturation)
+    {
+      continue;
+    }
+    fitter.add_data(i, v.at(i));
+  }
+  // if too many are saturated don't do the saturation recovery need enough ndf
+  if ((int) fitter.ndata() < (size1 - 4))
+  {
+    fitter.clear_data();
+    for (int i = 0; i < size1; ++i)
+    {
+      fitter.add_data(i, v.at(i));
+    }
+  }
+  const int ndata = fitter.ndata();
+
+  const double tmin = m_setTimeLim ? m_timeLim_low : -1 * m_peakTimeTemp;
+  const double tmax = m_setTimeLim ? m_timeLim_high : size1 - m_peakTimeTemp;
+  const auto result = fitter.fit(maxheight - pedestal, maxbin - m_peakTimeTemp, pedestal, tmin, tmax);
+  const double chi2min = result.chi2 / (ndata - 3);  // divide by the number of dof
+
+  if (chi2min > _chi2threshold && (result.pedestal < _bfr_highpedestalthreshold || pedestal < _bfr_highpedestalthreshold) && (result.pedestal > _bfr_lowpedestalthreshold || pedestal > _bfr_lowpedestalthreshold) && _dobitfliprecovery)
+  {
+    std::vector<float> rv;  // temporary recovered waveform
+    bitflip_recovered_waveform(v, size1, rv);
+    find_peak_and_pedestal(rv, size1, maxheight, maxbin, pedestal);
+
+    fitter.clear_data();
+    for (int i = 0; i < size1; ++i)
+    {
+      fitter.add_data(i, rv.at(i));
+    }
+    const auto recover_result = fitter.fit(maxheight - pedestal, 0, pedestal, -1 * m_peakTimeTemp, size1 - m_peakTimeTemp);
+    const double recover_chi2min = recover_result.chi2 / (size1 - 3);  // divide by the number of dof
+    if (recover_chi2min < _chi2lowthreshold && recover_result.pedestal < _bfr_highpedestalthreshold && recover_result.pedestal > _bfr_lowpedestalthreshold)
+    {
+      std::copy(rv.begin(), rv.end(), v.begin());
+      v.push_back(recover_result.amplitude);
+      v.push_back(recover_result.time);
+      v.push_back(recover_result.pedestal);
+      v.push_back(recover_chi2min);
+      v.push_back(1);
+      v.push_back(recover_result.status);
+      return;
+    }
+  }
+
+  v.push_back(result.amplitude);
+  v.push_back(result.time);
+  v.push_back(result.pedestal);
+  v.push_back(chi2min);
+  v.push_back(0);
+  v.push_back(result.status);
+}
+
 void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float y1, float y2, float &xmax, float &ymax)
 {
   int n = 3;
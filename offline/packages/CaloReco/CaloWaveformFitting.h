@@ -1,6 +1,9 @@
 #ifndef CALORECO_CALOWAVEFORMFITTING_H
 #define CALORECO_CALOWAVEFORMFITTING_H
 
+#include "CaloWaveformTemplateFit.h"
+
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -64,6 +67,19 @@ class CaloWaveformFitting
     _handleSaturation = handleSaturation;
   }
 
+  // use native template fit instead of ROOT GSLMultiFit (default). With the native fit
+  // the last output column is 0 if the fit converged, 1 otherwise, rather than the GSL status code
+  void set_templatefit_native(bool native = true)
+  {
+    m_templatefit_native = native;
+  }
+
+  // number of channels per batch for the native template fit
+  void set_templatefit_batch_size(unsigned int size)
+  {
+    m_templatefit_batch_size = std::max(1U, size);
+  }
+
   std::vector<std::vector<float>> process_waveform(std::vector<std::vector<float>> waveformvector);
   std::vector<std::vector<float>> calo_processing_templatefit(std::vector<std::vector<float>> chnlvector);
   static std::vector<std::vector<float>> calo_processing_fast(const std::vector<std::vector<float>> &chnlvector);
@@ -108,6 +124,18 @@ class CaloWaveformFitting
   static float psinc(float t, std::vector<float> &vec_signal_samples);
   double template_function(double *x, double *par);
 
+  // find maximum sample and estimate pedestal
+  static void find_peak_and_pedestal(const std::vector<float> &v, int size1, float &maxheight, int &maxbin, float &pedestal);
+
+  // append results for zero suppressed waveform
+  static void fill_zero_suppressed(std::vector<float> &v, float amplitude);
+
+  // waveform with bit flip recovery applied
+  void bitflip_recovered_waveform(const std::vector<float> &v, int size1, std::vector<float> &rv) const;
+
+  // native template fit of a single channel
+  void templatefit_native(std::vector<float> &v, CaloWaveformTemplateFit &fitter) const;
+
   TProfile *h_template{nullptr};
   double m_peakTimeTemp{0};
   int _nthreads{1};
@@ -125,6 +153,12 @@ class CaloWaveformFitting
   bool m_setTimeLim{false};
   bool _dobitfliprecovery{false};
   bool _handleSaturation{true};
+  bool m_templatefit_native{false};
+  unsigned int m_templatefit_batch_size{64};
+
+  // native template fit, with tabulated template. Copied into one workspace per batch
+  CaloWaveformTemplateFit m_templatefit;
+  std::vector<CaloWaveformTemplateFit> m_templatefit_workspaces;
 
   std::string m_template_input_file;
   std::string url_template;
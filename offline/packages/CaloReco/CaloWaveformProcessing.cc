@@ -13,10 +13,8 @@
 #include <memory>  // for allocator_traits<>::value_type
 #include <string>
 
-namespace
-{
-  Ort::Session *onnxmodule;
-}
+// needed here for unique_ptr to incomplete onnxlib::Context in header
+CaloWaveformProcessing::CaloWaveformProcessing() = default;
 
 CaloWaveformProcessing::~CaloWaveformProcessing()
 {
@@ -51,12 +49,14 @@ void CaloWaveformProcessing::initialize_processing()
     {
       m_Fitter->set_bitFlipRecovery(_dobitfliprecovery);
     }
+    m_Fitter->set_templatefit_native(_templatefit_native);
   }
   else if (m_processingtype == CaloWaveformProcessing::ONNX)
   {
     // std::string calibrations_repo_model = m_model_name;
     // url_onnx = CDBInterface::instance()->getUrl("CEMC_ONNX", m_model_name);
-    onnxmodule = onnxSession(m_model_name, Verbosity());
+    // intra op threads of the onnx runtime follow the number of threads set for the module
+    m_onnx = std::make_unique<onnxlib::Context>(m_model_name, get_nthreads(), Verbosity());
   }
   else if (m_processingtype == CaloWaveformProcessing::NYQUIST)
   {
@@ -116,6 +116,10 @@ std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX(con
   std::vector<std::vector<float>> fit_values;
   std::vector<float> val;  // single row to return
   unsigned int nchnls = chnlvector.size();
+  fit_values.reserve(nchnls);
+
+  // channels which go through the network, filled in after a single inference call
+  std::vector<unsigned int> onnx_channels;
   for (unsigned int m = 0; m < nchnls; m++)
   {
     val.clear();
@@ -186,19 +190,8 @@ std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX(con
         unsigned int nsamples = v.size();
         if (nsamples == 12)
         {
-          // downstream onnx does not have a static input vector API,
-          // so we need to make a copy
-          std::vector<float> vtmp(v);  // NOLINT(performance-unnecessary-copy-initialization)
-          val = onnxInference(onnxmodule, vtmp, 1, onnxlib::n_input, onnxlib::n_output);
-          unsigned int nvals = val.size();
-          for (unsigned int i = 0; i < nvals; i++)
-          {
-            val.at(i) = val.at(i) * m_Onnx_factor.at(i) + m_Onnx_offset.at(i);
-          }
-          val.push_back(2000);
-          val.push_back(0);
-          val.push_back(0);
-          fit_values.push_back(val);
+          onnx_channels.push_back(m);
+          fit_values.emplace_back();
         }
         else
         {
@@ -209,6 +202,37 @@ std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX(con
       }
     }
   }
+
+  if (onnx_channels.empty())
+  {
+    return fit_values;
+  }
+
+  // one inference for all channels
+  const unsigned int n_input = m_onnx->n_input();
+  const unsigned int n_output = m_onnx->n_output();
+  float *input = m_onnx->input(onnx_channels.size());
+  for (const auto m : onnx_channels)
+  {
+    const std::vector<float> &v = chnlvector[m];
+    const size_t ncopy = std::min<size_t>(v.size(), n_input);
+    std::copy_n(v.begin(), ncopy, input);
+    std::fill(input + ncopy, input + n_input, 0.F);
+    input += n_input;
+  }
+  const std::vector<float> &output = m_onnx->run();
+  for (unsigned int ichannel = 0; ichannel < onnx_channels.size(); ++ichannel)
+  {
+    std::vector<float> &channel_val = fit_values[onnx_channels[ichannel]];
+    channel_val.reserve(n_output + 3);
+    for (unsigned int i = 0; i < n_output; i++)
+    {
+      channel_val.push_back(output[ichannel * n_output + i] * m_Onnx_factor.at(i) + m_Onnx_offset.at(i));
+    }
+    channel_val.push_back(2000);
+    channel_val.push_back(0);
+    channel_val.push_back(0);
+  }
   return fit_values;
 }
 
@@ -4,11 +4,18 @@
 #include <fun4all/SubsysReco.h>
 
 #include <array>
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
 class CaloWaveformFitting;
 
+namespace onnxlib
+{
+  class Context;
+}
+
 class CaloWaveformProcessing : public SubsysReco
 {
  public:
@@ -23,7 +30,7 @@ class CaloWaveformProcessing : public SubsysReco
     FUNCFIT = 6,
   };
 
-  CaloWaveformProcessing() = default;
+  CaloWaveformProcessing();
   ~CaloWaveformProcessing() override;
 
   void set_processing_type(CaloWaveformProcessing::process modelno)
@@ -76,6 +83,12 @@ class CaloWaveformProcessing : public SubsysReco
     _dobitfliprecovery = dobitfliprecovery;
   }
 
+  // use native template fit instead of ROOT fitter (default), see CaloWaveformFitting
+  void set_templatefit_native(bool native = true)
+  {
+    _templatefit_native = native;
+  }
+
   // Functional fit options: 0 = PowerLawExp, 1 = PowerLawDoubleExp
   void set_funcfit_type(int type)
   {
@@ -108,6 +121,9 @@ class CaloWaveformProcessing : public SubsysReco
  private:
   CaloWaveformFitting *m_Fitter{nullptr};
 
+  // onnx model, all waveforms of a call to calo_processing_ONNX are inferred in one batch
+  std::unique_ptr<onnxlib::Context> m_onnx;
+
   CaloWaveformProcessing::process m_processingtype{CaloWaveformProcessing::TEMPLATE};
   int _nthreads{1};
   int _nzerosuppresssamples{2};
@@ -115,6 +131,7 @@ class CaloWaveformProcessing : public SubsysReco
   int _nsoftwarezerosuppression{40};
   bool _bdosoftwarezerosuppression{false};
   bool _dobitfliprecovery{false};
+  bool _templatefit_native{false};
 
   std::string m_template_input_file;
   std::string url_template;
@@ -0,0 +1,169 @@
+#include "CaloWaveformTemplateFit.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace
+{
+  using Matrix = std::array<std::array<double, 3>, 3>;
+  using Vector = std::array<double, 3>;
+
+  // solve 3x3 linear system using Cramer's rule. Returns false if the matrix is singular
+  bool solve(const Matrix &m, const Vector &b, Vector &x)
+  {
+    auto det3 = [](const Matrix &a)
+    {
+      return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) -
+             a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0]) +
+             a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+    };
+
+    const double det = det3(m);
+    if (det == 0 || !std::isfinite(det))
+    {
+      return false;
+    }
+
+    for (int i = 0; i < 3; ++i)
+    {
+      Matrix mi = m;
+      for (int j = 0; j < 3; ++j)
+      {
+        mi[j][i] = b[j];
+      }
+      x[i] = det3(mi) / det;
+    }
+    return true;
+  }
+}  // namespace
+
+void CaloWaveformTemplateFit::set_template(const std::vector<double> &contents, double first_center, double bin_width)
+{
+  m_template = contents;
+  m_first_center = first_center;
+  m_bin_width = bin_width;
+  m_inv_bin_width = 1. / bin_width;
+}
+
+double CaloWaveformTemplateFit::template_value(double x, double &slope) const
+{
+  // same as TH1::Interpolate: constant outside of the first and last bin centers, linear in between
+  slope = 0;
+  const int nbins = m_template.size();
+  const double u = (x - m_first_center) * m_inv_bin_width;
+  if (!(u > 0))
+  {
+    return m_template.front();
+  }
+  if (u >= nbins - 1)
+  {
+    return m_template.back();
+  }
+
+  const int bin = std::min(static_cast<int>(u), nbins - 2);
+  const double low = m_template[bin];
+  const double high = m_template[bin + 1];
+  slope = (high - low) * m_inv_bin_width;
+  return low + (u - bin) * (high - low);
+}
+
+double CaloWaveformTemplateFit::chi2(double amplitude, double time, double pedestal) const
+{
+  double sum = 0;
+  double slope = 0;
+  for (unsigned int i = 0; i < m_x.size(); ++i)
+  {
+    const double residual = m_y[i] - (amplitude * template_value(m_x[i] - time, slope) + pedestal);
+    sum += residual * residual;
+  }
+  return sum;
+}
+
+CaloWaveformTemplateFit::Result CaloWaveformTemplateFit::fit(double amplitude, double time, double pedestal, double tmin, double tmax) const
+{
+  Vector par = {amplitude, std::clamp(time, tmin, tmax), pedestal};
+  double chi2_current = chi2(par[0], par[1], par[2]);
+  double lambda = 1e-3;
+
+  Result result;
+  for (int iteration = 0; iteration < m_max_iterations; ++iteration)
+  {
+    // normal equations, with residuals r = y - f and jacobian df/dpar
+    Matrix alpha{};
+    Vector beta{};
+    double slope = 0;
+    for (unsigned int i = 0; i < m_x.size(); ++i)
+    {
+      const double value = template_value(m_x[i] - par[1], slope);
+      const double residual = m_y[i] - (par[0] * value + par[2]);
+      const Vector jacobian = {value, -par[0] * slope, 1.};
+      for (int j = 0; j < 3; ++j)
+      {
+        beta[j] += jacobian[j] * residual;
+        for (int k = 0; k < 3; ++k)
+        {
+          alpha[j][k] += jacobian[j] * jacobian[k];
+        }
+      }
+    }
+
+    // damped step. Increase damping until chi2 decreases
+    bool improved = false;
+    Vector trial{};
+    double chi2_trial = chi2_current;
+    while (lambda < 1e10)
+    {
+      Matrix damped = alpha;
+      for (int j = 0; j < 3; ++j)
+      {
+        damped[j][j] += lambda * std::max(alpha[j][j], 1e-12);
+      }
+
+      Vector step{};
+      if (solve(damped, beta, step))
+      {
+        for (int j = 0; j < 3; ++j)
+        {
+          trial[j] = par[j] + step[j];
+        }
+        trial[1] = std::clamp(trial[1], tmin, tmax);
+        chi2_trial = chi2(trial[0], trial[1], trial[2]);
+        if (chi2_trial <= chi2_current)
+        {
+          improved = true;
+          lambda = std::max(lambda * 0.1, 1e-12);
+          break;
+        }
+      }
+      lambda *= 10;
+    }
+
+    // no step decreases chi2: we are at the minimum
+    if (!improved)
+    {
+      result.status = 0;
+      break;
+    }
+
+    // converged if chi2 or parameters no longer change
+    const double delta = chi2_current - chi2_trial;
+    const bool small_step =
+        std::abs(trial[0] - par[0]) <= m_tolerance * (std::abs(par[0]) + 1) &&
+        std::abs(trial[1] - par[1]) <= m_tolerance * (std::abs(par[1]) + 1) &&
+        std::abs(trial[2] - par[2]) <= m_tolerance * (std::abs(par[2]) + 1);
+    par = trial;
+    chi2_current = chi2_trial;
+    if (small_step || delta <= m_tolerance * chi2_current + 1e-12)
+    {
+      result.status = 0;
+      break;
+    }
+  }
+
+  result.amplitude = par[0];
+  result.time = par[1];
+  result.pedestal = par[2];
+  result.chi2 = chi2_current;
+  return result;
+}
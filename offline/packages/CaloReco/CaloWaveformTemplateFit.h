@@ -0,0 +1,82 @@
+#ifndef CALORECO_CALOWAVEFORMTEMPLATEFIT_H
+#define CALORECO_CALOWAVEFORMTEMPLATEFIT_H
+
+#include <vector>
+
+// Native template fit of calorimeter waveforms.
+// The model is amplitude * template(x - time) + pedestal, where the template is
+// linearly interpolated between bin centers, as in TH1::Interpolate.
+// The chi2 (unit errors) is minimized with a Levenberg-Marquardt solver on the three parameters,
+// with the time restricted to a range.
+// Data and tabulated template are stored in vectors that are reused from one fit to the next,
+// so that fitting does not allocate once the object has been used for a few channels.
+// One object is needed per concurrent fit.
+class CaloWaveformTemplateFit
+{
+ public:
+  struct Result
+  {
+    double amplitude{0};
+    double time{0};
+    double pedestal{0};
+    double chi2{0};
+    // 0 if the fit converged
+    int status{1};
+  };
+
+  CaloWaveformTemplateFit() = default;
+
+  // set tabulated template, from bin contents, first bin center and (uniform) bin width
+  void set_template(const std::vector<double> &contents, double first_center, double bin_width);
+
+  // true if template is set
+  bool has_template() const { return !m_template.empty(); }
+
+  // template value and slope at a given position
+  double template_value(double x, double &slope) const;
+
+  // remove all data points
+  void clear_data()
+  {
+    m_x.clear();
+    m_y.clear();
+  }
+
+  // add one data point
+  void add_data(double x, double y)
+  {
+    m_x.push_back(x);
+    m_y.push_back(y);
+  }
+
+  // number of data points
+  unsigned int ndata() const { return m_x.size(); }
+
+  // fit data, starting from given amplitude, time and pedestal, with time limited to [tmin, tmax]
+  Result fit(double amplitude, double time, double pedestal, double tmin, double tmax) const;
+
+  // chi2 for given parameters
+  double chi2(double amplitude, double time, double pedestal) const;
+
+  void set_max_iterations(int value) { m_max_iterations = value; }
+  void set_tolerance(double value) { m_tolerance = value; }
+
+ private:
+  // tabulated template
+  std::vector<double> m_template;
+  double m_first_center{0};
+  double m_bin_width{1};
+  double m_inv_bin_width{1};
+
+  // data points
+  std::vector<double> m_x;
+  std::vector<double> m_y;
+
+  // maximum number of Levenberg-Marquardt iterations
+  int m_max_iterations{200};
+
+  // relative tolerance on chi2 and parameters, for convergence
+  double m_tolerance{1e-8};
+};
+
+#endif
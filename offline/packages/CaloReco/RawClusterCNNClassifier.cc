@@ -28,7 +28,9 @@ I trained a crappy CNN to classify EMCal clusters as photon or not photon. S.Li
 #include <phool/onnxlib.h>
 #include <phool/phool.h>
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 RawClusterCNNClassifier::RawClusterCNNClassifier(const std::string &name)
@@ -36,15 +38,18 @@ RawClusterCNNClassifier::RawClusterCNNClassifier(const std::string &name)
 {
 }
 
-RawClusterCNNClassifier::~RawClusterCNNClassifier()
-{
-  delete onnxmodule;
-}
+RawClusterCNNClassifier::~RawClusterCNNClassifier() = default;
 
 int RawClusterCNNClassifier::Init(PHCompositeNode *topNode)
 {
   // init the onnx model
-  onnxmodule = onnxSession(m_modelPath,Verbosity());
+  m_onnx = std::make_unique<onnxlib::Context>(m_modelPath, m_onnx_threads, Verbosity());
+  if (m_onnx->n_input() != inputDimx * inputDimy * inputDimz || m_onnx->n_output() != outputDim)
+  {
+    std::cout << PHWHERE << " model " << m_modelPath << " has " << m_onnx->n_input() << " inputs and " << m_onnx->n_output()
+              << " outputs, expected " << inputDimx * inputDimy * inputDimz << " and " << outputDim << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
 
   if (m_inputNodeName == m_outputNodeName)
   {
@@ -98,6 +103,10 @@ int RawClusterCNNClassifier::process_event(PHCompositeNode *topNode)
     return Fun4AllReturnCodes::ABORTEVENT;
   }
 
+  // inputs of all clusters to classify, inferred in one go after the loop
+  std::vector<RawCluster *> classified_clusters;
+  m_input.clear();
+
   RawClusterContainer::Map clusterMap = _clusters->getClustersMap();
   for (auto &clusterPair : clusterMap)
   {
@@ -191,10 +200,19 @@ int RawClusterCNNClassifier::process_event(PHCompositeNode *topNode)
         }
       }
     }
-    std::vector<float> prob = onnxInference(onnxmodule, input, 1, inputDimx, inputDimy, inputDimz, outputDim);
-    // std::cout << "new prob: " << prob[0] << "ET: " << ET << " original prob: " << recoCluster->get_prob() << std::endl;
-    // inplace change for the prob for now
-    recoCluster->set_prob(prob[0]);
+    classified_clusters.push_back(recoCluster);
+    m_input.insert(m_input.end(), input.begin(), input.end());
+  }
+
+  if (!classified_clusters.empty())
+  {
+    std::copy(m_input.begin(), m_input.end(), m_onnx->input(classified_clusters.size()));
+    const std::vector<float> &prob = m_onnx->run();
+    for (size_t i = 0; i < classified_clusters.size(); ++i)
+    {
+      // inplace change for the prob for now
+      classified_clusters[i]->set_prob(prob[i * outputDim]);
+    }
   }
 
   return Fun4AllReturnCodes::EVENT_OK;
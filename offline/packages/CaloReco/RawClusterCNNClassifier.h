@@ -5,6 +5,10 @@
 
 #include <phool/onnxlib.h>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 class PHCompositeNode;
 class RawClusterContainer;
 
@@ -29,10 +33,16 @@ class RawClusterCNNClassifier : public SubsysReco
 
   void set_min_cluster_e(const float min_cluster_e) { m_min_cluster_e = min_cluster_e; }
 
+  // intra op threads used by the onnx runtime
+  void set_onnx_threads(const int nthreads) { m_onnx_threads = nthreads; }
+
  private:
   void CreateNodes(PHCompositeNode* topNode);
 
-  Ort::Session *onnxmodule{nullptr};
+  // all clusters of an event are classified in one batch
+  std::unique_ptr<onnxlib::Context> m_onnx;
+  int m_onnx_threads{1};
+  std::vector<float> m_input;
   const int inputDimx{5};
   const int inputDimy{5};
   const int inputDimz{1};
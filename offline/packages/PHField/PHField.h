@@ -3,6 +3,8 @@
 
 // units of this class. To convert internal value to Geant4/CLHEP units for fast access
 
+#include <cstddef>
+
 //! \brief transient object for field storage and access
 class PHField
 {
@@ -30,6 +32,24 @@ class PHField
       double *Bfield) const
   { return GetFieldValue( Point, Bfield ); }
 
+  //! batch access to field values
+  /*!
+   * @param[in]  Points  n space time coordinates, stored contiguously as x, y, z, t in Geant4/CLHEP units
+   * @param[out] Bfields n field values, stored contiguously as Bx, By, Bz in Geant4/CLHEP units
+   * @param[in]  n       number of points
+   * By default, loops over GetFieldValue. Overloaded by fields that provide a faster batch implementation
+   */
+  virtual void GetFieldValues(
+      const double *Points,
+      double *Bfields,
+      std::size_t n) const
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      GetFieldValue(Points + 4 * i, Bfields + 3 * i);
+    }
+  }
+
   //! verbosity
   void Verbosity(const int i) { m_Verbosity = i; }
 
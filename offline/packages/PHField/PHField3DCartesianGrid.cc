@@ -0,0 +1,331 @@
+#include "PHField3DCartesianGrid.h"
+
+#include <phool/phool.h>
+
+#include <TDirectory.h>  // for TDirectory, gDirectory
+#include <TFile.h>
+#include <TNtuple.h>
+#include <TSystem.h>
+
+#include <Geant4/G4SystemOfUnits.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+namespace
+{
+  //! number of points processed together in GetFieldValues
+  constexpr std::size_t block_size = 64;
+
+  //! remove duplicates from a list of node positions
+  std::vector<float> sorted_unique(std::vector<float> values)
+  {
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    return values;
+  }
+}  // namespace
+
+//_____________________________________________________________
+void PHField3DCartesianGrid::Axis::set_nodes(const std::vector<float> &nodes)
+{
+  m_nodes.assign(nodes.begin(), nodes.end());
+  m_min = m_nodes.front();
+  m_max = m_nodes.back();
+  m_step = (m_max - m_min) / (m_nodes.size() - 1);
+  m_inv_step = 1. / m_step;
+}
+
+//_____________________________________________________________
+int PHField3DCartesianGrid::Axis::find_node(float value) const
+{
+  const auto iter = std::lower_bound(m_nodes.begin(), m_nodes.end(), static_cast<double>(value));
+  return (iter == m_nodes.end() || *iter != value) ? -1 : iter - m_nodes.begin();
+}
+
+//_____________________________________________________________
+void PHField3DCartesianGrid::Axis::locate(double value, int &index_lo, int &index_hi, double &fraction) const
+{
+  // first guess from regular spacing, then correct by at most one node for rounding and small irregularities.
+  // Corrections are written without branches, since they are hard to predict
+  const int last = size() - 1;
+  int index = std::clamp(static_cast<int>(std::ceil((value - m_min) * m_inv_step)), 0, last);
+  index -= (index > 0 && m_nodes[index - 1] >= value);
+  index += (index < last && m_nodes[index] < value);
+
+  index_hi = index;
+  index_lo = index > 0 ? index - 1 : index;
+  fraction = (value - m_nodes[index_lo]) / m_step;
+}
+
+//_____________________________________________________________
+PHField3DCartesianGrid::PHField3DCartesianGrid(const std::string &fname, const float magfield_rescale, const float innerradius, const float outerradius, const float size_z)
+  : m_filename(fname)
+{
+  std::cout << "PHField3DCartesianGrid::PHField3DCartesianGrid" << std::endl;
+  std::cout << "\n================ Begin Construct Mag Field =====================" << std::endl;
+
+  // open file
+  TFile *rootinput = TFile::Open(m_filename.c_str());
+  if (!rootinput)
+  {
+    std::cout << "\n could not open " << m_filename << " exiting now" << std::endl;
+    gSystem->Exit(1);
+    exit(1);
+  }
+  std::cout << "\n ---> "
+               "Reading the field grid from "
+            << m_filename << " ... " << std::endl;
+
+  //  get root NTuple objects
+  TNtuple *field_map = nullptr;
+  rootinput->GetObject("fieldmap", field_map);
+  if (field_map == nullptr)
+  {
+    std::cout << PHWHERE << " Could not load fieldmap ntuple from "
+              << m_filename << " exiting now" << std::endl;
+    gSystem->Exit(1);
+    exit(1);
+  }
+  Float_t ROOT_X;
+  Float_t ROOT_Y;
+  Float_t ROOT_Z;
+  Float_t ROOT_BX;
+  Float_t ROOT_BY;
+  Float_t ROOT_BZ;
+  field_map->SetBranchAddress("x", &ROOT_X);
+  field_map->SetBranchAddress("y", &ROOT_Y);
+  field_map->SetBranchAddress("z", &ROOT_Z);
+  field_map->SetBranchAddress("bx", &ROOT_BX);
+  field_map->SetBranchAddress("by", &ROOT_BY);
+  field_map->SetBranchAddress("bz", &ROOT_BZ);
+
+  // first pass: store all entries, using the same float conversion as PHField3DCartesian
+  const auto entries = field_map->GetEntries();
+  std::vector<float> xvals;
+  std::vector<float> yvals;
+  std::vector<float> zvals;
+  std::vector<float> bvals;
+  std::vector<unsigned char> selected;
+  xvals.reserve(entries);
+  yvals.reserve(entries);
+  zvals.reserve(entries);
+  bvals.reserve(3 * entries);
+  selected.reserve(entries);
+  for (int i = 0; i < entries; i++)
+  {
+    field_map->GetEntry(i);
+    xvals.push_back(ROOT_X * cm);
+    yvals.push_back(ROOT_Y * cm);
+    zvals.push_back(ROOT_Z * cm);
+    bvals.push_back(ROOT_BX * tesla * magfield_rescale);
+    bvals.push_back(ROOT_BY * tesla * magfield_rescale);
+    bvals.push_back(ROOT_BZ * tesla * magfield_rescale);
+
+    const double r = std::sqrt(ROOT_X * cm * ROOT_X * cm + ROOT_Y * cm * ROOT_Y * cm);
+    selected.push_back((r >= innerradius && r <= outerradius) || std::abs(ROOT_Z * cm) > size_z);
+  }
+  delete field_map;
+  delete rootinput;
+
+  if (xvals.empty())
+  {
+    std::cout << PHWHERE << " empty fieldmap ntuple in " << m_filename << " exiting now" << std::endl;
+    gSystem->Exit(1);
+    exit(1);
+  }
+
+  // build axes
+  m_x.set_nodes(sorted_unique(xvals));
+  m_y.set_nodes(sorted_unique(yvals));
+  m_z.set_nodes(sorted_unique(zvals));
+
+  // check grid regularity. Interpolation uses the actual node positions, but cell location assumes regular spacing
+  for (const auto *axis : {&m_x, &m_y, &m_z})
+  {
+    for (int i = 0; i < axis->size(); ++i)
+    {
+      if (std::abs(axis->m_nodes[i] - (axis->m_min + i * axis->m_step)) > 0.01 * axis->m_step)
+      {
+        std::cout << PHWHERE << " non regular grid spacing in " << m_filename
+                  << " node " << i << " position: " << axis->m_nodes[i] / cm
+                  << " expected: " << (axis->m_min + i * axis->m_step) / cm << std::endl;
+        break;
+      }
+    }
+  }
+
+  // second pass: fill dense grid
+  // nodes that are not filled are set to NaN, which propagates to any interpolation that uses them
+  const std::size_t nnodes = static_cast<std::size_t>(m_x.size()) * m_y.size() * m_z.size();
+  m_field.assign(3 * nnodes, std::numeric_limits<float>::quiet_NaN());
+  std::size_t nfilled = 0;
+  for (std::size_t i = 0; i < xvals.size(); ++i)
+  {
+    if (!selected[i])
+    {
+      continue;
+    }
+
+    const auto node = index(m_x.find_node(xvals[i]), m_y.find_node(yvals[i]), m_z.find_node(zvals[i]));
+    std::copy(&bvals[3 * i], &bvals[3 * i] + 3, &m_field[3 * node]);
+    ++nfilled;
+  }
+
+  if (Verbosity() > 0)
+  {
+    std::cout << "PHField3DCartesianGrid - grid: " << m_x.size() << "x" << m_y.size() << "x" << m_z.size()
+              << " nodes: " << nnodes
+              << " filled: " << nfilled
+              << std::endl;
+  }
+
+  std::cout << "\n================= End Construct Mag Field ======================\n"
+            << std::endl;
+}
+
+//_____________________________________________________________
+void PHField3DCartesianGrid::locate(const double *point, Cell &cell) const
+{
+  const double &x = point[0];
+  const double &y = point[1];
+  const double &z = point[2];
+
+  cell.valid = false;
+  if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z))
+  {
+    static std::atomic<int> ifirst = 0;
+    if (ifirst++ < 10)
+    {
+      std::cout << "PHField3DCartesianGrid::GetFieldValue: "
+                << "Invalid coordinates: "
+                << "x: " << x / cm
+                << ", y: " << y / cm
+                << ", z: " << z / cm
+                << " bailing out returning zero bfield"
+                << std::endl;
+    }
+    return;
+  }
+
+  if (x < m_x.m_min || x > m_x.m_max ||
+      y < m_y.m_min || y > m_y.m_max ||
+      z < m_z.m_min || z > m_z.m_max)
+  {
+    return;
+  }
+
+  int ix[2];
+  int iy[2];
+  int iz[2];
+  m_x.locate(x, ix[0], ix[1], cell.fraction[0]);
+  m_y.locate(y, iy[0], iy[1], cell.fraction[1]);
+  m_z.locate(z, iz[0], iz[1], cell.fraction[2]);
+
+  for (int i = 0; i < 2; ++i)
+  {
+    for (int j = 0; j < 2; ++j)
+    {
+      for (int k = 0; k < 2; ++k)
+      {
+        cell.corner[i][j][k] = index(ix[i], iy[j], iz[k]);
+      }
+    }
+  }
+
+  cell.valid = true;
+}
+
+//_____________________________________________________________
+void PHField3DCartesianGrid::interpolate(const Cell &cell, double *bfield) const
+{
+  // linear interpolation in cube, with weight (1-f) for the low node and f for the high node along each axis
+  const double fx[2] = {1. - cell.fraction[0], cell.fraction[0]};
+  const double fy[2] = {1. - cell.fraction[1], cell.fraction[1]};
+  const double fz[2] = {1. - cell.fraction[2], cell.fraction[2]};
+
+  double b[3] = {0, 0, 0};
+  for (int i = 0; i < 2; ++i)
+  {
+    for (int j = 0; j < 2; ++j)
+    {
+      for (int k = 0; k < 2; ++k)
+      {
+        const double weight = fx[i] * fy[j] * fz[k];
+        const float *value = &m_field[3 * cell.corner[i][j][k]];
+        b[0] += weight * value[0];
+        b[1] += weight * value[1];
+        b[2] += weight * value[2];
+      }
+    }
+  }
+
+  // missing nodes, e.g. outside of the selected radius, give NaN
+  if (!std::isfinite(b[0]) || !std::isfinite(b[1]) || !std::isfinite(b[2]))
+  {
+    if (Verbosity() > 0)
+    {
+      std::cout << PHWHERE << " missing grid node in " << m_filename << std::endl;
+    }
+    bfield[0] = 0.0;
+    bfield[1] = 0.0;
+    bfield[2] = 0.0;
+    return;
+  }
+
+  bfield[0] = b[0];
+  bfield[1] = b[1];
+  bfield[2] = b[2];
+}
+
+//_____________________________________________________________
+void PHField3DCartesianGrid::GetFieldValue(const double point[4], double *Bfield) const
+{
+  Cell cell;
+  locate(point, cell);
+  if (cell.valid)
+  {
+    interpolate(cell, Bfield);
+  }
+  else
+  {
+    Bfield[0] = 0.0;
+    Bfield[1] = 0.0;
+    Bfield[2] = 0.0;
+  }
+}
+
+//_____________________________________________________________
+void PHField3DCartesianGrid::GetFieldValues(const double *points, double *bfields, std::size_t n) const
+{
+  // process points by blocks, locating all cells first, then interpolating,
+  // so that the interpolation loop runs without branches on contiguous data
+  Cell cells[block_size];
+  for (std::size_t first = 0; first < n; first += block_size)
+  {
+    const std::size_t count = std::min(block_size, n - first);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      locate(points + 4 * (first + i), cells[i]);
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      double *bfield = bfields + 3 * (first + i);
+      if (cells[i].valid)
+      {
+        interpolate(cells[i], bfield);
+      }
+      else
+      {
+        bfield[0] = 0.0;
+        bfield[1] = 0.0;
+        bfield[2] = 0.0;
+      }
+    }
+  }
+}
@@ -0,0 +1,113 @@
+#ifndef PHFIELD_PHFIELD3DCARTESIANGRID_H
+#define PHFIELD_PHFIELD3DCARTESIANGRID_H
+
+#include "PHField.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//! 3D field map expressed in Cartesian coordinates, stored on a dense regular grid
+/*!
+ * Reads the same fieldmap ntuple as PHField3DCartesian and gives the same trilinear interpolation,
+ * but field values are stored in a flat array indexed by grid cell,
+ * so that locating the 8 interpolation corners requires no map nor set lookup.
+ * There is no internal cache, so GetFieldValue is thread safe and GetFieldValue_nocache is identical.
+ * GetFieldValues evaluates the field for a batch of points in two passes, cell location then interpolation.
+ */
+class PHField3DCartesianGrid : public PHField
+{
+ public:
+  //! constructor
+  explicit PHField3DCartesianGrid(const std::string &fname, const float magfield_rescale = 1.0, const float innerradius = 0, const float outerradius = 1.e10, const float size_z = 1.e10);
+
+  //! destructor
+  ~PHField3DCartesianGrid() override = default;
+
+  //! access field value
+  //! Follow the convention of G4ElectroMagneticField
+  //! @param[in]  Point   space time coordinate. x, y, z, t in Geant4/CLHEP units
+  //! @param[out] Bfield  field value. In the case of magnetic field, the order is Bx, By, Bz in in Geant4/CLHEP units
+  void GetFieldValue(const double Point[4], double *Bfield) const override;
+
+  //! same as GetFieldValue, since there is no cache
+  void GetFieldValue_nocache(const double Point[4], double *Bfield) const override
+  {
+    GetFieldValue(Point, Bfield);
+  }
+
+  //! batch access to field values
+  void GetFieldValues(const double *Points, double *Bfields, std::size_t n) const override;
+
+ private:
+  //! grid axis
+  class Axis
+  {
+   public:
+    //! node positions
+    std::vector<double> m_nodes;
+
+    //! first and last node
+    double m_min = 0;
+    double m_max = 0;
+
+    //! step size and its inverse
+    double m_step = 0;
+    double m_inv_step = 0;
+
+    //! number of nodes
+    int size() const { return m_nodes.size(); }
+
+    //! initialize from sorted, unique node positions
+    void set_nodes(const std::vector<float> &);
+
+    //! node index for a given position, -1 if not found
+    int find_node(float) const;
+
+    /*!
+     * locate interval containing a given value, assumed within range
+     * index_hi is the first node that is greater or equal to value,
+     * index_lo the one before, and fraction is the normalized distance from index_lo.
+     * This matches the convention of PHField3DCartesian
+     */
+    void locate(double value, int &index_lo, int &index_hi, double &fraction) const;
+  };
+
+  //! cell location for a given point
+  struct Cell
+  {
+    //! corner index, with (lo, hi) along each axis
+    std::size_t corner[2][2][2]{};
+
+    //! fractional position along each axis
+    double fraction[3]{};
+
+    //! true if point is inside the grid
+    bool valid = false;
+  };
+
+  //! locate cell containing a given point
+  void locate(const double *point, Cell &) const;
+
+  //! interpolate field in cell
+  void interpolate(const Cell &, double *bfield) const;
+
+  //! node index
+  std::size_t index(int ix, int iy, int iz) const
+  {
+    return (static_cast<std::size_t>(ix) * m_y.size() + iy) * m_z.size() + iz;
+  }
+
+  std::string m_filename;
+
+  //! grid axes
+  Axis m_x;
+  Axis m_y;
+  Axis m_z;
+
+  //! field values, three components per node. NaN for nodes that are not in the fieldmap
+  /*! nodes outside of the inner and outer radius are not stored */
+  std::vector<float> m_field;
+};
+
+#endif
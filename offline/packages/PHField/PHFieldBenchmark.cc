@@ -0,0 +1,178 @@
+#include "PHFieldBenchmark.h"
+
+#include "PHField.h"
+#include "PHField3DCartesian.h"
+#include "PHField3DCartesianGrid.h"
+
+#include <Geant4/G4SystemOfUnits.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+namespace
+{
+  //! points, stored as x, y, z, t
+  using PointList = std::vector<double>;
+
+  //! field values, stored as bx, by, bz
+  using FieldList = std::vector<double>;
+
+  //! uniformly distributed random points
+  PointList random_points(const PHFieldBenchmark::Config& config, std::mt19937& engine)
+  {
+    std::uniform_real_distribution<double> xdist(config.xmin * cm, config.xmax * cm);
+    std::uniform_real_distribution<double> ydist(config.ymin * cm, config.ymax * cm);
+    std::uniform_real_distribution<double> zdist(config.zmin * cm, config.zmax * cm);
+
+    PointList points;
+    points.reserve(4 * config.npoints);
+    for (unsigned int i = 0; i < config.npoints; ++i)
+    {
+      points.insert(points.end(), {xdist(engine), ydist(engine), zdist(engine), 0});
+    }
+    return points;
+  }
+
+  //! points along straight segments with random origin and direction
+  PointList stepping_points(const PHFieldBenchmark::Config& config, std::mt19937& engine)
+  {
+    std::uniform_real_distribution<double> xdist(config.xmin * cm, config.xmax * cm);
+    std::uniform_real_distribution<double> ydist(config.ymin * cm, config.ymax * cm);
+    std::uniform_real_distribution<double> zdist(config.zmin * cm, config.zmax * cm);
+    std::normal_distribution<double> direction;
+
+    const unsigned int nsteps = std::max(1U, config.nsteps);
+    PointList points;
+    points.reserve(4 * config.npoints);
+    for (unsigned int i = 0; i < config.npoints; i += nsteps)
+    {
+      double position[3] = {xdist(engine), ydist(engine), zdist(engine)};
+      double u[3] = {direction(engine), direction(engine), direction(engine)};
+      const double norm = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+      for (auto& value : u)
+      {
+        value *= config.step * cm / norm;
+      }
+
+      for (unsigned int j = 0; j < nsteps && i + j < config.npoints; ++j)
+      {
+        points.insert(points.end(), {position[0], position[1], position[2], 0});
+        for (int k = 0; k < 3; ++k)
+        {
+          position[k] += u[k];
+        }
+      }
+    }
+    return points;
+  }
+
+  //! time per point, in ns
+  double time_per_point(const std::function<void()>& function, std::size_t npoints)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto stop = std::chrono::steady_clock::now();
+    return npoints ? std::chrono::duration<double, std::nano>(stop - start).count() / npoints : 0;
+  }
+
+  //! benchmark one sample. Return maximum absolute difference, in tesla
+  double compare_sample(const std::string& name, const PHField& reference, const PHField& candidate, const PointList& points, std::ostream& out)
+  {
+    const std::size_t npoints = points.size() / 4;
+    FieldList reference_values(3 * npoints);
+    FieldList candidate_values(3 * npoints);
+    FieldList candidate_batch_values(3 * npoints);
+
+    // timing
+    const double t_reference = time_per_point([&]()
+                                              {
+                                                for (std::size_t i = 0; i < npoints; ++i)
+                                                {
+                                                  reference.GetFieldValue(&points[4 * i], &reference_values[3 * i]);
+                                                }
+                                              },
+                                              npoints);
+
+    const double t_reference_nocache = time_per_point([&]()
+                                                      {
+                                                        for (std::size_t i = 0; i < npoints; ++i)
+                                                        {
+                                                          reference.GetFieldValue_nocache(&points[4 * i], &reference_values[3 * i]);
+                                                        }
+                                                      },
+                                                      npoints);
+
+    const double t_candidate = time_per_point([&]()
+                                              {
+                                                for (std::size_t i = 0; i < npoints; ++i)
+                                                {
+                                                  candidate.GetFieldValue(&points[4 * i], &candidate_values[3 * i]);
+                                                }
+                                              },
+                                              npoints);
+
+    const double t_candidate_nocache = time_per_point([&]()
+                                                      {
+                                                        for (std::size_t i = 0; i < npoints; ++i)
+                                                        {
+                                                          candidate.GetFieldValue_nocache(&points[4 * i], &candidate_values[3 * i]);
+                                                        }
+                                                      },
+                                                      npoints);
+
+    const double t_candidate_batch = time_per_point([&]()
+                                                    { candidate.GetFieldValues(points.data(), candidate_batch_values.data(), npoints); },
+                                                    npoints);
+
+    // numerics
+    double max_difference = 0;
+    double max_batch_difference = 0;
+    double sum2 = 0;
+    double max_field = 0;
+    for (std::size_t i = 0; i < 3 * npoints; ++i)
+    {
+      const double difference = std::abs(candidate_values[i] - reference_values[i]) / tesla;
+      max_difference = std::max(max_difference, difference);
+      max_batch_difference = std::max(max_batch_difference, std::abs(candidate_batch_values[i] - candidate_values[i]) / tesla);
+      sum2 += difference * difference;
+      max_field = std::max(max_field, std::abs(reference_values[i]) / tesla);
+    }
+    const double rms = npoints ? std::sqrt(sum2 / (3 * npoints)) : 0;
+
+    out << "PHFieldBenchmark - " << name << " - points: " << npoints << std::endl;
+    out << "  reference GetFieldValue:         " << std::setw(8) << t_reference << " ns/point" << std::endl;
+    out << "  reference GetFieldValue_nocache: " << std::setw(8) << t_reference_nocache << " ns/point" << std::endl;
+    out << "  candidate GetFieldValue:         " << std::setw(8) << t_candidate << " ns/point" << std::endl;
+    out << "  candidate GetFieldValue_nocache: " << std::setw(8) << t_candidate_nocache << " ns/point" << std::endl;
+    out << "  candidate GetFieldValues:        " << std::setw(8) << t_candidate_batch << " ns/point" << std::endl;
+    out << "  max |B|: " << max_field << " T"
+        << " max difference: " << max_difference << " T"
+        << " rms difference: " << rms << " T"
+        << " max batch difference: " << max_batch_difference << " T"
+        << std::endl;
+
+    return std::max(max_difference, max_batch_difference);
+  }
+}  // namespace
+
+//_____________________________________________________________
+double PHFieldBenchmark::Compare(const PHField& reference, const PHField& candidate, const Config& config, std::ostream& out)
+{
+  std::mt19937 engine(config.seed);
+  const double random_difference = compare_sample("random points", reference, candidate, random_points(config, engine), out);
+  const double stepping_difference = compare_sample("stepping points", reference, candidate, stepping_points(config, engine), out);
+  return std::max(random_difference, stepping_difference);
+}
+
+//_____________________________________________________________
+double PHFieldBenchmark::CompareCartesian(const std::string& filename, const float magfield_rescale, const Config& config, std::ostream& out)
+{
+  const PHField3DCartesian reference(filename, magfield_rescale);
+  const PHField3DCartesianGrid candidate(filename, magfield_rescale);
+  return Compare(reference, candidate, config, out);
+}
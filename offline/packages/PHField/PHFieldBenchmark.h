@@ -0,0 +1,61 @@
+#ifndef PHFIELD_PHFIELDBENCHMARK_H
+#define PHFIELD_PHFIELDBENCHMARK_H
+
+#include <iostream>
+#include <string>
+
+class PHField;
+
+//! benchmark configuration. Positions are in cm
+struct PHFieldBenchmarkConfig
+{
+  //! sampled volume
+  double xmin = -80;
+  double xmax = 80;
+  double ymin = -80;
+  double ymax = 80;
+  double zmin = -150;
+  double zmax = 150;
+
+  //! number of random points
+  unsigned int npoints = 1000000;
+
+  //! number of steps per straight segment
+  unsigned int nsteps = 100;
+
+  //! step length
+  double step = 0.5;
+
+  //! random seed
+  unsigned int seed = 0;
+};
+
+//! compare speed and numerical agreement of two field implementations
+/*!
+ * Field values are evaluated at uniformly distributed random points,
+ * and along straight segments with small steps, which mimics Geant4 stepping and track propagation.
+ * Reported are the time per point for GetFieldValue, GetFieldValue_nocache and GetFieldValues,
+ * and the maximum and rms difference between the two fields.
+ *
+ * Example, from a ROOT macro:
+ * PHFieldBenchmark::CompareCartesian("sphenix3dtrackingmapxyz.root");
+ */
+class PHFieldBenchmark
+{
+ public:
+  //! benchmark configuration
+  using Config = PHFieldBenchmarkConfig;
+
+  //! compare candidate field to reference. Return maximum absolute difference, in tesla
+  static double Compare(const PHField& reference, const PHField& candidate, const Config& = Config(), std::ostream& = std::cout);
+
+  //! build PHField3DCartesian and PHField3DCartesianGrid from the same fieldmap and compare
+  static double CompareCartesian(const std::string& filename, const float magfield_rescale = 1.0, const Config& = Config(), std::ostream& = std::cout);
+
+ private:
+  // static tool sets only
+  PHFieldBenchmark() = delete;
+  ~PHFieldBenchmark() = delete;
+};
+
+#endif
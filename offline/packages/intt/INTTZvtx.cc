@@ -62,10 +62,8 @@ INTTZvtx::INTTZvtx(const std::string& runType,
   N_comb_phi.clear();
   // eff_N_comb.clear(); eff_z_mid.clear(); eff_N_comb_e.clear(); eff_z_range.clear(); // note : eff_sig
 
-  inner_clu_phi_map.clear();
-  outer_clu_phi_map.clear();
-  inner_clu_phi_map = std::vector<std::vector<std::pair<bool, clu_info>>>(360);
-  outer_clu_phi_map = std::vector<std::vector<std::pair<bool, clu_info>>>(360);
+  inner_clu_sorted.clear();
+  outer_clu_sorted.clear();
 
   ///////////
   //    Init();
@@ -162,14 +160,17 @@ void INTTZvtx::Init()
 void INTTZvtx::InitHist()
 {
   // histos for z-vertex calculation
-  evt_possible_z = new TH1F("evt_possible_z", "evt_possible_z", 50, evt_possible_z_range.first, evt_possible_z_range.second);
-  evt_possible_z->SetLineWidth(1);
-  evt_possible_z->GetXaxis()->SetTitle("Z [mm]");
-  evt_possible_z->GetYaxis()->SetTitle("Entry");
-
-  int N = 1200;        // note : N bins for each side, regardless the bin at zero
-  double width = 0.5;  // note : bin width with the unit [mm]
-  line_breakdown_hist = new TH1F("line_breakdown_hist", "line_breakdown_hist", 2 * N + 1, -1 * (width * N + width / 2.), width * N + width / 2.);
+  // note : the z candidates are counted in evt_possible_z_content, the histogram is only for QA and the event display
+  if (draw_event_display || m_enable_qa)
+  {
+    evt_possible_z = new TH1F("evt_possible_z", "evt_possible_z", evt_possible_z_nbins, evt_possible_z_range.first, evt_possible_z_range.second);
+    evt_possible_z->SetLineWidth(1);
+    evt_possible_z->GetXaxis()->SetTitle("Z [mm]");
+    evt_possible_z->GetYaxis()->SetTitle("Entry");
+  }
+
+  // note : the lines are counted in line_breakdown_content, the histogram is only filled from it for the gaussian fit
+  line_breakdown_hist = new TH1F("line_breakdown_hist", "line_breakdown_hist", line_breakdown_nbins, line_breakdown_min, -line_breakdown_min);
   line_breakdown_hist->SetLineWidth(1);
   line_breakdown_hist->GetXaxis()->SetTitle("Z [mm]");
   line_breakdown_hist->GetYaxis()->SetTitle("Entry");
@@ -623,189 +624,131 @@ bool INTTZvtx::ProcessEvt(
   //--std::cout<<"--1--"<<std::endl;
   //-----------------
   // cluster pair
-  // note : put the cluster into the phi map, the first bool is for the cluster usage.
-  // note : false means the cluster is not used
-  double Clus_InnerPhi_Offset = 0;  // note : the vertex in XY is not at zero, so the "offset" moves the offset back to the orign which is (0,0)
-  double Clus_OuterPhi_Offset = 0;  // note : the vertex in XY is not at zero, so the "offset" moves the offset back to the orign which is (0,0)
-  for (auto& inner_i : temp_sPH_inner_nocolumn_vec)
-  {
-    Clus_InnerPhi_Offset = (inner_i.y - beam_origin.second < 0)
-                               ? atan2(inner_i.y - beam_origin.second,
-                                       inner_i.x - beam_origin.first) *
-                                         (180. / M_PI) +
-                                     360
-                               : atan2(inner_i.y - beam_origin.second,
-                                       inner_i.x - beam_origin.first) *
-                                     (180. / M_PI);
-
-    // std::cout<<"inner clu phi : "<<Clus_InnerPhi_Offset<<" origin: "<< temp_sPH_inner_nocolumn_vec[inner_i].phi <<std::endl;
-    // std::cout<<" ("<<Clus_InnerPhi_Offset<<", "<< temp_sPH_inner_nocolumn_vec[inner_i].phi<<")" <<std::endl;
-    //
-    inner_clu_phi_map[int(Clus_InnerPhi_Offset)].emplace_back(false, inner_i);
-
-    if (inner_i.z > 0)
-    {
-      out_N_cluster_north += 1;
-    }
-    else
-    {
-      out_N_cluster_south += 1;
-    }
-  }
-  //--std::cout<<"--2--"<<std::endl;
-  for (auto& outer_i : temp_sPH_outer_nocolumn_vec)
+  // note : compute the cluster phi w.r.t. the beam origin once, and sort the clusters in phi
+  // note : the vertex in XY is not at zero, so the "offset" moves the offset back to the orign which is (0,0)
+  auto sort_clusters = [this](const std::vector<clu_info>& clusters, std::vector<tracklet_clu>& sorted)
   {
-    Clus_OuterPhi_Offset = (outer_i.y - beam_origin.second < 0)
-                               ? atan2(outer_i.y - beam_origin.second,
-                                       outer_i.x - beam_origin.first) *
-                                         (180. / M_PI) +
-                                     360
-                               : atan2(outer_i.y - beam_origin.second,
-                                       outer_i.x - beam_origin.first) *
-                                     (180. / M_PI);
-
-    outer_clu_phi_map[int(Clus_OuterPhi_Offset)].emplace_back(false, outer_i);
-
-    if (outer_i.z > 0)
+    sorted.clear();
+    sorted.reserve(clusters.size());
+    for (const auto& clu : clusters)
     {
-      out_N_cluster_north += 1;
-    }
-    else
-    {
-      out_N_cluster_south += 1;
+      const double dx = clu.x - beam_origin.first;
+      const double dy = clu.y - beam_origin.second;
+      const double phi = (dy < 0) ? atan2(dy, dx) * (180. / M_PI) + 360 : atan2(dy, dx) * (180. / M_PI);
+      sorted.push_back({phi, clu.x, clu.y, get_radius(dx, dy), clu.z});
+
+      if (clu.z > 0)
+      {
+        out_N_cluster_north += 1;
+      }
+      else
+      {
+        out_N_cluster_south += 1;
+      }
     }
-  }
+    std::sort(sorted.begin(), sorted.end(), [](const tracklet_clu& a, const tracklet_clu& b)
+              { return a.phi < b.phi; });
+  };
+  sort_clusters(temp_sPH_inner_nocolumn_vec, inner_clu_sorted);
+  sort_clusters(temp_sPH_outer_nocolumn_vec, outer_clu_sorted);
 
   //--std::cout<<"--3--"<<std::endl;
   ////
   // tracklet reconstruction from inner and outer clusters
+  // note : for each inner cluster, only the outer clusters within the phi window are considered.
+  // note : the event display shows the phi difference of all the nearby pairs, so the window is opened to 2 degrees for it
+  const double phi_window = (draw_event_display) ? std::max(phi_diff_cut, 2.) : phi_diff_cut;
   int good_pair_count = 0;
 
-  for (int inner_phi_i = 0; inner_phi_i < 360; inner_phi_i++)  // note : each phi cell (1 degree)
+  for (const auto& inner_clu : inner_clu_sorted)
   {
-    // note : N cluster in this phi cell
-    for (unsigned int inner_phi_clu_i = 0; inner_phi_clu_i < inner_clu_phi_map[inner_phi_i].size(); inner_phi_clu_i++)
+    // note : the window can wrap around 0/360 degree, scan it also shifted by one turn
+    for (const double shift : {0., 360., -360.})
     {
-      if (inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].first == true)
+      const double window_low = inner_clu.phi - phi_window + shift;
+      const double window_high = inner_clu.phi + phi_window + shift;
+      if (window_high < 0 || window_low >= 360)
       {
         continue;
       }
 
-      Clus_InnerPhi_Offset = (inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.y - beam_origin.second < 0)
-                                 ? atan2(inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.y - beam_origin.second,
-                                         inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.x - beam_origin.first) *
-                                           (180. / M_PI) +
-                                       360
-                                 : atan2(inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.y - beam_origin.second,
-                                         inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.x - beam_origin.first) *
-                                       (180. / M_PI);
-
-      // todo: change the outer phi scan range
-      // note : the outer phi index, -1, 0, 1
-      for (int scan_i = -1; scan_i < 2; scan_i++)
+      auto outer_itr = std::lower_bound(outer_clu_sorted.begin(), outer_clu_sorted.end(), window_low,
+                                        [](const tracklet_clu& clu, double value)
+                                        { return clu.phi < value; });
+      for (; outer_itr != outer_clu_sorted.end() && outer_itr->phi <= window_high; ++outer_itr)
       {
-        // int true_scan_i = ((inner_phi_i + scan_i) < 0)     ? 360 + (inner_phi_i + scan_i)
-        //                   : ((inner_phi_i + scan_i) > 359) ? (inner_phi_i + scan_i) - 360
-        //                                                    : inner_phi_i + scan_i;
-        // The following expression is longer but much easier to understand
-        int tmp = inner_phi_i + scan_i;
-        int true_scan_i;
-
-        if (tmp < 0)
-        {
-          true_scan_i = 360 + tmp;
-        }
-        else if (tmp > 359)
-        {
-          true_scan_i = tmp - 360;
-        }
-        else
+        const auto& outer_clu = *outer_itr;
+        double delta_phi = get_delta_phi(inner_clu.phi, outer_clu.phi);
+
+        if (draw_event_display)
         {
-          true_scan_i = tmp;
+          evt_phi_diff_1D->Fill(delta_phi);                         // QA
+          evt_phi_diff_inner_phi->Fill(inner_clu.phi, delta_phi);   // QA
+          evt_inner_outer_phi->Fill(inner_clu.phi, outer_clu.phi);  // QA
+
+          phi_diff_inner_phi->Fill(inner_clu.phi, delta_phi);  // QA
         }
-        // end of nested condition readable translation
-        // note : N clusters in that outer phi cell
-        for (unsigned int outer_phi_clu_i = 0; outer_phi_clu_i < outer_clu_phi_map[true_scan_i].size(); outer_phi_clu_i++)
+
+        if (fabs(delta_phi) < phi_diff_cut)
         {
-          if (outer_clu_phi_map[true_scan_i][outer_phi_clu_i].first == true)
+          double DCA_sign = calculateAngleBetweenVectors(
+              outer_clu.x, outer_clu.y,
+              inner_clu.x, inner_clu.y,
+              beam_origin.first, beam_origin.second);
+          if (m_enable_qa)
           {
-            continue;
+            dca_inner_phi->Fill(inner_clu.phi, DCA_sign);
           }
 
-          Clus_OuterPhi_Offset = (outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.y - beam_origin.second < 0)
-                                     ? atan2(outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.y - beam_origin.second,
-                                             outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.x - beam_origin.first) *
-                                               (180. / M_PI) +
-                                           360
-                                     : atan2(outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.y - beam_origin.second,
-                                             outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.x - beam_origin.first) *
-                                           (180. / M_PI);
-
-          double delta_phi = get_delta_phi(Clus_InnerPhi_Offset, Clus_OuterPhi_Offset);
-
-          if (draw_event_display)
+          if (DCA_cut.first < DCA_sign && DCA_sign < DCA_cut.second)
           {
-            evt_phi_diff_1D->Fill(delta_phi);                                       // QA
-            evt_phi_diff_inner_phi->Fill(Clus_InnerPhi_Offset, delta_phi);          // QA
-            evt_inner_outer_phi->Fill(Clus_InnerPhi_Offset, Clus_OuterPhi_Offset);  // QA
+            good_pair_count += 1;
+
+            // note : we basically transform the coordinate from cartesian to cylinder
+            // note : we should set the offset first, otherwise it provides the bias
+            // todo : which point should be used, DCA point or vertex xy ? Has to be studied
+            std::pair<double, double> z_range_info = Get_possible_zvtx(
+                0.,                          // get_radius(beam_origin.first,beam_origin.second),
+                {inner_clu.r, inner_clu.z},  // note : unsign radius
+                {outer_clu.r, outer_clu.z}   // note : unsign radius
+            );
+
+            // note : try to remove some crazy background candidates. Can be a todo
+            if (evt_possible_z_range.first < z_range_info.first && z_range_info.first < evt_possible_z_range.second)
+            {
+              N_comb.push_back(good_comb_id);
+              N_comb_e.push_back(0);
+              N_comb_phi.push_back(get_track_phi(inner_clu.phi, delta_phi));
+              z_mid.push_back(z_range_info.first);
+              z_range.push_back(z_range_info.second);
 
-            phi_diff_inner_phi->Fill(Clus_InnerPhi_Offset, delta_phi);  // QA
-          }
+              // note : same bin as TH1::Fill, the candidate is within the histogram range
+              evt_possible_z_content[1 + int(evt_possible_z_nbins * (z_range_info.first - evt_possible_z_range.first) / (evt_possible_z_range.second - evt_possible_z_range.first))] += 1;  // used for calculation
 
-          if (fabs(delta_phi) < phi_diff_cut)
-          {
-            double DCA_sign = calculateAngleBetweenVectors(
-                outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.x, outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.y,
-                inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.x, inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.y,
-                beam_origin.first, beam_origin.second);
-            if (m_enable_qa)
-            {
-              dca_inner_phi->Fill(Clus_InnerPhi_Offset, DCA_sign);
-            }
+              // note : fill the line_breakdwon as well as a vector for the width determination
+              line_breakdown({z_range_info.first - z_range_info.second,
+                              z_range_info.first + z_range_info.second});  // used for calculation
 
-            if (DCA_cut.first < DCA_sign && DCA_sign < DCA_cut.second)
-            {
-              good_pair_count += 1;
-              // used_outer_check[outer_i] = 1; //note : this outer cluster was already used!
-
-              // note : we basically transform the coordinate from cartesian to cylinder
-              // note : we should set the offset first, otherwise it provides the bias
-              // todo : which point should be used, DCA point or vertex xy ? Has to be studied
-              std::pair<double, double> z_range_info = Get_possible_zvtx(
-                  0.,  // get_radius(beam_origin.first,beam_origin.second),
-                  {get_radius(inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.x - beam_origin.first,
-                              inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.y - beam_origin.second),
-                   inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.z},  // note : unsign radius
-                  {get_radius(outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.x - beam_origin.first,
-                              outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.y - beam_origin.second),
-                   outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.z}  // note : unsign radius
-              );
-
-              // note : try to remove some crazy background candidates. Can be a todo
-              if (evt_possible_z_range.first < z_range_info.first && z_range_info.first < evt_possible_z_range.second)
-              {
-                N_comb.push_back(good_comb_id);
-                N_comb_e.push_back(0);
-                N_comb_phi.push_back(get_track_phi(Clus_InnerPhi_Offset, delta_phi));
-                z_mid.push_back(z_range_info.first);
-                z_range.push_back(z_range_info.second);
-
-                evt_possible_z->Fill(z_range_info.first);  // used for calculation
-
-                // note : fill the line_breakdwon histogram as well as a vector for the width determination
-                line_breakdown(line_breakdown_hist,  // used for calculation
-                               {z_range_info.first - z_range_info.second,
-                                z_range_info.first + z_range_info.second});
-
-                good_comb_id += 1;
-              }
+              good_comb_id += 1;
             }
           }
         }
       }  // note : end of outer clu loop
     }
-
   }  // note : end of inner clu loop
+
+  // note : number of lines covering each bin
+  int N_line = 0;
+  for (int i = 0; i < line_breakdown_nbins + 2; i++)
+  {
+    N_line += line_breakdown_step[i];
+    line_breakdown_content[i] = N_line;
+  }
+
+  if (draw_event_display || m_enable_qa)
+  {
+    evt_possible_z->SetContent(evt_possible_z_content.data());
+  }
   //--std::cout<<"--4--"<<std::endl;
 
   // if (event_i == 906) {
@@ -828,21 +771,26 @@ bool INTTZvtx::ProcessEvt(
   if (N_comb.size() > zvtx_cal_require)
   {
     //--std::cout<<"--4 1--"<<std::endl;
-    N_group_info = find_Ngroup(evt_possible_z);
-    N_group_info_detail = find_Ngroup(line_breakdown_hist);
+    N_group_info = find_Ngroup(evt_possible_z_content.data(), evt_possible_z_nbins, evt_possible_z_range.first,
+                               (evt_possible_z_range.second - evt_possible_z_range.first) / evt_possible_z_nbins);
+    N_group_info_detail = find_Ngroup(line_breakdown_content.data(), line_breakdown_nbins, line_breakdown_min, line_breakdown_width);
+
+    // note : the histogram is only the container for the fit
+    line_breakdown_hist->SetContent(line_breakdown_content.data());
+    const int LB_max_bin = get_max_bin(line_breakdown_content.data(), line_breakdown_nbins);
+    const double LB_max_content = line_breakdown_content[LB_max_bin];
+    const double LB_max_center = line_breakdown_hist->GetBinCenter(LB_max_bin);
 
     // note : first fit is for the width, so apply the constraints on the Gaussian offset
-    gaus_fit->SetParameters(line_breakdown_hist->GetBinContent(line_breakdown_hist->GetMaximumBin()),
-                            line_breakdown_hist->GetBinCenter(line_breakdown_hist->GetMaximumBin()),
+    gaus_fit->SetParameters(LB_max_content,
+                            LB_max_center,
                             40,
                             0);
     gaus_fit->SetParLimits(0, 0, 100000);  // note : size
     gaus_fit->SetParLimits(2, 5, 10000);   // note : Width
     gaus_fit->SetParLimits(3, 0, 10000);   // note : offset
     // todo : try to use single gaus to fit the distribution, and try to only fit the peak region (peak - 100 mm + peak + 100 mm)
-    line_breakdown_hist->Fit(gaus_fit, "NQ", "",
-                             line_breakdown_hist->GetBinCenter(line_breakdown_hist->GetMaximumBin()) - 90,
-                             line_breakdown_hist->GetBinCenter(line_breakdown_hist->GetMaximumBin()) + 90);
+    line_breakdown_hist->Fit(gaus_fit, "NQ", "", LB_max_center - 90, LB_max_center + 90);
     //----------------
     // 1st try z-vertex
     tight_offset_peak = gaus_fit->GetParameter(1);
@@ -851,14 +799,19 @@ bool INTTZvtx::ProcessEvt(
     double final_selection_widthU = (tight_offset_peak + tight_offset_width);
     double final_selection_widthD = (tight_offset_peak - tight_offset_width);
 
+    // note : the gaussian ratio is only used for QA and the event display
     double gaus_fit_offset = gaus_fit->GetParameter(3);
-    gaus_fit->SetParameter(3, 0);  // note : in order to calculate the integration
-    double gaus_ratio = (fabs(gaus_fit->GetParameter(0)) / gaus_fit->Integral(-600, 600)) / fabs(gaus_fit->GetParameter(2));
-    gaus_fit->SetParameter(3, gaus_fit_offset);  // note : put the offset back to the function
+    double gaus_ratio = -1;
+    if (m_enable_qa || draw_event_display)
+    {
+      gaus_fit->SetParameter(3, 0);  // note : in order to calculate the integration
+      gaus_ratio = (fabs(gaus_fit->GetParameter(0)) / gaus_fit->Integral(-600, 600)) / fabs(gaus_fit->GetParameter(2));
+      gaus_fit->SetParameter(3, gaus_fit_offset);  // note : put the offset back to the function
+    }
 
     // note : second fit is for the peak position, therefore, loose the constraints on the Gaussian offset
-    gaus_fit->SetParameters(line_breakdown_hist->GetBinContent(line_breakdown_hist->GetMaximumBin()),
-                            line_breakdown_hist->GetBinCenter(line_breakdown_hist->GetMaximumBin()),
+    gaus_fit->SetParameters(LB_max_content,
+                            LB_max_center,
                             40,
                             0);
 
@@ -866,9 +819,7 @@ bool INTTZvtx::ProcessEvt(
     gaus_fit->SetParLimits(2, 5, 10000);     // note : Width
     gaus_fit->SetParLimits(3, -200, 10000);  // note : offset
     // todo : try to use single gaus to fit the distribution, and try to only fit the peak region (peak - 100 mm + peak + 100 mm)
-    line_breakdown_hist->Fit(gaus_fit, "NQ", "",
-                             line_breakdown_hist->GetBinCenter(line_breakdown_hist->GetMaximumBin()) - 90,
-                             line_breakdown_hist->GetBinCenter(line_breakdown_hist->GetMaximumBin()) + 90);
+    line_breakdown_hist->Fit(gaus_fit, "NQ", "", LB_max_center - 90, LB_max_center + 90);
 
     // line_breakdown_hist -> Fit(gaus_fit, "NQ", "", N_group_info_detail[2]-10, N_group_info_detail[3]+10);
 
@@ -879,45 +830,50 @@ bool INTTZvtx::ProcessEvt(
     loose_offset_peakE = gaus_fit->GetParError(1);
 
     // additional QA below
-    // note : eff sigma method, relatively sensitive to the background
-    // note : use z-mid to do the effi_sig, because that line_breakdown takes too long time
-    temp_event_zvtx_info = InttVertexUtil::sigmaEff_avg(z_mid, Integrate_portion);
-
+    // note : only for QA and the event display, the z-vertex is given by the gaussian fit above
     std::vector<double> eff_N_comb;    // QA
     std::vector<double> eff_N_comb_e;  // QA
     std::vector<double> eff_z_mid;     // QA
     std::vector<double> eff_z_range;   // QA note : eff_sig
-    for (unsigned int track_i = 0; track_i < N_comb.size(); track_i++)
+    double width_density_par = -1;     // QA
+    if (m_enable_qa || draw_event_display)
     {
-      if (N_group_info[2] <= z_mid[track_i] && z_mid[track_i] <= N_group_info[3])
-      {
-        eff_N_comb.push_back(N_comb[track_i]);
-        eff_N_comb_e.push_back(N_comb_e[track_i]);
-        eff_z_mid.push_back(z_mid[track_i]);
-        eff_z_range.push_back(z_range[track_i]);
-      }
+      // note : eff sigma method, relatively sensitive to the background
+      // note : use z-mid to do the effi_sig, because that line_breakdown takes too long time
+      temp_event_zvtx_info = InttVertexUtil::sigmaEff_avg(z_mid, Integrate_portion);
 
-      if (draw_event_display)
+      for (unsigned int track_i = 0; track_i < N_comb.size(); track_i++)
       {
-        if (final_selection_widthD <= z_mid[track_i] && z_mid[track_i] <= final_selection_widthU)
+        if (N_group_info[2] <= z_mid[track_i] && z_mid[track_i] <= N_group_info[3])
         {
-          // note : for monitoring the the phi distribution that is used for the z vertex determination.
-          // note : in principle, I expect it should be something uniform.
-          evt_select_track_phi->Fill(N_comb_phi[track_i]);  // QA
+          eff_N_comb.push_back(N_comb[track_i]);
+          eff_N_comb_e.push_back(N_comb_e[track_i]);
+          eff_z_mid.push_back(z_mid[track_i]);
+          eff_z_range.push_back(z_range[track_i]);
+        }
+
+        if (draw_event_display)
+        {
+          if (final_selection_widthD <= z_mid[track_i] && z_mid[track_i] <= final_selection_widthU)
+          {
+            // note : for monitoring the the phi distribution that is used for the z vertex determination.
+            // note : in principle, I expect it should be something uniform.
+            evt_select_track_phi->Fill(N_comb_phi[track_i]);  // QA
+          }
         }
       }
-    }
 
-    //--std::cout<<"--6--"<<std::endl;
+      //--std::cout<<"--6--"<<std::endl;
 
-    delete z_range_gr;
+      delete z_range_gr;
 
-    z_range_gr = new TGraphErrors(eff_N_comb.size(),
-                                  eff_N_comb.data(), eff_z_mid.data(),
-                                  eff_N_comb_e.data(), eff_z_range.data());
+      z_range_gr = new TGraphErrors(eff_N_comb.size(),
+                                    eff_N_comb.data(), eff_z_mid.data(),
+                                    eff_N_comb_e.data(), eff_z_range.data());
 
-    z_range_gr->Fit(zvtx_finder, "NQ", "", 0, N_comb[N_comb.size() - 1]);
-    double width_density_par = (double(eff_N_comb.size()) / fabs(temp_event_zvtx_info[2] - temp_event_zvtx_info[1]));
+      z_range_gr->Fit(zvtx_finder, "NQ", "", 0, N_comb[N_comb.size() - 1]);
+      width_density_par = (double(eff_N_comb.size()) / fabs(temp_event_zvtx_info[2] - temp_event_zvtx_info[1]));
+    }
 
     if (zvtx_QA_width.first < tight_offset_width &&
         tight_offset_width < zvtx_QA_width.second &&
@@ -1027,8 +983,7 @@ bool INTTZvtx::ProcessEvt(
 
       out_centrality_bin = centrality_bin;
 
-      out_LB_geo_mean = LB_geo_mean(line_breakdown_hist,
-                                    {(tight_offset_peak - tight_offset_width),
+      out_LB_geo_mean = LB_geo_mean({(tight_offset_peak - tight_offset_width),
                                      (tight_offset_peak + tight_offset_width)},
                                     event_i);
       out_good_zvtx_tag = good_zvtx_tag;
@@ -1223,7 +1178,10 @@ bool INTTZvtx::ProcessEvt(
     m_zvtxinfo.peakratio = N_group_info_detail[1];
     m_zvtxinfo.peakwidth = fabs(N_group_info_detail[3] - N_group_info_detail[2]) / 2.;
 
-    std::cout << "chi2 : " << m_zvtxinfo.chi2ndf << " " << m_zvtxinfo.width << std::endl;
+    if (print_message_opt == true)
+    {
+      std::cout << "chi2 : " << m_zvtxinfo.chi2ndf << " " << m_zvtxinfo.width << std::endl;
+    }
 
   }  // if (N_comb.size() > zvtx_cal_require)
 
@@ -1233,7 +1191,10 @@ bool INTTZvtx::ProcessEvt(
   ////////////////////////////////////////
 
   // std::cout<<"good pair count : "<<good_pair_count<<std::endl;
-  std::cout << "evt : " << event_i << ", good pair count : " << N_comb.size() << " " << good_pair_count << std::endl;
+  if (print_message_opt == true)
+  {
+    std::cout << "evt : " << event_i << ", good pair count : " << N_comb.size() << " " << good_pair_count << std::endl;
+  }
 
   //--std::cout<<"--14 0--"<<std::endl;
   if (m_enable_qa)
@@ -1280,7 +1241,14 @@ void INTTZvtx::ClearEvt()
   N_group_info.clear();
   N_group_info_detail = {-1., -1., -1., -1.};
 
-  evt_possible_z->Reset("ICESM");
+  evt_possible_z_content.fill(0);
+  line_breakdown_step.fill(0);
+  line_breakdown_content.fill(0);
+
+  if (draw_event_display || m_enable_qa)
+  {
+    evt_possible_z->Reset("ICESM");
+  }
   line_breakdown_hist->Reset("ICESM");
 
   if (draw_event_display)
@@ -1291,10 +1259,8 @@ void INTTZvtx::ClearEvt()
     evt_phi_diff_inner_phi->Reset("ICESM");
   }
 
-  inner_clu_phi_map.clear();
-  outer_clu_phi_map.clear();
-  inner_clu_phi_map = std::vector<std::vector<std::pair<bool, clu_info>>>(360);
-  outer_clu_phi_map = std::vector<std::vector<std::pair<bool, clu_info>>>(360);
+  inner_clu_sorted.clear();
+  outer_clu_sorted.clear();
 
   // note : this is the distribution for full run
   // line_breakdown_gaus_ratio_hist -> Reset("ICESM");
@@ -1666,13 +1632,13 @@ double INTTZvtx::Get_extrapolation(double given_y, double p0x, double p0y, doubl
   return xCoordinate;
 }
 
-std::pair<double, double> INTTZvtx::Get_possible_zvtx(double rvtx, std::vector<double> p0, std::vector<double> p1)  // note : inner p0, outer p1, vector {r,z}, -> {y,x}
+std::pair<double, double> INTTZvtx::Get_possible_zvtx(double rvtx, std::pair<double, double> p0, std::pair<double, double> p1)  // note : inner p0, outer p1, pair {r,z}, -> {y,x}
 {
-  std::vector<double> p0_z_edge = {(fabs(p0[1]) < 130) ? p0[1] - 8. : p0[1] - 10., (fabs(p0[1]) < 130) ? p0[1] + 8. : p0[1] + 10.};  // note : vector {left edge, right edge}
-  std::vector<double> p1_z_edge = {(fabs(p1[1]) < 130) ? p1[1] - 8. : p1[1] - 10., (fabs(p1[1]) < 130) ? p1[1] + 8. : p1[1] + 10.};  // note : vector {left edge, right edge}
+  const double p0_z_half = (fabs(p0.second) < 130) ? 8. : 10.;  // note : half length of the strip
+  const double p1_z_half = (fabs(p1.second) < 130) ? 8. : 10.;  // note : half length of the strip
 
-  double edge_first = Get_extrapolation(rvtx, p0_z_edge[0], p0[0], p1_z_edge[1], p1[0]);
-  double edge_second = Get_extrapolation(rvtx, p0_z_edge[1], p0[0], p1_z_edge[0], p1[0]);
+  double edge_first = Get_extrapolation(rvtx, p0.second - p0_z_half, p0.first, p1.second + p1_z_half, p1.first);
+  double edge_second = Get_extrapolation(rvtx, p0.second + p0_z_half, p0.first, p1.second - p1_z_half, p1.first);
 
   double mid_point = (edge_first + edge_second) / 2.;
   double possible_width = fabs(edge_first - edge_second) / 2.;
@@ -1680,44 +1646,41 @@ std::pair<double, double> INTTZvtx::Get_possible_zvtx(double rvtx, std::vector<d
   return {mid_point, possible_width};  // note : first : mid point, second : width
 }
 
-void INTTZvtx::line_breakdown(TH1* hist_in, std::pair<double, double> line_range)
+void INTTZvtx::line_breakdown(std::pair<double, double> line_range)
 {
-  int first_bin = int((line_range.first - hist_in->GetXaxis()->GetXmin()) / hist_in->GetBinWidth(1)) + 1;
-  int last_bin = int((line_range.second - hist_in->GetXaxis()->GetXmin()) / hist_in->GetBinWidth(1)) + 1;
+  // note : same bins as the line_breakdown_hist
+  int first_bin = int((line_range.first - line_breakdown_min) / line_breakdown_width) + 1;
+  int last_bin = int((line_range.second - line_breakdown_min) / line_breakdown_width) + 1;
 
-  if (first_bin < 1)
-  {
-    first_bin = 0;
-  }
-  else if (first_bin > hist_in->GetNbinsX())
-  {
-    first_bin = hist_in->GetNbinsX() + 1;
-  }
-
-  if (last_bin < 1)
-  {
-    last_bin = 0;
-  }
-  else if (last_bin > hist_in->GetNbinsX())
-  {
-    last_bin = hist_in->GetNbinsX() + 1;
-  }
-
-  // std::cout<<"Digitize the bin : "<<first_bin<<" "<<last_bin<<std::endl;
+  first_bin = (first_bin < 1) ? 0 : std::min(first_bin, line_breakdown_nbins + 1);
+  last_bin = (last_bin < 1) ? 0 : std::min(last_bin, line_breakdown_nbins + 1);
 
   // note : if first:last = (0:0) or (N+1:N+1) -> the subtraction of them euqals to zero.
-  for (int i = 0; i < (last_bin - first_bin) + 1; i++)
+  // note : the bins from first to last are counted once the event is done, see ProcessEvt
+  if (last_bin >= first_bin)
   {
-    hist_in->SetBinContent(first_bin + i, hist_in->GetBinContent(first_bin + i) + 1);
+    line_breakdown_step[first_bin] += 1;
+    line_breakdown_step[last_bin + 1] -= 1;
   }
 }
 
+// note : same as TH1::GetMaximumBin, first bin with the highest content, under/overflow excluded
+int INTTZvtx::get_max_bin(const double* content, int nbins)
+{
+  return int(std::max_element(content + 1, content + nbins + 1) - content);
+}
+
 // note : search_range : should be the gaus fit range
-double INTTZvtx::LB_geo_mean(TH1* hist_in, std::pair<double, double> search_range, int /*event_i*/)
+double INTTZvtx::LB_geo_mean(std::pair<double, double> search_range, int /*event_i*/)
 {
-  int Highest_bin_index = hist_in->GetMaximumBin();
-  double Highest_bin_center = hist_in->GetBinCenter(Highest_bin_index);
-  double Highest_bin_content = hist_in->GetBinContent(Highest_bin_index);
+  auto bin_center = [](int bin)
+  { return line_breakdown_min + (bin - 0.5) * line_breakdown_width; };
+  auto bin_content = [this](int bin)
+  { return (bin < 0 || bin > line_breakdown_nbins + 1) ? 0. : line_breakdown_content[bin]; };
+
+  int Highest_bin_index = get_max_bin(line_breakdown_content.data(), line_breakdown_nbins);
+  double Highest_bin_center = bin_center(Highest_bin_index);
+  double Highest_bin_content = bin_content(Highest_bin_index);
   if (Highest_bin_center < search_range.first || search_range.second < Highest_bin_center)
   {
     // std::cout<<"In INTTZvtx class, event : "<<event_i<<", interesting event, different group was fit"<<std::endl;
@@ -1729,39 +1692,36 @@ double INTTZvtx::LB_geo_mean(TH1* hist_in, std::pair<double, double> search_rang
   same_height_bin.push_back(Highest_bin_center);
 
   int search_index = 1;
-  while ((hist_in->GetBinCenter(Highest_bin_index + search_index)) < search_range.second)
+  while (bin_center(Highest_bin_index + search_index) < search_range.second)
   {
-    if (hist_in->GetBinContent(Highest_bin_index + search_index) == Highest_bin_content)
+    if (bin_content(Highest_bin_index + search_index) == Highest_bin_content)
     {
-      same_height_bin.push_back(hist_in->GetBinCenter(Highest_bin_index + search_index));
+      same_height_bin.push_back(bin_center(Highest_bin_index + search_index));
     }
     search_index++;
   }
 
-  // std::cout<<"test, search_index right : "<<search_index<<std::endl;
-
   search_index = 1;
-  while (search_range.first < (hist_in->GetBinCenter(Highest_bin_index - search_index)))
+  while (search_range.first < bin_center(Highest_bin_index - search_index))
   {
-    if (hist_in->GetBinContent(Highest_bin_index - search_index) == Highest_bin_content)
+    if (bin_content(Highest_bin_index - search_index) == Highest_bin_content)
     {
-      same_height_bin.push_back(hist_in->GetBinCenter(Highest_bin_index - search_index));
+      same_height_bin.push_back(bin_center(Highest_bin_index - search_index));
     }
     search_index++;
   }
 
-  // std::cout<<"test, search_index left : "<<search_index<<std::endl;
-  // std::cout<<"test, same_height_bin.size(): "<<same_height_bin.size()<<std::endl;
-
   return accumulate(same_height_bin.begin(), same_height_bin.end(), 0.0) / double(same_height_bin.size());
 }
 
 //  note : N group, group size, group tag, group width ?  // note : {group size, group entry, group tag, group widthL, group widthR}
 // note : {N_group, ratio (if two), peak widthL, peak widthR}
-std::vector<double> INTTZvtx::find_Ngroup(TH1* hist_in)
+// note : content has the TH1 layout, bin 0 and nbins + 1 are the underflow and overflow
+std::vector<double> INTTZvtx::find_Ngroup(const double* content, int nbins, double xmin, double width)
 {
-  double Highest_bin_Content = hist_in->GetBinContent(hist_in->GetMaximumBin());
-  double Highest_bin_Center = hist_in->GetBinCenter(hist_in->GetMaximumBin());
+  int Highest_bin = get_max_bin(content, nbins);
+  double Highest_bin_Content = content[Highest_bin];
+  double Highest_bin_Center = xmin + (Highest_bin - 0.5) * width;
 
   int group_Nbin = 0;
   int peak_group_ID = 0;  // =0 added by TH 20240418
@@ -1776,16 +1736,16 @@ std::vector<double> INTTZvtx::find_Ngroup(TH1* hist_in)
   std::vector<double> group_widthR_vec;
   group_widthR_vec.clear();
 
-  for (int i = 0; i < hist_in->GetNbinsX(); i++)
+  for (int i = 0; i < nbins; i++)
   {
     // todo : the background rejection is here : Highest_bin_Content/2. for the time being
-    double bin_content = (hist_in->GetBinContent(i + 1) <= Highest_bin_Content / 2.) ? 0. : (hist_in->GetBinContent(i + 1) - Highest_bin_Content / 2.);
+    double bin_content = (content[i + 1] <= Highest_bin_Content / 2.) ? 0. : (content[i + 1] - Highest_bin_Content / 2.);
 
     if (bin_content != 0)
     {
       if (group_Nbin == 0)
       {
-        group_widthL_vec.push_back(hist_in->GetBinCenter(i + 1) - (hist_in->GetBinWidth(i + 1) / 2.));
+        group_widthL_vec.push_back(xmin + i * width);
       }
 
       group_Nbin += 1;
@@ -1793,7 +1753,7 @@ std::vector<double> INTTZvtx::find_Ngroup(TH1* hist_in)
     }
     else if (bin_content == 0 && group_Nbin != 0)
     {
-      group_widthR_vec.push_back(hist_in->GetBinCenter(i + 1) - (hist_in->GetBinWidth(i + 1) / 2.));
+      group_widthR_vec.push_back(xmin + i * width);
       group_Nbin_vec.push_back(group_Nbin);
       group_entry_vec.push_back(group_entry);
       group_Nbin = 0;
@@ -1804,7 +1764,7 @@ std::vector<double> INTTZvtx::find_Ngroup(TH1* hist_in)
   {
     group_Nbin_vec.push_back(group_Nbin);
     group_entry_vec.push_back(group_entry);
-    group_widthR_vec.push_back(hist_in->GetXaxis()->GetXmax());
+    group_widthR_vec.push_back(xmin + nbins * width);
   }  // note : the last group at the edge
 
   // note : find the peak group
@@ -1852,9 +1812,17 @@ std::vector<double> INTTZvtx::find_Ngroup(TH1* hist_in)
 
 double INTTZvtx::get_delta_phi(double angle_1, double angle_2)
 {
-  std::vector<double> vec_abs = {fabs(angle_1 - angle_2), fabs(angle_1 - angle_2 + 360), fabs(angle_1 - angle_2 - 360)};
-  std::vector<double> vec = {(angle_1 - angle_2), (angle_1 - angle_2 + 360), (angle_1 - angle_2 - 360)};
-  return vec[std::distance(vec_abs.begin(), std::min_element(vec_abs.begin(), vec_abs.end()))];
+  // note : the one of (angle_1 - angle_2), (angle_1 - angle_2 + 360), (angle_1 - angle_2 - 360) with the smallest magnitude
+  double delta_phi = angle_1 - angle_2;
+  if (delta_phi > 180)
+  {
+    delta_phi -= 360;
+  }
+  else if (delta_phi < -180)
+  {
+    delta_phi += 360;
+  }
+  return delta_phi;
 }
 
 double INTTZvtx::get_track_phi(double inner_clu_phi_in, double delta_phi_in)
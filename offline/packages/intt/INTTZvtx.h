@@ -3,6 +3,7 @@
 
 #include "InttVertexUtil.h"
 
+#include <array>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -140,13 +141,33 @@ class INTTZvtx
   double zvtx_hist_r = 500;               // histogram range for QA
   int print_rate = 50;                    // if_print in processEvt, todo : the print rate is here
 
-  std::vector<std::vector<std::pair<bool, clu_info>>> inner_clu_phi_map{};  // note: phi
-  std::vector<std::vector<std::pair<bool, clu_info>>> outer_clu_phi_map{};  // note: phi
+  // note : cluster used in the tracklet reconstruction, phi is w.r.t. the beam origin, unit degree
+  struct tracklet_clu
+  {
+    double phi{0};
+    double x{0};
+    double y{0};
+    double r{0};
+    double z{0};
+  };
+
+  std::vector<tracklet_clu> inner_clu_sorted{};  // note : sorted in phi
+  std::vector<tracklet_clu> outer_clu_sorted{};  // note : sorted in phi
 
   ZvtxInfo m_zvtxinfo;
 
-  TH1* evt_possible_z{nullptr};
-  TH1* line_breakdown_hist{nullptr};  // note : try to fill the line into the histogram
+  // note : the z candidates are accumulated in plain arrays with the binning of evt_possible_z and line_breakdown_hist
+  // note : index 0 and nbins + 1 are the underflow and overflow, as in TH1
+  static constexpr int evt_possible_z_nbins = 50;
+  static constexpr int line_breakdown_nbins = 2401;        // note : 1200 bins for each side, plus the bin at zero
+  static constexpr double line_breakdown_width = 0.5;      // note : unit [mm]
+  static constexpr double line_breakdown_min = -600.25;    // note : unit [mm]
+  std::array<double, evt_possible_z_nbins + 2> evt_possible_z_content{};
+  std::array<int, line_breakdown_nbins + 3> line_breakdown_step{};  // note : +1 at the first bin of a line, -1 after its last bin
+  std::array<double, line_breakdown_nbins + 2> line_breakdown_content{};
+
+  TH1* evt_possible_z{nullptr};       // note : QA and event display only
+  TH1* line_breakdown_hist{nullptr};  // note : gaussian fit of line_breakdown_content
   TF1* gaus_fit{nullptr};
   TF1* zvtx_finder{nullptr};
   TGraphErrors* z_range_gr{nullptr};  // ana // memory leak
@@ -279,19 +300,20 @@ class INTTZvtx
   std::vector<float> z_range{};      // tracklet
 
   // function for analysis
-  std::pair<double, double> Get_possible_zvtx(double rvtx, std::vector<double> p0, std::vector<double> p1);
-  std::vector<double> find_Ngroup(TH1* hist_in);
+  std::pair<double, double> Get_possible_zvtx(double rvtx, std::pair<double, double> p0, std::pair<double, double> p1);
+  std::vector<double> find_Ngroup(const double* content, int nbins, double xmin, double width);
   double get_radius(double x, double y);
   double calculateAngleBetweenVectors(double x1, double y1, double x2, double y2, double targetX, double targetY);
   double Get_extrapolation(double given_y, double p0x, double p0y, double p1x, double p1y);
-  void line_breakdown(TH1* hist_in, std::pair<double, double> line_range);
+  void line_breakdown(std::pair<double, double> line_range);
+  static int get_max_bin(const double* content, int nbins);
 
   // tracklet reco
   double get_delta_phi(double angle_1, double angle_2);
   double get_track_phi(double inner_clu_phi_in, double delta_phi_in);
 
   // for Tree
-  double LB_geo_mean(TH1* hist_in, std::pair<double, double> search_range, int event_i);
+  double LB_geo_mean(std::pair<double, double> search_range, int event_i);
 
   // InitCanvas
   void Characterize_Pad(TPad* pad, float left = 0.15, float right = 0.1,
@@ -268,7 +268,88 @@ void FastJetAlgo::cluster_and_fill(std::vector<Jet*>& particles, JetContainer* j
   }
 
   // translate input jets to input fastjets
-  auto pseudojets = jets_to_pseudojets(particles);
+  m_pseudojets = jets_to_pseudojets(particles);
+
+  cluster_pseudojets();
+  fill_jets(particles, jetcont);
+}
+
+bool FastJetAlgo::prepare_cluster(JetContainer* jetcont)
+{
+  if (m_first_cluster_call)
+  {
+    first_call_init(jetcont);
+  }
+
+  // ghosts used for the area and median background density calculations come from a random generator
+  // shared by all algorithms, so that running them concurrently would make the results depend on thread scheduling
+  return !m_opt.calc_area && !m_opt.calc_jetmedbkgdens && m_opt.verbosity <= 1;
+}
+
+void FastJetAlgo::select_pseudojets(const std::vector<fastjet::PseudoJet>& pseudojets)
+{
+  // same selection as jets_to_pseudojets, user index is kept
+  // this may run concurrently with other algorithms, invalid inputs are reported by fill
+  m_pseudojets.clear();
+  m_invalid_input = false;
+  for (const auto& pseudojet : pseudojets)
+  {
+    if (pseudojet.e() < m_opt.constituent_min_E)
+    {
+      continue;
+    }
+    if (!std::isfinite(pseudojet.px()) ||
+        !std::isfinite(pseudojet.py()) ||
+        !std::isfinite(pseudojet.pz()) ||
+        !std::isfinite(pseudojet.e()))
+    {
+      if (!m_invalid_input)
+      {
+        m_invalid_input = true;
+        m_invalid_pseudojet = pseudojet;
+      }
+      continue;
+    }
+    if (m_opt.use_constituent_min_pt && pseudojet.perp() < m_opt.constituent_min_pt)
+    {
+      continue;
+    }
+    m_pseudojets.push_back(pseudojet);
+  }
+}
+
+void FastJetAlgo::cluster(const std::vector<fastjet::PseudoJet>& pseudojets)
+{
+  if (m_opt.verbosity > 1)
+  {
+    std::cout << "   Verbosity>1 FastJetAlgo::cluster -- entered" << std::endl;
+  }
+  if (m_opt.verbosity > 8)
+  {
+    std::cout << "   Verbosity>8 #input particles: " << pseudojets.size() << std::endl;
+  }
+
+  select_pseudojets(pseudojets);
+  cluster_pseudojets();
+}
+
+void FastJetAlgo::fill(std::vector<Jet*>& particles, JetContainer* jetcont)
+{
+  if (m_invalid_input)
+  {
+    std::cout << PHWHERE << " invalid particle kinematics:"
+              << " px: " << m_invalid_pseudojet.px()
+              << " py: " << m_invalid_pseudojet.py()
+              << " pz: " << m_invalid_pseudojet.pz()
+              << " e: " << m_invalid_pseudojet.e() << std::endl;
+    gSystem->Exit(1);
+  }
+  fill_jets(particles, jetcont);
+}
+
+void FastJetAlgo::cluster_pseudojets()
+{
+  auto& pseudojets = m_pseudojets;
 
   // if using constituent subtraction, oberve maximum eta and subtract the constituents
   if (m_opt.cs_calc_constsub)
@@ -319,11 +400,20 @@ void FastJetAlgo::cluster_and_fill(std::vector<Jet*>& particles, JetContainer* j
 
   if (m_opt.calc_jetmedbkgdens)
   {
-    jetcont->set_rho_median(calc_rhomeddens(pseudojets));
+    m_rho_median = calc_rhomeddens(pseudojets);
   }
 
-  auto fastjets = (m_opt.calc_area ? cluster_area_jets(pseudojets) : cluster_jets(pseudojets));
+  m_fastjets = (m_opt.calc_area ? cluster_area_jets(pseudojets) : cluster_jets(pseudojets));
+}
+
+void FastJetAlgo::fill_jets(std::vector<Jet*>& particles, JetContainer* jetcont)
+{
+  if (m_opt.calc_jetmedbkgdens)
+  {
+    jetcont->set_rho_median(m_rho_median);
+  }
 
+  auto& fastjets = m_fastjets;
   if (m_opt.verbosity > 8)
   {
     std::cout << "   Verbosity>8 fastjets: " << fastjets.size() << std::endl;
@@ -410,6 +500,7 @@ void FastJetAlgo::cluster_and_fill(std::vector<Jet*>& particles, JetContainer* j
   {
     std::cout << "FastJetAlgo::process_event -- exited" << std::endl;
   }
+  fastjets.clear();
   delete (m_opt.calc_area ? m_cluseqarea : m_cluseq);  // if (m_cluseq) delete m_cluseq;
 }
 
@@ -49,6 +49,12 @@ class FastJetAlgo : public JetAlgo
   std::vector<Jet*> get_jets(std::vector<Jet*> particles) override;
   void cluster_and_fill(std::vector<Jet*>& particles, JetContainer* jetcont) override;
 
+  // shared input version, used by JetReco::set_shared_input
+  bool supports_shared_input() override { return true; }
+  bool prepare_cluster(JetContainer* jetcont) override;
+  void cluster(const std::vector<fastjet::PseudoJet>& pseudojets) override;
+  void fill(std::vector<Jet*>& particles, JetContainer* jetcont) override;
+
  private:
   FastJetOptions m_opt{};
   bool m_first_cluster_call{true};
@@ -61,6 +67,9 @@ class FastJetAlgo : public JetAlgo
 
   // Internal processes
   std::vector<fastjet::PseudoJet> jets_to_pseudojets(std::vector<Jet*>& particles) const;
+  void select_pseudojets(const std::vector<fastjet::PseudoJet>& pseudojets);
+  void cluster_pseudojets();
+  void fill_jets(std::vector<Jet*>& particles, JetContainer* jetcont);
   std::vector<fastjet::PseudoJet> cluster_jets(std::vector<fastjet::PseudoJet>& pseudojets);
   std::vector<fastjet::PseudoJet> cluster_area_jets(std::vector<fastjet::PseudoJet>& pseudojets);
   float calc_rhomeddens(std::vector<fastjet::PseudoJet>& constituents) const;
@@ -75,6 +84,16 @@ class FastJetAlgo : public JetAlgo
 
   fastjet::ClusterSequence* m_cluseq{nullptr};
   fastjet::ClusterSequence* m_cluseqarea{nullptr};
+
+  // clustering input and output of the current event, kept between cluster and fill
+  // calls. Memory is reused from one event to the next
+  std::vector<fastjet::PseudoJet> m_pseudojets;
+  std::vector<fastjet::PseudoJet> m_fastjets;
+  float m_rho_median{0};
+
+  // first input with non finite kinematics found by cluster, reported by fill
+  bool m_invalid_input{false};
+  fastjet::PseudoJet m_invalid_pseudojet;
 };
 
 #endif
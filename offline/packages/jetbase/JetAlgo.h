@@ -4,8 +4,14 @@
 #include "Jet.h"
 
 #include <limits>
+#include <vector>
 
 class JetContainer;
+namespace fastjet
+{
+  class PseudoJet;
+}
+
 class JetAlgo
 {
  public:
@@ -30,6 +36,15 @@ class JetAlgo
   {
   }
 
+  // shared input version -- JetReco converts the input particles to pseudojets once per event
+  // and passes the same array to all algorithms. user_index of each pseudojet is its index in particles.
+  // prepare_cluster and fill are called serially, in registration order. cluster is called in between,
+  // concurrently with other algorithms if prepare_cluster returns true
+  virtual bool supports_shared_input() { return false; }
+  virtual bool prepare_cluster(JetContainer* /*jetcont*/) { return false; }
+  virtual void cluster(const std::vector<fastjet::PseudoJet>& /*pseudojets*/) {}
+  virtual void fill(std::vector<Jet*>& /*particles*/, JetContainer* /*jetcont*/) {}
+
   virtual std::map<Jet::PROPERTY, unsigned int>& property_indices();
 
  protected:
@@ -18,13 +18,17 @@
 #include <phool/PHNode.h>  // for PHNode
 #include <phool/PHNodeIterator.h>
 #include <phool/PHObject.h>  // for PHObject
+#include <phool/PHThreadPool.h>
 #include <phool/PHTypedNodeIterator.h>
 #include <phool/getClass.h>
 #include <phool/phool.h>  // for PHWHERE
 
+#include <fastjet/PseudoJet.hh>
+
 #include <boost/format.hpp>
 
 // standard includes
+#include <cstddef>
 #include <cstdlib>  // for exit
 #include <fstream>
 #include <iostream>
@@ -79,6 +83,15 @@ int JetReco::InitRun(PHCompositeNode *topNode)
     std::cout << "===========================================================================" << std::endl;
   }
 
+  if (m_shared_input && use_jetcon && !m_threadPool)
+  {
+    m_threadPool = std::make_unique<PHThreadPool>(m_nthreads);
+    if (Verbosity() > 0)
+    {
+      std::cout << " shared input, clustering with " << m_threadPool->size() << " threads" << std::endl;
+    }
+  }
+
   return CreateNodes(topNode);
 }
 
@@ -108,11 +121,16 @@ int JetReco::process_event(PHCompositeNode *topNode)
   //---------------------------
   // Run the jet reconstruction
   //---------------------------
+  if (use_jetcon && m_shared_input)
+  {
+    FillJetContainers(topNode, inputs);
+  }
+
   for (unsigned int ialgo = 0; ialgo < _algos.size(); ++ialgo)
   {
     // send the output somewhere on the DST
     /* if (_fill_JetContainer) { */
-    if (use_jetcon)
+    if (use_jetcon && !m_shared_input)
     {
       if (Verbosity() > 5)
       {
@@ -298,13 +316,92 @@ void JetReco::FillJetContainer(PHCompositeNode *topNode, int ipos, std::vector<J
     jetconn->insert_src(_input->get_src());
   }
 
+  PrintJetContainer(ipos, jetconn);
+
+  return;
+}
+
+void JetReco::FillJetContainers(PHCompositeNode *topNode, std::vector<Jet *> &inputs)
+{
+  // convert the inputs once for all algorithms. The user index points back to the input,
+  // each algorithm applies its own constituent selection
+  m_pseudojets.clear();
+  m_pseudojets.reserve(inputs.size());
+  for (unsigned int ipart = 0; ipart < inputs.size(); ++ipart)
+  {
+    fastjet::PseudoJet pseudojet(inputs[ipart]->get_px(),
+                                 inputs[ipart]->get_py(),
+                                 inputs[ipart]->get_pz(),
+                                 inputs[ipart]->get_e());
+    pseudojet.set_user_index(ipart);
+    m_pseudojets.push_back(pseudojet);
+  }
+
+  // node lookup and algorithm initialization are done serially
+  m_containers.assign(_algos.size(), nullptr);
+  m_concurrent_algos.clear();
+  for (unsigned int ialgo = 0; ialgo < _algos.size(); ++ialgo)
+  {
+    if (!_algos[ialgo]->supports_shared_input())
+    {
+      FillJetContainer(topNode, ialgo, inputs);
+      continue;
+    }
+
+    JetContainer *jetconn = findNode::getClass<JetContainer>(topNode, JC_name(_outputs[ialgo]));
+    if (!jetconn)
+    {
+      std::cout << PHWHERE << " ERROR: Can't find JetContainer: " << _outputs[ialgo] << std::endl;
+      exit(-1);
+    }
+    jetconn->Reset();
+    m_containers[ialgo] = jetconn;
+
+    if (_algos[ialgo]->prepare_cluster(jetconn) && m_threadPool)
+    {
+      m_concurrent_algos.push_back(ialgo);
+    }
+    else
+    {
+      _algos[ialgo]->cluster(m_pseudojets);
+    }
+  }
+
+  // each algorithm only touches its own state
+  if (!m_concurrent_algos.empty())
+  {
+    m_threadPool->parallel_for(m_concurrent_algos.size(), [this](std::size_t i, unsigned int /*worker*/)
+                               { _algos[m_concurrent_algos[i]]->cluster(m_pseudojets); });
+  }
+
+  // fill containers in registration order
+  for (unsigned int ialgo = 0; ialgo < _algos.size(); ++ialgo)
+  {
+    JetContainer *jetconn = m_containers[ialgo];
+    if (!jetconn)
+    {
+      continue;
+    }
+    if (Verbosity() > 5)
+    {
+      std::cout << " Verbosity>5:: filling JetContainter for " << JC_name(_outputs[ialgo]) << std::endl;
+    }
+    _algos[ialgo]->fill(inputs, jetconn);
+    for (auto &_input : _inputs)
+    {
+      jetconn->insert_src(_input->get_src());
+    }
+    PrintJetContainer(ialgo, jetconn);
+  }
+}
+
+void JetReco::PrintJetContainer(int ipos, JetContainer *jetconn)
+{
   if (Verbosity() > 7)
   {
     std::cout << " Verbosity()>7:: jets in container " << _outputs[ipos] << std::endl;
     jetconn->print_jets();
   }
-
-  return;
 }
 
 JetAlgo *JetReco::get_algo(unsigned int which_algo)
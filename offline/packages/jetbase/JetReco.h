@@ -10,15 +10,20 @@
 // PHENIX includes
 #include <fun4all/SubsysReco.h>
 
+#include <fastjet/PseudoJet.hh>
+
 // standard includes
+#include <memory>
 #include <string>  // for string
 #include <vector>
 
 // forward declarations
 class Jet;
 class JetAlgo;
+class JetContainer;
 class JetInput;
 class PHCompositeNode;
+class PHThreadPool;
 
 /// \class JetReco
 ///
@@ -56,12 +61,25 @@ class JetReco : public SubsysReco
   void set_input_node(const std::string &inputnode) { _inputnode = inputnode; }
   /* void set_fill_JetContainer(bool b) { _fill_JetContainer = b; } */
 
+  /// convert the inputs to pseudojets once per event and share them between all algorithms
+  /// filling a JetContainer. Algorithms which allow it (e.g. FastJetAlgo without jet areas)
+  /// are clustered concurrently, using nthreads threads (negative: number of hardware threads,
+  /// zero: clustering is done in the calling thread). Concurrent clustering requires a thread-safe fastjet build.
+  /// Must be called before InitRun
+  void set_shared_input(bool b = true, int nthreads = -1)
+  {
+    m_shared_input = b;
+    m_nthreads = nthreads;
+  }
+
   JetAlgo *get_algo(unsigned int which_algo = 0);
 
  private:
   int CreateNodes(PHCompositeNode *topNode);
   void FillJetNode(PHCompositeNode *topNode, int ipos, const std::vector<Jet *> &jets);
   void FillJetContainer(PHCompositeNode *topNode, int ipos, std::vector<Jet *> &inputs);
+  void FillJetContainers(PHCompositeNode *topNode, std::vector<Jet *> &inputs);
+  void PrintJetContainer(int ipos, JetContainer *jetconn);
 
   std::vector<JetInput *> _inputs;
   std::vector<JetAlgo *> _algos;
@@ -82,6 +100,16 @@ class JetReco : public SubsysReco
   TRANSITION which_fill;  // fill both container and map
   bool use_jetcon;
   bool use_jetmap;
+
+  // shared input mode
+  bool m_shared_input{false};
+  int m_nthreads{-1};
+  std::unique_ptr<PHThreadPool> m_threadPool;
+
+  // per event buffers, reused from one event to the next
+  std::vector<fastjet::PseudoJet> m_pseudojets;
+  std::vector<JetContainer *> m_containers;
+  std::vector<unsigned int> m_concurrent_algos;
 };
 
 #endif  // JETBASE_JETRECO_H
@@ -22,12 +22,15 @@
 #include <Event/Event.h>
 #include <Event/EventTypes.h>
 
+#include <phool/PHThreadPool.h>
+
 #include <TCanvas.h>
 #include <TDirectory.h>
 #include <TF1.h>
 #include <TGraphErrors.h>
 #include <TH1.h>
 #include <TH2.h>
+#include <TROOT.h>
 #include <TSystem.h>
 
 #include <algorithm>
@@ -134,6 +137,13 @@ int MbdEvent::InitRun()
     _mbdgeom = new MbdGeomV1();
   }
 
+  // charge channels are processed concurrently when the template fits allow it
+  if ( _nthreads != 0 && m_threadPool == nullptr )
+  {
+    ROOT::EnableThreadSafety();
+    m_threadPool = std::make_unique<PHThreadPool>(_nthreads);
+  }
+
   // Always reload calibrations on InitRun()
   
   
@@ -222,6 +232,7 @@ int MbdEvent::InitRun()
         // std::cout << "SIZES0 " << _mbdcal->get_shape(ifeech).size() << std::endl;
         //  Should set template size automatically here
         _mbdsig[ifeech].SetTemplate(_mbdcal->get_shape(ifeech), _mbdcal->get_sherr(ifeech));
+        _mbdsig[ifeech].SetFitEngine(_fitengine);
         _mbdsig[ifeech].SetMinMaxFitTime(_mbdcal->get_sampmax(ifeech) - 2 - 3, _mbdcal->get_sampmax(ifeech) - 2 + 3);
         //_mbdsig[ifeech].SetMinMaxFitTime( 0, 31 );
       }
@@ -375,6 +386,19 @@ int MbdEvent::InitRun()
 int MbdEvent::End()
 {
   //std::cout << "MbdEvent::End()" << std::endl;
+  if ( _fitengine == MbdSig::VALIDATEFIT )
+  {
+    int nfits = 0;
+    int nbad = 0;
+    for (auto & sig : _mbdsig)
+    {
+      nfits += sig.GetNValidatedFits();
+      nbad += sig.GetNBadValidatedFits();
+    }
+    std::cout << "MbdEvent::End() native template fit differs from ROOT fit in "
+              << nbad << " of " << nfits << " fits" << std::endl;
+  }
+
   if ( _calpass == 1 )
   {
     CalcSampMaxCalib();
@@ -804,36 +828,38 @@ int MbdEvent::ProcessPackets(MbdRawContainer *bbcraws)
         m_ttdc[pmtch] = std::numeric_limits<Float_t>::quiet_NaN();   // no hit
       }
     }
-    else if ( type == 1 && (!std::isnan(m_ttdc[pmtch]) || _always_process_charge ) )
-    {
-      // we process charge channels which have good time hit
-      // or have always_process_charge set to 1 (useful for threshold studies)
-
-      // Use dCFD method to seed time in charge channels (or as primary if not fitting template)
-      // std::cout << "getspline " << ifeech << std::endl;
-      _mbdsig[ifeech].GetSplineAmpl();
-      Double_t threshold = 0.5;
-      m_qtdc[pmtch] = _mbdsig[ifeech].dCFD(threshold);
-      m_ampl[ifeech] = _mbdsig[ifeech].GetAmpl(); // in adc units
-      if (do_templatefit)
-      {
-        //std::cout << "fittemplate " << ifeech << std::endl;
-        _mbdsig[ifeech].FitTemplate( _mbdcal->get_sampmax(ifeech) );
+  }
 
-        /*
-        if ( _verbose )
-        {
-          std::cout << "tt " << ifeech << " " << pmtch << " " << m_pmttt[pmtch] << std::endl;
-        }
-        */
-        m_qtdc[pmtch] = _mbdsig[ifeech].GetTime();  // in units of sample number
-        m_ampl[ifeech] = _mbdsig[ifeech].GetAmpl(); // in units of adc
-      }
+  // charge channels, once all time channels are known
+  m_qchannels.clear();
+  bool threadsafe = (m_threadPool != nullptr);
+  for (int ifeech = 0; ifeech < MbdDefs::BBC_N_FEECH; ifeech++)
+  {
+    int pmtch = _mbdgeom->get_pmt(ifeech);
+    int type = _mbdgeom->get_type(ifeech);  // 0 = T-channel, 1 = Q-channel
 
-      // calpass 2, uncal_mbd. template fit. make sure qgain = 1, tq_t0 = 0
- 
+    // we process charge channels which have good time hit
+    // or have always_process_charge set to 1 (useful for threshold studies)
+    if ( _mbdsig[ifeech].GetNSamples()==0 || type != 1 || (std::isnan(m_ttdc[pmtch]) && !_always_process_charge) )
+    {
+      continue;
     }
+    m_qchannels.push_back(ifeech);
+    threadsafe = threadsafe && (!do_templatefit || _mbdsig[ifeech].IsThreadSafeFit());
+  }
 
+  if ( threadsafe )
+  {
+    // each channel only touches its own MbdSig and output slots
+    m_threadPool->parallel_for(m_qchannels.size(), [this](const std::size_t i, const unsigned int /*worker*/)
+                               { ProcessChargeChannel(m_qchannels[i]); });
+  }
+  else
+  {
+    for (const int ifeech : m_qchannels)
+    {
+      ProcessChargeChannel(ifeech);
+    }
   }
 
   // Copy to output
@@ -850,6 +876,34 @@ int MbdEvent::ProcessPackets(MbdRawContainer *bbcraws)
   return m_evt;
 }
 
+void MbdEvent::ProcessChargeChannel(const int ifeech)
+{
+  int pmtch = _mbdgeom->get_pmt(ifeech);
+
+  // Use dCFD method to seed time in charge channels (or as primary if not fitting template)
+  // std::cout << "getspline " << ifeech << std::endl;
+  _mbdsig[ifeech].GetSplineAmpl();
+  Double_t threshold = 0.5;
+  m_qtdc[pmtch] = _mbdsig[ifeech].dCFD(threshold);
+  m_ampl[ifeech] = _mbdsig[ifeech].GetAmpl(); // in adc units
+  if (do_templatefit)
+  {
+    //std::cout << "fittemplate " << ifeech << std::endl;
+    _mbdsig[ifeech].FitTemplate( _mbdcal->get_sampmax(ifeech) );
+
+    /*
+    if ( _verbose )
+    {
+      std::cout << "tt " << ifeech << " " << pmtch << " " << m_pmttt[pmtch] << std::endl;
+    }
+    */
+    m_qtdc[pmtch] = _mbdsig[ifeech].GetTime();  // in units of sample number
+    m_ampl[ifeech] = _mbdsig[ifeech].GetAmpl(); // in units of adc
+  }
+
+  // calpass 2, uncal_mbd. template fit. make sure qgain = 1, tq_t0 = 0
+}
+
 int MbdEvent::ProcessRawContainer(MbdRawContainer *bbcraws, MbdPmtContainer *bbcpmts)
 {
   //std::cout << "In ProcessRawContainer" << std::endl;
@@ -13,6 +13,7 @@
 
 #include <array>
 #include <limits>
+#include <memory>
 #include <vector>
 
 class PHCompositeNode;
@@ -23,6 +24,7 @@ class MbdOut;
 class MbdCalib;
 class MbdGeom;
 class CDBUtils;
+class PHThreadPool;
 class TF1;
 class TCanvas;
 #ifndef ONLINE
@@ -56,6 +58,12 @@ class MbdEvent
   void SetRawDstFlag(const int r) { _rawdstflag = r; }
   void SetFitsOnly(const int f) { _fitsonly = f; }
 
+  /** Template fit engine for all channels, see MbdSig::FitEngine */
+  void SetFitEngine(const int e) { _fitengine = e; }
+
+  /** Number of threads used to process charge channels (0 = serial, -1 = all cores) */
+  void SetNThreads(const int n) { _nthreads = n; }
+
   float get_bbcz() { return m_bbcz; }
   float get_bbczerr() { return m_bbczerr; }
   float get_bbct0() { return m_bbct0; }
@@ -153,6 +161,13 @@ class MbdEvent
   Float_t m_pmttq[MbdDefs::MBD_N_PMT]{};  // time in each arm
 
   int do_templatefit{1};
+  int _fitengine{MbdSig::ROOTFIT};
+
+  // charge channel processing, run concurrently when the fits are thread safe
+  void ProcessChargeChannel(const int ifeech);
+  int _nthreads{0};
+  std::unique_ptr<PHThreadPool> m_threadPool;
+  std::vector<int> m_qchannels;  // charge channels to process in current event
 
   // output data
   Short_t m_bbcn[2]{};                                            // num hits for each arm (north and south)
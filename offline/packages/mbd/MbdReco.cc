@@ -70,6 +70,8 @@ int MbdReco::InitRun(PHCompositeNode *topNode)
   m_mbdevent->SetRawDstFlag(_rawdstflag);
   m_mbdevent->SetFitsOnly(_fitsonly);
   m_mbdevent->set_doeval(_fiteval);
+  m_mbdevent->SetFitEngine(_fitengine);
+  m_mbdevent->SetNThreads(_nthreads);
 
   ret = m_mbdevent->InitRun();
 
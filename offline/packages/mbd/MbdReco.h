@@ -1,6 +1,8 @@
 #ifndef MBD_MBDRECO_H
 #define MBD_MBDRECO_H
 
+#include "MbdSig.h"
+
 #include <fun4all/SubsysReco.h>
 
 #include <array>
@@ -39,6 +41,8 @@ class MbdReco : public SubsysReco
   void SetCalPass(const int calpass) { _calpass = calpass; if (calpass==1) DoOnlyFits(); }
   void SetProcChargeCh(const bool s) { _always_process_charge = s; }
   void SetMbdTrigOnly(const int m)   { _mbdonly = m; }
+  void SetFitEngine(const int e)     { _fitengine = e; }  // see MbdSig::FitEngine
+  void SetNThreads(const int n)      { _nthreads = n; }   // threads for charge channel fits
 
   MbdEvent* GetMbdEvent() { return m_mbdevent.get(); }
 
@@ -52,6 +56,8 @@ class MbdReco : public SubsysReco
   int  _rawdstflag{0};  // dst with raw container
   int  _fitsonly{0};    // stop reco after waveform fits (for DST_CALOFIT pass)
   int  _fiteval{0};     // overload with segment+1
+  int  _fitengine{MbdSig::ROOTFIT};
+  int  _nthreads{0};    // serial processing
 
   float m_tres = 0.05;
   std::unique_ptr<TF1> m_gaussian = nullptr;
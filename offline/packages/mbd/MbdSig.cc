@@ -1,5 +1,6 @@
 #include "MbdSig.h"
 #include "MbdCalib.h"
+#include "MbdDefs.h"
 
 #include <phool/phool.h>
 
@@ -17,6 +18,8 @@
 #include <TVirtualFitter.h>
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
@@ -128,6 +131,25 @@ void MbdSig::SetTemplateSize(const Int_t nptsx, const Int_t nptsy, const Double_
   h2Template = new THnSparseF(name,name,2,nbins,lowrange,highrange);
   */
   // h2Template->cd( gDirectory );
+
+  BuildTemplateTable();
+}
+
+void MbdSig::BuildTemplateTable()
+{
+  template_table.clear();
+  if ( template_npointsx < 2 || static_cast<int>(template_y.size()) < template_npointsx )
+  {
+    return;
+  }
+
+  template_step = (template_endtime - template_begintime) / (template_npointsx - 1);
+  template_table.resize(2 * template_npointsx);
+  for (int i = 0; i < template_npointsx; i++)
+  {
+    template_table[2 * i] = template_y[i];
+    template_table[2 * i + 1] = (i < template_npointsx - 1) ? (template_y[i + 1] - template_y[i]) / template_step : 0.;
+  }
 }
 
 void MbdSig::SetMinMaxFitTime(const Double_t mintime, const Double_t maxtime)
@@ -408,7 +430,7 @@ void MbdSig::Remove_Pileup()
       if (_verbose == 0)
       {
         //std::cout << PHWHERE << std::endl;
-        gSubPulse->Fit(template_fcn, "RNQ");
+        TemplateFit(template_fcn);
       }
       else
       {
@@ -1377,7 +1399,7 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   if (_verbose == 0)
   {
     //std::cout << PHWHERE << std::endl;
-    gSubPulse->Fit(template_fcn, "RNQ");
+    TemplateFit(template_fcn);
   }
   else
   {
@@ -1438,7 +1460,7 @@ int MbdSig::FitTemplate( const Int_t sampmax )
 
     if (_verbose == 0)
     {
-      gSubPulse->Fit(twotemplate_fcn, "RNQ");
+      TemplateFit(twotemplate_fcn);
     }
     else
     {
@@ -1513,7 +1535,7 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   if (_verbose == 0)
   {
     //std::cout << PHWHERE << std::endl;
-    gSubPulse->Fit(template_fcn, "RNQ");
+    TemplateFit(template_fcn);
   }
   else
   {
@@ -1560,6 +1582,262 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   return 1;
 }
 
+bool MbdSig::IsThreadSafeFit() const
+{
+  // the ROOT fit and the drawing in verbose mode use global state
+  return _fitengine == NATIVEFIT && _verbose == 0 && !template_table.empty() && gSubPulse != nullptr && gSubPulse->GetN() <= MbdDefs::MAX_SAMPLES;
+}
+
+void MbdSig::TemplateFit(TF1 *fcn)
+{
+  if ( _fitengine == ROOTFIT )
+  {
+    gSubPulse->Fit(fcn, "RNQ");
+    return;
+  }
+
+  if ( _fitengine == NATIVEFIT )
+  {
+    NativeTemplateFit(fcn);
+    return;
+  }
+
+  // validation, run the native fit and the ROOT fit from the same seeds
+  const int npar = fcn->GetNpar();
+  std::array<Double_t, 4> seed{};
+  fcn->GetParameters(seed.data());
+  NativeTemplateFit(fcn);
+
+  std::array<Double_t, 4> native{};
+  fcn->GetParameters(native.data());
+  Double_t native_chi2 = fcn->GetChisquare();
+  Int_t native_ndf = fcn->GetNDF();
+
+  fcn->SetParameters(seed.data());
+  gSubPulse->Fit(fcn, "RNQ");
+
+  _nvalidfits++;
+  bool agree = (native_ndf == fcn->GetNDF());
+  for (int ipar = 0; ipar < npar; ipar += 2)
+  {
+    Double_t ampl = fcn->GetParameter(ipar);
+    Double_t time = fcn->GetParameter(ipar + 1);
+    agree = agree && std::abs(native[ipar] - ampl) <= 0.001 * std::abs(ampl) + 0.1 && std::abs(native[ipar + 1] - time) <= 0.001;
+  }
+
+  if ( !agree )
+  {
+    _nbadvalidfits++;
+    std::cout << "MbdSig::TemplateFit native and ROOT fits differ, evt " << _evt_counter << " ch " << _ch << std::endl;
+    for (int ipar = 0; ipar < npar; ipar++)
+    {
+      std::cout << "  " << fcn->GetParName(ipar) << "\t" << native[ipar] << "\t" << fcn->GetParameter(ipar) << std::endl;
+    }
+    std::cout << "  chi2/ndf\t" << native_chi2 << "/" << native_ndf << "\t" << fcn->GetChisquare() << "/" << fcn->GetNDF() << std::endl;
+  }
+}
+
+// Levenberg-Marquardt fit of one or two templates, a*T(x-t), to gSubPulse.
+// Points are used or rejected as in TemplateFcn, so that chi2 and ndf are the same as for the ROOT fit.
+// All fit storage is on the stack (at most MAX_SAMPLES points and 4 parameters)
+void MbdSig::NativeTemplateFit(TF1 *fcn)
+{
+  const int npar = fcn->GetNpar();
+  const int n = gSubPulse->GetN();
+  if ( template_table.empty() || n > MbdDefs::MAX_SAMPLES || npar > 4 )
+  {
+    gSubPulse->Fit(fcn, "RNQ");
+    return;
+  }
+
+  Double_t xmin{0.};
+  Double_t xmax{0.};
+  fcn->GetRange(xmin, xmax);
+
+  // select points in range, skipping saturated samples
+  // with all errors at zero, ROOT fits with unit errors, otherwise it skips points with zero error
+  const Double_t *gx = gSubPulse->GetX();
+  const Double_t *gy = gSubPulse->GetY();
+  const Double_t *gey = gSubPulse->GetEY();
+  const Double_t *rawy = gRawPulse->GetY();
+  const int nraw = gRawPulse->GetN();
+  const bool has_errors = std::any_of(gey, gey + n, [](const Double_t e) { return e > 0.; });
+
+  std::array<Double_t, MbdDefs::MAX_SAMPLES> xs{};
+  std::array<Double_t, MbdDefs::MAX_SAMPLES> ys{};
+  std::array<Double_t, MbdDefs::MAX_SAMPLES> ws{};  // 1/error
+  int npts = 0;
+  for (int i = 0; i < n; i++)
+  {
+    if ( gx[i] < xmin || gx[i] > xmax || (has_errors && !(gey[i] > 0.)) )
+    {
+      continue;
+    }
+    const int samp_point = static_cast<int>(gx[i]);
+    if ( samp_point >= 0 && samp_point < nraw && rawy[samp_point] > 16370 )
+    {
+      continue;
+    }
+    xs[npts] = gx[i];
+    ys[npts] = gy[i];
+    ws[npts] = has_errors ? 1.0 / gey[i] : 1.0;
+    npts++;
+  }
+
+  // chi2 at par, with the normal equations (alpha = J^T J, beta = J^T r) when requested
+  auto chi2_at = [&](const std::array<Double_t, 4> &par, int &nused, std::array<Double_t, 16> *alpha, std::array<Double_t, 4> *beta)
+  {
+    Double_t chi2 = 0.;
+    nused = 0;
+    if ( alpha )
+    {
+      alpha->fill(0.);
+      beta->fill(0.);
+    }
+    for (int i = 0; i < npts; i++)
+    {
+      Double_t f = 0.;
+      std::array<Double_t, 4> deriv{};
+      bool used = true;
+      for (int ipar = 0; ipar < npar; ipar += 2)
+      {
+        Double_t value{0.};
+        Double_t slope{0.};
+        if ( !TemplateValue(xs[i] - par[ipar + 1], value, slope) )
+        {
+          used = false;
+          break;
+        }
+        f += par[ipar] * value;
+        deriv[ipar] = value * ws[i];
+        deriv[ipar + 1] = -par[ipar] * slope * ws[i];
+      }
+      if ( !used )
+      {
+        continue;
+      }
+
+      const Double_t resid = (ys[i] - f) * ws[i];
+      chi2 += resid * resid;
+      nused++;
+      if ( alpha )
+      {
+        for (int j = 0; j < npar; j++)
+        {
+          (*beta)[j] += deriv[j] * resid;
+          for (int k = 0; k < npar; k++)
+          {
+            (*alpha)[j * 4 + k] += deriv[j] * deriv[k];
+          }
+        }
+      }
+    }
+    return chi2;
+  };
+
+  std::array<Double_t, 4> par{};
+  fcn->GetParameters(par.data());
+
+  std::array<Double_t, 16> alpha{};
+  std::array<Double_t, 4> beta{};
+  int nused = 0;
+  Double_t chi2 = chi2_at(par, nused, &alpha, &beta);
+  Double_t lambda = 0.001;
+
+  for (int iter = 0; iter < 200 && lambda < 1e10; iter++)
+  {
+    // solve (alpha + lambda*diag(alpha)) step = beta, gaussian elimination with partial pivoting
+    std::array<Double_t, 16> a = alpha;
+    std::array<Double_t, 4> step = beta;
+    for (int j = 0; j < npar; j++)
+    {
+      a[j * 4 + j] *= (1. + lambda);
+    }
+
+    bool singular = false;
+    for (int col = 0; col < npar && !singular; col++)
+    {
+      int pivot = col;
+      for (int row = col + 1; row < npar; row++)
+      {
+        if ( std::abs(a[row * 4 + col]) > std::abs(a[pivot * 4 + col]) )
+        {
+          pivot = row;
+        }
+      }
+      if ( !(std::abs(a[pivot * 4 + col]) > 0.) )
+      {
+        singular = true;
+        break;
+      }
+      if ( pivot != col )
+      {
+        for (int k = 0; k < npar; k++)
+        {
+          std::swap(a[col * 4 + k], a[pivot * 4 + k]);
+        }
+        std::swap(step[col], step[pivot]);
+      }
+      for (int row = col + 1; row < npar; row++)
+      {
+        const Double_t factor = a[row * 4 + col] / a[col * 4 + col];
+        for (int k = col; k < npar; k++)
+        {
+          a[row * 4 + k] -= factor * a[col * 4 + k];
+        }
+        step[row] -= factor * step[col];
+      }
+    }
+    if ( singular )
+    {
+      break;
+    }
+    for (int row = npar - 1; row >= 0; row--)
+    {
+      for (int k = row + 1; k < npar; k++)
+      {
+        step[row] -= a[row * 4 + k] * step[k];
+      }
+      step[row] /= a[row * 4 + row];
+    }
+
+    std::array<Double_t, 4> trial = par;
+    for (int j = 0; j < npar; j++)
+    {
+      trial[j] += step[j];
+    }
+
+    int trial_nused = 0;
+    std::array<Double_t, 16> trial_alpha{};
+    std::array<Double_t, 4> trial_beta{};
+    const Double_t trial_chi2 = chi2_at(trial, trial_nused, &trial_alpha, &trial_beta);
+    if ( !(trial_chi2 < chi2) )
+    {
+      lambda *= 10.;
+      continue;
+    }
+
+    const Double_t improvement = chi2 - trial_chi2;
+    par = trial;
+    chi2 = trial_chi2;
+    nused = trial_nused;
+    alpha = trial_alpha;
+    beta = trial_beta;
+    lambda = std::max(lambda * 0.1, 1e-9);
+
+    if ( improvement < 1e-9 * chi2 + 1e-12 )
+    {
+      break;
+    }
+  }
+
+  // store results as the ROOT fit would
+  fcn->SetParameters(par.data());
+  fcn->SetChisquare(chi2);
+  fcn->SetNumberFitPoints(nused);
+  fcn->SetNDF(nused - npar);
+}
+
 int MbdSig::SetTemplate(const std::vector<float>& shape, const std::vector<float>& sherr)
 {
   template_y = shape;
@@ -1610,6 +1888,8 @@ int MbdSig::SetTemplate(const std::vector<float>& shape, const std::vector<float
     }
   }
 
+  BuildTemplateTable();
+
   return 1;
 }
 
@@ -5,6 +5,7 @@
 
 #include <Rtypes.h>
 
+#include <algorithm>
 #include <fstream>
 #include <limits>
 #include <vector>
@@ -25,6 +26,15 @@ MbdSig: Single Channel digital signal class, includes processing
 class MbdSig
 {
  public:
+  /** Template fit engines. ROOTFIT is the default, NATIVEFIT is opt-in.
+      VALIDATEFIT runs both, keeps the ROOT result and reports differences */
+  enum FitEngine
+  {
+    NATIVEFIT = 0,
+    ROOTFIT = 1,
+    VALIDATEFIT = 2
+  };
+
   explicit MbdSig(const int chnum = 0, const int nsamp = 0);
   // explicit MbdSig(const MbdSig &obj);    // never used
   virtual ~MbdSig();
@@ -109,6 +119,17 @@ class MbdSig
 
   /** Use template fit to get ampl and time */
   Int_t FitTemplate(const Int_t sampmax = -1);
+
+  /** Select the template fit engine (see FitEngine), ROOT is the default */
+  void SetFitEngine(const int e) { _fitengine = e; }
+  int  GetFitEngine() const { return _fitengine; }
+
+  /** Number of fits compared, and number of native fits that differ from ROOT, in VALIDATEFIT mode */
+  int  GetNValidatedFits() const { return _nvalidfits; }
+  int  GetNBadValidatedFits() const { return _nbadvalidfits; }
+
+  /** true if FitTemplate only uses channel-local data, so that channels can be fit concurrently */
+  bool IsThreadSafeFit() const;
   // Double_t Ampl() { return f_ampl; }
   // Double_t Time() { return f_time; }
 
@@ -138,6 +159,29 @@ class MbdSig
  private:
   void Init();
 
+  /** Fit fcn (template_fcn or twotemplate_fcn) to gSubPulse with the selected engine.
+   * Seeds and range are taken from fcn, results (parameters, chi2, ndf) are stored back into it */
+  void TemplateFit(TF1 *fcn);
+  void NativeTemplateFit(TF1 *fcn);
+
+  /** Fill template_table from template_y */
+  void BuildTemplateTable();
+
+  /** Template value and slope at xx, false if xx is outside the template (point rejected in TemplateFcn) */
+  bool TemplateValue(const Double_t xx, Double_t &value, Double_t &slope) const
+  {
+    if ( !(xx >= template_begintime && xx <= template_endtime) )
+    {
+      return false;
+    }
+    int ilow = static_cast<int>((xx - template_begintime) / template_step);
+    ilow = std::min(ilow, template_npointsx - 1);
+    const Double_t *entry = &template_table[2 * ilow];
+    value = entry[0] + entry[1] * (xx - template_begintime - ilow * template_step);
+    slope = entry[1];
+    return true;
+  }
+
   int _ch;
   int _nsamples;
   int _status{0};
@@ -203,6 +247,11 @@ class MbdSig
   std::vector<float> template_yrms;
   TF1 *template_fcn{nullptr};
   TF1 *twotemplate_fcn{nullptr};
+  std::vector<Double_t> template_table;  //! interleaved (value, slope) at each template point, for the native fit
+  Double_t template_step{0.};            //! template point spacing
+  int _fitengine{ROOTFIT};
+  int _nvalidfits{0};     //! fits compared in VALIDATEFIT mode
+  int _nbadvalidfits{0};  //! fits where native and ROOT results differ
   Double_t fit_min_time{};  //! min time for fit, in original units of waveform data
   Double_t fit_max_time{};  //! max time for fit, in original units of waveform data
 
@@ -6,6 +6,7 @@
  */
 #include "MvtxClusterizer.h"
 #include "CylinderGeom_Mvtx.h"
+#include "SegmentationAlpide.h"
 
 #include <g4detectors/PHG4CylinderGeom.h>
 #include <g4detectors/PHG4CylinderGeomContainer.h>
@@ -13,6 +14,7 @@
 #include <trackbase/ClusHitsVerbosev1.h>
 #include <trackbase/MvtxDefs.h>
 #include <trackbase/TrkrClusterContainerv4.h>
+#include <trackbase/TrkrClusterContainerv5.h>
 #include <trackbase/TrkrClusterHitAssocv3.h>
 #include <trackbase/TrkrClusterv3.h>
 #include <trackbase/TrkrClusterv4.h>
@@ -34,6 +36,7 @@
 #include <phool/PHNode.h>  // for PHNode
 #include <phool/PHNodeIterator.h>
 #include <phool/PHObject.h>  // for PHObject
+#include <phool/PHThreadPool.h>
 #include <phool/getClass.h>
 #include <phool/phool.h>  // for PHWHERE
 
@@ -42,18 +45,14 @@
 #include <TMatrixTUtils.h>  // for TMatrixTRow
 #include <TVector3.h>
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-#include <boost/graph/adjacency_list.hpp>
-#pragma GCC diagnostic pop
-
-#include <boost/graph/connected_components.hpp>
-
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>  // for exit
 #include <iostream>
-#include <map>  // for multimap<>::iterator
+#include <map>
+#include <numeric>
 #include <set>  // for set, set<>::iterator
 #include <string>
 #include <vector>  // for vector
@@ -67,56 +66,152 @@ namespace
   {
     return x * x;
   }
-}  // namespace
 
-bool MvtxClusterizer::are_adjacent(
-    const std::pair<TrkrDefs::hitkey, TrkrHit *> &lhs,
-    const std::pair<TrkrDefs::hitkey, TrkrHit *> &rhs) const
-{
-  if (GetZClustering())
+  /// union-find root, with path halving
+  int find_root(std::vector<int> &parent, int i)
   {
-    return
+    while (parent[i] != i)
+    {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  }
 
-        // column adjacent
-        ((MvtxDefs::getCol(lhs.first) > MvtxDefs::getCol(rhs.first)) ? MvtxDefs::getCol(lhs.first) <= MvtxDefs::getCol(rhs.first) + 1 : MvtxDefs::getCol(rhs.first) <= MvtxDefs::getCol(lhs.first) + 1) &&
+  /// connected components of adjacent pixels, (row, column), of one chip
+  /**
+   * pixels are sorted by (row, column) and visited in that order. Each pixel is merged (union-find)
+   * with its already visited neighbors: the previous row and the previous column with z clustering,
+   * the previous row of the same column otherwise. An occupancy bitmap of the chip avoids searching for empty neighbors.
+   * Components are numbered in order of their first pixel, as boost::connected_components does,
+   * so that cluster keys do not depend on the algorithm. Returns the number of components
+   */
+  unsigned int find_components(const std::vector<MvtxClusterizer::pixel> &pixels, bool zclustering, std::vector<int> &component)
+  {
+    // scratch buffers, reused for all chips processed by a given thread
+    thread_local std::vector<uint64_t> bitmap;
+    thread_local std::vector<std::pair<uint32_t, int>> sorted;
+    thread_local std::vector<int> parent;
+
+    const int nhits = pixels.size();
+    const auto pixel_key = [](unsigned int row, unsigned int col)
+    { return static_cast<uint32_t>((row << 16U) | col); };
+
+    // pixels outside of the chip (none expected) disable the bitmap
+    bool use_bitmap = true;
+    sorted.clear();
+    for (int i = 0; i < nhits; ++i)
+    {
+      const auto &[row, col] = pixels[i];
+      use_bitmap = use_bitmap && row < static_cast<unsigned int>(SegmentationAlpide::NRows) && col < static_cast<unsigned int>(SegmentationAlpide::NCols);
+      sorted.emplace_back(pixel_key(row, col), i);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    if (use_bitmap && bitmap.empty())
+    {
+      bitmap.assign(SegmentationAlpide::NPixels / 64, 0);
+    }
 
-        // row adjacent
-        ((MvtxDefs::getRow(lhs.first) > MvtxDefs::getRow(rhs.first)) ? MvtxDefs::getRow(lhs.first) <= MvtxDefs::getRow(rhs.first) + 1 : MvtxDefs::getRow(rhs.first) <= MvtxDefs::getRow(lhs.first) + 1);
-  }
-  return
-      // column identical
-      MvtxDefs::getCol(rhs.first) == MvtxDefs::getCol(lhs.first) &&
+    parent.resize(nhits);
+    std::iota(parent.begin(), parent.end(), 0);
+    const auto unite = [](int a, int b)
+    {
+      a = find_root(parent, a);
+      b = find_root(parent, b);
+      if (a != b)
+      {
+        parent[std::max(a, b)] = std::min(a, b);
+      }
+    };
 
-      // row adjacent
-      ((MvtxDefs::getRow(lhs.first) > MvtxDefs::getRow(rhs.first)) ? MvtxDefs::getRow(lhs.first) <= MvtxDefs::getRow(rhs.first) + 1 : MvtxDefs::getRow(rhs.first) <= MvtxDefs::getRow(lhs.first) + 1);
-}
+    const auto bit = [](unsigned int row, unsigned int col)
+    { return static_cast<std::size_t>(row) * SegmentationAlpide::NCols + col; };
 
-bool MvtxClusterizer::are_adjacent(RawHit *lhs, RawHit *rhs) const
-{
-  if (GetZClustering())
-  {
-    return
+    // visited neighbors, as (row offset, column offset)
+    static constexpr std::array<std::pair<int, int>, 4> neighbors_z = {{{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}}};
+    static constexpr std::array<std::pair<int, int>, 1> neighbors_noz = {{{-1, 0}}};
+    const std::pair<int, int> *neighbors_begin = zclustering ? neighbors_z.data() : neighbors_noz.data();
+    const std::pair<int, int> *neighbors_end = zclustering ? neighbors_z.data() + neighbors_z.size() : neighbors_noz.data() + neighbors_noz.size();
 
-        // phi adjacent (== column)
-        ((lhs->getPhiBin() > rhs->getPhiBin()) ? lhs->getPhiBin() <= rhs->getPhiBin() + 1 : rhs->getPhiBin() <= lhs->getPhiBin() + 1) &&
+    for (int pos = 0; pos < nhits; ++pos)
+    {
+      const auto &[key, ihit] = sorted[pos];
+      const int row = key >> 16U;
+      const int col = key & 0xFFFFU;
 
-        // time adjacent (== row)
-        ((lhs->getTBin() > rhs->getTBin()) ? lhs->getTBin() <= rhs->getTBin() + 1 : rhs->getTBin() <= lhs->getTBin() + 1);
-  }
-  return
+      // duplicated pixel
+      if (pos > 0 && sorted[pos - 1].first == key)
+      {
+        unite(ihit, sorted[pos - 1].second);
+        continue;
+      }
 
-      // phi identical (== column)
-      lhs->getPhiBin() == rhs->getPhiBin() &&
+      for (const auto *neighbor = neighbors_begin; neighbor != neighbors_end; ++neighbor)
+      {
+        const int nrow = row + neighbor->first;
+        const int ncol = col + neighbor->second;
+        if (nrow < 0 || ncol < 0 || (use_bitmap && ncol >= SegmentationAlpide::NCols))
+        {
+          continue;
+        }
+        if (use_bitmap)
+        {
+          const std::size_t ibit = bit(nrow, ncol);
+          if (!(bitmap[ibit / 64] & (uint64_t(1) << (ibit % 64))))
+          {
+            continue;
+          }
+        }
+        const auto nkey = pixel_key(nrow, ncol);
+        const auto iter = std::lower_bound(sorted.begin(), sorted.begin() + pos, nkey, [](const std::pair<uint32_t, int> &lhs, uint32_t rhs)
+                                           { return lhs.first < rhs; });
+        if (iter != sorted.begin() + pos && iter->first == nkey)
+        {
+          unite(ihit, iter->second);
+        }
+      }
 
-      // time adjacent (== row)
-      ((lhs->getTBin() > rhs->getTBin()) ? lhs->getTBin() <= rhs->getTBin() + 1 : rhs->getTBin() <= lhs->getTBin() + 1);
-}
+      if (use_bitmap)
+      {
+        const std::size_t ibit = bit(row, col);
+        bitmap[ibit / 64] |= (uint64_t(1) << (ibit % 64));
+      }
+    }
+
+    // reset the bitmap
+    if (use_bitmap)
+    {
+      for (const auto &[row, col] : pixels)
+      {
+        const std::size_t ibit = bit(row, col);
+        bitmap[ibit / 64] &= ~(uint64_t(1) << (ibit % 64));
+      }
+    }
+
+    // number components in order of their first hit
+    component.assign(nhits, -1);
+    unsigned int ncomponents = 0;
+    for (int i = 0; i < nhits; ++i)
+    {
+      const int root = find_root(parent, i);
+      if (component[root] < 0)
+      {
+        component[root] = ncomponents++;
+      }
+      component[i] = component[root];
+    }
+    return ncomponents;
+  }
+}  // namespace
 
 MvtxClusterizer::MvtxClusterizer(const std::string &name)
   : SubsysReco(name)
 {
 }
 
+// needed here for unique_ptr to incomplete PHThreadPool in header
+MvtxClusterizer::~MvtxClusterizer() = default;
+
 int MvtxClusterizer::InitRun(PHCompositeNode *topNode)
 {
   //-----------------
@@ -157,7 +252,14 @@ int MvtxClusterizer::InitRun(PHCompositeNode *topNode)
       dstNode->addNode(DetNode);
     }
 
-    trkrclusters = new TrkrClusterContainerv4;
+    if (m_use_clustercontainer_v5)
+    {
+      trkrclusters = new TrkrClusterContainerv5;
+    }
+    else
+    {
+      trkrclusters = new TrkrClusterContainerv4;
+    }
     PHIODataNode<PHObject> *TrkrClusterContainerNode =
         new PHIODataNode<PHObject>(trkrclusters, "TRKR_CLUSTER", "PHObject");
     DetNode->addNode(TrkrClusterContainerNode);
@@ -200,6 +302,12 @@ int MvtxClusterizer::InitRun(PHCompositeNode *topNode)
     }
   }
 
+  // chips are clustered concurrently
+  if (!m_threadPool)
+  {
+    m_threadPool = std::make_unique<PHThreadPool>(m_num_threads);
+  }
+
   //----------------
   // Report Settings
   //----------------
@@ -211,6 +319,7 @@ int MvtxClusterizer::InitRun(PHCompositeNode *topNode)
               << std::endl;
     std::cout << " Z-dimension Clustering = " << std::boolalpha << m_makeZClustering
               << std::noboolalpha << std::endl;
+    std::cout << " Worker threads = " << m_threadPool->size() << std::endl;
     std::cout << "=================================================================="
                  "========="
               << std::endl;
@@ -303,20 +412,28 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
   //-----------
 
   // loop over each MvtxHitSet object (chip)
+  std::vector<TrkrHitSet *> hitsets;
   TrkrHitSetContainer::ConstRange hitsetrange =
       m_hits->getHitSets(TrkrDefs::TrkrId::mvtxId);
   for (TrkrHitSetContainer::ConstIterator hitsetitr = hitsetrange.first;
        hitsetitr != hitsetrange.second; ++hitsetitr)
   {
-    TrkrHitSet *hitset = hitsetitr->second;
+    hitsets.push_back(hitsetitr->second);
+  }
+
+  std::vector<std::vector<ChipCluster>> chipclusters(hitsets.size());
+  auto cluster_chip = [&](const std::size_t index, const unsigned int /*worker*/)
+  {
+    TrkrHitSet *hitset = hitsets[index];
+    const auto hitsetkey = hitset->getHitSetKey();
 
     if (Verbosity() > 0)
     {
-      unsigned int layer = TrkrDefs::getLayer(hitsetitr->first);
-      unsigned int stave = MvtxDefs::getStaveId(hitsetitr->first);
-      unsigned int chip = MvtxDefs::getChipId(hitsetitr->first);
-      unsigned int strobe = MvtxDefs::getStrobeId(hitsetitr->first);
-      std::cout << "MvtxClusterizer found hitsetkey " << hitsetitr->first
+      unsigned int layer = TrkrDefs::getLayer(hitsetkey);
+      unsigned int stave = MvtxDefs::getStaveId(hitsetkey);
+      unsigned int chip = MvtxDefs::getChipId(hitsetkey);
+      unsigned int strobe = MvtxDefs::getStrobeId(hitsetkey);
+      std::cout << "MvtxClusterizer found hitsetkey " << hitsetkey
                 << " layer " << layer << " stave " << stave << " chip " << chip
                 << " strobe " << strobe << std::endl;
     }
@@ -327,266 +444,83 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
     }
 
     // fill a vector of hits to make things easier
-    std::vector<std::pair<TrkrDefs::hitkey, TrkrHit *> > hitvec;
-
+    ChipHits hits;
     TrkrHitSet::ConstRange hitrangei = hitset->getHits();
     for (TrkrHitSet::ConstIterator hitr = hitrangei.first;
          hitr != hitrangei.second; ++hitr)
     {
-      hitvec.emplace_back(hitr->first, hitr->second);
+      hits.pixels.emplace_back(MvtxDefs::getRow(hitr->first), MvtxDefs::getCol(hitr->first));
+      hits.hitkeys.push_back(hitr->first);
+      hits.energies.push_back(hitr->second->getAdc());
     }
     if (Verbosity() > 2)
     {
-      std::cout << "hitvec.size(): " << hitvec.size() << std::endl;
+      std::cout << "hitvec.size(): " << hits.pixels.size() << std::endl;
     }
 
     if (Verbosity() > 0)
     {
-      for (auto &hit : hitvec)
+      for (unsigned int i = 0; i < hits.pixels.size(); i++)
       {
-        auto hitkey = hit.first;
-        auto row = MvtxDefs::getRow(hitkey);
-        auto col = MvtxDefs::getCol(hitkey);
-        std::cout << "      hitkey " << hitkey << " row " << row << " col "
-                  << col << std::endl;
+        std::cout << "      hitkey " << hits.hitkeys[i] << " row " << hits.pixels[i].first << " col "
+                  << hits.pixels[i].second << std::endl;
       }
     }
 
-    // do the clustering
-    using Graph = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>;
-    Graph G;
+    ClusterChip(hitsetkey, hits, geom_container, chipclusters[index]);
+  };
 
-    // loop over hits in this chip
-    for (unsigned int i = 0; i < hitvec.size(); i++)
+  // chips are independent. Verbose printout is kept in order by running serially
+  if (m_threadPool && Verbosity() == 0)
+  {
+    m_threadPool->parallel_for(hitsets.size(), cluster_chip);
+  }
+  else
+  {
+    for (std::size_t index = 0; index < hitsets.size(); ++index)
     {
-      for (unsigned int j = 0; j < hitvec.size(); j++)
-      {
-        if (are_adjacent(hitvec[i], hitvec[j]))
-        {
-          add_edge(i, j, G);
-        }
-      }
+      cluster_chip(index, 0);
     }
+  }
 
-    // Find the connections between the vertices of the graph (vertices are the
-    // rawhits,
-    // connections are made when they are adjacent to one another)
-    std::vector<int> component(num_vertices(G));
-
-    // this is the actual clustering, performed by boost
-    boost::connected_components(G, component.data());
-
-    // Loop over the components(hits) compiling a list of the
-    // unique connected groups (ie. clusters).
-    std::set<int> cluster_ids;  // unique components
-    std::multimap<int, std::pair<TrkrDefs::hitkey, TrkrHit *> > clusters;
-    for (unsigned int i = 0; i < component.size(); i++)
-    {
-      cluster_ids.insert(component[i]);
-      clusters.insert(make_pair(component[i], hitvec[i]));
-    }
-    for (const auto &clusid : cluster_ids)
+  // store clusters and associations, in chip order
+  for (auto &clusters : chipclusters)
+  {
+    for (auto &cluster : clusters)
     {
-      auto clusrange = clusters.equal_range(clusid);
-      auto ckey = TrkrDefs::genClusKey(hitset->getHitSetKey(), clusid);
-
-      // determine the size of the cluster in phi and z
-      std::set<int> phibins;
-      std::set<int> zbins;
-      std::map<int, unsigned int> m_phi;
-      std::map<int, unsigned int> m_z;  // Note, there are no "cut" bins for Svtx Clusters
-
-      // determine the cluster position...
-      double locxsum = 0.;
-      double loczsum = 0.;
-      const unsigned int nhits =
-          std::distance(clusrange.first, clusrange.second);
-
-      double locclusx = std::numeric_limits<double>::quiet_NaN();
-      double locclusz = std::numeric_limits<double>::quiet_NaN();
-
-      // we need the geometry object for this layer to get the global positions
-      int layer = TrkrDefs::getLayer(ckey);
-      auto *layergeom = dynamic_cast<CylinderGeom_Mvtx *>(geom_container->GetLayerGeom(layer));
-      if (!layergeom)
+      // add the association between this cluster key and its hitkeys to the table
+      for (const auto &hitkey : cluster.hitkeys)
       {
-        exit(1);
+        m_clusterhitassoc->addAssoc(cluster.key, hitkey);
       }
 
-      for (auto mapiter = clusrange.first; mapiter != clusrange.second;
-           ++mapiter)
-      {
-        // size
-        const auto energy = (mapiter->second).second->getAdc();
-        int col = MvtxDefs::getCol((mapiter->second).first);
-        int row = MvtxDefs::getRow((mapiter->second).first);
-        zbins.insert(col);
-        phibins.insert(row);
-
-        if (mClusHitsVerbose)
-        {
-          auto pnew = m_phi.try_emplace(row, energy);
-          if (!pnew.second)
-          {
-            pnew.first->second += energy;
-          }
-
-          pnew = m_z.try_emplace(col, energy);
-          if (!pnew.second)
-          {
-            pnew.first->second += energy;
-          }
-        }
-
-        // get local coordinates, in stae reference frame, for hit
-        auto local_coords = layergeom->get_local_coords_from_pixel(row, col);
-
-        /*
-          manually offset position along y (thickness of the sensor),
-          to account for effective hit position in the sensor, resulting from
-          diffusion.
-          Effective position corresponds to 1um above the middle of the sensor
-        */
-        local_coords.SetY(1e-4);
-
-        // update cluster position
-        locxsum += local_coords.X();
-        loczsum += local_coords.Z();
-        // add the association between this cluster key and this hitkey to the
-        // table
-        m_clusterhitassoc->addAssoc(ckey, mapiter->second.first);
-
-      }  // mapiter
-
       if (mClusHitsVerbose)
       {
         if (Verbosity() > 10)
         {
-          for (auto &hit : m_phi)
+          for (auto &hit : cluster.phi_energy)
           {
             std::cout << " m_phi(" << hit.first << " : " << hit.second << ") "
                       << std::endl;
           }
         }
-        for (auto &hit : m_phi)
+        for (auto &hit : cluster.phi_energy)
         {
           mClusHitsVerbose->addPhiHit(hit.first, (float) hit.second);
         }
-        for (auto &hit : m_z)
+        for (auto &hit : cluster.z_energy)
         {
           mClusHitsVerbose->addZHit(hit.first, (float) hit.second);
         }
-        mClusHitsVerbose->push_hits(ckey);
-      }
-
-      // This is the local position
-      locclusx = locxsum / nhits;
-      locclusz = loczsum / nhits;
-
-      const double pitch = layergeom->get_pixel_x();
-      const double length = layergeom->get_pixel_z();
-      const double phisize = phibins.size() * pitch;
-      const double zsize = zbins.size() * length;
-
-      static const double invsqrt12 = 1. / std::sqrt(12);
-
-      // scale factors (phi direction)
-      /*
-        they corresponds to clusters of size (2,2), (2,3), (3,2) and (3,3) in
-        phi and z
-        other clusters, which are very few and pathological, get a scale factor
-        of 1
-        These scale factors are applied to produce cluster pulls with width
-        unity
-      */
-
-      double phierror = pitch * invsqrt12;
-
-      static constexpr std::array<double, 7> scalefactors_phi = {
-          {0.36, 0.6, 0.37, 0.49, 0.4, 0.37, 0.33}};
-
-      if ((phibins.size() == 1 && zbins.size() == 1) ||
-          (phibins.size() == 2 && zbins.size() == 2))
-      {
-        phierror *= scalefactors_phi[0];
-      }
-      else if ((phibins.size() == 2 && zbins.size() == 1) ||
-               (phibins.size() == 2 && zbins.size() == 3))
-      {
-        phierror *= scalefactors_phi[1];
-      }
-      else if ((phibins.size() == 1 && zbins.size() == 2) ||
-               (phibins.size() == 3 && zbins.size() == 2))
-      {
-        phierror *= scalefactors_phi[2];
-      }
-      else if (phibins.size() == 3 && zbins.size() == 3)
-      {
-        phierror *= scalefactors_phi[3];
-      }
-
-      // scale factors (z direction)
-      /*
-        they corresponds to clusters of size (2,2), (2,3), (3,2) and (3,3) in z
-        and phi
-        other clusters, which are very few and pathological, get a scale factor
-        of 1
-      */
-      static constexpr std::array<double, 4> scalefactors_z = {
-          {0.47, 0.48, 0.71, 0.55}};
-      double zerror = length * invsqrt12;
-      if (zbins.size() == 2 && phibins.size() == 2)
-      {
-        zerror *= scalefactors_z[0];
-      }
-      else if (zbins.size() == 2 && phibins.size() == 3)
-      {
-        zerror *= scalefactors_z[1];
-      }
-      else if (zbins.size() == 3 && phibins.size() == 2)
-      {
-        zerror *= scalefactors_z[2];
-      }
-      else if (zbins.size() == 3 && phibins.size() == 3)
-      {
-        zerror *= scalefactors_z[3];
+        mClusHitsVerbose->push_hits(cluster.key);
       }
 
-      if (Verbosity() > 0)
+      if (cluster.cluster)
       {
-        std::cout << " MvtxClusterizer: cluskey " << ckey << " layer " << layer
-                  << " rad " << layergeom->get_radius() << " phibins "
-                  << phibins.size() << " pitch " << pitch << " phisize " << phisize
-                  << " zbins " << zbins.size() << " length " << length << " zsize "
-                  << zsize << " local x " << locclusx << " local y " << locclusz
-                  << std::endl;
+        m_clusterlist->addClusterSpecifyKey(cluster.key, cluster.cluster.release());
       }
-
-      auto clus = std::make_unique<TrkrClusterv5>();
-      clus->setAdc(nhits);
-      clus->setMaxAdc(1);
-      clus->setLocalX(locclusx);
-      clus->setLocalY(locclusz);
-      clus->setPhiError(phierror);
-      clus->setZError(zerror);
-      clus->setPhiSize(phibins.size());
-      clus->setZSize(zbins.size());
-      // All silicon surfaces have a 1-1 map to hitsetkey.
-      // So set subsurface key to 0
-      clus->setSubSurfKey(0);
-
-      if (Verbosity() > 2)
-      {
-        clus->identify();
-      }
-
-      if (zbins.size() <= 127)
-      {
-        m_clusterlist->addClusterSpecifyKey(ckey, clus.release());
-      }
-
-    }  // clusitr loop
-  }  // loop over hitsets
+    }
+  }
 
   if (Verbosity() > 1)
   {
@@ -617,20 +551,28 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
   //-----------
 
   // loop over each MvtxHitSet object (chip)
+  std::vector<RawHitSet *> hitsets;
   RawHitSetContainer::ConstRange hitsetrange =
       m_rawhits->getHitSets(TrkrDefs::TrkrId::mvtxId);
   for (RawHitSetContainer::ConstIterator hitsetitr = hitsetrange.first;
        hitsetitr != hitsetrange.second; ++hitsetitr)
   {
-    RawHitSet *hitset = hitsetitr->second;
+    hitsets.push_back(hitsetitr->second);
+  }
+
+  std::vector<std::vector<ChipCluster>> chipclusters(hitsets.size());
+  auto cluster_chip = [&](const std::size_t index, const unsigned int /*worker*/)
+  {
+    RawHitSet *hitset = hitsets[index];
+    const auto hitsetkey = hitset->getHitSetKey();
 
     if (Verbosity() > 0)
     {
-      unsigned int layer = TrkrDefs::getLayer(hitsetitr->first);
-      unsigned int stave = MvtxDefs::getStaveId(hitsetitr->first);
-      unsigned int chip = MvtxDefs::getChipId(hitsetitr->first);
-      unsigned int strobe = MvtxDefs::getStrobeId(hitsetitr->first);
-      std::cout << "MvtxClusterizer found hitsetkey " << hitsetitr->first
+      unsigned int layer = TrkrDefs::getLayer(hitsetkey);
+      unsigned int stave = MvtxDefs::getStaveId(hitsetkey);
+      unsigned int chip = MvtxDefs::getChipId(hitsetkey);
+      unsigned int strobe = MvtxDefs::getStrobeId(hitsetkey);
+      std::cout << "MvtxClusterizer found hitsetkey " << hitsetkey
                 << " layer " << layer << " stave " << stave << " chip " << chip
                 << " strobe " << strobe << std::endl;
     }
@@ -641,230 +583,252 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
     }
 
     // fill a vector of hits to make things easier
-    std::vector<RawHit *> hitvec;
-
+    // row is the time bin, column is the phi bin
+    ChipHits hits;
     RawHitSet::ConstRange hitrangei = hitset->getHits();
     for (RawHitSet::ConstIterator hitr = hitrangei.first;
          hitr != hitrangei.second; ++hitr)
     {
-      hitvec.push_back((*hitr));
+      hits.pixels.emplace_back((*hitr)->getTBin(), (*hitr)->getPhiBin());
     }
     if (Verbosity() > 2)
     {
-      std::cout << "hitvec.size(): " << hitvec.size() << std::endl;
+      std::cout << "hitvec.size(): " << hits.pixels.size() << std::endl;
     }
 
-    // do the clustering
-    using Graph = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>;
-    Graph G;
+    ClusterChip(hitsetkey, hits, geom_container, chipclusters[index]);
+  };
 
-    // loop over hits in this chip
-    for (unsigned int i = 0; i < hitvec.size(); i++)
+  // chips are independent. Verbose printout is kept in order by running serially
+  if (m_threadPool && Verbosity() == 0)
+  {
+    m_threadPool->parallel_for(hitsets.size(), cluster_chip);
+  }
+  else
+  {
+    for (std::size_t index = 0; index < hitsets.size(); ++index)
     {
-      for (unsigned int j = 0; j < hitvec.size(); j++)
+      cluster_chip(index, 0);
+    }
+  }
+
+  // store clusters, in chip order. Raw hits have no hit association
+  for (auto &clusters : chipclusters)
+  {
+    for (auto &cluster : clusters)
+    {
+      if (cluster.cluster)
       {
-        if (are_adjacent(hitvec[i], hitvec[j]))
-        {
-          add_edge(i, j, G);
-        }
+        m_clusterlist->addClusterSpecifyKey(cluster.key, cluster.cluster.release());
       }
     }
+  }
 
-    // Find the connections between the vertices of the graph (vertices are the
-    // rawhits,
-    // connections are made when they are adjacent to one another)
-    std::vector<int> component(num_vertices(G));
+  if (Verbosity() > 1)
+  {
+    // check that the associations were written correctly
+    m_clusterhitassoc->identify();
+  }
 
-    // this is the actual clustering, performed by boost
-    boost::connected_components(G, component.data());
+  return;
+}
 
-    // Loop over the components(hits) compiling a list of the
-    // unique connected groups (ie. clusters).
-    std::set<int> cluster_ids;  // unique components
+void MvtxClusterizer::ClusterChip(TrkrDefs::hitsetkey hitsetkey, const ChipHits &hits, PHG4CylinderGeomContainer *geom_container, std::vector<ChipCluster> &clusters) const
+{
+  // this is the actual clustering
+  std::vector<int> component;
+  const unsigned int nclusters = find_components(hits.pixels, GetZClustering(), component);
 
-    std::multimap<int, RawHit *> clusters;
+  // group hits by cluster, keeping hit order within each cluster
+  std::vector<unsigned int> offsets(nclusters + 1, 0);
+  for (const int clusid : component)
+  {
+    ++offsets[clusid + 1];
+  }
+  for (unsigned int clusid = 0; clusid < nclusters; ++clusid)
+  {
+    offsets[clusid + 1] += offsets[clusid];
+  }
+  std::vector<unsigned int> members(component.size());
+  {
+    std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
     for (unsigned int i = 0; i < component.size(); i++)
     {
-      cluster_ids.insert(component[i]);
-      clusters.emplace(component[i], hitvec[i]);
+      members[cursor[component[i]]++] = i;
     }
-    //    std::cout << "found cluster #: "<< clusters.size()<< std::endl;
-    // loop over the componenets and make clusters
-    for (const auto &clusid : cluster_ids)
-    {
-      auto clusrange = clusters.equal_range(clusid);
+  }
 
-      // make the cluster directly in the node tree
-      auto ckey = TrkrDefs::genClusKey(hitset->getHitSetKey(), clusid);
+  // we need the geometry object for this layer to get the global positions
+  int layer = TrkrDefs::getLayer(hitsetkey);
+  auto *layergeom = dynamic_cast<CylinderGeom_Mvtx *>(geom_container->GetLayerGeom(layer));
+  if (!layergeom)
+  {
+    exit(1);
+  }
 
-      // determine the size of the cluster in phi and z
-      std::set<int> phibins;
-      std::set<int> zbins;
+  const bool with_hitkeys = !hits.hitkeys.empty();
+  clusters.resize(nclusters);
+  for (unsigned int clusid = 0; clusid < nclusters; ++clusid)
+  {
+    auto &cluster = clusters[clusid];
+    cluster.key = TrkrDefs::genClusKey(hitsetkey, clusid);
+    const auto ckey = cluster.key;
 
-      // determine the cluster position...
-      double locxsum = 0.;
-      double loczsum = 0.;
-      const unsigned int nhits =
-          std::distance(clusrange.first, clusrange.second);
+    // determine the size of the cluster in phi and z
+    std::set<int> phibins;
+    std::set<int> zbins;
 
-      double locclusx = NAN;
-      double locclusz = NAN;
+    // determine the cluster position...
+    double locxsum = 0.;
+    double loczsum = 0.;
+    const unsigned int nhits = offsets[clusid + 1] - offsets[clusid];
 
-      // we need the geometry object for this layer to get the global positions
-      int layer = TrkrDefs::getLayer(ckey);
-      auto *layergeom = dynamic_cast<CylinderGeom_Mvtx *>(
-          geom_container->GetLayerGeom(layer));
-      if (!layergeom)
-      {
-        exit(1);
-      }
+    double locclusx = std::numeric_limits<double>::quiet_NaN();
+    double locclusz = std::numeric_limits<double>::quiet_NaN();
 
-      for (auto mapiter = clusrange.first; mapiter != clusrange.second;
-           ++mapiter)
-      {
-        // size
-        int col = (mapiter->second)->getPhiBin();
-        int row = (mapiter->second)->getTBin();
-        zbins.insert(col);
-        phibins.insert(row);
-
-        // get local coordinates, in stae reference frame, for hit
-        auto local_coords = layergeom->get_local_coords_from_pixel(row, col);
-
-        /*
-          manually offset position along y (thickness of the sensor),
-          to account for effective hit position in the sensor, resulting from
-          diffusion.
-          Effective position corresponds to 1um above the middle of the sensor
-        */
-        local_coords.SetY(1e-4);
-
-        // update cluster position
-        locxsum += local_coords.X();
-        loczsum += local_coords.Z();
-        // add the association between this cluster key and this hitkey to the
-        // table
-        //	      m_clusterhitassoc->addAssoc(ckey, mapiter->second.first);
-
-      }  // mapiter
-
-      // This is the local position
-      locclusx = locxsum / nhits;
-      locclusz = loczsum / nhits;
-
-      const double pitch = layergeom->get_pixel_x();
-      //	std::cout << " pitch: " <<  pitch << std::endl;
-      const double length = layergeom->get_pixel_z();
-      //	std::cout << " length: " << length << std::endl;
-      const double phisize = phibins.size() * pitch;
-      const double zsize = zbins.size() * length;
-
-      static const double invsqrt12 = 1. / std::sqrt(12);
-
-      // scale factors (phi direction)
-      /*
-        they corresponds to clusters of size (2,2), (2,3), (3,2) and (3,3) in
-        phi and z
-        other clusters, which are very few and pathological, get a scale factor
-        of 1
-        These scale factors are applied to produce cluster pulls with width
-        unity
-      */
+    for (unsigned int imember = offsets[clusid]; imember < offsets[clusid + 1]; ++imember)
+    {
+      const unsigned int ihit = members[imember];
 
-      double phierror = pitch * invsqrt12;
+      // size
+      int row = hits.pixels[ihit].first;
+      int col = hits.pixels[ihit].second;
+      zbins.insert(col);
+      phibins.insert(row);
 
-      static constexpr std::array<double, 7> scalefactors_phi = {
-          {0.36, 0.6, 0.37, 0.49, 0.4, 0.37, 0.33}};
-      if ((phibins.size() == 1 && zbins.size() == 1) ||
-          (phibins.size() == 2 && zbins.size() == 2))
-      {
-        phierror *= scalefactors_phi[0];
-      }
-      else if ((phibins.size() == 2 && zbins.size() == 1) ||
-               (phibins.size() == 2 && zbins.size() == 3))
-      {
-        phierror *= scalefactors_phi[1];
-      }
-      else if ((phibins.size() == 1 && zbins.size() == 2) ||
-               (phibins.size() == 3 && zbins.size() == 2))
+      if (with_hitkeys)
       {
-        phierror *= scalefactors_phi[2];
-      }
-      else if (phibins.size() == 3 && zbins.size() == 3)
-      {
-        phierror *= scalefactors_phi[3];
+        cluster.hitkeys.push_back(hits.hitkeys[ihit]);
+        if (mClusHitsVerbose)
+        {
+          const auto energy = hits.energies[ihit];
+          cluster.phi_energy[row] += energy;
+          cluster.z_energy[col] += energy;
+        }
       }
 
-      // scale factors (z direction)
+      // get local coordinates, in stae reference frame, for hit
+      auto local_coords = layergeom->get_local_coords_from_pixel(row, col);
+
       /*
-        they corresponds to clusters of size (2,2), (2,3), (3,2) and (3,3) in z
-        and phi
-        other clusters, which are very few and pathological, get a scale factor
-        of 1
+        manually offset position along y (thickness of the sensor),
+        to account for effective hit position in the sensor, resulting from
+        diffusion.
+        Effective position corresponds to 1um above the middle of the sensor
       */
-      static constexpr std::array<double, 4> scalefactors_z = {
-          {0.47, 0.48, 0.71, 0.55}};
-      double zerror = length * invsqrt12;
+      local_coords.SetY(1e-4);
 
-      if (zbins.size() == 2 && phibins.size() == 2)
-      {
-        zerror *= scalefactors_z[0];
-      }
-      else if (zbins.size() == 2 && phibins.size() == 3)
-      {
-        zerror *= scalefactors_z[1];
-      }
-      else if (zbins.size() == 3 && phibins.size() == 2)
-      {
-        zerror *= scalefactors_z[2];
-      }
-      else if (zbins.size() == 3 && phibins.size() == 3)
-      {
-        zerror *= scalefactors_z[3];
-      }
+      // update cluster position
+      locxsum += local_coords.X();
+      loczsum += local_coords.Z();
+    }
 
-      if (Verbosity() > 0)
-      {
-        std::cout << " MvtxClusterizer: cluskey " << ckey << " layer " << layer
-                  << " rad " << layergeom->get_radius() << " phibins "
-                  << phibins.size() << " pitch " << pitch << " phisize " << phisize
-                  << " zbins " << zbins.size() << " length " << length << " zsize "
-                  << zsize << " local x " << locclusx << " local y " << locclusz
-                  << std::endl;
-      }
+    // This is the local position
+    locclusx = locxsum / nhits;
+    locclusz = loczsum / nhits;
 
-      auto clus = std::make_unique<TrkrClusterv5>();
-      clus->setAdc(nhits);
-      clus->setMaxAdc(1);
-      clus->setLocalX(locclusx);
-      clus->setLocalY(locclusz);
-      clus->setPhiError(phierror);
-      clus->setZError(zerror);
-      clus->setPhiSize(phibins.size());
-      clus->setZSize(zbins.size());
-      // All silicon surfaces have a 1-1 map to hitsetkey.
-      // So set subsurface key to 0
-      clus->setSubSurfKey(0);
-
-      if (Verbosity() > 2)
-      {
-        clus->identify();
-      }
+    const double pitch = layergeom->get_pixel_x();
+    const double length = layergeom->get_pixel_z();
+    const double phisize = phibins.size() * pitch;
+    const double zsize = zbins.size() * length;
 
-      if (zbins.size() <= 127)
-      {
-        m_clusterlist->addClusterSpecifyKey(ckey, clus.release());
-      }
-    }  // clusitr loop
-  }  // loop over hitsets
+    static const double invsqrt12 = 1. / std::sqrt(12);
 
-  if (Verbosity() > 1)
-  {
-    // check that the associations were written correctly
-    m_clusterhitassoc->identify();
-  }
+    // scale factors (phi direction)
+    /*
+      they corresponds to clusters of size (2,2), (2,3), (3,2) and (3,3) in
+      phi and z
+      other clusters, which are very few and pathological, get a scale factor
+      of 1
+      These scale factors are applied to produce cluster pulls with width
+      unity
+    */
 
-  return;
+    double phierror = pitch * invsqrt12;
+
+    static constexpr std::array<double, 7> scalefactors_phi = {
+        {0.36, 0.6, 0.37, 0.49, 0.4, 0.37, 0.33}};
+
+    if ((phibins.size() == 1 && zbins.size() == 1) ||
+        (phibins.size() == 2 && zbins.size() == 2))
+    {
+      phierror *= scalefactors_phi[0];
+    }
+    else if ((phibins.size() == 2 && zbins.size() == 1) ||
+             (phibins.size() == 2 && zbins.size() == 3))
+    {
+      phierror *= scalefactors_phi[1];
+    }
+    else if ((phibins.size() == 1 && zbins.size() == 2) ||
+             (phibins.size() == 3 && zbins.size() == 2))
+    {
+      phierror *= scalefactors_phi[2];
+    }
+    else if (phibins.size() == 3 && zbins.size() == 3)
+    {
+      phierror *= scalefactors_phi[3];
+    }
+
+    // scale factors (z direction)
+    /*
+      they corresponds to clusters of size (2,2), (2,3), (3,2) and (3,3) in z
+      and phi
+      other clusters, which are very few and pathological, get a scale factor
+      of 1
+    */
+    static constexpr std::array<double, 4> scalefactors_z = {
+        {0.47, 0.48, 0.71, 0.55}};
+    double zerror = length * invsqrt12;
+    if (zbins.size() == 2 && phibins.size() == 2)
+    {
+      zerror *= scalefactors_z[0];
+    }
+    else if (zbins.size() == 2 && phibins.size() == 3)
+    {
+      zerror *= scalefactors_z[1];
+    }
+    else if (zbins.size() == 3 && phibins.size() == 2)
+    {
+      zerror *= scalefactors_z[2];
+    }
+    else if (zbins.size() == 3 && phibins.size() == 3)
+    {
+      zerror *= scalefactors_z[3];
+    }
+
+    if (Verbosity() > 0)
+    {
+      std::cout << " MvtxClusterizer: cluskey " << ckey << " layer " << layer
+                << " rad " << layergeom->get_radius() << " phibins "
+                << phibins.size() << " pitch " << pitch << " phisize " << phisize
+                << " zbins " << zbins.size() << " length " << length << " zsize "
+                << zsize << " local x " << locclusx << " local y " << locclusz
+                << std::endl;
+    }
+
+    auto clus = std::make_unique<TrkrClusterv5>();
+    clus->setAdc(nhits);
+    clus->setMaxAdc(1);
+    clus->setLocalX(locclusx);
+    clus->setLocalY(locclusz);
+    clus->setPhiError(phierror);
+    clus->setZError(zerror);
+    clus->setPhiSize(phibins.size());
+    clus->setZSize(zbins.size());
+    // All silicon surfaces have a 1-1 map to hitsetkey.
+    // So set subsurface key to 0
+    clus->setSubSurfKey(0);
+
+    if (Verbosity() > 2)
+    {
+      clus->identify();
+    }
+
+    if (zbins.size() <= 127)
+    {
+      cluster.cluster = std::move(clus);
+    }
+  }  // clusitr loop
 }
 
 void MvtxClusterizer::PrintClusters(PHCompositeNode *topNode)
@@ -11,16 +11,20 @@
 #include <trackbase/TrkrCluster.h>
 #include <trackbase/TrkrDefs.h>
 
+#include <map>
+#include <memory>
 #include <string>  // for string
 #include <utility>
+#include <vector>
 
 class ClusHitsVerbose;
 class PHCompositeNode;
-class TrkrHit;
+class PHG4CylinderGeomContainer;
+class PHThreadPool;
+class TrkrClusterv5;
 class TrkrHitSetContainer;
 class TrkrClusterContainer;
 class TrkrClusterHitAssoc;
-class RawHit;
 class RawHitSet;
 class RawHitSetContainer;
 
@@ -33,7 +37,7 @@ class MvtxClusterizer : public SubsysReco
   typedef std::pair<unsigned int, unsigned int> pixel;
 
   MvtxClusterizer(const std::string &name = "MvtxClusterizer");
-  ~MvtxClusterizer() override {}
+  ~MvtxClusterizer() override;
 
   //! module initialization
   int Init(PHCompositeNode * /*topNode*/) override { return 0; }
@@ -60,16 +64,40 @@ class MvtxClusterizer : public SubsysReco
   void set_do_hit_association(bool do_assoc) { do_hit_assoc = do_assoc; }
   void set_read_raw(bool read_raw) { do_read_raw = read_raw; }
   void set_ClusHitsVerbose(bool set = true) { record_ClusHitsVerbose = set; };
+
+  //! create the TRKR_CLUSTER node as TrkrClusterContainerv5 instead of TrkrClusterContainerv4, if it does not exist yet
+  void set_use_clustercontainer_v5(bool value) { m_use_clustercontainer_v5 = value; }
+
+  //! number of threads used to cluster chips concurrently (0 = serial, the default, -1 = all cores)
+  void set_num_threads(int nthreads) { m_num_threads = nthreads; }
   ClusHitsVerbose *mClusHitsVerbose{nullptr};
 
  private:
-  // bool are_adjacent(const pixel lhs, const pixel rhs);
   bool record_ClusHitsVerbose{false};
-  bool are_adjacent(const std::pair<TrkrDefs::hitkey, TrkrHit *> &lhs, const std::pair<TrkrDefs::hitkey, TrkrHit *> &rhs) const;
-  bool are_adjacent(RawHit *lhs, RawHit *rhs) const;
+
+  //! hits of one chip
+  struct ChipHits
+  {
+    std::vector<pixel> pixels;  // (row, column)
+    std::vector<TrkrDefs::hitkey> hitkeys;  // empty for raw hits
+    std::vector<unsigned int> energies;
+  };
+
+  //! cluster of one chip, stored in the node tree once all chips are done
+  struct ChipCluster
+  {
+    TrkrDefs::cluskey key{0};
+    std::unique_ptr<TrkrClusterv5> cluster;  // null if the cluster is dropped
+    std::vector<TrkrDefs::hitkey> hitkeys;
+    std::map<int, unsigned int> phi_energy;  // for ClusHitsVerbose
+    std::map<int, unsigned int> z_energy;
+  };
 
   void ClusterMvtx(PHCompositeNode *topNode);
   void ClusterMvtxRaw(PHCompositeNode *topNode);
+
+  //! make clusters from the hits of one chip. Only uses its arguments, so that chips can be processed concurrently
+  void ClusterChip(TrkrDefs::hitsetkey hitsetkey, const ChipHits &hits, PHG4CylinderGeomContainer *geom_container, std::vector<ChipCluster> &clusters) const;
   void PrintClusters(PHCompositeNode *topNode);
 
   // node tree storage pointers
@@ -83,6 +111,10 @@ class MvtxClusterizer : public SubsysReco
   bool m_makeZClustering {true};  // z_clustering_option
   bool do_hit_assoc {true};
   bool do_read_raw {false};
+  bool m_use_clustercontainer_v5 {false};
+
+  int m_num_threads {0};
+  std::unique_ptr<PHThreadPool> m_threadPool;
 };
 
 #endif  // MVTX_MVTXCLUSTERIZER_H
@@ -1,6 +1,7 @@
 // One-stop header
 // Must include first to avoid conflict with "ClassDef" in Rtypes.h
 #include <torch/script.h>
+#include <c10/core/InferenceMode.h>
 
 #include "TpcClusterizer.h"
 
@@ -44,6 +45,7 @@
 #include <phool/PHNode.h>        // for PHNode
 #include <phool/PHNodeIterator.h>
 #include <phool/PHObject.h>  // for PHObject
+#include <phool/PHThreadPool.h>
 #include <phool/getClass.h>
 #include <phool/phool.h>  // for PHWHERE
 
@@ -57,6 +59,9 @@
 #include <algorithm>
 #include <array>
 #include <cmath>  // for sqrt, cos, sin
+#include <cstddef>
+#include <exception>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <map>  // for _Rb_tree_cons...
@@ -64,8 +69,6 @@
 #include <utility>  // for pair
 #include <vector>
 #include <unordered_set>
-// Terra incognita....
-#include <pthread.h>
 
 namespace
 {
@@ -121,9 +124,23 @@ namespace
   // Neural network parameters and modules
   bool gen_hits = false;
   bool use_nn = false;
+  bool nn_batch = false;
+  bool nn_batch_check = false;
   const int nd = 5;
   torch::jit::script::Module module_pos;
 
+  // batched NN input, (clusters, 3, 2*nd+1, 2*nd+1). Kept across events and only grown
+  torch::Tensor nn_input;
+
+  // cluster waiting for the batched NN position correction
+  struct nn_entry
+  {
+    TrkrCluster *cluster = nullptr;
+    TrainingHits *training_hits = nullptr;
+    Surface surface;
+    double radius = 0;
+  };
+
   struct thread_data
   {
     PHG4TpcGeom *layergeom = nullptr;
@@ -166,13 +183,97 @@ namespace
     std::vector<assoc> association_vector;
     std::vector<TrkrCluster *> cluster_vector;
     std::vector<TrainingHits *> v_hits;
+    std::vector<nn_entry> nn_entries;  // only filled in batched NN mode
     int verbosity = 0;
     bool fillClusHitsVerbose = false;
     vec_dVerbose phivec_ClusHitsVerbose;  // only fill if fillClusHitsVerbose
     vec_dVerbose zvec_ClusHitsVerbose;    // only fill if fillClusHitsVerbose
   };
 
-  pthread_mutex_t mythreadlock;
+  // move cluster to the NN position. dphi and dz are the NN outputs, in bins from the center of the training hits patch
+  void set_nn_position(const thread_data &my_data, TrkrCluster *clus, const TrainingHits *training_hits, const Surface &surface, double radius, double dphi, double dz)
+  {
+    double nn_phi = training_hits->phi + std::clamp(dphi, -(double) nd, (double) nd) * training_hits->phistep;
+    double nn_z = training_hits->z + std::clamp(dz, -(double) nd, (double) nd) * training_hits->zstep;
+    double nn_x = radius * std::cos(nn_phi);
+    double nn_y = radius * std::sin(nn_phi);
+
+    Acts::Vector3 nn_env_global(nn_x, nn_y, nn_z);
+    Acts::Vector3 nn_global = my_data.tGeometry->transformTpcEnvelopeToWorld(nn_env_global);
+    nn_global *= Acts::UnitConstants::cm;
+    Acts::Vector3 nn_local = surface->localToGlobalTransform(my_data.tGeometry->geometry().geoContext).inverse() * nn_global;
+    nn_local /= Acts::UnitConstants::cm;
+    double nn_t = my_data.m_tdriftmax - std::fabs(nn_z) / my_data.tGeometry->get_drift_velocity();
+    clus->setLocalX(nn_local(0));
+    clus->setLocalY(nn_t);
+  }
+
+  // NN input of one cluster, (3, 2*nd+1, 2*nd+1) floats: adc values, layer group and z/r
+  void fill_nn_row(const TrainingHits *training_hits, double radius, float *row)
+  {
+    const int patch_size = (2 * nd + 1) * (2 * nd + 1);
+    std::copy(training_hits->v_adc.begin(), training_hits->v_adc.end(), row);
+    std::fill_n(row + patch_size, patch_size, (float) std::clamp((training_hits->layer - 7) / 16, 0, 2));
+    std::fill_n(row + 2 * patch_size, patch_size, (float) (training_hits->z / radius));
+  }
+
+  // NN output (dphi, dz) for a single cluster
+  std::pair<double, double> nn_forward_single(const TrainingHits *training_hits, double radius)
+  {
+    const int64_t width = 2 * nd + 1;
+    torch::Tensor input = torch::empty({1, 3, width, width}, torch::kFloat32);
+    fill_nn_row(training_hits, radius, input.data_ptr<float>());
+
+    std::vector<torch::jit::IValue> inputs;
+    inputs.emplace_back(input);
+    const at::Tensor ten_pos = module_pos.forward(inputs).toTensor();
+    return {ten_pos[0][0][0].item<double>(), ten_pos[0][1][0].item<double>()};
+  }
+
+  // copy NN inputs of the hitset pending clusters to the batch, starting at row "first"
+  void fill_nn_input(const thread_data &my_data, float *input, size_t first)
+  {
+    const int patch_size = (2 * nd + 1) * (2 * nd + 1);
+    float *row = input + first * 3 * patch_size;
+    for (const auto &entry : my_data.nn_entries)
+    {
+      fill_nn_row(entry.training_hits, entry.radius, row);
+      row += 3 * patch_size;
+    }
+  }
+
+  // compare batched NN outputs of the hitset pending clusters to single cluster evaluation, returns the number of mismatches
+  int check_nn_output(const thread_data &my_data, const float *output, size_t first, size_t stride, size_t zoffset)
+  {
+    static constexpr double tolerance = 1e-4;
+    int nmismatch = 0;
+    const float *row = output + first * stride;
+    for (const auto &entry : my_data.nn_entries)
+    {
+      const auto [dphi, dz] = nn_forward_single(entry.training_hits, entry.radius);
+      if (std::abs(dphi - row[0]) > tolerance * std::max(1., std::abs(dphi)) ||
+          std::abs(dz - row[zoffset]) > tolerance * std::max(1., std::abs(dz)))
+      {
+        std::cout << PHWHERE << " batched NN output (" << row[0] << ", " << row[zoffset]
+                  << ") differs from single cluster output (" << dphi << ", " << dz << ")" << std::endl;
+        ++nmismatch;
+      }
+      row += stride;
+    }
+    return nmismatch;
+  }
+
+  // apply NN outputs of the hitset pending clusters, starting at row "first".
+  // Each output row has "stride" values, the phi correction at 0 and the z correction at "zoffset"
+  void apply_nn_output(const thread_data &my_data, const float *output, size_t first, size_t stride, size_t zoffset)
+  {
+    const float *row = output + first * stride;
+    for (const auto &entry : my_data.nn_entries)
+    {
+      set_nn_position(my_data, entry.cluster, entry.training_hits, entry.surface, entry.radius, row[0], row[zoffset]);
+      row += stride;
+    }
+  }
 
   void remove_hit(double adc, int phibin, int tbin, int edge, std::multimap<unsigned short, ihit> &all_hit_map, std::vector<std::vector<unsigned short>> &adcval)
   {
@@ -982,32 +1083,18 @@ namespace
     }
 
     // This code needs to be reviewed in case of a non-zero TPC tilt - ADF 6/16/26
-    if (use_nn && clus_base && training_hits)
+    if (use_nn && nn_batch && clus_base && training_hits)
+    {
+      // corrected once all hitsets of the event are processed
+      my_data.nn_entries.push_back({clus_base, training_hits, surface, radius});
+    }
+    else if (use_nn && clus_base && training_hits)
     {
       try
       {
-        // Create a vector of inputs
-        std::vector<torch::jit::IValue> inputs;
-        inputs.emplace_back(torch::stack({torch::from_blob(std::vector<double>(training_hits->v_adc.begin(), training_hits->v_adc.end()).data(), {1, 2 * nd + 1, 2 * nd + 1}, torch::kFloat32),
-                                          torch::full({1, 2 * nd + 1, 2 * nd + 1}, std::clamp((training_hits->layer - 7) / 16, 0, 2), torch::kFloat32),
-                                          torch::full({1, 2 * nd + 1, 2 * nd + 1}, training_hits->z / radius, torch::kFloat32)},
-                                         1));
-
-        // Execute the model and turn its output into a tensor
-        at::Tensor ten_pos = module_pos.forward(inputs).toTensor();
-        double nn_phi = training_hits->phi + std::clamp(ten_pos[0][0][0].item<double>(), -(double) nd, (double) nd) * training_hits->phistep;
-        double nn_z = training_hits->z + std::clamp(ten_pos[0][1][0].item<double>(), -(double) nd, (double) nd) * training_hits->zstep;
-        double nn_x = radius * std::cos(nn_phi);
-        double nn_y = radius * std::sin(nn_phi);
-
-        Acts::Vector3 nn_env_global(nn_x, nn_y, nn_z);
-        Acts::Vector3 nn_global = my_data.tGeometry->transformTpcEnvelopeToWorld(nn_env_global);
-        nn_global *= Acts::UnitConstants::cm;
-         Acts::Vector3 nn_local = surface->localToGlobalTransform(my_data.tGeometry->geometry().geoContext).inverse() * nn_global;
-        nn_local /= Acts::UnitConstants::cm;
-        double nn_t = my_data.m_tdriftmax - std::fabs(nn_z) / my_data.tGeometry->get_drift_velocity();
-        clus_base->setLocalX(nn_local(0));
-        clus_base->setLocalY(nn_t);
+        // same float input as the batched mode
+        const auto [dphi, dz] = nn_forward_single(training_hits, radius);
+        set_nn_position(my_data, clus_base, training_hits, surface, radius, dphi, dz);
       }
       catch (const c10::Error &e)
       {
@@ -1381,14 +1468,73 @@ namespace
                 << std::endl;
     }
     */
-    // pthread_exit(nullptr);
   }
 
-  void *ProcessSector(void *threadarg)
+  // NN position correction of the pending clusters of all hitsets, in a single forward pass
+  void ProcessNNBatch(std::vector<thread_data> &tasks, PHThreadPool *pool)
   {
-    auto *my_data = static_cast<thread_data *>(threadarg);
-    ProcessSectorData(my_data);
-    pthread_exit(nullptr);
+    // first batch row of each hitset
+    std::vector<size_t> first(tasks.size() + 1, 0);
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+      first[i + 1] = first[i] + tasks[i].nn_entries.size();
+    }
+    const int64_t nclusters = first.back();
+    if (nclusters == 0)
+    {
+      return;
+    }
+
+    const auto for_each_task = [&tasks, pool](const std::function<void(std::size_t)> &function)
+    {
+      if (pool)
+      {
+        pool->parallel_for(tasks.size(), [&function](std::size_t index, unsigned int /*worker*/)
+                           { function(index); });
+      }
+      else
+      {
+        for (size_t index = 0; index < tasks.size(); ++index)
+        {
+          function(index);
+        }
+      }
+    };
+
+    const int64_t width = 2 * nd + 1;
+    if (!nn_input.defined() || nn_input.size(0) < nclusters)
+    {
+      nn_input = torch::empty({nclusters + nclusters / 2, 3, width, width}, torch::kFloat32);
+    }
+    float *input = nn_input.data_ptr<float>();
+    for_each_task([&](std::size_t index)
+                  { fill_nn_input(tasks[index], input, first[index]); });
+
+    try
+    {
+      c10::InferenceMode guard;
+      std::vector<torch::jit::IValue> inputs;
+      inputs.emplace_back(nn_input.narrow(0, 0, nclusters));
+      const at::Tensor ten_pos = module_pos.forward(inputs).toTensor().to(torch::kFloat32).contiguous();
+      const size_t stride = ten_pos.numel() / nclusters;
+      const size_t zoffset = ten_pos.size(2);
+      const float *output = ten_pos.data_ptr<float>();
+      if (nn_batch_check)
+      {
+        int nmismatch = 0;
+        for (size_t index = 0; index < tasks.size(); ++index)
+        {
+          nmismatch += check_nn_output(tasks[index], output, first[index], stride, zoffset);
+        }
+        std::cout << PHWHERE << " batched NN check: " << nmismatch << " mismatches out of " << nclusters << " clusters" << std::endl;
+      }
+      for_each_task([&](std::size_t index)
+                    { apply_nn_output(tasks[index], output, first[index], stride, zoffset); });
+    }
+    catch (const c10::Error &e)
+    {
+      std::cout << PHWHERE << "Error: Failed to execute NN modules" << std::endl;
+    }
   }
 }  // namespace
 
@@ -1398,6 +1544,9 @@ TpcClusterizer::TpcClusterizer(const std::string &name)
 {
 }
 
+// needed here for unique_ptr to incomplete PHThreadPool in header
+TpcClusterizer::~TpcClusterizer() = default;
+
 bool TpcClusterizer::is_in_sector_boundary(int phibin, int sector, PHG4TpcGeom *layergeom) const
 {
   bool reject_it = false;
@@ -1506,6 +1655,8 @@ int TpcClusterizer::InitRun(PHCompositeNode *topNode)
     {
       // Deserialize the ScriptModule from a file using torch::jit::load()
       module_pos = torch::jit::load(net_model);
+      // inference mode, in both per cluster and batched evaluation
+      module_pos.eval();
       std::cout << PHWHERE << "Load NN module: " << net_model << std::endl;
     }
     catch (const c10::Error &e)
@@ -1513,6 +1664,25 @@ int TpcClusterizer::InitRun(PHCompositeNode *topNode)
       std::cout << PHWHERE << "Error: Cannot load module " << net_model << std::endl;
       exit(1);
     }
+
+    nn_batch = m_nn_batch;
+    nn_batch_check = m_nn_batch_check;
+    if (m_nn_intraop_threads > 0)
+    {
+      at::set_num_threads(m_nn_intraop_threads);
+    }
+    if (m_nn_interop_threads > 0)
+    {
+      // can only be set once per process, before any inter op work
+      try
+      {
+        at::set_num_interop_threads(m_nn_interop_threads);
+      }
+      catch (const c10::Error &e)
+      {
+        std::cout << PHWHERE << "Warning: cannot set NN inter op threads: " << e.what_without_backtrace() << std::endl;
+      }
+    }
   }
   else
   {
@@ -1563,6 +1733,16 @@ int TpcClusterizer::InitRun(PHCompositeNode *topNode)
     makeChannelMask(m_hotChannelMap, m_hotChannelMapName, "TotalHotChannels");
   }
 
+  // start the worker pool once, it is reused for all events
+  if (!do_sequential && !m_threadPool)
+  {
+    m_threadPool = std::make_unique<PHThreadPool>(m_num_threads);
+    if (Verbosity())
+    {
+      std::cout << PHWHERE << "Using " << m_threadPool->size() << " worker threads" << std::endl;
+    }
+  }
+
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -1685,28 +1865,10 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
       rawhitsetrange = m_rawhits->getHitSets(TrkrDefs::TrkrId::tpcId);
       num_hitsets = std::distance(rawhitsetrange.first, rawhitsetrange.second);
     }
-  // create structure to store given thread and associated data
-  struct thread_pair_t
-  {
-    pthread_t thread{};
-    thread_data data;
-  };
-
-  // create vector of thread pairs and reserve the right size upfront to avoid reallocation
-  std::vector<thread_pair_t> threads;
-  threads.reserve(num_hitsets);
-
-  pthread_attr_t attr;
-  pthread_attr_init(&attr);
-  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-
-  if (pthread_mutex_init(&mythreadlock, nullptr) != 0)
-  {
-    std::cout << std::endl
-              << " mutex init failed" << std::endl;
-    return 1;
-  }
-//  int count = 0;
+  // create vector of per-hitset task data and reserve the right size upfront to avoid reallocation
+  // each entry is only ever touched by the worker processing it, so no locking is needed
+  std::vector<thread_data> tasks;
+  tasks.reserve(num_hitsets);
 
   if (!do_read_raw)
   {
@@ -1714,47 +1876,46 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
          hitsetitr != hitsetrange.second;
          ++hitsetitr)
     {
-      // if(count>0)continue;
       TrkrHitSet *hitset = hitsetitr->second;
       unsigned int layer = TrkrDefs::getLayer(hitsetitr->first);
       int side = TpcDefs::getSide(hitsetitr->first);
       unsigned int sector = TpcDefs::getSectorId(hitsetitr->first);
       PHG4TpcGeom *layergeom = geom_container->GetLayerCellGeom(layer);
 
-      // instanciate new thread pair, at the end of thread vector
-      thread_pair_t &thread_pair = threads.emplace_back();
+      // instanciate new task data, at the end of task vector
+      thread_data &data = tasks.emplace_back();
       if (mClusHitsVerbose)
       {
-        thread_pair.data.fillClusHitsVerbose = true;
+        data.fillClusHitsVerbose = true;
       };
 
-      thread_pair.data.layergeom = layergeom;
-      thread_pair.data.hitset = hitset;
-      thread_pair.data.rawhitset = nullptr;
-      thread_pair.data.layer = layer;
-      thread_pair.data.pedestal = pedestal;
-      thread_pair.data.seed_threshold = seed_threshold;
-      thread_pair.data.edge_threshold = edge_threshold;
-      thread_pair.data.sector = sector;
-      thread_pair.data.side = side;
-      thread_pair.data.do_assoc = do_hit_assoc;
-      thread_pair.data.do_wedge_emulation = do_wedge_emulation;
-      thread_pair.data.do_singles = do_singles;
-      thread_pair.data.tGeometry = m_tGeometry;
-      thread_pair.data.maxHalfSizeT = MaxClusterHalfSizeT;
-      thread_pair.data.maxHalfSizePhi = MaxClusterHalfSizePhi;
-      thread_pair.data.verbosity = Verbosity();
-      thread_pair.data.do_split = do_split;
-      thread_pair.data.FixedWindow = do_fixed_window;
-      thread_pair.data.min_err_squared = min_err_squared;
-      thread_pair.data.min_clus_size = min_clus_size;
-      thread_pair.data.min_adc_sum = min_adc_sum;
+      data.layergeom = layergeom;
+      data.hitset = hitset;
+      data.rawhitset = nullptr;
+      data.layer = layer;
+      data.pedestal = pedestal;
+      data.seed_threshold = seed_threshold;
+      data.edge_threshold = edge_threshold;
+      data.sector = sector;
+      data.side = side;
+      data.do_assoc = do_hit_assoc;
+      data.do_wedge_emulation = do_wedge_emulation;
+      data.do_singles = do_singles;
+      data.tGeometry = m_tGeometry;
+      data.maxHalfSizeT = MaxClusterHalfSizeT;
+      data.maxHalfSizePhi = MaxClusterHalfSizePhi;
+      data.verbosity = Verbosity();
+      data.do_split = do_split;
+      data.FixedWindow = do_fixed_window;
+      data.min_err_squared = min_err_squared;
+      data.min_clus_size = min_clus_size;
+      data.min_adc_sum = min_adc_sum;
 
       // --- pass dead/hot map info ---
-      thread_pair.data.deadMap  = &m_deadChannelMap;
-      thread_pair.data.hotMap   = &m_hotChannelMap;
-      thread_pair.data.maskDead = m_maskDeadChannels;
-      thread_pair.data.maskHot  = m_maskHotChannels;
+      data.deadMap  = &m_deadChannelMap;
+      data.hotMap   = &m_hotChannelMap;
+      data.maskDead = m_maskDeadChannels;
+      data.maskHot  = m_maskHotChannels;
 
       unsigned short NPhiBins = (unsigned short) layergeom->get_phibins();
       unsigned short NPhiBinsSector = NPhiBins / 12;
@@ -1773,74 +1934,17 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
       unsigned short TOffset = NTBinsMin;
 
       m_tdriftmax = layergeom->get_max_driftlength() / m_tGeometry->get_drift_velocity(); 
-      //  std::cout << "     m_tdriftmax " << m_tdriftmax << " drift velocity reco " << m_tGeometry->get_drift_velocity() << std::endl;
-      thread_pair.data.m_tdriftmax = m_tdriftmax;
-
-      thread_pair.data.phibins = NPhiBinsSector;
-      thread_pair.data.phioffset = PhiOffset;
-      thread_pair.data.tbins = NTBinsSide;
-      thread_pair.data.toffset = TOffset;
-      thread_pair.data.debug = m_debug;
-      thread_pair.data.radius = layergeom->get_radius();
-      thread_pair.data.drift_velocity = m_tGeometry->get_drift_velocity();
-      thread_pair.data.pads_per_sector = 0;
-      thread_pair.data.phistep = 0;
-      int rc;
-      rc = pthread_create(&thread_pair.thread, &attr, ProcessSector, (void *) &thread_pair.data);
-
-      if (rc)
-      {
-        std::cout << "Error:unable to create thread," << rc << std::endl;
-      }
-      if (do_sequential)
-      {
-        int rc2 = pthread_join(thread_pair.thread, nullptr);
-        if (rc2)
-        {
-          std::cout << "Error:unable to join," << rc2 << std::endl;
-        }
-
-        // get the hitsetkey from thread data
-        const auto &data(thread_pair.data);
-        const auto hitsetkey = TpcDefs::genHitSetKey(data.layer, data.sector, data.side);
-
-        // copy clusters to map
-        for (uint32_t index = 0; index < data.cluster_vector.size(); ++index)
-        {
-          // generate cluster key
-          const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
-
-          // get cluster
-          auto *cluster = data.cluster_vector[index];
-
-          // insert in map
-          m_clusterlist->addClusterSpecifyKey(ckey, cluster);
-
-          if (mClusHitsVerbose)
-          {
-            for (const auto &hit : data.phivec_ClusHitsVerbose[index])
-            {
-              mClusHitsVerbose->addPhiHit(hit.first, hit.second);
-            }
-            for (const auto &hit : data.zvec_ClusHitsVerbose[index])
-            {
-              mClusHitsVerbose->addZHit(hit.first, hit.second);
-            }
-            mClusHitsVerbose->push_hits(ckey);
-          }
-        }
-
-        // copy hit associations to map
-        for (const auto &[index, hkey] : thread_pair.data.association_vector)
-        {
-          // generate cluster key
-          const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
-
-          // add to association table
-          m_clusterhitassoc->addAssoc(ckey, hkey);
-        }
-      }
-//      count++;
+      data.m_tdriftmax = m_tdriftmax;
+
+      data.phibins = NPhiBinsSector;
+      data.phioffset = PhiOffset;
+      data.tbins = NTBinsSide;
+      data.toffset = TOffset;
+      data.debug = m_debug;
+      data.radius = layergeom->get_radius();
+      data.drift_velocity = m_tGeometry->get_drift_velocity();
+      data.pads_per_sector = 0;
+      data.phistep = 0;
     }
   }
   else
@@ -1849,39 +1953,35 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
          hitsetitr != rawhitsetrange.second;
          ++hitsetitr)
     {
-      //	if(count>0)continue;
-      //    const auto hitsetid = hitsetitr->first;
-      //	std::cout << " starting thread # " << count << std::endl;
-
       RawHitSet *hitset = hitsetitr->second;
       unsigned int layer = TrkrDefs::getLayer(hitsetitr->first);
       int side = TpcDefs::getSide(hitsetitr->first);
       unsigned int sector = TpcDefs::getSectorId(hitsetitr->first);
       PHG4TpcGeom *layergeom = geom_container->GetLayerCellGeom(layer);
 
-      // instanciate new thread pair, at the end of thread vector
-      thread_pair_t &thread_pair = threads.emplace_back();
-
-      thread_pair.data.layergeom = layergeom;
-      thread_pair.data.hitset = nullptr;
-      thread_pair.data.rawhitset = hitset;
-      thread_pair.data.layer = layer;
-      thread_pair.data.pedestal = pedestal;
-      thread_pair.data.sector = sector;
-      thread_pair.data.side = side;
-      thread_pair.data.debug = m_debug;
-      thread_pair.data.do_assoc = do_hit_assoc;
-      thread_pair.data.do_wedge_emulation = do_wedge_emulation;
-      thread_pair.data.tGeometry = m_tGeometry;
-      thread_pair.data.maxHalfSizeT = MaxClusterHalfSizeT;
-      thread_pair.data.maxHalfSizePhi = MaxClusterHalfSizePhi;
-      thread_pair.data.verbosity = Verbosity();
+      // instanciate new task data, at the end of task vector
+      thread_data &data = tasks.emplace_back();
+
+      data.layergeom = layergeom;
+      data.hitset = nullptr;
+      data.rawhitset = hitset;
+      data.layer = layer;
+      data.pedestal = pedestal;
+      data.sector = sector;
+      data.side = side;
+      data.debug = m_debug;
+      data.do_assoc = do_hit_assoc;
+      data.do_wedge_emulation = do_wedge_emulation;
+      data.tGeometry = m_tGeometry;
+      data.maxHalfSizeT = MaxClusterHalfSizeT;
+      data.maxHalfSizePhi = MaxClusterHalfSizePhi;
+      data.verbosity = Verbosity();
 
       // --- pass dead/hot map info ---
-      thread_pair.data.deadMap  = &m_deadChannelMap;
-      thread_pair.data.hotMap   = &m_hotChannelMap;
-      thread_pair.data.maskDead = m_maskDeadChannels;
-      thread_pair.data.maskHot  = m_maskHotChannels;
+      data.deadMap  = &m_deadChannelMap;
+      data.hotMap   = &m_hotChannelMap;
+      data.maskDead = m_maskDeadChannels;
+      data.maskHot  = m_maskHotChannels;
 
       unsigned short NPhiBins = (unsigned short) layergeom->get_phibins();
       unsigned short NPhiBinsSector = NPhiBins / 12;
@@ -1892,149 +1992,91 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
       unsigned short TOffset = NTBinsMin;
 
       m_tdriftmax = layergeom->get_max_driftlength() / m_tGeometry->get_drift_velocity(); 
-      //      std::cout << "     m_tdriftmax " << m_tdriftmax << " drift velocity reco " << m_tGeometry->get_drift_velocity() << std::endl;
-      thread_pair.data.m_tdriftmax = m_tdriftmax;
-
-      thread_pair.data.phibins = NPhiBinsSector;
-      thread_pair.data.phioffset = PhiOffset;
-      thread_pair.data.tbins = NTBinsSide;
-      thread_pair.data.toffset = TOffset;
-      
-      /*
-      PHG4TpcGeom *testlayergeom = geom_container->GetLayerCellGeom(32);
-      for( double iphi = 1408; iphi < 1408+ 128;iphi+=0.1){
-        double clusiphi = iphi;
-        double clusphi = testlayergeom->get_phi(clusiphi);
-        double radius = layergeom->get_radius();
-        double clusx = radius * cos(clusphi);
-        double clusy = radius * sin(clusphi);
-        double clusz  = -37.524;
-
-        TrkrDefs::hitsetkey tpcHitSetKey = TpcDefs::genHitSetKey( 32,11, 0 );
-        Acts::Vector3 global(clusx, clusy, clusz);
-        TrkrDefs::subsurfkey subsurfkey = 0;
-
-        Surface surface = m_tGeometry->get_tpc_surface_from_coords(
-                                                                   tpcHitSetKey,
-                                                                   global,
-                                                                   subsurfkey);
-        std::cout << " iphi: " << iphi << " clusphi: " << clusphi << " surfkey " << subsurfkey << std::endl;
-        //	std::cout << "surfkey" << subsurfkey << std::endl;
-      }
-      continue;
-      */
-      int rc = 0;
-      //      if(layer==32)
-      rc = pthread_create(&thread_pair.thread, &attr, ProcessSector, (void *) &thread_pair.data);
-      //      else
-      // continue;
+      data.m_tdriftmax = m_tdriftmax;
 
-      if (rc)
-      {
-        std::cout << "Error:unable to create thread," << rc << std::endl;
-      }
-
-      if (do_sequential)
-      {
-        int rc2 = pthread_join(thread_pair.thread, nullptr);
-        if (rc2)
-        {
-          std::cout << "Error:unable to join," << rc2 << std::endl;
-        }
-
-        // get the hitsetkey from thread data
-        const auto &data(thread_pair.data);
-        const auto hitsetkey = TpcDefs::genHitSetKey(data.layer, data.sector, data.side);
-
-        // copy clusters to map
-        for (uint32_t index = 0; index < data.cluster_vector.size(); ++index)
-        {
-          // generate cluster key
-          const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
-
-          // get cluster
-          auto *cluster = data.cluster_vector[index];
-
-          // insert in map
-          m_clusterlist->addClusterSpecifyKey(ckey, cluster);
-        }
-
-        // copy hit associations to map
-        for (const auto &[index, hkey] : thread_pair.data.association_vector)
-        {
-          // generate cluster key
-          const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
-
-          // add to association table
-          m_clusterhitassoc->addAssoc(ckey, hkey);
-        }
-      }
-//      count++;
+      data.phibins = NPhiBinsSector;
+      data.phioffset = PhiOffset;
+      data.tbins = NTBinsSide;
+      data.toffset = TOffset;
     }
   }
 
-  pthread_attr_destroy(&attr);
-//  count = 0;
-  // wait for completion of all threads
-  if (!do_sequential)
+  // process all hitsets on the worker pool, or in this thread in sequential mode
+  try
   {
-    for (const auto &thread_pair : threads)
+    if (do_sequential || !m_threadPool)
     {
-      int rc2 = pthread_join(thread_pair.thread, nullptr);
-      if (rc2)
+      for (auto &data : tasks)
       {
-        std::cout << "Error:unable to join," << rc2 << std::endl;
+        ProcessSectorData(&data);
       }
+    }
+    else
+    {
+      m_threadPool->parallel_for(tasks.size(), [&tasks](std::size_t index, unsigned int /*worker*/)
+                                 { ProcessSectorData(&tasks[index]); });
+    }
+  }
+  catch (const std::exception &e)
+  {
+    std::cout << PHWHERE << "Error: clustering failed: " << e.what() << std::endl;
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+
+  if (use_nn && nn_batch)
+  {
+    ProcessNNBatch(tasks, do_sequential ? nullptr : m_threadPool.get());
+  }
 
-      // get the hitsetkey from thread data
-      const auto &data(thread_pair.data);
-      const auto hitsetkey = TpcDefs::genHitSetKey(data.layer, data.sector, data.side);
+  // merge per-hitset outputs, in hitset order, into the node tree
+  for (auto &data : tasks)
+  {
+    // get the hitsetkey from task data
+    const auto hitsetkey = TpcDefs::genHitSetKey(data.layer, data.sector, data.side);
 
-      // copy clusters to map
-      for (uint32_t index = 0; index < data.cluster_vector.size(); ++index)
-      {
-        // generate cluster key
-        const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
+    // copy clusters to map
+    for (uint32_t index = 0; index < data.cluster_vector.size(); ++index)
+    {
+      // generate cluster key
+      const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
 
-        // get cluster
-        auto *cluster = data.cluster_vector[index];
+      // get cluster
+      auto *cluster = data.cluster_vector[index];
 
-        // insert in map
-        // std::cout << "X: " << cluster->getLocalX() << "Y: " << cluster->getLocalY() << std::endl;
-        m_clusterlist->addClusterSpecifyKey(ckey, cluster);
+      // insert in map
+      m_clusterlist->addClusterSpecifyKey(ckey, cluster);
 
-        if (mClusHitsVerbose)
+      if (mClusHitsVerbose && data.fillClusHitsVerbose)
+      {
+        for (const auto &hit : data.phivec_ClusHitsVerbose[index])
         {
-          for (const auto &hit : data.phivec_ClusHitsVerbose[index])
-          {
-            mClusHitsVerbose->addPhiHit(hit.first, (double) hit.second);
-          }
-          for (const auto &hit : data.zvec_ClusHitsVerbose[index])
-          {
-            mClusHitsVerbose->addZHit(hit.first, (double) hit.second);
-          }
-          mClusHitsVerbose->push_hits(ckey);
+          mClusHitsVerbose->addPhiHit(hit.first, (double) hit.second);
         }
+        for (const auto &hit : data.zvec_ClusHitsVerbose[index])
+        {
+          mClusHitsVerbose->addZHit(hit.first, (double) hit.second);
+        }
+        mClusHitsVerbose->push_hits(ckey);
       }
+    }
 
-      // copy hit associations to map
-      for (const auto &[index, hkey] : thread_pair.data.association_vector)
-      {
-        // generate cluster key
-        const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
+    // copy hit associations to map
+    for (const auto &[index, hkey] : data.association_vector)
+    {
+      // generate cluster key
+      const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
 
-        // add to association table
-        m_clusterhitassoc->addAssoc(ckey, hkey);
-      }
+      // add to association table
+      m_clusterhitassoc->addAssoc(ckey, hkey);
+    }
 
-      for (auto *v_hit : thread_pair.data.v_hits)
+    for (auto *v_hit : data.v_hits)
+    {
+      if (_store_hits)
       {
-        if (_store_hits)
-        {
-          m_training->v_hits.emplace_back(*v_hit);
-        }
-        delete v_hit;
+        m_training->v_hits.emplace_back(*v_hit);
       }
+      delete v_hit;
     }
   }
 
@@ -2066,6 +2108,7 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
 
 int TpcClusterizer::End(PHCompositeNode * /*topNode*/)
 {
+  m_threadPool.reset();
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
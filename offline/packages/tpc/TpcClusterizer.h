@@ -7,6 +7,7 @@
 #include <trackbase/TrkrDefs.h>
 
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_set>
 
@@ -14,6 +15,7 @@ typedef std::map<TrkrDefs::hitsetkey, std::unordered_set<TrkrDefs::hitkey>> hitM
 
 class ClusHitsVerbosev1;
 class PHCompositeNode;
+class PHThreadPool;
 class TrkrHitSet;
 class TrkrHitSetContainer;
 class TrkrClusterContainer;
@@ -30,7 +32,7 @@ public:
   typedef std::pair<unsigned short, iphiz> ihit;
 
   TpcClusterizer(const std::string &name = "TpcClusterizer");
-  ~TpcClusterizer() override = default;
+  ~TpcClusterizer() override;
 
   int InitRun(PHCompositeNode *topNode) override;
   int process_event(PHCompositeNode *topNode) override;
@@ -39,9 +41,25 @@ public:
   void set_sector_fiducial_cut(const double cut) { SectorFiducialCut = cut; }
   void set_store_hits(bool store_hits) { _store_hits = store_hits; }
   void set_use_nn(bool use_nn) { _use_nn = use_nn; }
+
+  //! run the NN position correction once per event on all clusters, instead of once per cluster
+  void set_nn_batch(bool batch) { m_nn_batch = batch; }
+
+  //! in batched mode, also evaluate the NN once per cluster and report clusters for which both modes disagree. Slow, for validation only
+  void set_nn_batch_check(bool check) { m_nn_batch_check = check; }
+
+  //! torch intra and inter op threads used by the NN. Zero or negative keeps the torch default
+  void set_nn_threads(int intraop, int interop = 0)
+  {
+    m_nn_intraop_threads = intraop;
+    m_nn_interop_threads = interop;
+  }
   void set_do_hit_association(bool do_assoc) { do_hit_assoc = do_assoc; }
   void set_do_wedge_emulation(bool do_wedge) { do_wedge_emulation = do_wedge; }
   void set_do_sequential(bool do_seq) { do_sequential = do_seq; }
+
+  //! number of worker threads used to process hitsets. Negative means one per hardware thread
+  void set_num_threads(int nthreads) { m_num_threads = nthreads; }
   void set_do_split(bool split) { do_split = split; }
   void set_fixed_window(int fixed) { do_fixed_window = fixed; }
   void set_pedestal(double val) { pedestal = val; }
@@ -110,6 +128,10 @@ public:
   bool m_rejectEvent = true;
   bool _store_hits = false;
   bool _use_nn = false;
+  bool m_nn_batch = false;
+  bool m_nn_batch_check = false;
+  int m_nn_intraop_threads = 0;
+  int m_nn_interop_threads = 0;
   bool do_hit_assoc = true;
   bool do_wedge_emulation = false;
   bool do_read_raw = false;
@@ -128,6 +150,10 @@ public:
   unsigned short MaxClusterHalfSizePhi = 3;
   unsigned short MaxClusterHalfSizeT = 5;
 
+  //! worker pool, started in InitRun
+  int m_num_threads = -1;
+  std::unique_ptr<PHThreadPool> m_threadPool;
+
   double m_tdriftmax = 0;
   double AdcClockPeriod = 53.0;  // ns
   double NZBinsSide = 249;
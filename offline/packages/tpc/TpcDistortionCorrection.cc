@@ -82,8 +82,24 @@ Acts::Vector3 TpcDistortionCorrection::get_corrected_position(const Acts::Vector
   dr=0;
   dz=0;
   
-  //get the corrections from the histograms
-  if (dcc->m_dimensions == 3)
+  //get the corrections from the compiled grid, if available, or from the histograms
+  if (dcc->m_grid.is_compiled())
+  {
+    dcc->m_grid.interpolate(index, phi, r, z, mask, dphi, dr, dz);
+    if (dcc->m_dimensions == 2)
+    {
+      double zterm = 1.0;
+      if (dcc->m_interpolate_z)
+      {
+        zterm = (1. - std::abs(z) / 102.605);
+      }
+      dphi *= zterm;
+      dr *= zterm;
+      dz *= zterm;
+    }
+    dphi /= divisor;
+  }
+  else if (dcc->m_dimensions == 3)
   {
     if (dcc->m_hDPint[index] && (mask & COORD_PHI) && check_boundaries(dcc->m_hDPint[index], phi, r, z))
     {
@@ -138,3 +154,12 @@ if(dcc->m_use_scalefactor)
 
   return {x_new, y_new, z_new};
 }
+
+//________________________________________________________
+void TpcDistortionCorrection::get_corrected_positions(std::vector<Acts::Vector3>& positions, const TpcDistortionCorrectionContainer* dcc, unsigned int mask) const
+{
+  for (auto& position : positions)
+  {
+    position = get_corrected_position(position, dcc, mask);
+  }
+}
@@ -25,6 +25,9 @@ void TpcDistortionCorrectionContainer::load_histograms( const std::string& sourc
     exit(1);
   }
 
+  // compiled grid no longer matches histograms
+  m_grid.clear();
+
   const std::array<const std::string, 2> extension = {{"_negz", "_posz"}};
   for (int j = 0; j < 2; ++j)
   {
@@ -7,6 +7,8 @@
  * \author Hugo Pereira Da Costa <hugo.pereira-da-costa@cea.fr>
  */
 
+#include "TpcDistortionCorrectionGrid.h"
+
 #include <array>
 #include <string>
 
@@ -48,6 +50,12 @@ class TpcDistortionCorrectionContainer
    */
   std::array<TH1*, 2> m_hentries = {{nullptr, nullptr}};
   //@}
+
+  //! compiled copy of the distortion histograms, used instead of the histograms when available
+  /**
+   * it must be recompiled, or cleared, whenever the histograms are modified
+   */
+  TpcDistortionCorrectionGrid m_grid;
 };
 
 #endif
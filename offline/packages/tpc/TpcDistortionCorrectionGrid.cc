@@ -0,0 +1,252 @@
+/*!
+ * \file TpcDistortionCorrectionGrid.cc
+ * \brief compiled representation of the distortion correction histograms stored in TpcDistortionCorrectionContainer
+ */
+
+#include "TpcDistortionCorrectionGrid.h"
+
+#include "TpcDistortionCorrection.h"
+#include "TpcDistortionCorrectionContainer.h"
+
+#include <TAxis.h>
+#include <TH1.h>
+
+#include <algorithm>
+
+//________________________________________________________
+bool TpcDistortionCorrectionGrid::Axis::set(const TAxis* axis)
+{
+  if (axis->IsVariableBinSize())
+  {
+    return false;
+  }
+  nbins = axis->GetNbins();
+  min = axis->GetXmin();
+  max = axis->GetXmax();
+  width = (max - min) / nbins;
+  return nbins > 0;
+}
+
+//________________________________________________________
+int TpcDistortionCorrectionGrid::Axis::find_bin(double value) const
+{
+  // same arithmetic as TAxis::FindFixBin for uniform bins
+  // value is clamped before conversion, so that it is well defined even when out of range or NaN
+  const double u = nbins * (value - min) / (max - min);
+  const int bin = 1 + static_cast<int>(std::min<double>(nbins, std::max(0., u)));
+  return value < min ? 0 : (!(value < max) ? nbins + 1 : bin);
+}
+
+//________________________________________________________
+int TpcDistortionCorrectionGrid::Axis::locate(double value, int bin, double& fraction) const
+{
+  // lower bin is the one whose center is just below value
+  const int lower = value < center(bin) ? bin - 1 : bin;
+  const double low = center(lower);
+  fraction = (value - low) / (center(lower + 1) - low);
+  return lower - 1;
+}
+
+//________________________________________________________
+int TpcDistortionCorrectionGrid::Axis::locate(double value, int bin, double& low, double& high) const
+{
+  // quadrant selection as in TH2::Interpolate
+  const double up_edge = min + bin * width;
+  const int lower = (up_edge - value <= width / 2) ? bin : bin - 1;
+  low = center(lower);
+  high = center(lower + 1);
+  return lower - 1;
+}
+
+//________________________________________________________
+void TpcDistortionCorrectionGrid::clear()
+{
+  m_compiled = false;
+  m_sides = {};
+}
+
+//________________________________________________________
+bool TpcDistortionCorrectionGrid::compile(const TpcDistortionCorrectionContainer& dcc)
+{
+  clear();
+  if (dcc.m_dimensions != 2 && dcc.m_dimensions != 3)
+  {
+    return false;
+  }
+
+  for (int side = 0; side < 2; ++side)
+  {
+    m_sides[side].dimension = dcc.m_dimensions;
+    if (!compile(m_sides[side], {{dcc.m_hDPint[side], dcc.m_hDRint[side], dcc.m_hDZint[side]}}))
+    {
+      clear();
+      return false;
+    }
+  }
+
+  m_compiled = true;
+  return true;
+}
+
+//________________________________________________________
+bool TpcDistortionCorrectionGrid::compile(Side& side, const std::array<const TH1*, 3>& histograms)
+{
+  // coordinate mask matching each histogram
+  static constexpr std::array<unsigned int, 3> coordinates = {{TpcDistortionCorrection::COORD_PHI, TpcDistortionCorrection::COORD_R, TpcDistortionCorrection::COORD_Z}};
+
+  // get axes from first available histogram, and check that all others match
+  bool first = true;
+  for (int i = 0; i < 3; ++i)
+  {
+    const TH1* h = histograms[i];
+    if (!h)
+    {
+      continue;
+    }
+
+    if (h->GetDimension() != side.dimension)
+    {
+      return false;
+    }
+
+    std::array<Axis, 3> axes;
+    if (!axes[0].set(h->GetXaxis()) || !axes[1].set(h->GetYaxis()))
+    {
+      return false;
+    }
+
+    // 2D histograms have a single z bin
+    if (side.dimension == 3)
+    {
+      if (!axes[2].set(h->GetZaxis()))
+      {
+        return false;
+      }
+    }
+    else
+    {
+      axes[2].nbins = 1;
+    }
+
+    if (first)
+    {
+      side.axes = axes;
+      first = false;
+    }
+    else if (!(axes[0] == side.axes[0] && axes[1] == side.axes[1] && axes[2] == side.axes[2]))
+    {
+      return false;
+    }
+
+    side.available |= coordinates[i];
+  }
+
+  // no histogram, no correction
+  if (first)
+  {
+    return true;
+  }
+
+  // copy bin contents, interleaved. Missing histograms give zero correction
+  side.values.assign(3 * static_cast<std::size_t>(side.axes[0].nbins) * side.axes[1].nbins * side.axes[2].nbins, 0);
+  for (int i = 0; i < 3; ++i)
+  {
+    const TH1* h = histograms[i];
+    if (!h)
+    {
+      continue;
+    }
+
+    for (int iphi = 0; iphi < side.axes[0].nbins; ++iphi)
+    {
+      for (int ir = 0; ir < side.axes[1].nbins; ++ir)
+      {
+        for (int iz = 0; iz < side.axes[2].nbins; ++iz)
+        {
+          side.values[side.index(iphi, ir, iz) + i] = side.dimension == 3 ? h->GetBinContent(iphi + 1, ir + 1, iz + 1) : h->GetBinContent(iphi + 1, ir + 1);
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+//________________________________________________________
+void TpcDistortionCorrectionGrid::interpolate(int side_index, double phi, double r, double z, unsigned int mask, double& dphi, double& dr, double& dz) const
+{
+  const Side& side = m_sides[side_index];
+  const unsigned int active = mask & side.available;
+
+  // for the interpolation to work, the value must be within the range of the provided axis, and not into the first and last bin
+  const int bin_phi = side.axes[0].find_bin(phi);
+  const int bin_r = side.axes[1].find_bin(r);
+  const int bin_z = side.dimension == 3 ? side.axes[2].find_bin(z) : 2;
+  const int nbins_z = side.dimension == 3 ? side.axes[2].nbins : 3;
+  const bool inside =
+      (bin_phi >= 2) & (bin_phi < side.axes[0].nbins) &
+      (bin_r >= 2) & (bin_r < side.axes[1].nbins) &
+      (bin_z >= 2) & (bin_z < nbins_z);
+
+  if (!active || !inside)
+  {
+    dphi = 0;
+    dr = 0;
+    dz = 0;
+    return;
+  }
+
+  double result[3];
+  if (side.dimension == 3)
+  {
+    // trilinear interpolation, same as TH3::Interpolate
+    double xd = 0;
+    double yd = 0;
+    double zd = 0;
+    const int ix = side.axes[0].locate(phi, bin_phi, xd);
+    const int iy = side.axes[1].locate(r, bin_r, yd);
+    const int iz = side.axes[2].locate(z, bin_z, zd);
+
+    const double* v000 = &side.values[side.index(ix, iy, iz)];
+    const double* v010 = &side.values[side.index(ix, iy + 1, iz)];
+    const double* v100 = &side.values[side.index(ix + 1, iy, iz)];
+    const double* v110 = &side.values[side.index(ix + 1, iy + 1, iz)];
+
+    // z neighbors are adjacent in memory, 3 values apart
+    for (int i = 0; i < 3; ++i)
+    {
+      const double i1 = v000[i] * (1 - zd) + v000[i + 3] * zd;
+      const double i2 = v010[i] * (1 - zd) + v010[i + 3] * zd;
+      const double j1 = v100[i] * (1 - zd) + v100[i + 3] * zd;
+      const double j2 = v110[i] * (1 - zd) + v110[i + 3] * zd;
+      const double w1 = i1 * (1 - yd) + i2 * yd;
+      const double w2 = j1 * (1 - yd) + j2 * yd;
+      result[i] = w1 * (1 - xd) + w2 * xd;
+    }
+  }
+  else
+  {
+    // bilinear interpolation, same as TH2::Interpolate
+    double x1 = 0;
+    double x2 = 0;
+    double y1 = 0;
+    double y2 = 0;
+    const int ix = side.axes[0].locate(phi, bin_phi, x1, x2);
+    const int iy = side.axes[1].locate(r, bin_r, y1, y2);
+
+    const double* q11 = &side.values[side.index(ix, iy, 0)];
+    const double* q12 = &side.values[side.index(ix, iy + 1, 0)];
+    const double* q21 = &side.values[side.index(ix + 1, iy, 0)];
+    const double* q22 = &side.values[side.index(ix + 1, iy + 1, 0)];
+
+    const double d = 1.0 * (x2 - x1) * (y2 - y1);
+    for (int i = 0; i < 3; ++i)
+    {
+      result[i] = 1.0 * q11[i] / d * (x2 - phi) * (y2 - r) + 1.0 * q21[i] / d * (phi - x1) * (y2 - r) + 1.0 * q12[i] / d * (x2 - phi) * (r - y1) + 1.0 * q22[i] / d * (phi - x1) * (r - y1);
+    }
+  }
+
+  dphi = (active & TpcDistortionCorrection::COORD_PHI) ? result[0] : 0;
+  dr = (active & TpcDistortionCorrection::COORD_R) ? result[1] : 0;
+  dz = (active & TpcDistortionCorrection::COORD_Z) ? result[2] : 0;
+}
@@ -0,0 +1,109 @@
+#ifndef TPC_TPCDISTORTIONCORRECTIONGRID_H
+#define TPC_TPCDISTORTIONCORRECTIONGRID_H
+
+/*!
+ * \file TpcDistortionCorrectionGrid.h
+ * \brief compiled representation of the distortion correction histograms stored in TpcDistortionCorrectionContainer
+ *
+ * for each side, the phi, r and z corrections are copied into a single flat array,
+ * interleaved as (dphi, dr, dz) for each (phi, r, z) bin, so that one interpolation
+ * returns all three corrections without any histogram bin search nor virtual call.
+ * Boundary checks and interpolation are the same as in TpcDistortionCorrection with TH3::Interpolate
+ * and TH2::Interpolate, up to rounding.
+ * It requires that all histograms of a given side have the same, uniform, binning.
+ */
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+class TAxis;
+class TH1;
+class TpcDistortionCorrectionContainer;
+
+class TpcDistortionCorrectionGrid
+{
+ public:
+  //! constructor
+  TpcDistortionCorrectionGrid() = default;
+
+  //! copy histograms content from container. Returns false if histograms cannot be compiled
+  bool compile(const TpcDistortionCorrectionContainer&);
+
+  //! true if compiled
+  bool is_compiled() const { return m_compiled; }
+
+  //! remove compiled data
+  void clear();
+
+  //! interpolated histogram values, for a given side (0 for negative z, 1 for positive z)
+  /**
+   * corrections are set to zero if the corresponding histogram is missing,
+   * masked out (using TpcDistortionCorrection::CoordMask), or if the position is outside of the histogram
+   * range or in its first or last bin. No unit conversion nor scale factor is applied.
+   */
+  void interpolate(int side, double phi, double r, double z, unsigned int mask, double& dphi, double& dr, double& dz) const;
+
+ private:
+  //! uniform axis
+  struct Axis
+  {
+    int nbins = 0;
+    double min = 0;
+    double max = 0;
+    double width = 0;
+
+    //! copy from TAxis. Returns false if bins are not uniform
+    bool set(const TAxis*);
+
+    //! same as TAxis::FindFixBin
+    int find_bin(double) const;
+
+    //! same as TAxis::GetBinCenter
+    double center(int bin) const { return min + (bin - 1) * width + 0.5 * width; }
+
+    //! locate interpolation interval, same as TH3::Interpolate
+    /** returns 0-based index of the lower bin, and normalized distance to its center */
+    int locate(double value, int bin, double& fraction) const;
+
+    //! locate interpolation interval, same as TH2::Interpolate
+    /** returns 0-based index of the lower bin, and centers of the lower and upper bins */
+    int locate(double value, int bin, double& low, double& high) const;
+
+    bool operator==(const Axis& other) const
+    {
+      return nbins == other.nbins && min == other.min && max == other.max;
+    }
+  };
+
+  //! compiled grid for one side
+  struct Side
+  {
+    //! histogram dimension, 2 or 3
+    int dimension = 0;
+
+    //! phi, r and z axes. The z axis is not used for 2D histograms
+    std::array<Axis, 3> axes;
+
+    //! coordinate mask of available histograms
+    unsigned int available = 0;
+
+    //! interleaved (dphi, dr, dz) values, for each (phi, r, z) bin
+    std::vector<double> values;
+
+    //! flat index of first value for a given 0-based bin
+    std::size_t index(int iphi, int ir, int iz) const
+    {
+      return 3 * ((static_cast<std::size_t>(iphi) * axes[1].nbins + ir) * axes[2].nbins + iz);
+    }
+  };
+
+  //! compile one side
+  bool compile(Side&, const std::array<const TH1*, 3>&);
+
+  bool m_compiled = false;
+
+  std::array<Side, 2> m_sides;
+};
+
+#endif
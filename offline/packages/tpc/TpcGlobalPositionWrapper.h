@@ -10,6 +10,8 @@
 
 #include <trackbase/TrkrDefs.h>
 
+#include <vector>
+
 
 class ActsGeometry;
 class PHCompositeNode;
@@ -51,6 +53,14 @@ class TpcGlobalPositionWrapper
   //! apply all loaded distortion corrections to a given position
   Acts::Vector3 applyDistortionCorrections( Acts::Vector3 /*source*/ ) const;
 
+  //! apply all loaded distortion corrections to a set of positions, in place
+  /**
+   * corrections are applied one container at a time to all positions,
+   * which keeps each correction grid in cache. Result is identical to calling
+   * applyDistortionCorrections on each position.
+   */
+  void applyDistortionCorrections( std::vector<Acts::Vector3>& /*positions*/ ) const;
+
   //! get distortion corrected global position from cluster
   /**
    * first converts cluster position local coordinate to global coordinates
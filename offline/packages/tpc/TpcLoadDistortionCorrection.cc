@@ -102,6 +102,11 @@ int TpcLoadDistortionCorrection::InitRun(PHCompositeNode* topNode)
     distortion_correction_object->m_use_scalefactor = m_use_scalefactor[i];
     distortion_correction_object->m_scalefactor = m_scalefactor[i];
 
+    // compile histograms into regular grid
+    if (m_compile_histograms && !distortion_correction_object->m_grid.compile(*distortion_correction_object))
+    {
+      std::cout << "TpcLoadDistortionCorrection::InitRun - cannot compile histograms for " << m_node_name[i] << ", using histograms directly" << std::endl;
+    }
 
     if (Verbosity())
     {
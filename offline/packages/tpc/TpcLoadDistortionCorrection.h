@@ -75,6 +75,13 @@ class TpcLoadDistortionCorrection : public SubsysReco
     m_interpolate_z[i] = flag;
   }
 
+  //! copy histograms into a compiled regular grid, for faster interpolation. Default is true
+  /** histograms are used directly if the grid cannot be compiled, e.g. for non uniform binning */
+  void set_compile_histograms(bool flag)
+  {
+    m_compile_histograms = flag;
+  }
+
   //! node name
   void set_node_name(const std::string& value)
   {
@@ -105,6 +112,9 @@ class TpcLoadDistortionCorrection : public SubsysReco
   //! z interpolation
   std::array<bool,nDistortionTypes> m_interpolate_z = {true,true,true,true};
 
+  //! compile histograms into regular grid
+  bool m_compile_histograms = true;
+
   //! distortion object node name
   std::array<std::string,nDistortionTypes> m_node_name = {"TpcDistortionCorrectionContainerStatic", "TpcDistortionCorrectionContainerAverage", "TpcDistortionCorrectionContainerFluctuation","TpcDistortionCorrectionContainerModuleEdge"};
 };
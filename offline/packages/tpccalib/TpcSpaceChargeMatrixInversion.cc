@@ -9,15 +9,20 @@
 #include "TpcSpaceChargeReconstructionHelper.h"
 
 #include <frog/FROG.h>
+#include <phool/PHThreadPool.h>
 #include <tpc/TpcDistortionCorrectionContainer.h>
 
 #include <TFile.h>
 #include <TH2.h>
 #include <TH3.h>
+#include <TROOT.h>
 
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
 
 namespace
@@ -64,6 +69,31 @@ namespace
     return out;
   }
 
+  // create empty matrix container with the same grid dimensions as source
+  std::unique_ptr<TpcSpaceChargeMatrixContainer> create_container( const TpcSpaceChargeMatrixContainer& source )
+  {
+    std::unique_ptr<TpcSpaceChargeMatrixContainer> out(new TpcSpaceChargeMatrixContainerv2);
+
+    // get grid dimensions from source
+    int phibins = 0;
+    int rbins = 0;
+    int zbins = 0;
+    source.get_grid_dimensions(phibins, rbins, zbins);
+
+    // assign
+    out->set_grid_dimensions(phibins, rbins, zbins);
+    return out;
+  }
+
+  // inversion result for one cell. Distortions and errors are stored as (phi, z, r)
+  struct cell_result_t
+  {
+    bool valid = false;
+    int entries = 0;
+    std::array<float, 3> value = {};
+    std::array<float, 3> error = {};
+  };
+
 }  // namespace
 
 //_____________________________________________________________________
@@ -72,6 +102,10 @@ TpcSpaceChargeMatrixInversion::TpcSpaceChargeMatrixInversion(const std::string&
 {
 }
 
+//_____________________________________________________________________
+// needed here for unique_ptr to incomplete PHThreadPool in header
+TpcSpaceChargeMatrixInversion::~TpcSpaceChargeMatrixInversion() = default;
+
 //_____________________________________________________________________
 void TpcSpaceChargeMatrixInversion::load_cm_distortion_corrections(const std::string& filename)
 {
@@ -147,34 +181,174 @@ bool TpcSpaceChargeMatrixInversion::add_from_file(const std::string& shortfilena
 {
   // get filename from frog
   FROG frog;
-  const auto *const filename = frog.location(shortfilename);
+  const std::string filename = frog.location(shortfilename);
+
+  // load object from input file
+  const auto source = load_from_file(filename, objectname);
+  if (!source)
+  {
+    return false;
+  }
+
+  // add object
+  return add(*source);
+}
+
+//_____________________________________________________________________
+bool TpcSpaceChargeMatrixInversion::add_from_files(const std::vector<std::string>& shortfilenames, const std::string& objectname)
+{
+  if (shortfilenames.empty())
+  {
+    return true;
+  }
+
+  // get filenames from frog, before starting any thread
+  std::vector<std::string> filenames;
+  FROG frog;
+  for (const auto& shortfilename : shortfilenames)
+  {
+    filenames.emplace_back(frog.location(shortfilename));
+  }
+
+  auto* pool = thread_pool();
+  if (pool->size() > 0)
+  {
+    // files are opened and read concurrently
+    ROOT::EnableThreadSafety();
+  }
+
+  // one contiguous block of files per thread, each accumulated in its own container
+  const size_t nblocks = std::min<size_t>(filenames.size(), pool->nslots());
+  std::vector<std::unique_ptr<TpcSpaceChargeMatrixContainer>> partial(nblocks);
+  std::atomic<bool> success(true);
+  pool->parallel_for(nblocks, [&](std::size_t iblock, unsigned int /*worker*/)
+  {
+    const size_t first = iblock * filenames.size() / nblocks;
+    const size_t last = (iblock + 1) * filenames.size() / nblocks;
+    for (size_t i = first; i < last; ++i)
+    {
+      // source container is released as soon as it is added
+      const auto source = load_from_file(filenames[i], objectname);
+      if (!source)
+      {
+        success = false;
+        continue;
+      }
+
+      if (!partial[iblock])
+      {
+        partial[iblock] = create_container(*source);
+      }
+
+      if (!partial[iblock]->add(*source))
+      {
+        success = false;
+      }
+    }
+  });
+
+  // pairwise merging of the per thread containers
+  for (size_t step = 1; step < nblocks; step *= 2)
+  {
+    const size_t npairs = (nblocks + 2 * step - 1) / (2 * step);
+    pool->parallel_for(npairs, [&](std::size_t ipair, unsigned int /*worker*/)
+    {
+      const size_t target = 2 * step * ipair;
+      const size_t source = target + step;
+      if (source >= nblocks || !partial[source])
+      {
+        return;
+      }
+
+      if (!partial[target])
+      {
+        partial[target] = std::move(partial[source]);
+      }
+      else
+      {
+        if (!partial[target]->add(*partial[source]))
+        {
+          success = false;
+        }
+        partial[source].reset();
+      }
+    });
+  }
+
+  // add to current
+  if (partial[0] && !add(*partial[0]))
+  {
+    success = false;
+  }
+
+  return success;
+}
+
+//_____________________________________________________________________
+bool TpcSpaceChargeMatrixInversion::save_matrix_container(const std::string& filename, const std::string& objectname) const
+{
+  if (!m_matrix_container)
+  {
+    std::cout << "TpcSpaceChargeMatrixInversion::save_matrix_container - invalid matrix container." << std::endl;
+    return false;
+  }
+
+  std::unique_ptr<TFile> outputfile(TFile::Open(filename.c_str(), "RECREATE"));
+  if (!outputfile)
+  {
+    std::cout << "TpcSpaceChargeMatrixInversion::save_matrix_container - could not open file " << filename << std::endl;
+    return false;
+  }
+
+  std::cout << "TpcSpaceChargeMatrixInversion::save_matrix_container - writing " << objectname << " to " << filename << " entries: " << m_matrix_container->get_entries() << std::endl;
+  outputfile->cd();
+  m_matrix_container->Write(objectname.c_str());
+  outputfile->Close();
+  return true;
+}
 
+//_____________________________________________________________________
+std::unique_ptr<TpcSpaceChargeMatrixContainer> TpcSpaceChargeMatrixInversion::load_from_file(const std::string& filename, const std::string& objectname) const
+{
   // open TFile
-  std::unique_ptr<TFile> inputfile(TFile::Open(filename));
+  std::unique_ptr<TFile> inputfile(TFile::Open(filename.c_str()));
   if (!inputfile)
   {
-    std::cout << "TpcSpaceChargeMatrixInversion::add_from_file - could not open file " << filename << std::endl;
-    return false;
+    std::cout << "TpcSpaceChargeMatrixInversion::load_from_file - could not open file " << filename << std::endl;
+    return nullptr;
   }
 
   // load object from input file
   std::unique_ptr<TpcSpaceChargeMatrixContainer> source(dynamic_cast<TpcSpaceChargeMatrixContainer*>(inputfile->Get(objectname.c_str())));
   if (!source)
   {
-    std::cout << "TpcSpaceChargeMatrixInversion::add_from_file - could not find object name " << objectname << " in file " << filename << std::endl;
-    return false;
+    std::cout << "TpcSpaceChargeMatrixInversion::load_from_file - could not find object name " << objectname << " in file " << filename << std::endl;
+    return nullptr;
   }
 
   if( Verbosity() ) {
-    std::cout << "TpcSpaceChargeMatrixInversion::add_from_file -"
+    std::cout << "TpcSpaceChargeMatrixInversion::load_from_file -"
       << " file: " << filename
       << " objectname: " << objectname
       << " entries: " << source->get_entries()
       << std::endl;
   }
 
-  // add object
-  return add(*source);
+  return source;
+}
+
+//_____________________________________________________________________
+PHThreadPool* TpcSpaceChargeMatrixInversion::thread_pool()
+{
+  if (!m_threadPool)
+  {
+    m_threadPool = std::make_unique<PHThreadPool>(m_num_threads);
+    if (Verbosity())
+    {
+      std::cout << "TpcSpaceChargeMatrixInversion::thread_pool - using " << m_threadPool->size() << " worker threads" << std::endl;
+    }
+  }
+  return m_threadPool.get();
 }
 
 //_____________________________________________________________________
@@ -183,16 +357,7 @@ bool TpcSpaceChargeMatrixInversion::add(const TpcSpaceChargeMatrixContainer& sou
   // check internal container, create if necessary
   if (!m_matrix_container)
   {
-    m_matrix_container.reset(new TpcSpaceChargeMatrixContainerv2);
-
-    // get grid dimensions from source
-    int phibins = 0;
-    int rbins = 0;
-    int zbins = 0;
-    source.get_grid_dimensions(phibins, rbins, zbins);
-
-    // assign
-    m_matrix_container->set_grid_dimensions(phibins, rbins, zbins);
+    m_matrix_container = create_container(source);
   }
 
   // add content
@@ -230,128 +395,161 @@ void TpcSpaceChargeMatrixInversion::calculate_distortion_corrections(const Inver
     h->GetZaxis()->SetTitle("z (cm)");
   }
 
-  // loop over bins
+  // invert all cells, in parallel. Histograms are filled afterwards
+  // cells are processed in the calling thread when verbose, to keep the printout ordered
+  const int ncells = phibins * rbins * zbins;
+  std::vector<cell_result_t> cell_results(ncells);
+  auto invert_cell = [&](std::size_t index, unsigned int /*worker*/)
+  {
+    // get bin indexes
+    const int iphi = index / (rbins * zbins);
+    const int ir = (index / zbins) % rbins;
+    const int iz = index % zbins;
+
+    // get cell index
+    const auto icell = m_matrix_container->get_cell_index(iphi, ir, iz);
+
+    // minimum number of entries per bin
+    static constexpr int min_cluster_count = 2;
+    const auto cell_entries = m_matrix_container->get_entries(icell);
+    if (cell_entries < min_cluster_count)
+    {
+      return;
+    }
+
+    auto& cell_result = cell_results[index];
+    cell_result.valid = true;
+    cell_result.entries = cell_entries;
+
+    switch( inversionMode )
+    {
+      case InversionMode::FullInversion:
+      {
+        /* number of coordinates must match that of the matrix container */
+        static constexpr int ncoord = 3;
+        using matrix_t = Eigen::Matrix<float, ncoord, ncoord>;
+        using column_t = Eigen::Matrix<float, ncoord, 1>;
+
+        // build eigen matrices from container
+        matrix_t lhs = get_matrix<&TpcSpaceChargeMatrixContainer::get_lhs,ncoord>(m_matrix_container.get(),icell);
+        column_t rhs = get_column<&TpcSpaceChargeMatrixContainer::get_rhs,ncoord>(m_matrix_container.get(),icell);
+
+        if (Verbosity())
+        {
+          // print matrices and entries
+          std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - inverting bin " << iz << ", " << ir << ", " << iphi << std::endl;
+          std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - entries: " << cell_entries << std::endl;
+          std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - lhs: \n"
+            << lhs << std::endl;
+          std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - rhs: \n"
+            << rhs << std::endl;
+        }
+
+        // calculate result using linear solving
+        const auto cov = lhs.inverse();
+        auto partialLu = lhs.partialPivLu();
+        const auto result = partialLu.solve(rhs);
+
+        // store
+        cell_result.value = {result(0), result(1), result(2)};
+        cell_result.error = {std::sqrt(cov(0, 0)), std::sqrt(cov(1, 1)), std::sqrt(cov(2, 2))};
+
+        if (Verbosity())
+        {
+          std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dphi: " << result(0) << " +/- " << std::sqrt(cov(0, 0)) << std::endl;
+          std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dz: " << result(1) << " +/- " << std::sqrt(cov(1, 1)) << std::endl;
+          std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dr: " << result(2) << " +/- " << std::sqrt(cov(2, 2)) << std::endl;
+          std::cout << std::endl;
+        }
+        break;
+      }
+
+      case InversionMode::ReducedInversion_phi:
+      case InversionMode::ReducedInversion_z:
+      {
+        /* number of coordinates must match that of the matrix container */
+        static constexpr int ncoord = 2;
+        using matrix_t = Eigen::Matrix<float, ncoord, ncoord>;
+        using column_t = Eigen::Matrix<float, ncoord, 1>;
+
+        // build rphi eigen matrices from container and invert
+        matrix_t lhs_rphi = get_matrix<&TpcSpaceChargeMatrixContainer::get_lhs_rphi,ncoord>(m_matrix_container.get(),icell);
+        column_t rhs_rphi = get_column<&TpcSpaceChargeMatrixContainer::get_rhs_rphi,ncoord>(m_matrix_container.get(),icell);
+        const auto cov_rphi = lhs_rphi.inverse();
+        auto partialLu_rphi = lhs_rphi.partialPivLu();
+        const auto result_rphi = partialLu_rphi.solve(rhs_rphi);
+
+        // build z eigen matrices from container and invert
+        matrix_t lhs_z = get_matrix<&TpcSpaceChargeMatrixContainer::get_lhs_z,ncoord>(m_matrix_container.get(),icell);
+        column_t rhs_z = get_column<&TpcSpaceChargeMatrixContainer::get_rhs_z,ncoord>(m_matrix_container.get(),icell);
+        const auto cov_z = lhs_z.inverse();
+        auto partialLu_z = lhs_z.partialPivLu();
+        const auto result_z = partialLu_z.solve(rhs_z);
+
+        // store
+        cell_result.value[0] = result_rphi(0);
+        cell_result.error[0] = std::sqrt(cov_rphi(0, 0));
+
+        cell_result.value[1] = result_z(0);
+        cell_result.error[1] = std::sqrt(cov_z(0, 0));
+
+        if( inversionMode == InversionMode::ReducedInversion_phi )
+        {
+          cell_result.value[2] = result_rphi(1);
+          cell_result.error[2] = std::sqrt(cov_rphi(1, 1));
+        } else if( inversionMode == InversionMode::ReducedInversion_z ) {
+          cell_result.value[2] = result_z(1);
+          cell_result.error[2] = std::sqrt(cov_z(1, 1));
+        }
+
+        if (Verbosity())
+        {
+          std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dphi: " << result_rphi(0) << " +/- " << std::sqrt(cov_rphi(0, 0)) << std::endl;
+          std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dz: " << result_z(0) << " +/- " << std::sqrt(cov_z(0, 0)) << std::endl;
+          std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dr (rphi): " << result_rphi(1) << " +/- " << std::sqrt(cov_rphi(1, 1)) << std::endl;
+          std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dr (z): " << result_z(1) << " +/- " << std::sqrt(cov_z(1, 1)) << std::endl;
+          std::cout << std::endl;
+        }
+        break;
+      }
+    }
+  };
+
+  if (Verbosity())
+  {
+    for (int index = 0; index < ncells; ++index)
+    {
+      invert_cell(index, 0);
+    }
+  }
+  else
+  {
+    thread_pool()->parallel_for(ncells, invert_cell);
+  }
+
+  // fill histograms
   for (int iphi = 0; iphi < phibins; ++iphi)
   {
     for (int ir = 0; ir < rbins; ++ir)
     {
       for (int iz = 0; iz < zbins; ++iz)
       {
-        // get cell index
-        const auto icell = m_matrix_container->get_cell_index(iphi, ir, iz);
-
-        // minimum number of entries per bin
-        static constexpr int min_cluster_count = 2;
-        const auto cell_entries = m_matrix_container->get_entries(icell);
-        if (cell_entries < min_cluster_count)
+        const auto& cell_result = cell_results[(iphi * rbins + ir) * zbins + iz];
+        if (!cell_result.valid)
         {
           continue;
         }
 
-        switch( inversionMode )
-        {
-          case InversionMode::FullInversion:
-          {
-            /* number of coordinates must match that of the matrix container */
-            static constexpr int ncoord = 3;
-            using matrix_t = Eigen::Matrix<float, ncoord, ncoord>;
-            using column_t = Eigen::Matrix<float, ncoord, 1>;
-
-            // build eigen matrices from container
-            matrix_t lhs = get_matrix<&TpcSpaceChargeMatrixContainer::get_lhs,ncoord>(m_matrix_container.get(),icell);
-            column_t rhs = get_column<&TpcSpaceChargeMatrixContainer::get_rhs,ncoord>(m_matrix_container.get(),icell);
-
-            if (Verbosity())
-            {
-              // print matrices and entries
-              std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - inverting bin " << iz << ", " << ir << ", " << iphi << std::endl;
-              std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - entries: " << cell_entries << std::endl;
-              std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - lhs: \n"
-                << lhs << std::endl;
-              std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - rhs: \n"
-                << rhs << std::endl;
-            }
-
-            // calculate result using linear solving
-            const auto cov = lhs.inverse();
-            auto partialLu = lhs.partialPivLu();
-            const auto result = partialLu.solve(rhs);
-
-            // fill histograms
-            hentries->SetBinContent(iphi + 1, ir + 1, iz + 1, cell_entries);
-
-            hphi->SetBinContent(iphi + 1, ir + 1, iz + 1, result(0));
-            hphi->SetBinError(iphi + 1, ir + 1, iz + 1, std::sqrt(cov(0, 0)));
-
-            hz->SetBinContent(iphi + 1, ir + 1, iz + 1, result(1));
-            hz->SetBinError(iphi + 1, ir + 1, iz + 1, std::sqrt(cov(1, 1)));
-
-            hr->SetBinContent(iphi + 1, ir + 1, iz + 1, result(2));
-            hr->SetBinError(iphi + 1, ir + 1, iz + 1, std::sqrt(cov(2, 2)));
-
-            if (Verbosity())
-            {
-              std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dphi: " << result(0) << " +/- " << std::sqrt(cov(0, 0)) << std::endl;
-              std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dz: " << result(1) << " +/- " << std::sqrt(cov(1, 1)) << std::endl;
-              std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dr: " << result(2) << " +/- " << std::sqrt(cov(2, 2)) << std::endl;
-              std::cout << std::endl;
-            }
-            break;
-          }
-
-          case InversionMode::ReducedInversion_phi:
-          case InversionMode::ReducedInversion_z:
-          {
-            /* number of coordinates must match that of the matrix container */
-            static constexpr int ncoord = 2;
-            using matrix_t = Eigen::Matrix<float, ncoord, ncoord>;
-            using column_t = Eigen::Matrix<float, ncoord, 1>;
-
-            // build rphi eigen matrices from container and invert
-            matrix_t lhs_rphi = get_matrix<&TpcSpaceChargeMatrixContainer::get_lhs_rphi,ncoord>(m_matrix_container.get(),icell);
-            column_t rhs_rphi = get_column<&TpcSpaceChargeMatrixContainer::get_rhs_rphi,ncoord>(m_matrix_container.get(),icell);
-            const auto cov_rphi = lhs_rphi.inverse();
-            auto partialLu_rphi = lhs_rphi.partialPivLu();
-            const auto result_rphi = partialLu_rphi.solve(rhs_rphi);
-
-            // build z eigen matrices from container and invert
-            matrix_t lhs_z = get_matrix<&TpcSpaceChargeMatrixContainer::get_lhs_z,ncoord>(m_matrix_container.get(),icell);
-            column_t rhs_z = get_column<&TpcSpaceChargeMatrixContainer::get_rhs_z,ncoord>(m_matrix_container.get(),icell);
-            const auto cov_z = lhs_z.inverse();
-            auto partialLu_z = lhs_z.partialPivLu();
-            const auto result_z = partialLu_z.solve(rhs_z);
-
-            // fill histograms
-            hentries->SetBinContent(iphi + 1, ir + 1, iz + 1, cell_entries);
-
-            hphi->SetBinContent(iphi + 1, ir + 1, iz + 1, result_rphi(0));
-            hphi->SetBinError(iphi + 1, ir + 1, iz + 1, std::sqrt(cov_rphi(0, 0)));
-
-            hz->SetBinContent(iphi + 1, ir + 1, iz + 1, result_z(0));
-            hz->SetBinError(iphi + 1, ir + 1, iz + 1, std::sqrt(cov_z(0, 0)));
-
-            if( inversionMode == InversionMode::ReducedInversion_phi )
-            {
-              hr->SetBinContent(iphi + 1, ir + 1, iz + 1, result_rphi(1));
-              hr->SetBinError(iphi + 1, ir + 1, iz + 1, std::sqrt(cov_rphi(1, 1)));
-            } else if( inversionMode == InversionMode::ReducedInversion_z ) {
-              hr->SetBinContent(iphi + 1, ir + 1, iz + 1, result_z(1));
-              hr->SetBinError(iphi + 1, ir + 1, iz + 1, std::sqrt(cov_z(1, 1)));
-            }
-
-
-            if (Verbosity())
-            {
-              std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dphi: " << result_rphi(0) << " +/- " << std::sqrt(cov_rphi(0, 0)) << std::endl;
-              std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dz: " << result_z(0) << " +/- " << std::sqrt(cov_z(0, 0)) << std::endl;
-              std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dr (rphi): " << result_rphi(1) << " +/- " << std::sqrt(cov_rphi(1, 1)) << std::endl;
-              std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortion_corrections - dr (z): " << result_z(1) << " +/- " << std::sqrt(cov_z(1, 1)) << std::endl;
-              std::cout << std::endl;
-            }
-            break;
-          }
-        }
+        hentries->SetBinContent(iphi + 1, ir + 1, iz + 1, cell_result.entries);
+
+        hphi->SetBinContent(iphi + 1, ir + 1, iz + 1, cell_result.value[0]);
+        hphi->SetBinError(iphi + 1, ir + 1, iz + 1, cell_result.error[0]);
+
+        hz->SetBinContent(iphi + 1, ir + 1, iz + 1, cell_result.value[1]);
+        hz->SetBinError(iphi + 1, ir + 1, iz + 1, cell_result.error[1]);
 
+        hr->SetBinContent(iphi + 1, ir + 1, iz + 1, cell_result.value[2]);
+        hr->SetBinError(iphi + 1, ir + 1, iz + 1, cell_result.error[2]);
       } // z-loop
     } // r-loop
   } // phi-loop
@@ -12,6 +12,10 @@
 #include <tpc/TpcDistortionCorrectionContainer.h>
 
 #include <memory>
+#include <string>
+#include <vector>
+
+class PHThreadPool;
 
 /**
  * \class TpcSpaceChargeMatrixInversion
@@ -24,6 +28,9 @@ class TpcSpaceChargeMatrixInversion : public Fun4AllBase
   /// constructor
   TpcSpaceChargeMatrixInversion(const std::string& = "TPCSPACECHARGEMATRIXINVERSION");
 
+  /// destructor
+  ~TpcSpaceChargeMatrixInversion() override;
+
   ///@name modifiers
   //@{
 
@@ -39,6 +46,20 @@ class TpcSpaceChargeMatrixInversion : public Fun4AllBase
   /// add space charge correction matrix, loaded from file, to current. Returns true on success
   bool add_from_file(const std::string& /*filename*/, const std::string& /*objectname*/ = "TpcSpaceChargeMatrixContainer");
 
+  /// add space charge correction matrices, loaded from files, to current. Returns true on success
+  /**
+   * files are split in one contiguous block per thread. Each thread reads its files one at a time
+   * and accumulates them in its own container, so that at most two containers per thread are in memory.
+   * Per thread containers are then merged pairwise, in parallel, before being added to current.
+   */
+  bool add_from_files(const std::vector<std::string>& /*filenames*/, const std::string& /*objectname*/ = "TpcSpaceChargeMatrixContainer");
+
+  /// number of threads used to merge matrices and invert cells. Negative means one per hardware thread, 0 (default) runs in the calling thread
+  void set_num_threads(int nthreads) { m_num_threads = nthreads; }
+
+  /// save current (merged) space charge correction matrix to file, so that merged files can be merged again. Returns true on success
+  bool save_matrix_container(const std::string& /*filename*/, const std::string& /*objectname*/ = "TpcSpaceChargeMatrixContainer") const;
+
   enum class InversionMode
   {
     FullInversion,        // use 3D matrices (phi,z,r)
@@ -58,6 +79,18 @@ class TpcSpaceChargeMatrixInversion : public Fun4AllBase
   //@}
 
  private:
+  /// load space charge correction matrix from file. Returns nullptr on failure
+  std::unique_ptr<TpcSpaceChargeMatrixContainer> load_from_file(const std::string& /*filename*/, const std::string& /*objectname*/) const;
+
+  /// thread pool, created on first use
+  PHThreadPool* thread_pool();
+
+  /// number of threads
+  int m_num_threads = 0;
+
+  /// thread pool
+  std::unique_ptr<PHThreadPool> m_threadPool;
+
   /// matrix container
   std::unique_ptr<TpcSpaceChargeMatrixContainer> m_matrix_container;
 
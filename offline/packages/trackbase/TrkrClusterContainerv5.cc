@@ -0,0 +1,336 @@
+/**
+ * @file trackbase/TrkrClusterContainerv5.cc
+ * @author Hugo Pereira Da Costa
+ * @date October 2026
+ * @brief Implementation of TrkrClusterContainerv5
+ */
+#include "TrkrClusterContainerv5.h"
+#include "TrkrCluster.h"
+#include "TrkrDefs.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <typeinfo>
+
+namespace
+{
+  TrkrClusterContainer::Map dummy_map;
+}
+
+//_________________________________________________________________
+unsigned int TrkrClusterContainerv5::Block::size() const
+{
+  return std::count(m_valid.begin(), m_valid.end(), 1);
+}
+
+//_________________________________________________________________
+TrkrClusterContainerv5::~TrkrClusterContainerv5()
+{
+  for (auto&& [key, cluster] : m_other_clusters)
+  {
+    delete cluster;
+  }
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::Reset()
+{
+  m_hitsetkeys.clear();
+  m_blocks.clear();
+
+  // delete clusters stored outside of blocks
+  for (auto&& [key, cluster] : m_other_clusters)
+  {
+    delete cluster;
+  }
+  m_other_clusters.clear();
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::identify(std::ostream& os) const
+{
+  os << "-----TrkrClusterContainerv5-----" << std::endl;
+  os << "Number of clusters: " << size() << std::endl;
+
+  for (size_t iblock = 0; iblock < m_blocks.size(); ++iblock)
+  {
+    const auto hitsetkey = m_hitsetkeys[iblock];
+    const unsigned int layer = TrkrDefs::getLayer(hitsetkey);
+    os << "layer: " << layer << " hitsetkey: " << hitsetkey << std::endl;
+
+    const auto& block = m_blocks[iblock];
+    for (size_t index = 0; index < block.m_clusters.size(); ++index)
+    {
+      if (block.m_valid[index])
+      {
+        block.m_clusters[index].identify(os);
+      }
+    }
+  }
+
+  for (const auto& [key, cluster] : m_other_clusters)
+  {
+    cluster->identify(os);
+  }
+
+  os << "------------------------------" << std::endl;
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::removeCluster(TrkrDefs::cluskey key)
+{
+  // get hitset key from cluster
+  const TrkrDefs::hitsetkey hitsetkey = TrkrDefs::getHitSetKeyFromClusKey(key);
+
+  // find relevant block if any and invalidate corresponding cluster
+  const int block_index = find_block_index(hitsetkey);
+  if (block_index >= 0)
+  {
+    auto& block = m_blocks[block_index];
+    const auto index = TrkrDefs::getClusIndex(key);
+    if (index < block.m_valid.size() && block.m_valid[index])
+    {
+      block.m_valid[index] = 0;
+      block.m_clusters[index] = TrkrClusterv5();
+      block.m_map_valid = false;
+      return;
+    }
+  }
+
+  // check clusters stored outside of blocks
+  auto iter = m_other_clusters.find(key);
+  if (iter != m_other_clusters.end())
+  {
+    if (block_index >= 0)
+    {
+      m_blocks[block_index].m_map_valid = false;
+    }
+    delete iter->second;
+    m_other_clusters.erase(iter);
+  }
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::removeClusters(TrkrDefs::hitsetkey hitsetkey)
+{
+  const int index = find_block_index(hitsetkey);
+  if (index >= 0)
+  {
+    m_hitsetkeys.erase(m_hitsetkeys.begin() + index);
+    m_blocks.erase(m_blocks.begin() + index);
+  }
+
+  // also remove clusters stored outside of blocks
+  const auto begin = m_other_clusters.lower_bound(TrkrDefs::genClusKey(hitsetkey, 0));
+  const auto end = m_other_clusters.upper_bound(TrkrDefs::genClusKey(hitsetkey, UINT32_MAX));
+  for (auto iter = begin; iter != end; ++iter)
+  {
+    delete iter->second;
+  }
+  m_other_clusters.erase(begin, end);
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::addClusterSpecifyKey(const TrkrDefs::cluskey key, TrkrCluster* newclus)
+{
+  // get hitsetkey from cluster
+  const TrkrDefs::hitsetkey hitsetkey = TrkrDefs::getHitSetKeyFromClusKey(key);
+
+  // get cluster index in block
+  const auto index = TrkrDefs::getClusIndex(key);
+
+  // check for duplicates
+  if (findCluster(key))
+  {
+    std::cout << "TrkrClusterContainerv5::AddClusterSpecifyKey: duplicate key: " << key << " exiting now" << std::endl;
+    exit(1);
+  }
+
+  // clusters of another type, and clusters far beyond the end of their block, are stored as is, to keep blocks dense
+  const int block_index = find_block_index(hitsetkey);
+  const size_t block_size = block_index < 0 ? 0 : m_blocks[block_index].m_clusters.size();
+  if (typeid(*newclus) != typeid(TrkrClusterv5) || index >= block_size + max_index_gap)
+  {
+    m_other_clusters.insert(std::make_pair(key, newclus));
+    if (block_index >= 0)
+    {
+      m_blocks[block_index].m_map_valid = false;
+    }
+    return;
+  }
+
+  // find relevant block or create one if not found
+  auto& block = block_index < 0 ? get_block(hitsetkey) : m_blocks[block_index];
+  if (index >= block.m_clusters.size())
+  {
+    // growing a deque at its end does not move existing clusters
+    block.m_clusters.resize(index + 1);
+    block.m_valid.resize(index + 1, 0);
+  }
+
+  // copy and take ownership
+  block.m_clusters[index] = *static_cast<TrkrClusterv5*>(newclus);
+  block.m_valid[index] = 1;
+  block.m_map_valid = false;
+  delete newclus;
+}
+
+//_________________________________________________________________
+TrkrClusterContainerv5::ConstRange
+TrkrClusterContainerv5::getClusters() const
+{
+  std::cout << "deprecated function in TrkrClusterContainerv5, user getClusters(TrkrDefs:hitsetkey)"
+            << std::endl;
+  return std::make_pair(dummy_map.begin(), dummy_map.begin());
+}
+
+//_________________________________________________________________
+TrkrClusterContainerv5::ConstRange
+TrkrClusterContainerv5::getClusters(TrkrDefs::hitsetkey hitsetkey)
+{
+  // clusters stored outside of blocks
+  const auto begin = m_other_clusters.lower_bound(TrkrDefs::genClusKey(hitsetkey, 0));
+  const auto end = m_other_clusters.upper_bound(TrkrDefs::genClusKey(hitsetkey, UINT32_MAX));
+
+  // without a block, all clusters are in the other clusters map
+  const int block_index = find_block_index(hitsetkey);
+  if (block_index < 0)
+  {
+    return std::make_pair(begin, end);
+  }
+
+  // build block map if it is out of date
+  auto& block = m_blocks[block_index];
+  if (!block.m_map_valid)
+  {
+    block.m_map.clear();
+    for (size_t index = 0; index < block.m_clusters.size(); ++index)
+    {
+      if (block.m_valid[index])
+      {
+        // generate cluster key from hitset and index
+        const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
+
+        // insert in map
+        block.m_map.insert(block.m_map.end(), std::make_pair(ckey, &block.m_clusters[index]));
+      }
+    }
+    block.m_map.insert(begin, end);
+    block.m_map_valid = true;
+  }
+
+  return std::make_pair(block.m_map.cbegin(), block.m_map.cend());
+}
+
+//_________________________________________________________________
+const TrkrClusterContainerv5::Block* TrkrClusterContainerv5::getBlock(TrkrDefs::hitsetkey hitsetkey) const
+{
+  const int block_index = find_block_index(hitsetkey);
+  return block_index < 0 ? nullptr : &m_blocks[block_index];
+}
+
+//_________________________________________________________________
+TrkrCluster* TrkrClusterContainerv5::findCluster(TrkrDefs::cluskey key) const
+{
+  // get hitsetkey from cluster
+  const TrkrDefs::hitsetkey hitsetkey = TrkrDefs::getHitSetKeyFromClusKey(key);
+
+  const int block_index = find_block_index(hitsetkey);
+  if (block_index >= 0)
+  {
+    // get cluster position in block
+    const auto& block = m_blocks[block_index];
+    const auto index = TrkrDefs::getClusIndex(key);
+    if (index < block.m_valid.size() && block.m_valid[index])
+    {
+      return const_cast<TrkrClusterv5*>(&block.m_clusters[index]);
+    }
+  }
+
+  if (m_other_clusters.empty())
+  {
+    return nullptr;
+  }
+
+  const auto iter = m_other_clusters.find(key);
+  return iter == m_other_clusters.end() ? nullptr : iter->second;
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyList TrkrClusterContainerv5::getHitSetKeys() const
+{
+  // block hitset keys are already sorted
+  HitSetKeyList out(m_hitsetkeys);
+  if (m_other_clusters.empty())
+  {
+    return out;
+  }
+
+  for (const auto& [key, cluster] : m_other_clusters)
+  {
+    out.push_back(TrkrDefs::getHitSetKeyFromClusKey(key));
+  }
+
+  // sort and remove duplicates
+  std::sort(out.begin(), out.end());
+  out.erase(std::unique(out.begin(), out.end()), out.end());
+  return out;
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyList TrkrClusterContainerv5::getHitSetKeys(const TrkrDefs::TrkrId trackerid) const
+{
+  const TrkrDefs::hitsetkey keylo = TrkrDefs::getHitSetKeyLo(trackerid);
+  const TrkrDefs::hitsetkey keyhi = TrkrDefs::getHitSetKeyHi(trackerid);
+
+  auto out = getHitSetKeys();
+  out.erase(std::upper_bound(out.begin(), out.end(), keyhi), out.end());
+  out.erase(out.begin(), std::lower_bound(out.begin(), out.end(), keylo));
+  return out;
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyList TrkrClusterContainerv5::getHitSetKeys(const TrkrDefs::TrkrId trackerid, const uint8_t layer) const
+{
+  const TrkrDefs::hitsetkey keylo = TrkrDefs::getHitSetKeyLo(trackerid, layer);
+  const TrkrDefs::hitsetkey keyhi = TrkrDefs::getHitSetKeyHi(trackerid, layer);
+
+  auto out = getHitSetKeys();
+  out.erase(std::upper_bound(out.begin(), out.end(), keyhi), out.end());
+  out.erase(out.begin(), std::lower_bound(out.begin(), out.end(), keylo));
+  return out;
+}
+
+//_________________________________________________________________
+unsigned int TrkrClusterContainerv5::size() const
+{
+  unsigned int size = m_other_clusters.size();
+  for (const auto& block : m_blocks)
+  {
+    size += block.size();
+  }
+  return size;
+}
+
+//_________________________________________________________________
+int TrkrClusterContainerv5::find_block_index(TrkrDefs::hitsetkey hitsetkey) const
+{
+  const auto iter = std::lower_bound(m_hitsetkeys.begin(), m_hitsetkeys.end(), hitsetkey);
+  return (iter == m_hitsetkeys.end() || *iter != hitsetkey) ? -1 : (int) (iter - m_hitsetkeys.begin());
+}
+
+//_________________________________________________________________
+TrkrClusterContainerv5::Block& TrkrClusterContainerv5::get_block(TrkrDefs::hitsetkey hitsetkey)
+{
+  // insert new block at its sorted position. Moving blocks does not move their clusters
+  const auto iter = std::lower_bound(m_hitsetkeys.begin(), m_hitsetkeys.end(), hitsetkey);
+  if (iter != m_hitsetkeys.end() && *iter == hitsetkey)
+  {
+    return m_blocks[iter - m_hitsetkeys.begin()];
+  }
+
+  const auto index = iter - m_hitsetkeys.begin();
+  m_hitsetkeys.insert(iter, hitsetkey);
+  return *m_blocks.emplace(m_blocks.begin() + index);
+}
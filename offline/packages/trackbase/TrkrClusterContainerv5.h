@@ -0,0 +1,172 @@
+#ifndef TRACKBASE_TRKRCLUSTERCONTAINERV5_H
+#define TRACKBASE_TRKRCLUSTERCONTAINERV5_H
+
+/**
+ * @file trackbase/TrkrClusterContainerv5.h
+ * @author Hugo Pereira Da Costa
+ * @date October 2026
+ * @brief Cluster container object with contiguous per-hitset storage
+ */
+
+#include "TrkrClusterContainer.h"
+#include "TrkrClusterv5.h"
+
+#include <phool/PHObject.h>
+
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+class TrkrCluster;
+
+/**
+ * @brief Cluster container object with contiguous per-hitset storage
+ *
+ * TrkrClusterv5 clusters are stored by value, in one block per hitset, in cluster index order.
+ * Blocks are kept sorted by hitset key, with a flat sorted array of hitset keys used to locate them,
+ * so that findCluster is a binary search over hitsets and an array access, with no per-cluster heap object.
+ * The index is updated when blocks are added or removed, and is stored together with the blocks,
+ * so that const accessors never modify the container.
+ *
+ * Clusters of a block are stored in a std::deque, so that pointers returned by findCluster
+ * and getClusters stay valid when more clusters are added, until the cluster is removed or the container reset.
+ *
+ * getClusters(hitsetkey) must return a range of the TrkrClusterContainer map type. The map of each block is built
+ * on first use and kept until the block is modified, so that repeated calls do not rebuild it,
+ * and ranges of different hitsets stay valid at the same time. Code that knows about this container
+ * should rather iterate over the block storage directly, using getBlock.
+ *
+ * TrkrClusterv5 clusters passed to addClusterSpecifyKey are copied into the block and deleted.
+ * Other cluster versions, and clusters whose index is far beyond the current end of their block,
+ * are kept as is, in a separate map, so that sparse cluster indices cannot blow up the block size.
+ *
+ * Clusters are stored as objects rather than one array per field, because the TrkrClusterContainer
+ * interface hands out TrkrCluster pointers.
+ */
+class TrkrClusterContainerv5 : public TrkrClusterContainer
+{
+ public:
+  TrkrClusterContainerv5() = default;
+
+  //! destructor
+  ~TrkrClusterContainerv5() override;
+
+  // copying would require deep copying the non-v5 clusters
+  TrkrClusterContainerv5(const TrkrClusterContainerv5&) = delete;
+  TrkrClusterContainerv5& operator=(const TrkrClusterContainerv5&) = delete;
+
+  /**
+   * remove all stored clusters
+   * effectively leaving the container empty
+   */
+  void Reset() override;
+
+  void identify(std::ostream& os = std::cout) const override;
+
+  void addClusterSpecifyKey(const TrkrDefs::cluskey, TrkrCluster*) override;
+
+  //! remove cluster matching a given cluster key
+  void removeCluster(TrkrDefs::cluskey) override;
+
+  //! delete and remove all the clusters matching a given key
+  void removeClusters(TrkrDefs::hitsetkey) override;
+
+  ConstRange getClusters() const override;  // deprecated
+
+  ConstRange getClusters(TrkrDefs::hitsetkey) override;
+
+  TrkrCluster* findCluster(TrkrDefs::cluskey) const override;
+
+  HitSetKeyList getHitSetKeys() const override;
+
+  HitSetKeyList getHitSetKeys(const TrkrDefs::TrkrId) const override;
+
+  HitSetKeyList getHitSetKeys(const TrkrDefs::TrkrId, const uint8_t /* layer */) const override;
+
+  unsigned int size(void) const override;
+
+  //! clusters for a given hitset
+  class Block
+  {
+   public:
+    Block() = default;
+
+    //! copy does not copy the map, whose pointers refer to the original clusters
+    Block(const Block& other)
+      : m_clusters(other.m_clusters)
+      , m_valid(other.m_valid)
+    {
+    }
+
+    Block& operator=(const Block& other)
+    {
+      m_clusters = other.m_clusters;
+      m_valid = other.m_valid;
+      m_map.clear();
+      m_map_valid = false;
+      return *this;
+    }
+
+    //! move swaps storage, so that clusters stay in place when m_blocks grows or is reordered.
+    //! std::deque move is not noexcept, which would make std::vector copy blocks instead
+    Block(Block&& other) noexcept
+    {
+      swap(other);
+    }
+
+    Block& operator=(Block&& other) noexcept
+    {
+      swap(other);
+      return *this;
+    }
+
+    void swap(Block& other) noexcept
+    {
+      m_clusters.swap(other.m_clusters);
+      m_valid.swap(other.m_valid);
+      m_map.swap(other.m_map);
+      std::swap(m_map_valid, other.m_map_valid);
+    }
+
+    //! clusters, indexed by cluster index. Elements never move when the block grows
+    std::deque<TrkrClusterv5> m_clusters;
+
+    //! true if cluster at a given index is set
+    std::vector<unsigned char> m_valid;
+
+    //! number of valid clusters
+    unsigned int size() const;
+
+    //! cluster map returned by getClusters, built on first use
+    Map m_map;                //! transient
+    bool m_map_valid{false};  //! transient
+  };
+
+  //! block storage for a given hitset, nullptr if there is none.
+  //! Clusters that are not TrkrClusterv5, or whose index is far beyond the block end, are not in the block
+  const Block* getBlock(TrkrDefs::hitsetkey) const;
+
+  //! maximum distance between a new cluster index and the end of its block for the cluster to be stored in the block
+  static constexpr unsigned int max_index_gap = 1024;
+
+ private:
+  //! get index of block matching hitset key, -1 if not found
+  int find_block_index(TrkrDefs::hitsetkey) const;
+
+  //! get block matching hitset key, create it if not found
+  Block& get_block(TrkrDefs::hitsetkey);
+
+  //! sorted hitset keys, one per block
+  std::vector<TrkrDefs::hitsetkey> m_hitsetkeys;
+
+  //! per hitset cluster blocks, in the same order as hitset keys
+  std::vector<Block> m_blocks;
+
+  //! clusters that are not stored in blocks. Owned by the container
+  Map m_other_clusters;
+
+  ClassDefOverride(TrkrClusterContainerv5, 1)
+};
+
+#endif  // TRACKBASE_TRKRCLUSTERCONTAINERV5_H
@@ -0,0 +1,8 @@
+#ifdef __CINT__
+
+#pragma link C++ class TrkrClusterContainerv5 + ;
+#pragma link C++ class TrkrClusterContainerv5::Block + ;
+#pragma link C++ class std::deque<TrkrClusterv5> + ;
+#pragma link C++ class std::vector<TrkrClusterContainerv5::Block> + ;
+
+#endif /* __CINT__ */
@@ -0,0 +1,246 @@
+/**
+ * @file trackbase/TrkrHitSetv2.cc
+ * @author H. PEREIRA DA COSTA
+ * @date October 2026
+ * @brief Implementation of TrkrHitSetv2
+ */
+#include "TrkrHitSetv2.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>  // for exit
+#include <iostream>
+
+namespace
+{
+  //! saturating sum of adc values
+  inline uint16_t add_adc(unsigned int first, unsigned int second)
+  {
+    return std::min<unsigned int>(first + second, USHRT_MAX);
+  }
+}  // namespace
+
+//_________________________________________________________________
+void TrkrHitSetv2::Reset()
+{
+  m_hitSetKey = TrkrDefs::HITSETKEYMAX;
+  Clear();
+}
+
+//_________________________________________________________________
+void TrkrHitSetv2::Clear(Option_t* /*option*/)
+{
+  // vectors are cleared but not deallocated, so that memory is reused in next event
+  m_hitkeys.clear();
+  m_adcs.clear();
+}
+
+//_________________________________________________________________
+void TrkrHitSetv2::identify(std::ostream& os) const
+{
+  const unsigned int layer = TrkrDefs::getLayer(m_hitSetKey);
+  const unsigned int trkrid = TrkrDefs::getTrkrId(m_hitSetKey);
+  os
+      << "TrkrHitSetv2: "
+      << "       hitsetkey " << getHitSetKey()
+      << " TrkrId " << trkrid
+      << " layer " << layer
+      << " nhits: " << m_hitkeys.size()
+      << std::endl;
+
+  for (size_t i = 0; i < m_hitkeys.size(); ++i)
+  {
+    os << " hitkey " << m_hitkeys[i] << " adc " << m_adcs[i] << std::endl;
+  }
+}
+
+//_________________________________________________________________
+void TrkrHitSetv2::removeHit(TrkrDefs::hitkey key)
+{
+  const auto iter = std::lower_bound(m_hitkeys.begin(), m_hitkeys.end(), key);
+  if (iter != m_hitkeys.end() && *iter == key)
+  {
+    const auto index = iter - m_hitkeys.begin();
+    m_hitkeys.erase(iter);
+    m_adcs.erase(m_adcs.begin() + index);
+  }
+  else
+  {
+    identify();
+    std::cout << "TrkrHitSetv2::removeHit: deleting a nonexist key: " << key << " exiting now" << std::endl;
+    exit(1);
+  }
+}
+
+//_________________________________________________________________
+TrkrHitSetv2::ConstIterator
+TrkrHitSetv2::addHitSpecificKey(const TrkrDefs::hitkey key, TrkrHit* /*hit*/)
+{
+  std::cout << "TrkrHitSetv2::addHitSpecificKey: not supported, use setAdc. key: " << key << " exiting now" << std::endl;
+  exit(1);
+}
+
+//_________________________________________________________________
+TrkrHit* TrkrHitSetv2::getHit(const TrkrDefs::hitkey key) const
+{
+  std::cout << "TrkrHitSetv2::getHit: not supported, use getAdc. key: " << key << " exiting now" << std::endl;
+  exit(1);
+}
+
+//_________________________________________________________________
+TrkrHitSetv2::ConstRange
+TrkrHitSetv2::getHits() const
+{
+  std::cout << "TrkrHitSetv2::getHits: not supported, use getHitKeys and getAdcs. exiting now" << std::endl;
+  exit(1);
+}
+
+//_________________________________________________________________
+unsigned int TrkrHitSetv2::getAdc(const TrkrDefs::hitkey key) const
+{
+  const auto iter = std::lower_bound(m_hitkeys.begin(), m_hitkeys.end(), key);
+  return (iter != m_hitkeys.end() && *iter == key) ? m_adcs[iter - m_hitkeys.begin()] : 0;
+}
+
+//_________________________________________________________________
+void TrkrHitSetv2::setAdc(const TrkrDefs::hitkey key, const unsigned int adc)
+{
+  const uint16_t value = std::min<unsigned int>(adc, USHRT_MAX);
+  const auto iter = std::lower_bound(m_hitkeys.begin(), m_hitkeys.end(), key);
+  const auto index = iter - m_hitkeys.begin();
+  if (iter != m_hitkeys.end() && *iter == key)
+  {
+    m_adcs[index] = value;
+  }
+  else
+  {
+    m_hitkeys.insert(iter, key);
+    m_adcs.insert(m_adcs.begin() + index, value);
+  }
+}
+
+//_________________________________________________________________
+void TrkrHitSetv2::addAdc(const TrkrDefs::hitkey key, const unsigned int adc)
+{
+  const auto iter = std::lower_bound(m_hitkeys.begin(), m_hitkeys.end(), key);
+  const auto index = iter - m_hitkeys.begin();
+  if (iter != m_hitkeys.end() && *iter == key)
+  {
+    m_adcs[index] = add_adc(m_adcs[index], adc);
+  }
+  else
+  {
+    m_hitkeys.insert(iter, key);
+    m_adcs.insert(m_adcs.begin() + index, add_adc(0, adc));
+  }
+}
+
+//_________________________________________________________________
+void TrkrHitSetv2::addEnergy(const TrkrDefs::hitkey key, const double edep)
+{
+  // same conversion as in TrkrHitv2::addEnergy
+  const double ein = edep * TrkrDefs::EdepScaleFactor;
+  addAdc(key, ein > (double) USHRT_MAX ? USHRT_MAX : (unsigned int) ein);
+}
+
+//_________________________________________________________________
+void TrkrHitSetv2::addHits(std::vector<HitAdcPair>& hits)
+{
+  if (hits.empty())
+  {
+    return;
+  }
+
+  // sort input and sum duplicates in place
+  std::sort(hits.begin(), hits.end(), [](const HitAdcPair& first, const HitAdcPair& second)
+            { return first.first < second.first; });
+
+  auto out = hits.begin();
+  for (auto iter = hits.begin() + 1; iter != hits.end(); ++iter)
+  {
+    if (iter->first == out->first)
+    {
+      out->second = add_adc(out->second, iter->second);
+    }
+    else
+    {
+      *(++out) = *iter;
+    }
+  }
+  hits.erase(++out, hits.end());
+
+  // merge into storage
+  struct key_iterator
+  {
+    std::vector<HitAdcPair>::const_iterator iter;
+    TrkrDefs::hitkey operator*() const { return iter->first; }
+    key_iterator& operator++()
+    {
+      ++iter;
+      return *this;
+    }
+    bool operator!=(const key_iterator& other) const { return iter != other.iter; }
+  };
+
+  struct adc_iterator
+  {
+    std::vector<HitAdcPair>::const_iterator iter;
+    unsigned int operator*() const { return iter->second; }
+    adc_iterator& operator++()
+    {
+      ++iter;
+      return *this;
+    }
+  };
+
+  merge_sorted(key_iterator{hits.cbegin()}, key_iterator{hits.cend()}, adc_iterator{hits.cbegin()}, hits.size());
+}
+
+//_________________________________________________________________
+void TrkrHitSetv2::merge(const TrkrHitSetv2& other)
+{
+  merge_sorted(other.m_hitkeys.cbegin(), other.m_hitkeys.cend(), other.m_adcs.cbegin(), other.m_hitkeys.size());
+}
+
+//_________________________________________________________________
+template <class KeyIterator, class AdcIterator>
+void TrkrHitSetv2::merge_sorted(KeyIterator key_begin, KeyIterator key_end, AdcIterator adc_begin, size_t size)
+{
+  // linear merge of two sorted lists into scratch space, large enough for both
+  m_merge_hitkeys.clear();
+  m_merge_adcs.clear();
+  m_merge_hitkeys.reserve(m_hitkeys.size() + size);
+  m_merge_adcs.reserve(m_adcs.size() + size);
+
+  size_t i = 0;
+  auto key_iter = key_begin;
+  auto adc_iter = adc_begin;
+  while (i < m_hitkeys.size() || key_iter != key_end)
+  {
+    if (!(key_iter != key_end) || (i < m_hitkeys.size() && m_hitkeys[i] < *key_iter))
+    {
+      m_merge_hitkeys.push_back(m_hitkeys[i]);
+      m_merge_adcs.push_back(m_adcs[i]);
+      ++i;
+    }
+    else if (i < m_hitkeys.size() && m_hitkeys[i] == *key_iter)
+    {
+      m_merge_hitkeys.push_back(m_hitkeys[i]);
+      m_merge_adcs.push_back(add_adc(m_adcs[i], *adc_iter));
+      ++i;
+      ++key_iter;
+      ++adc_iter;
+    }
+    else
+    {
+      m_merge_hitkeys.push_back(*key_iter);
+      m_merge_adcs.push_back(add_adc(0, *adc_iter));
+      ++key_iter;
+      ++adc_iter;
+    }
+  }
+
+  // swap with storage. Old storage is kept as scratch space for next merge
+  m_hitkeys.swap(m_merge_hitkeys);
+  m_adcs.swap(m_merge_adcs);
+}
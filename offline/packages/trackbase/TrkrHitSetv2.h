@@ -0,0 +1,146 @@
+#ifndef TRACKBASE_TRKRHITSETV2_H
+#define TRACKBASE_TRKRHITSETV2_H
+
+/**
+ * @file trackbase/TrkrHitSetv2.h
+ * @author H. PEREIRA DA COSTA
+ * @date October 2026
+ * @brief Container for storing hits as a flat, sorted list of (hitkey, adc)
+ */
+#include "TrkrDefs.h"
+#include "TrkrHitSet.h"
+
+#include <cstdint>
+#include <iostream>
+#include <utility>  // for pair
+#include <vector>
+
+// forward declaration
+class TrkrHit;
+
+/**
+ * @brief Container for storing hits as a flat, sorted list of (hitkey, adc)
+ *
+ * Hit keys and adc values are stored in two parallel vectors, sorted by hit key,
+ * instead of one map node and one TrkrHit object per hit.
+ * When used in TrkrHitSetContainerv2, Clear() keeps the vectors allocation,
+ * so that the storage is re-used from one event to the next.
+ *
+ * Hits must be filled using setAdc, addAdc, addEnergy, or the bulk addHits and merge methods,
+ * and read using getHitKeys, getAdcs or getAdc. There is no TrkrHit object to hand out,
+ * so that the TrkrHit based interface (addHitSpecificKey, getHit, getHits) is not supported.
+ */
+class TrkrHitSetv2 : public TrkrHitSet
+{
+ public:
+  //! hit key list
+  using HitKeyList = std::vector<TrkrDefs::hitkey>;
+
+  //! adc list
+  using AdcList = std::vector<uint16_t>;
+
+  //! (hitkey, adc) pair, used for bulk insertion
+  using HitAdcPair = std::pair<TrkrDefs::hitkey, unsigned int>;
+
+  TrkrHitSetv2() = default;
+
+  ~TrkrHitSetv2() override = default;
+
+  void identify(std::ostream& os = std::cout) const override;
+
+  //! remove all hits and reset hitset key
+  void Reset() override;
+
+  //! For ROOT TClonesArray end of event Operation. Removes all hits but keeps hitset key and allocation
+  void Clear(Option_t* /*option*/ = "") override;
+
+  void setHitSetKey(const TrkrDefs::hitsetkey key) override
+  {
+    m_hitSetKey = key;
+  }
+
+  TrkrDefs::hitsetkey getHitSetKey() const override
+  {
+    return m_hitSetKey;
+  }
+
+  //! not supported, use setAdc
+  ConstIterator addHitSpecificKey(const TrkrDefs::hitkey, TrkrHit*) override;
+
+  void removeHit(TrkrDefs::hitkey) override;
+
+  //! not supported, use getAdc
+  TrkrHit* getHit(const TrkrDefs::hitkey) const override;
+
+  //! not supported, use getHitKeys and getAdcs
+  ConstRange getHits() const override;
+
+  unsigned int size() const override
+  {
+    return m_hitkeys.size();
+  }
+
+  //!@name flat storage interface
+  //@{
+
+  //! sorted hit keys
+  const HitKeyList& getHitKeys() const
+  {
+    return m_hitkeys;
+  }
+
+  //! adc values, in the same order as hit keys
+  const AdcList& getAdcs() const
+  {
+    return m_adcs;
+  }
+
+  //! adc for a given hit key, zero if not found
+  unsigned int getAdc(const TrkrDefs::hitkey) const;
+
+  //! set adc for a given hit key, add the hit if not found
+  void setAdc(const TrkrDefs::hitkey, const unsigned int);
+
+  //! add adc to a given hit key, add the hit if not found. Saturates at USHRT_MAX
+  void addAdc(const TrkrDefs::hitkey, const unsigned int);
+
+  //! add energy to a given hit key, with the same conversion as TrkrHitv2::addEnergy
+  void addEnergy(const TrkrDefs::hitkey, const double);
+
+  //! bulk insertion. Input needs not be sorted. Adc values with identical keys are summed
+  void addHits(std::vector<HitAdcPair>&);
+
+  //! merge all hits from other hitset into this one. Adc values with identical keys are summed
+  void merge(const TrkrHitSetv2&);
+
+  //! reserve space for a given number of hits
+  void reserve(size_t size)
+  {
+    m_hitkeys.reserve(size);
+    m_adcs.reserve(size);
+  }
+
+  //@}
+
+ private:
+  //! merge sorted, duplicate free range of "size" hits into storage
+  template <class KeyIterator, class AdcIterator>
+  void merge_sorted(KeyIterator key_begin, KeyIterator key_end, AdcIterator adc_begin, size_t size);
+
+  //! unique key for this object
+  TrkrDefs::hitsetkey m_hitSetKey = TrkrDefs::HITSETKEYMAX;
+
+  //! sorted hit keys
+  HitKeyList m_hitkeys;
+
+  //! adc values, in the same order as hit keys
+  AdcList m_adcs;
+
+  //! scratch space for merging
+  HitKeyList m_merge_hitkeys;  //!
+  AdcList m_merge_adcs;        //!
+
+  ClassDefOverride(TrkrHitSetv2, 1);
+};
+
+#endif  // TRACKBASE_TRKRHITSETV2_H
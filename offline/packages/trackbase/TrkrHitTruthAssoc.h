@@ -73,6 +73,17 @@ class TrkrHitTruthAssoc : public PHObject
   {
   }
 
+  /**
+   * @brief Get all associations for a given hitset
+   * @param[in] hset TrkrHitSet key
+   * @param[out] Range over (hitsetkey, (hitkey, g4hitkey)) pairs for @c hset
+   */
+  virtual ConstRange getHitSetAssocs(const TrkrDefs::hitsetkey /*hitsetkey*/) const
+  {
+    static const MMap dummy;
+    return std::make_pair(dummy.cbegin(), dummy.cend());
+  }
+
  protected:
   //! ctor
   TrkrHitTruthAssoc() = default;
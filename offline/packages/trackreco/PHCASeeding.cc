@@ -12,6 +12,7 @@
 // sPHENIX includes
 #include <fun4all/Fun4AllReturnCodes.h>
 
+#include <phool/PHThreadPool.h>
 #include <phool/PHTimer.h>  // for PHTimer
 #include <phool/getClass.h>
 #include <phool/phool.h>  // for PHWHERE
@@ -38,13 +39,6 @@
 #include <TFile.h>
 #include <TNtuple.h>
 
-// BOOST for combi seeding
-#include <boost/geometry.hpp>
-#include <boost/geometry/geometries/box.hpp>
-#include <boost/geometry/geometries/point.hpp>
-#include <boost/geometry/index/rtree.hpp>
-#include <boost/geometry/policies/compare.hpp>
-
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
@@ -54,7 +48,6 @@
 #include <iostream>
 #include <memory>
 #include <numeric>
-#include <unordered_set>
 #include <utility>  // for pair, make_pair
 #include <vector>
 
@@ -77,43 +70,6 @@
 #define PHCASEEDING_PRINT_TIME(timer, statement) (void) 0
 #endif
 
-// apparently there is no builtin STL hash function for a std::array
-// so to use std::unordered_set (essentially a hash table), we have to make our own hasher
-
-namespace std
-{
-  template <typename T, size_t N>
-  struct hash<std::array<T, N>>
-  {
-    using argument_type = std::array<T, N>;
-    using result_type = size_t;
-
-    result_type operator()(const argument_type& a) const
-    {
-      hash<T> hasher;
-      result_type h = 0;
-      for (result_type i = 0; i < N; ++i)
-      {
-        h = h * 31 + hasher(a[i]);
-      }
-      return h;
-    }
-  };
-  template <typename A, typename B>
-  struct hash<pair<A, B>>
-  {
-    using argument_type = pair<A, B>;
-    using result_type = size_t;
-
-    result_type operator()(const argument_type& a) const
-    {
-      hash<A> hashA;
-      hash<B> hashB;
-      return (hashA(a.first) * 31 + hashB(a.second));
-    }
-  };
-}  // namespace std
-
 // anonymous namespace for local functions
 namespace
 {
@@ -169,7 +125,6 @@ namespace
 }  // namespace
 
 // using namespace ROOT::Minuit2;
-namespace bgi = boost::geometry::index;
 
 PHCASeeding::PHCASeeding(
     const std::string& name,
@@ -197,6 +152,9 @@ PHCASeeding::PHCASeeding(
 {
 }
 
+// needed here for unique_ptr to incomplete PHThreadPool in header
+PHCASeeding::~PHCASeeding() = default;
+
 int PHCASeeding::InitializeGeometry(PHCompositeNode* topNode)
 {
   // geometry
@@ -218,7 +176,88 @@ Acts::Vector3 PHCASeeding::getGlobalPosition(TrkrDefs::cluskey key, TrkrCluster*
   return _pp_mode ? m_tGeometry->getGlobalPosition(key, cluster) : m_globalPositionWrapper.getGlobalPositionDistortionCorrected(key, cluster, 0);
 }
 
-void PHCASeeding::QueryTree(const bgi::rtree<PHCASeeding::pointKey, bgi::quadratic<16>>& rtree, double phimin, double z_min, double phimax, double z_max, std::vector<pointKey>& returned_values) const
+int PHCASeeding::LayerGrid::fill(const PHCASeeding::keyList& ckeys, const PHCASeeding::PositionMap& globalPositions)
+{
+  m_coords.clear();
+  m_coords.reserve(ckeys.size());
+  std::vector<std::array<double, 2>> positions;
+  positions.reserve(ckeys.size());
+  for (const auto& ckey : ckeys)
+  {
+    const auto& globalpos_d = globalPositions.at(ckey);
+    const double clus_phi = get_phi(globalpos_d);
+    const double clus_z = globalpos_d.z();
+    positions.push_back({clus_phi, clus_z});
+    m_coords.push_back({{static_cast<float>(clus_phi), static_cast<float>(clus_z)}, ckey});
+  }
+  bin_coords();
+
+  // remove duplicates: a cluster is skipped if an earlier, not skipped, cluster is within 1e-5 in phi and z
+  int n_dupli = 0;
+  std::vector<bool> kept(m_coords.size(), false);
+  std::vector<unsigned int> neighbors;
+  for (unsigned int i = 0; i < m_coords.size(); ++i)
+  {
+    neighbors.clear();
+    const auto& [clus_phi, clus_z] = positions[i];
+    query(clus_phi - 0.00001, clus_z - 0.00001, clus_phi + 0.00001, clus_z + 0.00001, neighbors);
+    if (std::any_of(neighbors.begin(), neighbors.end(), [&kept](unsigned int index)
+                    { return kept[index]; }))
+    {
+      ++n_dupli;
+      continue;
+    }
+    kept[i] = true;
+  }
+
+  if (n_dupli > 0)
+  {
+    unsigned int nkept = 0;
+    for (unsigned int i = 0; i < m_coords.size(); ++i)
+    {
+      if (kept[i])
+      {
+        m_coords[nkept++] = m_coords[i];
+      }
+    }
+    m_coords.resize(nkept);
+    bin_coords();
+  }
+  return n_dupli;
+}
+
+void PHCASeeding::LayerGrid::bin_coords()
+{
+  // about 16 clusters per phi bin
+  m_nbins = std::clamp<int>(m_coords.size() / 16, 1, 4096);
+  m_bins_per_radian = m_nbins / (2 * M_PI);
+
+  m_entries.resize(m_coords.size());
+  for (unsigned int i = 0; i < m_coords.size(); ++i)
+  {
+    m_entries[i] = {m_coords[i].first[0], m_coords[i].first[1], i};
+  }
+  std::sort(m_entries.begin(), m_entries.end(), [this](const Entry& lhs, const Entry& rhs)
+            {
+    const int lhs_bin = get_bin(lhs.phi);
+    const int rhs_bin = get_bin(rhs.phi);
+    return (lhs_bin == rhs_bin) ? (lhs.z < rhs.z) : (lhs_bin < rhs_bin); });
+
+  m_bin_offsets.assign(m_nbins + 1, 0);
+  for (const auto& entry : m_entries)
+  {
+    ++m_bin_offsets[get_bin(entry.phi) + 1];
+  }
+  std::partial_sum(m_bin_offsets.begin(), m_bin_offsets.end(), m_bin_offsets.begin());
+}
+
+int PHCASeeding::LayerGrid::get_bin(float phi) const
+{
+  // monotonic in phi, so that a phi window maps to a contiguous range of bins
+  return std::clamp<int>(std::floor(phi * m_bins_per_radian), 0, m_nbins - 1);
+}
+
+void PHCASeeding::LayerGrid::query(double phimin, double z_min, double phimax, double z_max, std::vector<unsigned int>& indices) const
 {
   bool query_both_ends = false;
   if (phimin < 0)
@@ -233,12 +272,36 @@ void PHCASeeding::QueryTree(const bgi::rtree<PHCASeeding::pointKey, bgi::quadrat
   }
   if (query_both_ends)
   {
-    rtree.query(bgi::intersects(box(point(phimin, z_min), point(2 * M_PI, z_max))), std::back_inserter(returned_values));
-    rtree.query(bgi::intersects(box(point(0., z_min), point(phimax, z_max))), std::back_inserter(returned_values));
+    query_box(phimin, z_min, 2 * M_PI, z_max, indices);
+    query_box(0., z_min, phimax, z_max, indices);
   }
   else
   {
-    rtree.query(bgi::intersects(box(point(phimin, z_min), point(phimax, z_max))), std::back_inserter(returned_values));
+    query_box(phimin, z_min, phimax, z_max, indices);
+  }
+}
+
+void PHCASeeding::LayerGrid::query_box(float phimin, float z_min, float phimax, float z_max, std::vector<unsigned int>& indices) const
+{
+  // closed box in float coordinates, like an rtree of float points
+  if (m_entries.empty() || phimin > phimax || z_min > z_max)
+  {
+    return;
+  }
+  const int last_bin = get_bin(phimax);
+  for (int bin = get_bin(phimin); bin <= last_bin; ++bin)
+  {
+    const auto first = m_entries.begin() + m_bin_offsets[bin];
+    const auto last = m_entries.begin() + m_bin_offsets[bin + 1];
+    auto iter = std::lower_bound(first, last, z_min, [](const Entry& entry, float z)
+                                 { return entry.z < z; });
+    for (; iter != last && iter->z <= z_max; ++iter)
+    {
+      if (iter->phi >= phimin && iter->phi <= phimax)
+      {
+        indices.push_back(iter->index);
+      }
+    }
   }
 }
 
@@ -288,51 +351,6 @@ std::pair<PHCASeeding::PositionMap, PHCASeeding::keyListPerLayer> PHCASeeding::F
   return std::make_pair(cachedPositions, ckeys);
 }
 
-std::vector<PHCASeeding::coordKey> PHCASeeding::FillTree(bgi::rtree<PHCASeeding::pointKey, bgi::quadratic<16>>& _rtree, const PHCASeeding::keyList& ckeys, const PHCASeeding::PositionMap& globalPositions, const int layer)
-{
-  // Fill _rtree with the clusters in ckeys; remove duplicates, and return a vector of the coordKeys
-  // Note that layer is only used for a cout statement
-  int n_dupli = 0;
-  std::vector<coordKey> coords;
-  _rtree.clear();
-  /* _rtree.reserve(ckeys.size()); */
-  for (const auto& ckey : ckeys)
-  {
-    const auto& globalpos_d = globalPositions.at(ckey);
-    const double clus_phi = get_phi(globalpos_d);
-    const double clus_z = globalpos_d.z();
-    if (Verbosity() > 5)
-    {
-      /* int layer = TrkrDefs::getLayer(ckey); */
-      std::cout << "Found cluster " << ckey << " in layer " << layer << std::endl;
-    }
-    std::vector<pointKey> testduplicate;
-    QueryTree(_rtree, clus_phi - 0.00001, clus_z - 0.00001, clus_phi + 0.00001, clus_z + 0.00001, testduplicate);
-    if (!testduplicate.empty())
-    {
-      ++n_dupli;
-      continue;
-    }
-    coords.push_back({{static_cast<float>(clus_phi), static_cast<float>(clus_z)}, ckey});
-    t_fill->restart();
-    _rtree.insert(std::make_pair(point(clus_phi, globalpos_d.z()), ckey));
-    t_fill->stop();
-  }
-  if (Verbosity() > 5)
-  {
-    std::cout << "nhits in layer(" << layer << "): " << coords.size() << std::endl;
-  }
-  if (Verbosity() > 3)
-  {
-    std::cout << "fill time: " << t_fill->get_accumulated_time() / 1000. << " sec" << std::endl;
-  }
-  if (Verbosity() > 3)
-  {
-    std::cout << "number of duplicates : " << n_dupli << std::endl;
-  }
-  return coords;
-}
-
 int PHCASeeding::Process(PHCompositeNode* /*topNode*/)
 {
   process_tupout_count();
@@ -408,136 +426,149 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
   keyLinks startLinks;        // bilinks at start of chains
   keyLinkPerLayer bodyLinks;  //  bilinks to build chains
                               //
-  double cluster_find_time = 0;
-  double rtree_query_time = 0;
-  double transform_time = 0;
-  double compute_best_angle_time = 0;
-  double set_insert_time = 0;
-
-  // there are three coord_array (only the current layer is used at a time,
-  // but it is filled the same time as the _rtrees, which are used two at
-  // a time -- the prior padplane row and the next padplain row
-  std::array<std::vector<coordKey>, 3> coord_arr;
-  std::array<std::unordered_set<keyLink>, 2> previous_downlinks_arr;
-  std::array<std::unordered_set<TrkrDefs::cluskey>, 2> bottom_of_bilink_arr;
+  double grid_fill_time = 0;
+  double link_search_time = 0;
+  double bilink_time = 0;
 
   // iterate from outer to inner layers
   const int inner_index = _start_layer - _FIRST_LAYER_TPC + 1;
   const int outer_index = _end_layer - _FIRST_LAYER_TPC - 2;
-
-  // fill the current and prior row coord and ttrees for the first iteration
-  int _index_above = (outer_index + 1) % 3;
-  int _index_current = (outer_index) % 3;
-  coord_arr[_index_above] = FillTree(_rtrees[_index_above], ckeys[outer_index + 1], globalPositions, outer_index + 1);
-  coord_arr[_index_current] = FillTree(_rtrees[_index_current], ckeys[outer_index], globalPositions, outer_index);
-
-  for (int layer_index = outer_index; layer_index >= inner_index; --layer_index)
+  if (outer_index < inner_index)
   {
-    // these lines of code will rotates through all three _rtree's in the array,
-    // where the old lower becomes the new middle, the old middle the new upper,
-    // and the old upper drops out and that _rtree is filled with the new lower
-    const unsigned int LAYER = layer_index + _FIRST_LAYER_TPC;
-    int index_above = (layer_index + 1) % 3;
-    int index_current = (layer_index) % 3;
-    int index_below = (layer_index - 1) % 3;
+    return std::make_pair(startLinks, bodyLinks);
+  }
 
-    coord_arr[index_below] = FillTree(_rtrees[index_below], ckeys[layer_index - 1], globalPositions, layer_index - 1);
+#if defined(_PHCASEEDING_CLUSTERLOG_TUPOUT_)
+  // tuples are filled during the link search, which must then run serially
+  const bool run_parallel = false;
+#else
+  const bool run_parallel = (m_threadPool != nullptr);
+#endif
+  auto run = [this, run_parallel](const int n, const PHThreadPool::Task& task)
+  {
+    if (run_parallel)
+    {
+      m_threadPool->parallel_for(n, task);
+    }
+    else
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        task(i, 0);
+      }
+    }
+  };
 
-    // NO DUPLICATES FOUND IN COORD_ARR
+  // fill the grids of all layers used, from the layer below the innermost to the one above the outermost
+  t_seed->restart();
+  const int first_grid = inner_index - 1;
+  const int ngrids = outer_index - inner_index + 3;
+  std::vector<int> n_dupli(ngrids, 0);
+  run(ngrids, [&](const std::size_t i, const unsigned int /*worker*/)
+      { n_dupli[i] = m_grids[first_grid + i].fill(ckeys[first_grid + i], globalPositions); });
+  t_seed->stop();
+  grid_fill_time = t_seed->elapsed();
 
-    auto& _rtree_above = _rtrees[index_above];
-    const std::vector<coordKey>& coord = coord_arr[index_current];
-    auto& _rtree_below = _rtrees[index_below];
+  for (int i = 0; i < ngrids && Verbosity() > 3; ++i)
+  {
+    const int layer_index = first_grid + i;
+    if (Verbosity() > 5)
+    {
+      for (const auto& coord : m_grids[layer_index].coords())
+      {
+        std::cout << "Found cluster " << coord.second << " in layer " << layer_index << std::endl;
+      }
+      std::cout << "nhits in layer(" << layer_index << "): " << m_grids[layer_index].coords().size() << std::endl;
+    }
+    std::cout << "number of duplicates : " << n_dupli[i] << std::endl;
+  }
 
-    auto& curr_downlinks = previous_downlinks_arr[layer_index % 2];
-    auto& last_downlinks = previous_downlinks_arr[(layer_index + 1) % 2];
+  // For all the clusters in a layer, find nearest neighbors in the
+  // above and below layers and make links.
+  // Layers are independent: the downlinks are sorted for the bilink search,
+  // uplinks are kept in order of start cluster, then key of the cluster above
+  std::array<keyLinks, _NLAYERS_TPC> downlinks;
+  std::array<keyLinks, _NLAYERS_TPC> uplinks;
+  t_seed->restart();
+  run(outer_index - inner_index + 1, [&](const std::size_t i, const unsigned int /*worker*/)
+      {
+    const int layer_index = inner_index + i;
+    const unsigned int LAYER = layer_index + _FIRST_LAYER_TPC;
 
-    auto& curr_bottom_of_bilink = bottom_of_bilink_arr[layer_index % 2];
-    auto& last_bottom_of_bilink = bottom_of_bilink_arr[(layer_index + 1) % 2];
+    const auto& grid_above = m_grids[layer_index + 1];
+    const auto& grid_below = m_grids[layer_index - 1];
+    const std::vector<coordKey>& coord_above = grid_above.coords();
+    const std::vector<coordKey>& coord_below = grid_below.coords();
 
-    curr_downlinks.clear();
-    curr_bottom_of_bilink.clear();
+    auto& layer_downlinks = downlinks[layer_index];
+    auto& layer_uplinks = uplinks[layer_index];
 
-    // For all the clusters in coord, find nearest neighbors in the
-    // above and below layers and make links
-    // Any link to an above node which matches the same clusters
-    // on the previous iteration (to a "below node") becomes a "bilink"
-    // Check if this bilink links to a prior bilink or not
+    std::vector<unsigned int> ClustersAbove;
+    std::vector<unsigned int> ClustersBelow;
+    std::vector<std::array<double, 3>> delta_below;
+    std::vector<std::array<double, 3>> delta_above;
+    keyList bestAboveClusters;
 
-    std::vector<keyLink> aboveLinks;
-    for (const auto& StartCluster : coord)
+    for (const auto& StartCluster : m_grids[layer_index].coords())
     {
       double StartPhi = StartCluster.first[0];
       const auto& globalpos = globalPositions.at(StartCluster.second);
       double StartX = globalpos(0);
       double StartY = globalpos(1);
       double StartZ = globalpos(2);
-      t_seed->stop();
-      cluster_find_time += t_seed->elapsed();
-      t_seed->restart();
       LogDebug(" starting cluster:" << std::endl);
       LogDebug(" z: " << StartZ << std::endl);
       LogDebug(" phi: " << StartPhi << std::endl);
 
-      std::vector<pointKey> ClustersAbove;
-      std::vector<pointKey> ClustersBelow;
+      ClustersAbove.clear();
+      ClustersBelow.clear();
 
-      QueryTree(_rtree_below,
-                StartPhi - dphi_per_layer[LAYER],
-                StartZ - dZ_per_layer[LAYER],
-                StartPhi + dphi_per_layer[LAYER],
-                StartZ + dZ_per_layer[LAYER],
-                ClustersBelow);
+      grid_below.query(StartPhi - dphi_per_layer[LAYER],
+                       StartZ - dZ_per_layer[LAYER],
+                       StartPhi + dphi_per_layer[LAYER],
+                       StartZ + dZ_per_layer[LAYER],
+                       ClustersBelow);
 
-      FillTupWinLink(_rtree_below, StartCluster, globalPositions);
+      FillTupWinLink(grid_below, StartCluster, globalPositions);
 
-      QueryTree(_rtree_above,
-                StartPhi - dphi_per_layer[LAYER + 1],
-                StartZ - dZ_per_layer[LAYER + 1],
-                StartPhi + dphi_per_layer[LAYER + 1],
-                StartZ + dZ_per_layer[LAYER + 1],
-                ClustersAbove);
+      grid_above.query(StartPhi - dphi_per_layer[LAYER + 1],
+                       StartZ - dZ_per_layer[LAYER + 1],
+                       StartPhi + dphi_per_layer[LAYER + 1],
+                       StartZ + dZ_per_layer[LAYER + 1],
+                       ClustersAbove);
 
-      t_seed->stop();
-      rtree_query_time += t_seed->elapsed();
-      t_seed->restart();
       LogDebug(" entries in below layer: " << ClustersBelow.size() << std::endl);
       LogDebug(" entries in above layer: " << ClustersAbove.size() << std::endl);
-      std::vector<std::array<double, 3>> delta_below;
-      std::vector<std::array<double, 3>> delta_above;
-      delta_below.clear();
-      delta_above.clear();
+
+      // calculate (delta_z_, delta_phi) vector for each neighboring cluster
       delta_below.resize(ClustersBelow.size());
       delta_above.resize(ClustersAbove.size());
-      // calculate (delta_z_, delta_phi) vector for each neighboring cluster
-
       std::transform(ClustersBelow.begin(), ClustersBelow.end(), delta_below.begin(),
-                     [&](pointKey BelowCandidate)
+                     [&](unsigned int BelowCandidate)
                      {
-          const auto& belowpos = globalPositions.at(BelowCandidate.second);
+          const auto& belowpos = globalPositions.at(coord_below[BelowCandidate].second);
           return std::array<double,3>{belowpos(0)-StartX,
           belowpos(1)-StartY,
           belowpos(2)-StartZ}; });
 
       std::transform(ClustersAbove.begin(), ClustersAbove.end(), delta_above.begin(),
-                     [&](pointKey AboveCandidate)
+                     [&](unsigned int AboveCandidate)
                      {
-          const auto& abovepos = globalPositions.at(AboveCandidate.second);
+          const auto& abovepos = globalPositions.at(coord_above[AboveCandidate].second);
           return std::array<double,3>{abovepos(0)-StartX,
           abovepos(1)-StartY,
           abovepos(2)-StartZ}; });
-      t_seed->stop();
-      transform_time += t_seed->elapsed();
-      t_seed->restart();
 
       // find the three clusters closest to a straight line
       // (by maximizing the cos of the angle between the (delta_z_,delta_phi) vectors)
-      // double minSumLengths = 1e9;
-      std::unordered_set<TrkrDefs::cluskey> bestAboveClusters;
+      bestAboveClusters.clear();
       for (size_t iAbove = 0; iAbove < delta_above.size(); ++iAbove)
       {
+        const auto above_key = coord_above[ClustersAbove[iAbove]].second;
         for (size_t iBelow = 0; iBelow < delta_below.size(); ++iBelow)
         {
+          const auto below_key = coord_below[ClustersBelow[iBelow]].second;
+
           // test for straightness of line just by taking the cos(angle) between the two vectors
           // use the sq as it is much faster than sqrt
           const auto& A = delta_below[iBelow];
@@ -547,21 +578,19 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
           const double B_len_sq = (B[0] * B[0] + B[1] * B[1] + B[2] * B[2]);
           const double dot_prod = (A[0] * B[0] + A[1] * B[1] + A[2] * B[2]);
           const double cos_angle_sq = dot_prod * dot_prod / A_len_sq / B_len_sq;  // also same as cos(angle), where angle is between two vectors
-          FillTupWinCosAngle(ClustersAbove[iAbove].second, StartCluster.second, ClustersBelow[iBelow].second, globalPositions, cos_angle_sq, (dot_prod < 0.));
+          FillTupWinCosAngle(above_key, StartCluster.second, below_key, globalPositions, cos_angle_sq, (dot_prod < 0.));
 
           constexpr double maxCosPlaneAngle = -0.95;
           constexpr double maxCosPlaneAngle_sq = maxCosPlaneAngle * maxCosPlaneAngle;
           if ((dot_prod < 0.) && (cos_angle_sq > maxCosPlaneAngle_sq))
           {
-            // maxCosPlaneAngle = cos(angle);
-            // minSumLengths = belowLength+aboveLength;
-            curr_downlinks.insert({StartCluster.second, ClustersBelow[iBelow].second});
-            bestAboveClusters.insert(ClustersAbove[iAbove].second);
+            layer_downlinks.emplace_back(StartCluster.second, below_key);
+            bestAboveClusters.push_back(above_key);
 
             // fill the tuples for plotting
             fill_tuple(_tupclus_links, 0, StartCluster.second, globalPositions.at(StartCluster.second));
-            fill_tuple(_tupclus_links, -1, ClustersBelow[iBelow].second, globalPositions.at(ClustersBelow[iBelow].second));
-            fill_tuple(_tupclus_links, 1, ClustersAbove[iAbove].second, globalPositions.at(ClustersAbove[iAbove].second));
+            fill_tuple(_tupclus_links, -1, below_key, globalPositions.at(below_key));
+            fill_tuple(_tupclus_links, 1, above_key, globalPositions.at(above_key));
           }
         }
       }
@@ -569,50 +598,63 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
       // There was some old commented-out code here for allowing layers to be skipped. This
       // may be useful in the future. This chunk of code has been moved towards the
       // end fo the file under the title: "---OLD CODE 0: SKIP_LAYERS---"
-      t_seed->stop();
-      compute_best_angle_time += t_seed->elapsed();
-      t_seed->restart();
 
-      for (auto cluster : bestAboveClusters)
+      std::sort(bestAboveClusters.begin(), bestAboveClusters.end());
+      bestAboveClusters.erase(std::unique(bestAboveClusters.begin(), bestAboveClusters.end()), bestAboveClusters.end());
+      for (const auto& cluster : bestAboveClusters)
       {
-        keyLink uplink = std::make_pair(cluster, StartCluster.second);
+        layer_uplinks.emplace_back(cluster, StartCluster.second);
+      }
+    }  // end loop over start clusters
 
-        if (last_downlinks.find(uplink) != last_downlinks.end())
+    std::sort(layer_downlinks.begin(), layer_downlinks.end());
+    layer_downlinks.erase(std::unique(layer_downlinks.begin(), layer_downlinks.end()), layer_downlinks.end()); });
+  t_seed->stop();
+  link_search_time = t_seed->elapsed();
+
+  // Any link to an above node which matches a downlink of the above layer becomes a "bilink"
+  // Check if this bilink links to a prior bilink or not
+  t_seed->restart();
+  keyList last_bottom_of_bilink;
+  keyList curr_bottom_of_bilink;
+  for (int layer_index = outer_index; layer_index >= inner_index; --layer_index)
+  {
+    const auto& last_downlinks = downlinks[layer_index + 1];
+    curr_bottom_of_bilink.clear();
+    for (const auto& uplink : uplinks[layer_index])
+    {
+      if (std::binary_search(last_downlinks.begin(), last_downlinks.end(), uplink))
+      {
+        // this is a bilink
+        const auto& key_top = uplink.first;
+        const auto& key_bot = uplink.second;
+        curr_bottom_of_bilink.push_back(key_bot);
+        fill_tuple(_tupclus_bilinks, 0, key_top, globalPositions.at(key_top));
+        fill_tuple(_tupclus_bilinks, 1, key_bot, globalPositions.at(key_bot));
+
+        if (!std::binary_search(last_bottom_of_bilink.begin(), last_bottom_of_bilink.end(), key_top))
         {
-          // this is a bilink
-          const auto& key_top = uplink.first;
-          const auto& key_bot = uplink.second;
-          curr_bottom_of_bilink.insert(key_bot);
-          fill_tuple(_tupclus_bilinks, 0, key_top, globalPositions.at(key_top));
-          fill_tuple(_tupclus_bilinks, 1, key_bot, globalPositions.at(key_bot));
-
-          if (last_bottom_of_bilink.find(key_top) == last_bottom_of_bilink.end())
-          {
-            startLinks.push_back(std::make_pair(key_top, key_bot));
-          }
-          else
-          {
-            bodyLinks[layer_index + 1].push_back(std::make_pair(key_top, key_bot));
-          }
+          startLinks.push_back(std::make_pair(key_top, key_bot));
         }
-      }  // end loop over all up-links
-    }    // end loop over start clusters
-
-    t_seed->stop();
-    set_insert_time += t_seed->elapsed();
-    t_seed->restart();
-    LogDebug(" max collinearity: " << maxCosPlaneAngle << std::endl);
+        else
+        {
+          bodyLinks[layer_index + 1].push_back(std::make_pair(key_top, key_bot));
+        }
+      }
+    }  // end loop over all up-links
+    std::sort(curr_bottom_of_bilink.begin(), curr_bottom_of_bilink.end());
+    curr_bottom_of_bilink.erase(std::unique(curr_bottom_of_bilink.begin(), curr_bottom_of_bilink.end()), curr_bottom_of_bilink.end());
+    std::swap(last_bottom_of_bilink, curr_bottom_of_bilink);
   }  // end loop over layers (to make links)
-
   t_seed->stop();
+  bilink_time = t_seed->elapsed();
+
   if (Verbosity() > 0)
   {
-    std::cout << "triplet forming time: " << t_seed->get_accumulated_time() / 1000 << " s" << std::endl;
-    std::cout << "starting cluster setup: " << cluster_find_time / 1000 << " s" << std::endl;
-    std::cout << "RTree query: " << rtree_query_time / 1000 << " s" << std::endl;
-    std::cout << "Transform: " << transform_time / 1000 << " s" << std::endl;
-    std::cout << "Compute best triplet: " << compute_best_angle_time / 1000 << " s" << std::endl;
-    std::cout << "Set insert: " << set_insert_time / 1000 << " s" << std::endl;
+    std::cout << "triplet forming time: " << (grid_fill_time + link_search_time + bilink_time) / 1000 << " s" << std::endl;
+    std::cout << "Grid fill: " << grid_fill_time / 1000 << " s" << std::endl;
+    std::cout << "Link search: " << link_search_time / 1000 << " s" << std::endl;
+    std::cout << "Bilink matching: " << bilink_time / 1000 << " s" << std::endl;
   }
   t_seed->restart();
 
@@ -970,9 +1012,6 @@ int PHCASeeding::Setup(PHCompositeNode* topNode)  // This is called by ::InitRun
   }
 
   // timing
-  t_fill = std::make_unique<PHTimer>("t_fill");
-  t_fill->stop();
-
   t_seed = std::make_unique<PHTimer>("t_seed");
   t_seed->stop();
 
@@ -982,6 +1021,16 @@ int PHCASeeding::Setup(PHCompositeNode* topNode)  // This is called by ::InitRun
   t_makeseeds = std::make_unique<PHTimer>("t_makeseeds");
   t_makeseeds->stop();
 
+  // layer grids are filled and searched for links concurrently
+  if (!m_threadPool)
+  {
+    m_threadPool = std::make_unique<PHThreadPool>(m_num_threads);
+  }
+  if (Verbosity() > 0)
+  {
+    std::cout << "PHCASeeding::Setup - worker threads: " << m_threadPool->size() << std::endl;
+  }
+
   auto geom_container =
       findNode::getClass<PHG4TpcGeomContainer>(topNode, "TPCGEOMCONTAINER");
   if (!geom_container)
@@ -1170,26 +1219,26 @@ void PHCASeeding::process_tupout_count()
   _search_windows->Fill(_neighbor_z_width, _neighbor_phi_width, _start_layer, _end_layer, _clusadd_delta_dzdr_window, _clusadd_delta_dphidr2_window);
 }
 
-void PHCASeeding::FillTupWinLink(bgi::rtree<PHCASeeding::pointKey, bgi::quadratic<16>>& _rtree_below, const PHCASeeding::coordKey& StartCluster, const PHCASeeding::PositionMap& globalPositions) const
+void PHCASeeding::FillTupWinLink(const PHCASeeding::LayerGrid& grid_below, const PHCASeeding::coordKey& StartCluster, const PHCASeeding::PositionMap& globalPositions) const
 {
   double StartPhi = StartCluster.first[0];
   const auto& P0 = globalPositions.at(StartCluster.second);
   double StartZ = P0(2);
   // Fill TNTuple _tupwin_link
-  std::vector<pointKey> ClustersBelow;
-  QueryTree(_rtree_below,
-            StartPhi - 1.,
-            StartZ - 20.,
-            StartPhi + 1.,
-            StartZ + 20.,
-            ClustersBelow);
-
-  for (const auto& pkey : ClustersBelow)
+  std::vector<unsigned int> ClustersBelow;
+  grid_below.query(StartPhi - 1.,
+                   StartZ - 20.,
+                   StartPhi + 1.,
+                   StartZ + 20.,
+                   ClustersBelow);
+
+  for (const auto& index : ClustersBelow)
   {
-    const auto P1 = globalPositions.at(pkey.second);
-    double dphi = bg::get<0>(pkey.first) - StartPhi;
+    const auto& coord = grid_below.coords()[index];
+    const auto P1 = globalPositions.at(coord.second);
+    double dphi = coord.first[0] - StartPhi;
     double dZ = P1(2) - StartZ;
-    _tupwin_link->Fill(_tupout_count, TrkrDefs::getLayer(StartCluster.second), P0(0), P0(1), P0(2), TrkrDefs::getLayer(pkey.second), P1(0), P1(1), P1(2), dphi, dZ);
+    _tupwin_link->Fill(_tupout_count, TrkrDefs::getLayer(StartCluster.second), P0(0), P0(1), P0(2), TrkrDefs::getLayer(coord.second), P1(0), P1(1), P1(2), dphi, dZ);
   }
 }
 
@@ -1258,7 +1307,7 @@ void PHCASeeding::write_tuples(){};
 void PHCASeeding::fill_tuple(TNtuple* /**/, float /**/, TrkrDefs::cluskey /**/, const Acts::Vector3& /**/) const {};
 void PHCASeeding::fill_tuple_with_seed(TNtuple* /**/, const PHCASeeding::keyList& /**/, const PHCASeeding::PositionMap& /**/) const {};
 void PHCASeeding::process_tupout_count(){};
-void PHCASeeding::FillTupWinLink(bgi::rtree<PHCASeeding::pointKey, bgi::quadratic<16>>& /**/, const PHCASeeding::coordKey& /**/, const PHCASeeding::PositionMap& /**/) const {};
+void PHCASeeding::FillTupWinLink(const PHCASeeding::LayerGrid& /**/, const PHCASeeding::coordKey& /**/, const PHCASeeding::PositionMap& /**/) const {};
 void PHCASeeding::FillTupWinCosAngle(const TrkrDefs::cluskey /**/, const TrkrDefs::cluskey /**/, const TrkrDefs::cluskey /**/, const PHCASeeding::PositionMap& /**/, double /**/, bool /**/) const {};
 void PHCASeeding::FillTupWinGrowSeed(const PHCASeeding::keyList& /**/, const PHCASeeding::keyLink& /**/, const PHCASeeding::PositionMap& /**/) const {};
 #endif  // defined _PHCASEEDING_CLUSTERLOG_TUPOUT_
@@ -25,14 +25,7 @@
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-#include <boost/geometry/geometries/box.hpp>  // for box
-#pragma GCC diagnostic pop
-
-#include <boost/geometry/geometries/point.hpp>  // for point
-#include <boost/geometry/index/rtree.hpp>       // for ca
-
+#include <array>
 #include <cmath>    // for M_PI
 #include <cstdint>  // for uint64_t
 #include <map>      // for map
@@ -49,14 +42,12 @@
 
 class ActsGeometry;
 class PHCompositeNode;
+class PHThreadPool;
 class PHTimer;
 class SvtxTrack_v3;
 class TpcDistortionCorrectionContainer;
 class TrkrCluster;
 
-namespace bg = boost::geometry;
-namespace bgi = boost::geometry::index;
-
 class PHCASeeding : public PHTrackSeeding
 {
  public:
@@ -64,9 +55,6 @@ class PHCASeeding : public PHTrackSeeding
   static const int _FIRST_LAYER_TPC = 7;
   // move `using` statements inside of the class to avoid polluting the global namespace
 
-  using point = bg::model::point<float, 2, bg::cs::cartesian>;
-  using box = bg::model::box<point>;
-  using pointKey = std::pair<point, TrkrDefs::cluskey>;                 // phi and z in the key
   using coordKey = std::pair<std::array<float, 2>, TrkrDefs::cluskey>;  // just use phi and Z, no longer needs the layer
 
   using keyList = std::vector<TrkrDefs::cluskey>;
@@ -98,7 +86,7 @@ class PHCASeeding : public PHTrackSeeding
       /* float cosTheta_limit = -0.8 */
   );
 
-  ~PHCASeeding() override = default;
+  ~PHCASeeding() override;
 
   void SetSplitSeeds(bool opt = true) { _split_seeds = opt; }
   void SetLayerRange(unsigned int layer_low, unsigned int layer_up)
@@ -156,6 +144,9 @@ class PHCASeeding : public PHTrackSeeding
   void setNitrogenFraction(double frac) { N2_frac = frac; };
   void setIsobutaneFraction(double frac) { isobutane_frac = frac; };
 
+  /// number of threads used to fill the layer grids and search for links (0: serial, negative: number of hardware threads)
+  void set_num_threads(int nthreads) { m_num_threads = nthreads; }
+
  protected:
   int Setup(PHCompositeNode* topNode) override;
   int Process(PHCompositeNode* topNode) override;
@@ -164,6 +155,42 @@ class PHCASeeding : public PHTrackSeeding
   int End() override;
 
  private:
+  /// clusters of one TPC layer, binned in phi and sorted in z within each phi bin
+  /**
+   * filled in one go from the clusters of the layer, then used for window queries.
+   * Selection is the same as for a boost rtree of float (phi,z) points queried with intersecting boxes
+   */
+  class LayerGrid
+  {
+   public:
+    /// fill with the clusters of one layer, skipping clusters within 1e-5 in phi and z of an earlier one. Returns the number of skipped clusters
+    int fill(const keyList& ckeys, const PositionMap& globalPositions);
+
+    /// clusters in fill order, without duplicates
+    const std::vector<coordKey>& coords() const { return m_coords; }
+
+    /// indices (in coords()) of clusters within [phimin,phimax] and [zmin,zmax], with phi wrapped around 2pi
+    void query(double phimin, double zmin, double phimax, double zmax, std::vector<unsigned int>& indices) const;
+
+   private:
+    struct Entry
+    {
+      float phi;
+      float z;
+      unsigned int index;
+    };
+
+    void bin_coords();
+    int get_bin(float phi) const;
+    void query_box(float phimin, float zmin, float phimax, float zmax, std::vector<unsigned int>& indices) const;
+
+    std::vector<coordKey> m_coords;
+    std::vector<Entry> m_entries;             // sorted in phi bin, then z
+    std::vector<unsigned int> m_bin_offsets;  // first entry of each phi bin, plus end
+    int m_nbins = 1;
+    double m_bins_per_radian = 0;
+  };
+
   bool _save_clus_proc = false;
   TFile* _f_clustering_process = nullptr;
   int _tupout_count = -1;
@@ -190,7 +217,7 @@ class PHCASeeding : public PHTrackSeeding
   void fill_tuple(TNtuple*, float, TrkrDefs::cluskey, const Acts::Vector3&) const;
   void fill_tuple_with_seed(TNtuple*, const keyList&, const PositionMap&) const;
   void process_tupout_count();
-  void FillTupWinLink(bgi::rtree<pointKey, bgi::quadratic<16>>&, const coordKey&, const PositionMap&) const;
+  void FillTupWinLink(const LayerGrid&, const coordKey&, const PositionMap&) const;
   void FillTupWinCosAngle(const TrkrDefs::cluskey, const TrkrDefs::cluskey, const TrkrDefs::cluskey, const PositionMap&, double cos_angle, bool isneg) const;
   void FillTupWinGrowSeed(const keyList& seed, const keyLink& link, const PositionMap& globalPositions) const;
   void fill_split_chains(const keyList& chain, const keyList& keylinks, const PositionMap& globalPositions, int& nchains) const;
@@ -224,10 +251,8 @@ class PHCASeeding : public PHTrackSeeding
   std::pair<PositionMap, keyListPerLayer> FillGlobalPositions();
   std::pair<keyLinks, keyLinkPerLayer> CreateBiLinks(const PositionMap& globalPositions, const keyListPerLayer& ckeys);
   PHCASeeding::keyLists FollowBiLinks(const keyLinks& trackSeedPairs, const keyLinkPerLayer& bilinks, const PositionMap& globalPositions) const;
-  std::vector<coordKey> FillTree(bgi::rtree<pointKey, bgi::quadratic<16>>&, const keyList&, const PositionMap&, int layer);
   int FindSeedsWithMerger(const PositionMap&, const keyListPerLayer&);
 
-  void QueryTree(const bgi::rtree<pointKey, bgi::quadratic<16>>& rtree, double phimin, double zmin, double phimax, double zmax, std::vector<pointKey>& returned_values) const;
   std::vector<TrackSeed_v2> RemoveBadClusters(const std::vector<keyList>& seeds, const PositionMap& globalPositions) const;
   double getMengerCurvature(TrkrDefs::cluskey a, TrkrDefs::cluskey b, TrkrDefs::cluskey c, const PositionMap& globalPositions) const;
 
@@ -269,11 +294,12 @@ class PHCASeeding : public PHTrackSeeding
   TpcGlobalPositionWrapper m_globalPositionWrapper;
 
   std::unique_ptr<PHTimer> t_seed;
-  std::unique_ptr<PHTimer> t_fill;
   std::unique_ptr<PHTimer> t_makebilinks;
   std::unique_ptr<PHTimer> t_makeseeds;
-  /* std::array<bgi::rtree<pointKey, bgi::quadratic<16>>, _NLAYERS_TPC> _rtrees; */
-  std::array<bgi::rtree<pointKey, bgi::quadratic<16>>, 3> _rtrees;  // need three layers at a time
+  std::array<LayerGrid, _NLAYERS_TPC> m_grids;
+
+  int m_num_threads = 0;
+  std::unique_ptr<PHThreadPool> m_threadPool;
 
   double Ne_frac = 0.00;
   double Ar_frac = 0.75;
@@ -19,7 +19,6 @@
 #include <g4main/PHG4TruthInfoContainer.h>
 #include <g4main/PHG4VtxPoint.h>
 
-#include <phool/PHTimer.h>
 #include <phool/getClass.h>
 
 #include <TVector3.h>
@@ -50,15 +49,12 @@ SvtxClusterEval::~SvtxClusterEval()
 
 void SvtxClusterEval::next_event(PHCompositeNode* topNode)
 {
-  _cache_all_truth_hits.clear();
+  _truth_index.clear();
   _cache_all_truth_clusters.clear();
   _cache_max_truth_hit_by_energy.clear();
   _cache_max_truth_cluster_by_energy.clear();
-  _cache_all_truth_particles.clear();
   _cache_max_truth_particle_by_energy.clear();
   _cache_max_truth_particle_by_cluster_energy.clear();
-  _cache_all_clusters_from_particle.clear();
-  _cache_all_clusters_from_g4hit.clear();
   _cache_best_cluster_from_g4hit.clear();
   _cache_get_energy_contribution_g4particle.clear();
   _cache_get_energy_contribution_g4hit.clear();
@@ -346,12 +342,8 @@ std::set<PHG4Hit*> SvtxClusterEval::all_truth_hits(TrkrDefs::cluskey cluster_key
 
   if (_do_cache)
   {
-    std::map<TrkrDefs::cluskey, std::set<PHG4Hit*>>::iterator iter =
-        _cache_all_truth_hits.find(cluster_key);
-    if (iter != _cache_all_truth_hits.end())
-    {
-      return iter->second;
-    }
+    const auto g4hits = get_truth_index().g4hits(cluster_key);
+    return std::set<PHG4Hit*>(g4hits.begin(), g4hits.end());
   }
 
   std::set<PHG4Hit*> truth_hits;
@@ -404,11 +396,6 @@ std::set<PHG4Hit*> SvtxClusterEval::all_truth_hits(TrkrDefs::cluskey cluster_key
     }  // end loop over g4hits associated with hitsetkey and hitkey
   }  // end loop over hits associated with cluskey
 
-  if (_do_cache)
-  {
-    _cache_all_truth_hits.insert(std::make_pair(cluster_key, truth_hits));
-  }
-
   return truth_hits;
 }
 
@@ -788,12 +775,8 @@ std::set<PHG4Particle*> SvtxClusterEval::all_truth_particles(TrkrDefs::cluskey c
 
   if (_do_cache)
   {
-    std::map<TrkrDefs::cluskey, std::set<PHG4Particle*>>::iterator iter =
-        _cache_all_truth_particles.find(cluster_key);
-    if (iter != _cache_all_truth_particles.end())
-    {
-      return iter->second;
-    }
+    const auto particles = get_truth_index().particles(cluster_key);
+    return std::set<PHG4Particle*>(particles.begin(), particles.end());
   }
 
   std::set<PHG4Particle*> truth_particles;
@@ -818,11 +801,6 @@ std::set<PHG4Particle*> SvtxClusterEval::all_truth_particles(TrkrDefs::cluskey c
     truth_particles.insert(particle);
   }
 
-  if (_do_cache)
-  {
-    _cache_all_truth_particles.insert(std::make_pair(cluster_key, truth_particles));
-  }
-
   return truth_particles;
 }
 
@@ -937,68 +915,14 @@ std::set<TrkrDefs::cluskey> SvtxClusterEval::all_clusters_from(PHG4Particle* tru
     ++_errors;
     return std::set<TrkrDefs::cluskey>();
   }
-  // check if cache is filled, if not fill it.
-  //   if(_cache_all_clusters_from_particle.count(truthparticle)==0){
-  if (_cache_all_clusters_from_particle.empty())
-  {
-    FillRecoClusterFromG4HitCache();
-  }
-
-  if (_do_cache)
-  {
-    std::map<PHG4Particle*, std::set<TrkrDefs::cluskey>>::iterator iter =
-        _cache_all_clusters_from_particle.find(truthparticle);
-    if (iter != _cache_all_clusters_from_particle.end())
-    {
-      return iter->second;
-    }
-  }
-  std::set<TrkrDefs::cluskey> clusters;
-  return clusters;
+  const auto clusters = get_truth_index().clusters(truthparticle);
+  return std::set<TrkrDefs::cluskey>(clusters.begin(), clusters.end());
 }
 
 void SvtxClusterEval::FillRecoClusterFromG4HitCache()
 {
-  auto Mytimer = std::make_unique<PHTimer>("ReCl_timer");
-  Mytimer->stop();
-  Mytimer->restart();
-
-  std::multimap<PHG4Particle*, TrkrDefs::cluskey> temp_clusters_from_particles;
-  // loop over all the clusters
-  for (const auto& hitsetkey : _clustermap->getHitSetKeys())
-  {
-    auto range = _clustermap->getClusters(hitsetkey);
-    for (auto iter = range.first; iter != range.second; ++iter)
-    {
-      TrkrDefs::cluskey cluster_key = iter->first;
-
-      // loop over all truth particles connected to this cluster
-      std::set<PHG4Particle*> particles = all_truth_particles(cluster_key);
-      for (auto* candidate : particles)
-      {
-        temp_clusters_from_particles.insert(std::make_pair(candidate, cluster_key));
-      }
-    }
-  }
-  // Loop over particles and fill cache
-  PHG4TruthInfoContainer::ConstRange range = _truthinfo->GetParticleRange();
-  for (PHG4TruthInfoContainer::ConstIterator iter = range.first;
-       iter != range.second; ++iter)
-  {
-    PHG4Particle* g4particle = iter->second;
-    std::set<TrkrDefs::cluskey> clusters;
-    std::multimap<PHG4Particle*, TrkrDefs::cluskey>::const_iterator lower_bound = temp_clusters_from_particles.lower_bound(g4particle);
-    std::multimap<PHG4Particle*, TrkrDefs::cluskey>::const_iterator upper_bound = temp_clusters_from_particles.upper_bound(g4particle);
-    std::multimap<PHG4Particle*, TrkrDefs::cluskey>::const_iterator cfp_iter;
-    for (cfp_iter = lower_bound; cfp_iter != upper_bound; ++cfp_iter)
-    {
-      TrkrDefs::cluskey cluster_key = cfp_iter->second;
-      clusters.insert(cluster_key);
-    }
-    _cache_all_clusters_from_particle.insert(std::make_pair(g4particle, clusters));
-  }
-
-  Mytimer->stop();
+  // all cluster to truth associations are in the truth association index, built once per event
+  get_truth_index();
 }
 
 std::set<TrkrDefs::cluskey> SvtxClusterEval::all_clusters_from(PHG4Hit* truthhit)
@@ -1019,115 +943,35 @@ std::set<TrkrDefs::cluskey> SvtxClusterEval::all_clusters_from(PHG4Hit* truthhit
     return std::set<TrkrDefs::cluskey>();
   }
 
-  // one time, fill cache of g4hit/cluster pairs
-  if (_cache_all_clusters_from_g4hit.empty())
-  {
-    // make a map of truthhit, cluster_key inside this loop
-    std::multimap<PHG4HitDefs::keytype, TrkrDefs::cluskey> truth_cluster_map;
-    std::set<PHG4HitDefs::keytype> all_g4hits_set;
-    std::map<PHG4HitDefs::keytype, PHG4Hit*> all_g4hits_map;
+  const auto clusters = get_truth_index().clusters(truthhit);
+  return std::set<TrkrDefs::cluskey>(clusters.begin(), clusters.end());
+}
 
-    // get all reco clusters
-    if (_verbosity > 1)
-    {
-      std::cout << "all_clusters_from_g4hit: list all reco clusters " << std::endl;
-    }
+const SvtxTruthAssocIndex& SvtxClusterEval::get_truth_index()
+{
+  // one pass over all clusters, filling the associations in both directions
+  if (!_truth_index.is_built())
+  {
+    SvtxTruthAssocIndex::G4HitContainers g4hits;
+    g4hits.mvtx = _g4hits_mvtx;
+    g4hits.intt = _g4hits_intt;
+    g4hits.tpc = _g4hits_tpc;
+    g4hits.micromegas = _g4hits_mms;
+    _truth_index.build(_clustermap, _cluster_hit_map, _hit_truth_map, g4hits, _truthinfo);
 
-    for (const auto& hitsetkey : _clustermap->getHitSetKeys())
+    if (_strict)
     {
-      auto range = _clustermap->getClusters(hitsetkey);
-      for (auto iter = range.first; iter != range.second; ++iter)
-      {
-        TrkrDefs::cluskey cluster_key = iter->first;
-        int layer = TrkrDefs::getLayer(cluster_key);
-        TrkrCluster* clus = iter->second;
-        if (_verbosity > 1)
-        {
-          std::cout << " layer " << layer << " cluster_key " << cluster_key << " adc " << clus->getAdc()
-                    << " localx " << clus->getLocalX()
-                    << " localy " << clus->getLocalY()
-                    << std::endl;
-          std::cout << "  associated hits:";
-          std::pair<std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>::const_iterator, std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>::const_iterator>
-              hitrange = _cluster_hit_map->getHits(cluster_key);  // returns range of pairs {cluster key, hit key} for this cluskey
-          for (std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>::const_iterator
-                   clushititer = hitrange.first;
-               clushititer != hitrange.second; ++clushititer)
-          {
-            TrkrDefs::hitkey hitkey = clushititer->second;
-            std::cout << " " << hitkey;
-          }
-          std::cout << std::endl;
-        }
-
-        // the returned truth hits were obtained from TrkrAssoc maps
-        std::set<PHG4Hit*> hits = all_truth_hits(cluster_key);
-        for (auto* candidate : hits)
-        {
-          PHG4HitDefs::keytype g4hit_key = candidate->get_hit_id();
-
-          if (_verbosity > 5)
-          {
-            int gtrackID = candidate->get_trkid();
-            std::cout << "   adding cluster with cluster_key " << cluster_key << " g4hit with g4hit_key " << g4hit_key
-                      << " gtrackID " << gtrackID
-                      << std::endl;
-          }
-
-          all_g4hits_set.insert(g4hit_key);
-          all_g4hits_map.insert(std::make_pair(g4hit_key, candidate));
-
-          truth_cluster_map.insert(std::make_pair(g4hit_key, cluster_key));
-        }
-      }
+      assert(_truth_index.get_missing_particles() == 0);
     }
+    _errors += _truth_index.get_missing_particles();
 
-    // now fill the cache
-    // loop over all entries in all_g4hits
-    for (unsigned long long g4hit_key : all_g4hits_set)
+    if (_verbosity > 1)
     {
-      if (_verbosity > 5)
-      {
-        std::cout << " associations for g4hit_key " << g4hit_key << std::endl;
-      }
-
-      std::map<PHG4HitDefs::keytype, PHG4Hit*>::iterator it = all_g4hits_map.find(g4hit_key);
-      PHG4Hit* g4hit = it->second;
-
-      std::set<TrkrDefs::cluskey> assoc_clusters;
-
-      std::pair<std::multimap<PHG4HitDefs::keytype, TrkrDefs::cluskey>::iterator,
-                std::multimap<PHG4HitDefs::keytype, TrkrDefs::cluskey>::iterator>
-          ret = truth_cluster_map.equal_range(g4hit_key);
-      for (std::multimap<PHG4HitDefs::keytype, TrkrDefs::cluskey>::iterator jter = ret.first; jter != ret.second; ++jter)
-      {
-        assoc_clusters.insert(jter->second);
-
-        if (_verbosity > 5)
-        {
-          std::cout << "             g4hit_key " << g4hit_key << " associated with cluster_key " << jter->second << std::endl;
-        }
-      }
-      // done with this g4hit
-      _cache_all_clusters_from_g4hit.insert(std::make_pair(g4hit, assoc_clusters));
+      std::cout << "SvtxClusterEval::get_truth_index - clusters: " << _clustermap->size()
+                << " missing particles: " << _truth_index.get_missing_particles() << std::endl;
     }
   }
-
-  // get the clusters
-  std::set<TrkrDefs::cluskey> clusters;
-  std::map<PHG4Hit*, std::set<TrkrDefs::cluskey>>::iterator iter =
-      _cache_all_clusters_from_g4hit.find(truthhit);
-  if (iter != _cache_all_clusters_from_g4hit.end())
-  {
-    return iter->second;
-  }
-
-  if (_clusters_per_layer.empty())
-  {
-    fill_cluster_layer_map();
-  }
-
-  return clusters;
+  return _truth_index;
 }
 
 TrkrDefs::cluskey SvtxClusterEval::best_cluster_by_nhit(int gid, int layer)
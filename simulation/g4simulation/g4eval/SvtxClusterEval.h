@@ -2,6 +2,7 @@
 #define G4EVAL_SVTXCLUSTEREVAL_H
 
 #include "SvtxHitEval.h"
+#include "SvtxTruthAssocIndex.h"
 
 #include <trackbase/ActsGeometry.h>
 #include <trackbase/TrkrDefs.h>
@@ -90,6 +91,9 @@ class SvtxClusterEval
   //  void fill_g4hit_layer_map();
   bool has_node_pointers();
 
+  //! cluster/g4hit/particle associations, built on first use in each event
+  const SvtxTruthAssocIndex& get_truth_index();
+
   //! Fast approximation of atan2() for cluster searching
   //! From https://www.dsprelated.com/showarticle/1052.php
   float fast_approx_atan2(float y, float x);
@@ -113,15 +117,12 @@ class SvtxClusterEval
   Acts::Vector3 getGlobalPosition(TrkrDefs::cluskey cluster_key, TrkrCluster* cluster);
 
   bool _do_cache = true;
-  std::map<TrkrDefs::cluskey, std::set<PHG4Hit*>> _cache_all_truth_hits;
+  SvtxTruthAssocIndex _truth_index;
   std::map<TrkrDefs::cluskey, std::map<TrkrDefs::cluskey, std::shared_ptr<TrkrCluster>>> _cache_all_truth_clusters;
   std::map<TrkrDefs::cluskey, PHG4Hit*> _cache_max_truth_hit_by_energy;
   std::map<TrkrDefs::cluskey, std::pair<TrkrDefs::cluskey, std::shared_ptr<TrkrCluster>>> _cache_max_truth_cluster_by_energy;
-  std::map<TrkrDefs::cluskey, std::set<PHG4Particle*>> _cache_all_truth_particles;
   std::map<TrkrDefs::cluskey, PHG4Particle*> _cache_max_truth_particle_by_energy;
   std::map<TrkrDefs::cluskey, PHG4Particle*> _cache_max_truth_particle_by_cluster_energy;
-  std::map<PHG4Particle*, std::set<TrkrDefs::cluskey>> _cache_all_clusters_from_particle;
-  std::map<PHG4Hit*, std::set<TrkrDefs::cluskey>> _cache_all_clusters_from_g4hit;
   std::map<PHG4Hit*, TrkrDefs::cluskey> _cache_best_cluster_from_g4hit;
   std::map<std::pair<int, int>, TrkrDefs::cluskey> _cache_best_cluster_from_gtrackid_layer;
   std::map<std::pair<TrkrDefs::cluskey, PHG4Particle*>, float> _cache_get_energy_contribution_g4particle;
@@ -0,0 +1,259 @@
+#include "SvtxTruthAssocIndex.h"
+
+#include <trackbase/MvtxDefs.h>
+#include <trackbase/TrkrClusterContainer.h>
+#include <trackbase/TrkrClusterHitAssoc.h>
+#include <trackbase/TrkrHitTruthAssoc.h>
+
+#include <g4main/PHG4Hit.h>
+#include <g4main/PHG4HitContainer.h>
+#include <g4main/PHG4HitDefs.h>
+#include <g4main/PHG4TruthInfoContainer.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+  using HitTruthPair = std::pair<TrkrDefs::hitkey, PHG4HitDefs::keytype>;
+
+  // (hitkey, g4hitkey) associations of one hitset, sorted by hitkey
+  void fill_hitset_table(const TrkrHitTruthAssoc* hit_truth_map, TrkrDefs::hitsetkey hitsetkey, std::vector<HitTruthPair>& table)
+  {
+    table.clear();
+    const auto range = hit_truth_map->getHitSetAssocs(hitsetkey);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+      table.push_back(iter->second);
+    }
+    // stable, to keep the association order of TrkrHitTruthAssoc::getG4Hits for a given hit
+    std::stable_sort(table.begin(), table.end(), [](const HitTruthPair& lhs, const HitTruthPair& rhs)
+                     { return lhs.first < rhs.first; });
+  }
+
+  // range of g4hitkeys associated to a hitkey
+  std::pair<std::vector<HitTruthPair>::const_iterator, std::vector<HitTruthPair>::const_iterator> find_hit(const std::vector<HitTruthPair>& table, TrkrDefs::hitkey hitkey)
+  {
+    return std::equal_range(table.begin(), table.end(), HitTruthPair(hitkey, 0), [](const HitTruthPair& lhs, const HitTruthPair& rhs)
+                            { return lhs.first < rhs.first; });
+  }
+}  // namespace
+
+//_____________________________________________________________________________
+void SvtxTruthAssocIndex::clear()
+{
+  m_built = false;
+  m_missing_particles = 0;
+
+  m_clusters.clear();
+  m_cluster_g4hit_offsets.clear();
+  m_cluster_g4hits.clear();
+  m_cluster_particle_offsets.clear();
+  m_cluster_particles.clear();
+
+  m_g4hits.clear();
+  m_g4hit_cluster_offsets.clear();
+  m_g4hit_clusters.clear();
+
+  m_particles.clear();
+  m_particle_cluster_offsets.clear();
+  m_particle_clusters.clear();
+}
+
+//_____________________________________________________________________________
+void SvtxTruthAssocIndex::build(TrkrClusterContainer* clustermap, TrkrClusterHitAssoc* cluster_hit_map, TrkrHitTruthAssoc* hit_truth_map,
+                                const G4HitContainers& g4hits, PHG4TruthInfoContainer* truthinfo)
+{
+  clear();
+  m_built = true;
+  if (!clustermap || !cluster_hit_map || !hit_truth_map)
+  {
+    m_cluster_g4hit_offsets.push_back(0);
+    m_cluster_particle_offsets.push_back(0);
+    return;
+  }
+
+  // all cluster keys, sorted.  Clusters of a given hitset are then contiguous
+  for (const auto& hitsetkey : clustermap->getHitSetKeys())
+  {
+    const auto range = clustermap->getClusters(hitsetkey);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+      m_clusters.push_back(iter->first);
+    }
+  }
+  std::sort(m_clusters.begin(), m_clusters.end());
+
+  m_cluster_g4hit_offsets.reserve(m_clusters.size() + 1);
+  m_cluster_particle_offsets.reserve(m_clusters.size() + 1);
+  m_cluster_g4hit_offsets.push_back(0);
+  m_cluster_particle_offsets.push_back(0);
+
+  std::vector<std::pair<PHG4Hit*, TrkrDefs::cluskey>> g4hit_cluster_pairs;
+  std::vector<std::pair<PHG4Particle*, TrkrDefs::cluskey>> particle_cluster_pairs;
+
+  std::vector<HitTruthPair> table;
+  std::vector<HitTruthPair> bare_table;
+  TrkrDefs::hitsetkey current_hitsetkey = 0;
+  bool has_current = false;
+  bool has_bare = false;
+  PHG4HitContainer* container = nullptr;
+
+  for (const auto& cluster_key : m_clusters)
+  {
+    const TrkrDefs::hitsetkey hitsetkey = TrkrDefs::getHitSetKeyFromClusKey(cluster_key);
+    const auto layer = TrkrDefs::getLayer(hitsetkey);
+    if (!has_current || hitsetkey != current_hitsetkey)
+    {
+      // new hitset: truth associations are read once for all its clusters
+      current_hitsetkey = hitsetkey;
+      has_current = true;
+      fill_hitset_table(hit_truth_map, hitsetkey, table);
+
+      // mvtx special case, same as TrkrHitTruthAssocv1::getG4Hits: hits without association are looked up in the bare hitsetkey
+      has_bare = false;
+      if (layer < 3)
+      {
+        const TrkrDefs::hitsetkey bare_hitsetkey = MvtxDefs::genHitSetKey(layer, MvtxDefs::getStaveId(hitsetkey), MvtxDefs::getChipId(hitsetkey), 0);
+        if (bare_hitsetkey != hitsetkey)
+        {
+          fill_hitset_table(hit_truth_map, bare_hitsetkey, bare_table);
+          has_bare = true;
+        }
+      }
+
+      switch (TrkrDefs::getTrkrId(hitsetkey))
+      {
+      case TrkrDefs::mvtxId:
+        container = g4hits.mvtx;
+        break;
+      case TrkrDefs::inttId:
+        container = g4hits.intt;
+        break;
+      case TrkrDefs::tpcId:
+        container = g4hits.tpc;
+        break;
+      case TrkrDefs::micromegasId:
+        container = g4hits.micromegas;
+        break;
+      default:
+        container = nullptr;
+        break;
+      }
+    }
+
+    // g4hits of this cluster
+    const size_t first_g4hit = m_cluster_g4hits.size();
+    if (container)
+    {
+      const auto hitrange = cluster_hit_map->getHits(cluster_key);
+      for (auto clushititer = hitrange.first; clushititer != hitrange.second; ++clushititer)
+      {
+        auto found = find_hit(table, clushititer->second);
+        if (found.first == found.second && has_bare)
+        {
+          found = find_hit(bare_table, clushititer->second);
+        }
+        for (auto iter = found.first; iter != found.second; ++iter)
+        {
+          PHG4Hit* g4hit = container->findHit(iter->second);
+          if (g4hit)
+          {
+            m_cluster_g4hits.push_back(g4hit);
+          }
+        }
+      }
+    }
+    std::sort(m_cluster_g4hits.begin() + first_g4hit, m_cluster_g4hits.end());
+    m_cluster_g4hits.erase(std::unique(m_cluster_g4hits.begin() + first_g4hit, m_cluster_g4hits.end()), m_cluster_g4hits.end());
+    m_cluster_g4hit_offsets.push_back(m_cluster_g4hits.size());
+
+    // particles of this cluster
+    const size_t first_particle = m_cluster_particles.size();
+    for (size_t i = first_g4hit; i < m_cluster_g4hits.size(); ++i)
+    {
+      PHG4Hit* g4hit = m_cluster_g4hits[i];
+      g4hit_cluster_pairs.emplace_back(g4hit, cluster_key);
+
+      PHG4Particle* particle = truthinfo ? truthinfo->GetParticle(g4hit->get_trkid()) : nullptr;
+      if (!particle)
+      {
+        ++m_missing_particles;
+        continue;
+      }
+      m_cluster_particles.push_back(particle);
+    }
+    std::sort(m_cluster_particles.begin() + first_particle, m_cluster_particles.end());
+    m_cluster_particles.erase(std::unique(m_cluster_particles.begin() + first_particle, m_cluster_particles.end()), m_cluster_particles.end());
+    m_cluster_particle_offsets.push_back(m_cluster_particles.size());
+
+    for (size_t i = first_particle; i < m_cluster_particles.size(); ++i)
+    {
+      particle_cluster_pairs.emplace_back(m_cluster_particles[i], cluster_key);
+    }
+  }
+
+  // reverse associations
+  compress(g4hit_cluster_pairs, m_g4hits, m_g4hit_cluster_offsets, m_g4hit_clusters);
+  compress(particle_cluster_pairs, m_particles, m_particle_cluster_offsets, m_particle_clusters);
+}
+
+//_____________________________________________________________________________
+SvtxTruthAssocIndex::Range<PHG4Hit*> SvtxTruthAssocIndex::g4hits(TrkrDefs::cluskey cluster_key) const
+{
+  return find(m_clusters, m_cluster_g4hit_offsets, m_cluster_g4hits, cluster_key);
+}
+
+//_____________________________________________________________________________
+SvtxTruthAssocIndex::Range<PHG4Particle*> SvtxTruthAssocIndex::particles(TrkrDefs::cluskey cluster_key) const
+{
+  return find(m_clusters, m_cluster_particle_offsets, m_cluster_particles, cluster_key);
+}
+
+//_____________________________________________________________________________
+SvtxTruthAssocIndex::Range<TrkrDefs::cluskey> SvtxTruthAssocIndex::clusters(PHG4Hit* g4hit) const
+{
+  return find(m_g4hits, m_g4hit_cluster_offsets, m_g4hit_clusters, g4hit);
+}
+
+//_____________________________________________________________________________
+SvtxTruthAssocIndex::Range<TrkrDefs::cluskey> SvtxTruthAssocIndex::clusters(PHG4Particle* particle) const
+{
+  return find(m_particles, m_particle_cluster_offsets, m_particle_clusters, particle);
+}
+
+//_____________________________________________________________________________
+template <class K, class T>
+SvtxTruthAssocIndex::Range<T> SvtxTruthAssocIndex::find(const std::vector<K>& keys, const std::vector<unsigned int>& offsets, const std::vector<T>& values, const K& key)
+{
+  const auto iter = std::lower_bound(keys.begin(), keys.end(), key);
+  if (iter == keys.end() || *iter != key)
+  {
+    return Range<T>();
+  }
+  const size_t index = iter - keys.begin();
+  return Range<T>(values.data() + offsets[index], values.data() + offsets[index + 1]);
+}
+
+//_____________________________________________________________________________
+template <class K, class T>
+void SvtxTruthAssocIndex::compress(std::vector<std::pair<K, T>>& pairs, std::vector<K>& keys, std::vector<unsigned int>& offsets, std::vector<T>& values)
+{
+  std::sort(pairs.begin(), pairs.end());
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+  keys.clear();
+  offsets.clear();
+  values.clear();
+  values.reserve(pairs.size());
+  for (const auto& [key, value] : pairs)
+  {
+    if (keys.empty() || keys.back() != key)
+    {
+      keys.push_back(key);
+      offsets.push_back(values.size());
+    }
+    values.push_back(value);
+  }
+  offsets.push_back(values.size());
+}
@@ -0,0 +1,116 @@
+#ifndef G4EVAL_SVTXTRUTHASSOCINDEX_H
+#define G4EVAL_SVTXTRUTHASSOCINDEX_H
+
+// Per event association between reco clusters, the g4hits behind them and their truth particles.
+// Built in one pass over TrkrClusterHitAssoc and TrkrHitTruthAssoc, and stored as flat
+// compressed (offset + value) arrays in both directions:
+//   cluster  -> g4hits, cluster -> particles
+//   g4hit    -> clusters, particle -> clusters
+// g4hits and particles of a cluster are sorted by address, and clusters by key,
+// which is the order of the std::set returned by SvtxClusterEval.
+
+#include <trackbase/TrkrDefs.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+class PHG4Hit;
+class PHG4HitContainer;
+class PHG4Particle;
+class PHG4TruthInfoContainer;
+class TrkrClusterContainer;
+class TrkrClusterHitAssoc;
+class TrkrHitTruthAssoc;
+
+class SvtxTruthAssocIndex
+{
+ public:
+  //! contiguous range of values, usable in range based for loops
+  template <class T>
+  class Range
+  {
+   public:
+    Range() = default;
+    Range(const T* first, const T* last)
+      : m_first(first)
+      , m_last(last)
+    {
+    }
+    const T* begin() const { return m_first; }
+    const T* end() const { return m_last; }
+    std::size_t size() const { return m_last - m_first; }
+    bool empty() const { return m_first == m_last; }
+
+   private:
+    const T* m_first{nullptr};
+    const T* m_last{nullptr};
+  };
+
+  //! g4hit containers, one per tracking detector
+  struct G4HitContainers
+  {
+    PHG4HitContainer* mvtx{nullptr};
+    PHG4HitContainer* intt{nullptr};
+    PHG4HitContainer* tpc{nullptr};
+    PHG4HitContainer* micromegas{nullptr};
+  };
+
+  SvtxTruthAssocIndex() = default;
+
+  //! remove all associations
+  void clear();
+
+  //! true once build has been called since the last clear
+  bool is_built() const { return m_built; }
+
+  //! fill all associations for the clusters of the container
+  void build(TrkrClusterContainer* clustermap, TrkrClusterHitAssoc* cluster_hit_map, TrkrHitTruthAssoc* hit_truth_map,
+             const G4HitContainers& g4hits, PHG4TruthInfoContainer* truthinfo);
+
+  //! g4hits associated to a cluster
+  Range<PHG4Hit*> g4hits(TrkrDefs::cluskey) const;
+
+  //! truth particles associated to a cluster
+  Range<PHG4Particle*> particles(TrkrDefs::cluskey) const;
+
+  //! clusters associated to a g4hit
+  Range<TrkrDefs::cluskey> clusters(PHG4Hit*) const;
+
+  //! clusters associated to a truth particle
+  Range<TrkrDefs::cluskey> clusters(PHG4Particle*) const;
+
+  //! number of g4hits for which no truth particle was found during build
+  unsigned int get_missing_particles() const { return m_missing_particles; }
+
+ private:
+  //! values of a given key, from sorted keys and offsets
+  template <class K, class T>
+  static Range<T> find(const std::vector<K>& keys, const std::vector<unsigned int>& offsets, const std::vector<T>& values, const K& key);
+
+  //! sort (key, value) pairs and compress them into sorted unique keys, offsets and values
+  template <class K, class T>
+  static void compress(std::vector<std::pair<K, T>>& pairs, std::vector<K>& keys, std::vector<unsigned int>& offsets, std::vector<T>& values);
+
+  bool m_built{false};
+  unsigned int m_missing_particles{0};
+
+  // cluster to g4hits and particles.  Both share the cluster keys
+  std::vector<TrkrDefs::cluskey> m_clusters;
+  std::vector<unsigned int> m_cluster_g4hit_offsets;
+  std::vector<PHG4Hit*> m_cluster_g4hits;
+  std::vector<unsigned int> m_cluster_particle_offsets;
+  std::vector<PHG4Particle*> m_cluster_particles;
+
+  // g4hit to clusters
+  std::vector<PHG4Hit*> m_g4hits;
+  std::vector<unsigned int> m_g4hit_cluster_offsets;
+  std::vector<TrkrDefs::cluskey> m_g4hit_clusters;
+
+  // particle to clusters
+  std::vector<PHG4Particle*> m_particles;
+  std::vector<unsigned int> m_particle_cluster_offsets;
+  std::vector<TrkrDefs::cluskey> m_particle_clusters;
+};
+
+#endif  // G4EVAL_SVTXTRUTHASSOCINDEX_H
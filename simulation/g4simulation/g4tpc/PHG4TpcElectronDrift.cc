@@ -15,6 +15,8 @@
 #include <trackbase/TrkrHit.h>  // for TrkrHit
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainerv1.h>
+#include <trackbase/TrkrHitSetContainerv2.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitTruthAssoc.h>  // for TrkrHitTruthA...
 #include <trackbase/TrkrHitTruthAssocv1.h>
 #include <trackbase/TrkrHitv2.h>
@@ -47,6 +49,7 @@
 #include <phool/PHNodeIterator.h>
 #include <phool/PHObject.h>  // for PHObject
 #include <phool/PHRandomSeed.h>
+#include <phool/PHThreadPool.h>
 #include <phool/getClass.h>
 #include <phool/phool.h>  // for PHWHERE
 
@@ -59,10 +62,12 @@
 #include <gsl/gsl_randist.h>
 #include <gsl/gsl_rng.h>  // for gsl_rng_alloc
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>    // for sqrt, abs, NAN
 #include <cstdlib>  // for exit
+#include <numeric>
 #include <format>
 #include <iostream>
 #include <map>      // for _Rb_tree_cons...
@@ -75,12 +80,63 @@ namespace
   {
     return x * x;
   }
+
+  // splitmix64 finalizer
+  constexpr uint64_t mix(uint64_t x)
+  {
+    x = (x ^ (x >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27U)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31U);
+  }
+
+  // counter based random generator used for batch transport
+  // the n-th number of the sequence for a given key is mix(key + n * golden ratio), i.e. splitmix64,
+  // so that seeding is free and any 64 bits key gives an independent sequence.
+  // It is wrapped as a gsl_rng_type so that the usual gsl_ran_* distributions can be used
+  struct counter_rng_state
+  {
+    uint64_t key;
+    uint64_t counter;
+  };
+
+  uint64_t counter_rng_next(void *vstate)
+  {
+    auto *state = static_cast<counter_rng_state *>(vstate);
+    return mix(state->key + (++state->counter) * 0x9e3779b97f4a7c15ULL);
+  }
+
+  void counter_rng_set(void *vstate, unsigned long seed)
+  {
+    auto *state = static_cast<counter_rng_state *>(vstate);
+    state->key = seed;
+    state->counter = 0;
+  }
+
+  unsigned long counter_rng_get(void *vstate)
+  {
+    return counter_rng_next(vstate) >> 32U;
+  }
+
+  double counter_rng_get_double(void *vstate)
+  {
+    // 53 random bits, in [0,1)
+    return static_cast<double>(counter_rng_next(vstate) >> 11U) * 0x1.0p-53;
+  }
+
+  const gsl_rng_type counter_rng_type = {
+      "phg4tpc_counter", 0xffffffffUL, 0, sizeof(counter_rng_state),
+      &counter_rng_set, &counter_rng_get, &counter_rng_get_double};
+
+  // number of g4hits transported together in batch mode
+  constexpr std::size_t batch_size = 4096;
 }  // namespace
 
 PHG4TpcElectronDrift::PHG4TpcElectronDrift(const std::string &name)
   : SubsysReco(name)
   , PHParameterInterface(name)
-  , temp_hitsetcontainer(new TrkrHitSetContainerv1)
+  // temporary hits are stored in flat hitsets, which are kept between dumps to re-use their allocation.
+  // estimated size is 48 layers x 12 sectors x 2 sides
+  , temp_hitsetcontainer(new TrkrHitSetContainerv2("TrkrHitSetv2", 1152))
   , single_hitsetcontainer(new TrkrHitSetContainerv1)
 {
   InitializeParameters();
@@ -88,6 +144,9 @@ PHG4TpcElectronDrift::PHG4TpcElectronDrift(const std::string &name)
   set_seed(PHRandomSeed());
 }
 
+//_____________________________________________________________
+PHG4TpcElectronDrift::~PHG4TpcElectronDrift() = default;
+
 //_____________________________________________________________
 int PHG4TpcElectronDrift::Init(PHCompositeNode *topNode)
 {
@@ -352,6 +411,24 @@ int PHG4TpcElectronDrift::InitRun(PHCompositeNode *topNode)
 
   padplane->InitRun(topNode);
 
+  if (m_batch_transport)
+  {
+    if (do_ElectronDriftQAHistos || Verbosity())
+    {
+      std::cout << "PHG4TpcElectronDrift::InitRun - batch transport does not fill per electron evaluation histograms and ntuples, using serial transport" << std::endl;
+      m_batch_transport = false;
+    }
+    else if (!m_thread_pool)
+    {
+      m_thread_pool = std::make_unique<PHThreadPool>(m_batch_threads);
+      m_batch_scratch.resize(m_thread_pool->nslots());
+      for (auto &scratch : m_batch_scratch)
+      {
+        scratch.rng.reset(gsl_rng_alloc(&counter_rng_type));
+      }
+    }
+  }
+
   // print all layers radii
   if (Verbosity())
   {
@@ -440,6 +517,18 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
 
   PHG4HitContainer::ConstRange hit_begin_end = g4hit->getHits();
   unsigned int count_g4hits = 0;
+
+  // batch transport works on blocks of g4hits, indexed by their position in the container
+  if (m_batch_transport)
+  {
+    m_batch_hits.clear();
+    for (auto hiter = hit_begin_end.first; hiter != hit_begin_end.second; ++hiter)
+    {
+      m_batch_hits.push_back(hiter);
+    }
+    m_batch.begin = 0;
+    m_batch.end = 0;
+  }
   //  int count_electrons = 0;
 
   //  double ecollectedhits = 0.0;
@@ -523,7 +612,23 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
     // drifted electrons, then copy to the node tree later
 
     double eion = hiter->second->get_eion();
-    unsigned int n_electrons = gsl_ran_poisson(RandomGenerator.get(), eion * electrons_per_gev);
+    unsigned int n_electrons = 0;
+    std::size_t batch_index = 0;
+    if (m_batch_transport)
+    {
+      // transport next block of g4hits if needed
+      const std::size_t index = count_g4hits - 1;
+      if (index >= m_batch.end)
+      {
+        transport_batch(index, std::min(index + batch_size, m_batch_hits.size()), layergeom->get_drift_velocity_sim());
+      }
+      batch_index = index - m_batch.begin;
+      n_electrons = m_batch.n_electrons[batch_index];
+    }
+    else
+    {
+      n_electrons = gsl_ran_poisson(RandomGenerator.get(), eion * electrons_per_gev);
+    }
     //    count_electrons += n_electrons;
 
     if (Verbosity() > 100)
@@ -556,167 +661,180 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
 
     int notReachingReadout = 0;
     //    int notInAcceptance = 0;
-    for (unsigned int i = 0; i < n_electrons; i++)
+    if (m_batch_transport)
     {
-      // We choose the electron starting position at random from a flat
-      // distribution along the path length the parameter t is the fraction of
-      // the distance along the path betwen entry and exit points, it has
-      // values between 0 and 1
-      const double f = gsl_ran_flat(RandomGenerator.get(), 0.0, 1.0);
-
-      const double x_start_glob = hiter->second->get_x(0) + f * (hiter->second->get_x(1) - hiter->second->get_x(0));
-      const double y_start_glob = hiter->second->get_y(0) + f * (hiter->second->get_y(1) - hiter->second->get_y(0));
-      const double z_start_glob = hiter->second->get_z(0) + f * (hiter->second->get_z(1) - hiter->second->get_z(0));
-      const double t_start = hiter->second->get_t(0) + f * (hiter->second->get_t(1) - hiter->second->get_t(0));
-
-      Acts::Vector3 start_glob(x_start_glob, y_start_glob, z_start_glob);
-      Acts::Vector3 start = m_tGeometry->transformTpcWorldToEnvelope(start_glob); // we drift in tpc envelope coords, where E is in the z direction
-
-      const double x_start = start.x();
-      const double y_start = start.y();
-      const double z_start = start.z();
-      /*
-      std::cout << " xg " << x_start_glob << " x " << x_start
-		<<" yg " << y_start_glob << " y " << y_start
-		<<" zg " << z_start_glob << " z " << z_start << std::endl;
-      */
-      unsigned int side = 0;
-      if (z_start > 0)
-      {
-        side = 1;
-      }
-
-      const double r_sigma = diffusion_trans * sqrt(tpc_length / 2. - std::abs(z_start));
-      const double rantrans =
-          gsl_ran_gaussian(RandomGenerator.get(), r_sigma) +
-          gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_trans);
-
-      const double t_path = (tpc_length / 2. - std::abs(z_start)) / layergeom->get_drift_velocity_sim();
-      const double t_sigma = diffusion_long * sqrt(tpc_length / 2. - std::abs(z_start)) / layergeom->get_drift_velocity_sim();
-      const double rantime =
-          gsl_ran_gaussian(RandomGenerator.get(), t_sigma) +
-	gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_long) / layergeom->get_drift_velocity_sim();
-      double t_final = t_start + t_path + rantime;
-
-      if (t_final < min_time || t_final > max_time)
-      {
-        continue;
-      }
-
-      double z_final;
-      if (z_start < 0)
-      {
-        z_final = -tpc_length / 2. + t_final * layergeom->get_drift_velocity_sim();
-      }
-      else
+      // electrons were already drifted, hand them over to the pad plane
+      notReachingReadout = m_batch.n_not_reaching_readout[batch_index];
+      const std::size_t offset = m_batch.offset[batch_index];
+      padplane->MapToPadPlane(truth_clusterer, single_hitsetcontainer.get(),
+                              temp_hitsetcontainer.get(), hittruthassoc,
+                              m_batch.x.data() + offset, m_batch.y.data() + offset, m_batch.t.data() + offset, m_batch.side.data() + offset,
+                              m_batch.n_drifted[batch_index], hiter, ntpad, nthit);
+    }
+    else
+    {
+      for (unsigned int i = 0; i < n_electrons; i++)
       {
-        z_final = tpc_length / 2. - t_final * layergeom->get_drift_velocity_sim();
-      }
-
-      const double radstart = std::sqrt(square(x_start) + square(y_start));
-      const double phistart = std::atan2(y_start, x_start);
-      const double ranphi = gsl_ran_flat(RandomGenerator.get(), -M_PI, M_PI);
-
-      double x_final = x_start + rantrans * std::cos(ranphi);  // Initialize these to be only diffused first, will be overwritten if doing SC distortion
-      double y_final = y_start + rantrans * std::sin(ranphi);
+        // We choose the electron starting position at random from a flat
+        // distribution along the path length the parameter t is the fraction of
+        // the distance along the path betwen entry and exit points, it has
+        // values between 0 and 1
+        const double f = gsl_ran_flat(RandomGenerator.get(), 0.0, 1.0);
+
+        const double x_start_glob = hiter->second->get_x(0) + f * (hiter->second->get_x(1) - hiter->second->get_x(0));
+        const double y_start_glob = hiter->second->get_y(0) + f * (hiter->second->get_y(1) - hiter->second->get_y(0));
+        const double z_start_glob = hiter->second->get_z(0) + f * (hiter->second->get_z(1) - hiter->second->get_z(0));
+        const double t_start = hiter->second->get_t(0) + f * (hiter->second->get_t(1) - hiter->second->get_t(0));
+
+        Acts::Vector3 start_glob(x_start_glob, y_start_glob, z_start_glob);
+        Acts::Vector3 start = m_tGeometry->transformTpcWorldToEnvelope(start_glob); // we drift in tpc envelope coords, where E is in the z direction
+
+        const double x_start = start.x();
+        const double y_start = start.y();
+        const double z_start = start.z();
+        /*
+        std::cout << " xg " << x_start_glob << " x " << x_start
+  		<<" yg " << y_start_glob << " y " << y_start
+  		<<" zg " << z_start_glob << " z " << z_start << std::endl;
+        */
+        unsigned int side = 0;
+        if (z_start > 0)
+        {
+          side = 1;
+        }
 
-      double rad_final = sqrt(square(x_final) + square(y_final));
-      double phi_final = atan2(y_final, x_final);
+        const double r_sigma = diffusion_trans * sqrt(tpc_length / 2. - std::abs(z_start));
+        const double rantrans =
+            gsl_ran_gaussian(RandomGenerator.get(), r_sigma) +
+            gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_trans);
 
-      if (do_ElectronDriftQAHistos)
-      {
-        z_startmap->Fill(z_start, radstart);                   // map of starting location in Z vs. R
-        deltaphinodist->Fill(phistart, rantrans / rad_final);  // delta phi no distortion, just diffusion+smear
-        deltarnodist->Fill(radstart, rantrans);                // delta r no distortion, just diffusion+smear
-      }
+        const double t_path = (tpc_length / 2. - std::abs(z_start)) / layergeom->get_drift_velocity_sim();
+        const double t_sigma = diffusion_long * sqrt(tpc_length / 2. - std::abs(z_start)) / layergeom->get_drift_velocity_sim();
+        const double rantime =
+            gsl_ran_gaussian(RandomGenerator.get(), t_sigma) +
+  	gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_long) / layergeom->get_drift_velocity_sim();
+        double t_final = t_start + t_path + rantime;
 
-      if (m_distortionMap)
-      {
-        // zhangcanyu
-        const double reaches = m_distortionMap->get_reaches_readout(radstart, phistart, z_start);
-        if (reaches < thresholdforreachesreadout)
+        if (t_final < min_time || t_final > max_time)
         {
-          notReachingReadout++;
           continue;
         }
 
-        const double r_distortion = m_distortionMap->get_r_distortion(radstart, phistart, z_start);
-        const double phi_distortion = m_distortionMap->get_rphi_distortion(radstart, phistart, z_start) / radstart;
-        const double z_distortion = m_distortionMap->get_z_distortion(radstart, phistart, z_start);
-
-        rad_final += r_distortion;
-        phi_final += phi_distortion;
-        z_final += z_distortion;
+        double z_final;
         if (z_start < 0)
         {
-          t_final = (z_final + tpc_length / 2.0) / layergeom->get_drift_velocity_sim();
+          z_final = -tpc_length / 2. + t_final * layergeom->get_drift_velocity_sim();
         }
         else
         {
-          t_final = (tpc_length / 2.0 - z_final) / layergeom->get_drift_velocity_sim();
+          z_final = tpc_length / 2. - t_final * layergeom->get_drift_velocity_sim();
         }
 
-        x_final = rad_final * std::cos(phi_final);
-        y_final = rad_final * std::sin(phi_final);
+        const double radstart = std::sqrt(square(x_start) + square(y_start));
+        const double phistart = std::atan2(y_start, x_start);
+        const double ranphi = gsl_ran_flat(RandomGenerator.get(), -M_PI, M_PI);
+
+        double x_final = x_start + rantrans * std::cos(ranphi);  // Initialize these to be only diffused first, will be overwritten if doing SC distortion
+        double y_final = y_start + rantrans * std::sin(ranphi);
 
-        //	if(i < 1)
-        //{std::cout << " electron " << i << " r_distortion " << r_distortion << " phi_distortion " << phi_distortion << " rad_final " << rad_final << " phi_final " << phi_final << " r*dphi distortion " << rad_final * phi_distortion << " z_distortion " << z_distortion << std::endl;}
+        double rad_final = sqrt(square(x_final) + square(y_final));
+        double phi_final = atan2(y_final, x_final);
 
         if (do_ElectronDriftQAHistos)
         {
-          const double phi_final_nodiff = phistart + phi_distortion;
-          const double rad_final_nodiff = radstart + r_distortion;
-          deltarnodiff->Fill(radstart, rad_final_nodiff - radstart);    // delta r no diffusion, just distortion
-          deltaphinodiff->Fill(phistart, phi_final_nodiff - phistart);  // delta phi no diffusion, just distortion
-          deltaphivsRnodiff->Fill(radstart, phi_final_nodiff - phistart);
-          deltaRphinodiff->Fill(radstart, rad_final_nodiff * phi_final_nodiff - radstart * phistart);
-
-          // Fill Diagnostic plots, written into ElectronDriftQA.root
-          hitmapstart->Fill(x_start, y_start);  // G4Hit starting positions
-          hitmapend->Fill(x_final, y_final);    // INcludes diffusion and distortion
-          hitmapstart_z->Fill(z_start, radstart);
-          hitmapend_z->Fill(z_final, rad_final);
-          deltar->Fill(radstart, rad_final - radstart);    // total delta r
-          deltaphi->Fill(phistart, phi_final - phistart);  // total delta phi
-          deltaz->Fill(z_start, z_distortion);             // map of distortion in Z (time)
+          z_startmap->Fill(z_start, radstart);                   // map of starting location in Z vs. R
+          deltaphinodist->Fill(phistart, rantrans / rad_final);  // delta phi no distortion, just diffusion+smear
+          deltarnodist->Fill(radstart, rantrans);                // delta r no distortion, just diffusion+smear
         }
-      }
 
-      // remove electrons outside of our acceptance. Careful though, electrons from just inside 30 cm can contribute in the 1st active layer readout, so leave a little margin
-      if (rad_final < min_active_radius - 2.0 || rad_final > max_active_radius + 1.0)
-      {
-        //        notInAcceptance++;
-        continue;
-      }
+        if (m_distortionMap)
+        {
+          // zhangcanyu
+          const double reaches = m_distortionMap->get_reaches_readout(radstart, phistart, z_start);
+          if (reaches < thresholdforreachesreadout)
+          {
+            notReachingReadout++;
+            continue;
+          }
 
-      if (Verbosity() > 1000)
-      //      if(i < 1)
-      {
-        std::cout << "electron " << i << " g4hitid " << hiter->first << " f " << f << std::endl;
-        std::cout << "radstart " << radstart << " x_start: " << x_start
-                  << ", y_start: " << y_start
-                  << ",z_start: " << z_start
-                  << " t_start " << t_start
-                  << " t_path " << t_path
-                  << " t_sigma " << t_sigma
-                  << " rantime " << rantime
-                  << std::endl;
-
-        std::cout << "       rad_final " << rad_final << " x_final " << x_final
-                  << " y_final " << y_final
-                  << " z_final " << z_final << " t_final " << t_final
-                  << " zdiff " << z_final - z_start << std::endl;
-      }
+          const double r_distortion = m_distortionMap->get_r_distortion(radstart, phistart, z_start);
+          const double phi_distortion = m_distortionMap->get_rphi_distortion(radstart, phistart, z_start) / radstart;
+          const double z_distortion = m_distortionMap->get_z_distortion(radstart, phistart, z_start);
 
-      if (Verbosity() > 0)
-      {
-        assert(nt);
-        nt->Fill(ihit, t_start, t_final, t_sigma, rad_final, z_start, z_final);
-      }
-      padplane->MapToPadPlane(truth_clusterer, single_hitsetcontainer.get(),
-                              temp_hitsetcontainer.get(), hittruthassoc, x_final, y_final, t_final,
-                              side, hiter, ntpad, nthit);
-    }  // end loop over electrons for this g4hit
+          rad_final += r_distortion;
+          phi_final += phi_distortion;
+          z_final += z_distortion;
+          if (z_start < 0)
+          {
+            t_final = (z_final + tpc_length / 2.0) / layergeom->get_drift_velocity_sim();
+          }
+          else
+          {
+            t_final = (tpc_length / 2.0 - z_final) / layergeom->get_drift_velocity_sim();
+          }
+
+          x_final = rad_final * std::cos(phi_final);
+          y_final = rad_final * std::sin(phi_final);
+
+          //	if(i < 1)
+          //{std::cout << " electron " << i << " r_distortion " << r_distortion << " phi_distortion " << phi_distortion << " rad_final " << rad_final << " phi_final " << phi_final << " r*dphi distortion " << rad_final * phi_distortion << " z_distortion " << z_distortion << std::endl;}
+
+          if (do_ElectronDriftQAHistos)
+          {
+            const double phi_final_nodiff = phistart + phi_distortion;
+            const double rad_final_nodiff = radstart + r_distortion;
+            deltarnodiff->Fill(radstart, rad_final_nodiff - radstart);    // delta r no diffusion, just distortion
+            deltaphinodiff->Fill(phistart, phi_final_nodiff - phistart);  // delta phi no diffusion, just distortion
+            deltaphivsRnodiff->Fill(radstart, phi_final_nodiff - phistart);
+            deltaRphinodiff->Fill(radstart, rad_final_nodiff * phi_final_nodiff - radstart * phistart);
+
+            // Fill Diagnostic plots, written into ElectronDriftQA.root
+            hitmapstart->Fill(x_start, y_start);  // G4Hit starting positions
+            hitmapend->Fill(x_final, y_final);    // INcludes diffusion and distortion
+            hitmapstart_z->Fill(z_start, radstart);
+            hitmapend_z->Fill(z_final, rad_final);
+            deltar->Fill(radstart, rad_final - radstart);    // total delta r
+            deltaphi->Fill(phistart, phi_final - phistart);  // total delta phi
+            deltaz->Fill(z_start, z_distortion);             // map of distortion in Z (time)
+          }
+        }
+
+        // remove electrons outside of our acceptance. Careful though, electrons from just inside 30 cm can contribute in the 1st active layer readout, so leave a little margin
+        if (rad_final < min_active_radius - 2.0 || rad_final > max_active_radius + 1.0)
+        {
+          //        notInAcceptance++;
+          continue;
+        }
+
+        if (Verbosity() > 1000)
+        //      if(i < 1)
+        {
+          std::cout << "electron " << i << " g4hitid " << hiter->first << " f " << f << std::endl;
+          std::cout << "radstart " << radstart << " x_start: " << x_start
+                    << ", y_start: " << y_start
+                    << ",z_start: " << z_start
+                    << " t_start " << t_start
+                    << " t_path " << t_path
+                    << " t_sigma " << t_sigma
+                    << " rantime " << rantime
+                    << std::endl;
+
+          std::cout << "       rad_final " << rad_final << " x_final " << x_final
+                    << " y_final " << y_final
+                    << " z_final " << z_final << " t_final " << t_final
+                    << " zdiff " << z_final - z_start << std::endl;
+        }
+
+        if (Verbosity() > 0)
+        {
+          assert(nt);
+          nt->Fill(ihit, t_start, t_final, t_sigma, rad_final, z_start, z_final);
+        }
+        padplane->MapToPadPlane(truth_clusterer, single_hitsetcontainer.get(),
+                                temp_hitsetcontainer.get(), hittruthassoc, x_final, y_final, t_final,
+                                side, hiter, ntpad, nthit);
+      }  // end loop over electrons for this g4hit
+    }
 
     if (do_ElectronDriftQAHistos)
     {
@@ -770,6 +888,12 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
            ++temp_hitset_iter)
       {
         // we have an itrator to one TrkrHitSet for the Tpc from the temp_hitsetcontainer
+        // hitsets are kept by the temp_hitsetcontainer after reset, so skip empty ones
+        if (temp_hitset_iter->second->size() == 0)
+        {
+          continue;
+        }
+
         TrkrDefs::hitsetkey node_hitsetkey = temp_hitset_iter->first;
         const unsigned int layer = TrkrDefs::getLayer(node_hitsetkey);
         const int sector = TpcDefs::getSectorId(node_hitsetkey);
@@ -783,21 +907,22 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
         // find or add this hitset on the node tree
         TrkrHitSetContainer::Iterator node_hitsetit = hitsetcontainer->findOrAddHitSet(node_hitsetkey);
 
-        // get all of the hits from the temporary hitset
-        TrkrHitSet::ConstRange temp_hit_range = temp_hitset_iter->second->getHits();
-        for (TrkrHitSet::ConstIterator temp_hit_iter = temp_hit_range.first;
-             temp_hit_iter != temp_hit_range.second;
-             ++temp_hit_iter)
+        // get all of the hits from the temporary hitset, stored as flat (hitkey, adc) lists
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+        const auto *temp_hitset = static_cast<TrkrHitSetv2 *>(temp_hitset_iter->second);
+        const auto &temp_hitkeys = temp_hitset->getHitKeys();
+        const auto &temp_adcs = temp_hitset->getAdcs();
+        for (size_t ihitkey = 0; ihitkey < temp_hitkeys.size(); ++ihitkey)
         {
-          TrkrDefs::hitkey temp_hitkey = temp_hit_iter->first;
-          TrkrHit *temp_tpchit = temp_hit_iter->second;
+          const TrkrDefs::hitkey temp_hitkey = temp_hitkeys[ihitkey];
+          const double temp_energy = temp_adcs[ihitkey] / TrkrDefs::EdepScaleFactor;
           if (Verbosity() > 10 && layer == print_layer)
           {
             std::cout << "      temp_hitkey " << temp_hitkey << " layer " << layer << " pad " << TpcDefs::getPad(temp_hitkey)
                       << " z bin " << TpcDefs::getTBin(temp_hitkey)
-                      << "  energy " << temp_tpchit->getEnergy() << " eg4hit " << eg4hit << std::endl;
+                      << "  energy " << temp_energy << " eg4hit " << eg4hit << std::endl;
 
-            eg4hit += temp_tpchit->getEnergy();
+            eg4hit += temp_energy;
             //            ecollectedhits += temp_tpchit->getEnergy();
             //            ncollectedhits++;
           }
@@ -812,7 +937,7 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
           }
 
           // Either way, add the energy to it
-          node_hit->addEnergy(temp_tpchit->getEnergy());
+          node_hit->addEnergy(temp_energy);
 
         }  // end loop over temp hits
 
@@ -947,6 +1072,173 @@ int PHG4TpcElectronDrift::End(PHCompositeNode * /*topNode*/)
 void PHG4TpcElectronDrift::set_seed(const unsigned int seed)
 {
   gsl_rng_set(RandomGenerator.get(), seed);
+  m_batch_seed = mix(seed);
+}
+
+//_____________________________________________________________
+unsigned int PHG4TpcElectronDrift::batch_electron_count(gsl_rng *rng, std::size_t index) const
+{
+  // one random sequence per seed, event and g4hit
+  gsl_rng_set(rng, mix(mix(m_batch_seed ^ static_cast<uint64_t>(event_num)) ^ index));
+
+  const PHG4Hit *hit = m_batch_hits[index]->second;
+  const double t0 = std::fmax(hit->get_t(0), hit->get_t(1));
+  if (t0 > max_time)
+  {
+    return 0;
+  }
+  return gsl_ran_poisson(rng, hit->get_eion() * electrons_per_gev);
+}
+
+//_____________________________________________________________
+void PHG4TpcElectronDrift::transport_batch(std::size_t begin, std::size_t end, const double drift_velocity)
+{
+  const std::size_t nhits = end - begin;
+  m_batch.begin = begin;
+  m_batch.end = end;
+  m_batch.n_electrons.assign(nhits, 0);
+  m_batch.n_not_reaching_readout.assign(nhits, 0);
+  m_batch.n_drifted.assign(nhits, 0);
+  m_batch.offset.assign(nhits + 1, 0);
+
+  // number of electrons per g4hit
+  m_thread_pool->parallel_for(nhits, [&](std::size_t i, unsigned int worker)
+                              { m_batch.n_electrons[i] = batch_electron_count(m_batch_scratch[worker].rng.get(), begin + i); });
+
+  // electron storage
+  std::partial_sum(m_batch.n_electrons.begin(), m_batch.n_electrons.end(), m_batch.offset.begin() + 1);
+  const std::size_t nelectrons = m_batch.offset.back();
+  m_batch.x.resize(nelectrons);
+  m_batch.y.resize(nelectrons);
+  m_batch.t.resize(nelectrons);
+  m_batch.side.resize(nelectrons);
+
+  const double half_length = tpc_length / 2.;
+
+  // generate and drift electrons
+  m_thread_pool->parallel_for(nhits, [&](std::size_t i, unsigned int worker)
+                              {
+    auto& scratch = m_batch_scratch[worker];
+    gsl_rng* rng = scratch.rng.get();
+
+    // reseed, and skip the electron count, already known
+    const unsigned int n = batch_electron_count(rng, begin + i);
+    if (n == 0)
+    {
+      return;
+    }
+
+    for (auto* v : {&scratch.f, &scratch.gaus_trans, &scratch.gaus_trans_smear, &scratch.gaus_long, &scratch.gaus_long_smear, &scratch.ranphi,
+                    &scratch.x_start, &scratch.y_start, &scratch.z_start, &scratch.x_final, &scratch.y_final, &scratch.z_final, &scratch.t_final})
+    {
+      v->resize(n);
+    }
+
+    // random numbers
+    for (unsigned int k = 0; k < n; ++k)
+    {
+      scratch.f[k] = gsl_ran_flat(rng, 0.0, 1.0);
+    }
+    for (unsigned int k = 0; k < n; ++k)
+    {
+      scratch.gaus_trans[k] = gsl_ran_gaussian(rng, 1.0);
+      scratch.gaus_trans_smear[k] = gsl_ran_gaussian(rng, 1.0);
+      scratch.gaus_long[k] = gsl_ran_gaussian(rng, 1.0);
+      scratch.gaus_long_smear[k] = gsl_ran_gaussian(rng, 1.0);
+    }
+    for (unsigned int k = 0; k < n; ++k)
+    {
+      scratch.ranphi[k] = gsl_ran_flat(rng, -M_PI, M_PI);
+    }
+
+    // starting points along the g4hit, in tpc envelope coordinates.
+    // the world to envelope transformation is affine, so it is applied to the g4hit end points only
+    const PHG4Hit* hit = m_batch_hits[begin + i]->second;
+    const Acts::Vector3 entry_point = m_tGeometry->transformTpcWorldToEnvelope(Acts::Vector3(hit->get_x(0), hit->get_y(0), hit->get_z(0)));
+    const Acts::Vector3 exit_point = m_tGeometry->transformTpcWorldToEnvelope(Acts::Vector3(hit->get_x(1), hit->get_y(1), hit->get_z(1)));
+    const double t_entry = hit->get_t(0);
+    const double t_exit = hit->get_t(1);
+
+    // diffusion and drift, without branches
+    for (unsigned int k = 0; k < n; ++k)
+    {
+      const double f = scratch.f[k];
+      const double x_start = entry_point.x() + f * (exit_point.x() - entry_point.x());
+      const double y_start = entry_point.y() + f * (exit_point.y() - entry_point.y());
+      const double z_start = entry_point.z() + f * (exit_point.z() - entry_point.z());
+      const double t_start = t_entry + f * (t_exit - t_entry);
+
+      const double drift_length = half_length - std::abs(z_start);
+      const double sqrt_drift_length = std::sqrt(drift_length);
+      const double rantrans = diffusion_trans * sqrt_drift_length * scratch.gaus_trans[k] + added_smear_sigma_trans * scratch.gaus_trans_smear[k];
+      const double t_path = drift_length / drift_velocity;
+      const double t_sigma = diffusion_long * sqrt_drift_length / drift_velocity;
+      const double rantime = t_sigma * scratch.gaus_long[k] + added_smear_sigma_long * scratch.gaus_long_smear[k] / drift_velocity;
+      const double t_final = t_start + t_path + rantime;
+
+      scratch.x_start[k] = x_start;
+      scratch.y_start[k] = y_start;
+      scratch.z_start[k] = z_start;
+      scratch.t_final[k] = t_final;
+      scratch.z_final[k] = z_start < 0 ? -half_length + t_final * drift_velocity : half_length - t_final * drift_velocity;
+      scratch.x_final[k] = x_start + rantrans * std::cos(scratch.ranphi[k]);
+      scratch.y_final[k] = y_start + rantrans * std::sin(scratch.ranphi[k]);
+    }
+
+    // distortions and acceptance. Accepted electrons are stored contiguously
+    std::size_t out = m_batch.offset[i];
+    unsigned int not_reaching_readout = 0;
+    for (unsigned int k = 0; k < n; ++k)
+    {
+      double t_final = scratch.t_final[k];
+      if (t_final < min_time || t_final > max_time)
+      {
+        continue;
+      }
+
+      const double z_start = scratch.z_start[k];
+      double x_final = scratch.x_final[k];
+      double y_final = scratch.y_final[k];
+      double rad_final = std::sqrt(square(x_final) + square(y_final));
+
+      if (m_distortionMap)
+      {
+        const double radstart = std::sqrt(square(scratch.x_start[k]) + square(scratch.y_start[k]));
+        const double phistart = std::atan2(scratch.y_start[k], scratch.x_start[k]);
+        const double reaches = m_distortionMap->get_reaches_readout(radstart, phistart, z_start);
+        if (reaches < thresholdforreachesreadout)
+        {
+          ++not_reaching_readout;
+          continue;
+        }
+
+        const double r_distortion = m_distortionMap->get_r_distortion(radstart, phistart, z_start);
+        const double phi_distortion = m_distortionMap->get_rphi_distortion(radstart, phistart, z_start) / radstart;
+        const double z_distortion = m_distortionMap->get_z_distortion(radstart, phistart, z_start);
+
+        rad_final += r_distortion;
+        const double phi_final = std::atan2(y_final, x_final) + phi_distortion;
+        const double z_final = scratch.z_final[k] + z_distortion;
+        t_final = z_start < 0 ? (z_final + half_length) / drift_velocity : (half_length - z_final) / drift_velocity;
+        x_final = rad_final * std::cos(phi_final);
+        y_final = rad_final * std::sin(phi_final);
+      }
+
+      // remove electrons outside of our acceptance, same margins as serial transport
+      if (rad_final < min_active_radius - 2.0 || rad_final > max_active_radius + 1.0)
+      {
+        continue;
+      }
+
+      m_batch.x[out] = x_final;
+      m_batch.y[out] = y_final;
+      m_batch.t[out] = t_final;
+      m_batch.side[out] = z_start > 0 ? 1 : 0;
+      ++out;
+    }
+
+    m_batch.n_drifted[i] = out - m_batch.offset[i];
+    m_batch.n_not_reaching_readout[i] = not_reaching_readout; });
 }
 
 void PHG4TpcElectronDrift::SetDefaultParameters()
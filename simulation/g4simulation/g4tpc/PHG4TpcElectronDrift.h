@@ -17,14 +17,18 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <fstream>
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 class PHG4TpcPadPlane;
 class PHG4TpcDistortion;
 class PHCompositeNode;
+class PHThreadPool;
 class TH1;
 class TH2;
 class TNtuple;
@@ -44,7 +48,7 @@ class PHG4TpcElectronDrift : public SubsysReco, public PHParameterInterface
 {
  public:
   PHG4TpcElectronDrift(const std::string &name = "PHG4TpcElectronDrift");
-  ~PHG4TpcElectronDrift() override = default;
+  ~PHG4TpcElectronDrift() override;
   int Init(PHCompositeNode *) override;
   int InitRun(PHCompositeNode *) override;
   int process_event(PHCompositeNode *) override;
@@ -76,6 +80,22 @@ class PHG4TpcElectronDrift : public SubsysReco, public PHParameterInterface
   //! setup readout plane
   void registerPadPlane(PHG4TpcPadPlane *padplane);
 
+  //! batched electron transport
+  /**
+   * electrons from blocks of g4hits are generated and drifted in parallel, using nthreads threads
+   * (negative: number of hardware threads, 0: no extra thread), then handed to the pad plane
+   * one g4hit at a time, in the same order as the serial transport.
+   * Each g4hit uses its own counter based random sequence, keyed on the seed, the event number and the g4hit index,
+   * so that results are reproducible and do not depend on the number of threads.
+   * They differ from the serial transport, which uses a single random sequence.
+   * Per electron evaluation histograms and ntuples are not filled in this mode
+   */
+  void set_batch_transport(bool flag = true, int nthreads = -1)
+  {
+    m_batch_transport = flag;
+    m_batch_threads = nthreads;
+  }
+
   // cluster the PHG4Tracks individually
   TpcClusterBuilder truth_clusterer{};
   void set_pixel_thresholdrat(double val) { truth_clusterer.set_pixel_thresholdrat(val); };
@@ -163,6 +183,57 @@ class PHG4TpcElectronDrift : public SubsysReco, public PHParameterInterface
     void operator()(gsl_rng *rng) const { gsl_rng_free(rng); }
   };
   std::unique_ptr<gsl_rng, Deleter> RandomGenerator;
+
+  //!@name batch transport
+  //@{
+  //! generate and drift electrons for g4hits in [begin, end) of m_batch_hits
+  void transport_batch(std::size_t begin, std::size_t end, const double drift_velocity);
+
+  //! seed random generator for a given g4hit and return number of ionization electrons
+  unsigned int batch_electron_count(gsl_rng *rng, std::size_t index) const;
+
+  //! per worker buffers, structure of arrays indexed by electron
+  struct BatchScratch
+  {
+    std::unique_ptr<gsl_rng, Deleter> rng;
+    std::vector<double> f;
+    std::vector<double> gaus_trans;
+    std::vector<double> gaus_trans_smear;
+    std::vector<double> gaus_long;
+    std::vector<double> gaus_long_smear;
+    std::vector<double> ranphi;
+    std::vector<double> x_start;
+    std::vector<double> y_start;
+    std::vector<double> z_start;
+    std::vector<double> x_final;
+    std::vector<double> y_final;
+    std::vector<double> z_final;
+    std::vector<double> t_final;
+  };
+
+  //! drifted electrons for a block of g4hits, stored contiguously for each g4hit
+  struct ElectronBatch
+  {
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    std::vector<unsigned int> n_electrons;
+    std::vector<unsigned int> n_not_reaching_readout;
+    std::vector<unsigned int> n_drifted;
+    std::vector<std::size_t> offset;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> t;
+    std::vector<unsigned int> side;
+  };
+
+  bool m_batch_transport{false};
+  int m_batch_threads{-1};
+  uint64_t m_batch_seed{0};
+  std::vector<PHG4HitContainer::ConstIterator> m_batch_hits;
+  ElectronBatch m_batch;
+  std::vector<BatchScratch> m_batch_scratch;
+  std::unique_ptr<PHThreadPool> m_thread_pool;
+  //@}
 };
 
 #endif  // G4TPC_PHG4TPCELECTRONDRIFT_H
@@ -9,6 +9,7 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <cstddef>
 #include <string>  // for string
 
 class TrkrHitSetContainer;
@@ -33,6 +34,16 @@ class PHG4TpcPadPlane : public SubsysReco, public PHParameterInterface
   virtual void UpdateInternalParameters() { return; }
   //  virtual void MapToPadPlane(PHG4CellContainer * /*g4cells*/, const double /*x_gem*/, const double /*y_gem*/, const double /*t_gem*/, const unsigned int /*side*/, PHG4HitContainer::ConstIterator /*hiter*/, TNtuple * /*ntpad*/, TNtuple * /*nthit*/) {}
   virtual void MapToPadPlane(TpcClusterBuilder & /*builder*/, TrkrHitSetContainer * /*single_hitsetcontainer*/, TrkrHitSetContainer * /*hitsetcontainer*/, TrkrHitTruthAssoc * /*hittruthassoc*/, const double /*x_gem*/, const double /*y_gem*/, const double /*t_gem*/, const unsigned int /*side*/, PHG4HitContainer::ConstIterator /*hiter*/, TNtuple * /*ntpad*/, TNtuple * /*nthit*/) = 0;  // { return {}; }
+
+  //! map a set of drifted electrons from the same g4hit. By default, electrons are mapped one at a time
+  virtual void MapToPadPlane(TpcClusterBuilder &builder, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer, TrkrHitTruthAssoc *hittruthassoc, const double *x_gem, const double *y_gem, const double *t_gem, const unsigned int *side, const std::size_t nelectrons, PHG4HitContainer::ConstIterator hiter, TNtuple *ntpad, TNtuple *nthit)
+  {
+    for (std::size_t i = 0; i < nelectrons; ++i)
+    {
+      MapToPadPlane(builder, single_hitsetcontainer, hitsetcontainer, hittruthassoc, x_gem[i], y_gem[i], t_gem[i], side[i], hiter, ntpad, nthit);
+    }
+  }
+
   void Detector(const std::string &name) { detector = name; }
 
  protected:
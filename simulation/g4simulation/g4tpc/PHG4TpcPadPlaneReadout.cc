@@ -20,6 +20,7 @@
 #include <trackbase/TrkrHit.h>   // for TrkrHit
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainer.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitv2.h>  // for TrkrHit
 
 #include <g4tracking/TrkrTruthTrack.h>
@@ -63,6 +64,22 @@ namespace
     return std::sqrt(square(x) + square(y));
   }
 
+  //! azimuth of (x, y), in [-pi, pi]
+  template <class T>
+  inline T get_phi(const T &x, const T &y)
+  {
+    T phi = std::atan2(y, x);
+    if (phi > +M_PI)
+    {
+      phi -= 2 * M_PI;
+    }
+    if (phi < -M_PI)
+    {
+      phi += 2 * M_PI;
+    }
+    return phi;
+  }
+
   //! return normalized gaussian centered on zero and of width sigma
   template <class T>
   inline T gaus(const T &x, const T &sigma)
@@ -72,6 +89,28 @@ namespace
 
   constexpr unsigned int print_layer = 18;
 
+  //! add energy to a given hit, creating it if needed
+  void add_energy(TrkrHitSet *hitset, TrkrDefs::hitkey hitkey, double energy)
+  {
+    // flat hitsets are updated in place, without allocating a TrkrHit
+    if (auto *flat_hitset = dynamic_cast<TrkrHitSetv2 *>(hitset))
+    {
+      flat_hitset->addEnergy(hitkey, energy);
+      return;
+    }
+
+    // See if this hit already exists
+    TrkrHit *hit = hitset->getHit(hitkey);
+    if (!hit)
+    {
+      // create a new one
+      hit = new TrkrHitv2();
+      hitset->addHitSpecificKey(hitkey, hit);
+    }
+    // Either way, add the energy to it  -- adc values will be added at digitization
+    hit->addEnergy(energy);
+  }
+
 }  // namespace
 
 PHG4TpcPadPlaneReadout::PHG4TpcPadPlaneReadout(const std::string &name)
@@ -308,18 +347,50 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
   // The x_gem and y_gem values have already been randomized within the transverse drift diffusion width
   // The t_gem value already reflects the drift time of the primary electron from the production point, and is randomized within the longitudinal diffusion witdth
 
-  double phi = atan2(y_gem, x_gem);
-  if (phi > +M_PI)
+  double rad_gem = get_r(x_gem, y_gem);
+  PHG4TpcGeom *layergeom = find_layer(rad_gem, hiter);
+  if (!layergeom)
   {
-    phi -= 2 * M_PI;
+    return;
   }
-  if (phi < -M_PI)
+
+  select_layer(layergeom);
+  map_electron(tpc_truth_clusterer, single_hitsetcontainer, hitsetcontainer, get_phi(x_gem, y_gem), rad_gem, t_gem, side);
+}
+
+void PHG4TpcPadPlaneReadout::MapToPadPlane(
+    TpcClusterBuilder &tpc_truth_clusterer,
+    TrkrHitSetContainer *single_hitsetcontainer,
+    TrkrHitSetContainer *hitsetcontainer,
+    TrkrHitTruthAssoc * /*hittruthassoc*/,
+    const double *x_gem, const double *y_gem, const double *t_gem, const unsigned int *side, const std::size_t nelectrons,
+    PHG4HitContainer::ConstIterator hiter, TNtuple * /*ntpad*/, TNtuple * /*nthit*/)
+{
+  // Electrons of the same g4hit mostly end up in the same layer.
+  // The layer of the previous electron is checked first, and its geometry is only reloaded when the layer changes.
+  // Electrons are mapped in order, so that random numbers are drawn exactly as when mapping them one at a time
+  PHG4TpcGeom *layergeom = nullptr;
+  for (std::size_t i = 0; i < nelectrons; ++i)
   {
-    phi += 2 * M_PI;
-  }
+    double rad_gem = get_r(x_gem[i], y_gem[i]);
+    PHG4TpcGeom *current = find_layer(rad_gem, hiter, layergeom);
+    if (!current)
+    {
+      continue;
+    }
 
-  double rad_gem = get_r(x_gem, y_gem);
+    if (current != layergeom)
+    {
+      layergeom = current;
+      select_layer(layergeom);
+    }
+    map_electron(tpc_truth_clusterer, single_hitsetcontainer, hitsetcontainer, get_phi(x_gem[i], y_gem[i]), rad_gem, t_gem[i], side[i]);
+  }
+}
 
+//_________________________________________________________
+PHG4TpcGeom *PHG4TpcPadPlaneReadout::find_layer(double &rad_gem, PHG4HitContainer::ConstIterator hiter, PHG4TpcGeom *hint)
+{
   // Moving electrons from dead area to a closest pad
   for (int iregion = 0; iregion < 3; ++iregion)
   {
@@ -345,50 +416,72 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
     }
   }
 
-  unsigned int layernum = 0;
-  /* TpcClusterBuilder pass_data {}; */
-
   // Find which readout layer this electron ends up in
-
-  PHG4TpcGeomContainer::ConstRange layerrange = GeomContainer->get_begin_end();
-  for (PHG4TpcGeomContainer::ConstIterator layeriter = layerrange.first;
-       layeriter != layerrange.second;
-       ++layeriter)
+  // layers do not overlap, so that at most one matches
+  auto in_layer = [rad_gem](const PHG4TpcGeom *geom)
   {
-    double rad_low = layeriter->second->get_radius() - layeriter->second->get_thickness() / 2.0;
-    double rad_high = layeriter->second->get_radius() + layeriter->second->get_thickness() / 2.0;
+    const double rad_low = geom->get_radius() - geom->get_thickness() / 2.0;
+    const double rad_high = geom->get_radius() + geom->get_thickness() / 2.0;
+    return rad_gem > rad_low && rad_gem < rad_high;
+  };
 
-    if (rad_gem > rad_low && rad_gem < rad_high)
+  PHG4TpcGeom *layergeom = nullptr;
+  if (hint && in_layer(hint))
+  {
+    layergeom = hint;
+  }
+  else
+  {
+    PHG4TpcGeomContainer::ConstRange layerrange = GeomContainer->get_begin_end();
+    for (PHG4TpcGeomContainer::ConstIterator layeriter = layerrange.first;
+         layeriter != layerrange.second;
+         ++layeriter)
     {
-      // capture the layer where this electron hits the gem stack
-      LayerGeom = layeriter->second;
-
-      layernum = LayerGeom->get_layer();
-      /* pass_data.layerGeom = LayerGeom; */
-      /* pass_data.layer = layernum; */
-      if (Verbosity() > 1000)
+      if (in_layer(layeriter->second))
       {
-        std::cout << " g4hit id " << hiter->first << " rad_gem " << rad_gem << " rad_low " << rad_low << " rad_high " << rad_high
-                  << " layer  " << hiter->second->get_layer() << " want to change to " << layernum << std::endl;
+        layergeom = layeriter->second;
+        break;
       }
-      hiter->second->set_layer(layernum);  // have to set here, since the stepping action knows nothing about layers
     }
   }
 
-  if (layernum == 0)
+  if (!layergeom || layergeom->get_layer() == 0)
   {
-    return;
+    return nullptr;
   }
 
-  // store phi bins and tbins upfront to avoid repetitive checks on the phi methods
-  const auto phibins = LayerGeom->get_phibins();
-  /* pass_data.nphibins = phibins; */
-
-  const auto tbins = LayerGeom->get_zbins();
+  // capture the layer where this electron hits the gem stack
+  const unsigned int layernum = layergeom->get_layer();
+  if (Verbosity() > 1000)
+  {
+    std::cout << " g4hit id " << hiter->first << " rad_gem " << rad_gem
+              << " layer  " << hiter->second->get_layer() << " want to change to " << layernum << std::endl;
+  }
+  hiter->second->set_layer(layernum);  // have to set here, since the stepping action knows nothing about layers
+  return layergeom;
+}
 
+//_________________________________________________________
+void PHG4TpcPadPlaneReadout::select_layer(PHG4TpcGeom *layergeom)
+{
+  LayerGeom = layergeom;
   sector_min_Phi = LayerGeom->get_sector_min_phi();
   sector_max_Phi = LayerGeom->get_sector_max_phi();
   phi_bin_width = LayerGeom->get_phistep();
+}
+
+//_________________________________________________________
+void PHG4TpcPadPlaneReadout::map_electron(
+    TpcClusterBuilder &tpc_truth_clusterer,
+    TrkrHitSetContainer *single_hitsetcontainer,
+    TrkrHitSetContainer *hitsetcontainer,
+    double phi, const double rad_gem, const double t_gem, const unsigned int side)
+{
+  const unsigned int layernum = LayerGeom->get_layer();
+
+  // store phi bins and tbins upfront to avoid repetitive checks on the phi methods
+  const auto phibins = LayerGeom->get_phibins();
+  const auto tbins = LayerGeom->get_zbins();
 
   phi = check_phi(side, phi, rad_gem);
 
@@ -498,8 +591,11 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
               << std::endl;
   }
 
-  std::vector<int> pad_phibin;
-  std::vector<double> pad_phibin_share;
+  // scratch buffers are members, to re-use their allocation from one electron to the next
+  auto &pad_phibin = m_pad_phibin;
+  auto &pad_phibin_share = m_pad_phibin_share;
+  pad_phibin.clear();
+  pad_phibin_share.clear();
 
   populate_zigzag_phibins(side, layernum, phi, sigmaT, pad_phibin, pad_phibin_share);
   /* if (pad_phibin.size() == 0) { */
@@ -528,8 +624,10 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
 		<< " with t_gem " << t_gem << " SAMPA peaking time  " << Ts << std::endl;
     }
 
-  std::vector<int> adc_tbin;
-  std::vector<double> adc_tbin_share;
+  auto &adc_tbin = m_adc_tbin;
+  auto &adc_tbin_share = m_adc_tbin_share;
+  adc_tbin.clear();
+  adc_tbin_share.clear();
   sampaTimeDistribution(t_gem, adc_tbin, adc_tbin_share);
 
   /* if (adc_tbin.size() == 0)  { */
@@ -646,32 +744,13 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
       // generate the key for this hit, requires tbin and phibin
       hitkey = TpcDefs::genHitKey((unsigned int) pad_num, (unsigned int) tbin_num);
 
-      // See if this hit already exists
-      TrkrHit *hit = nullptr;
-      hit = hitsetit->second->getHit(hitkey);
-      if (!hit)
-      {
-        // create a new one
-        hit = new TrkrHitv2();
-        hitsetit->second->addHitSpecificKey(hitkey, hit);
-      }
-      // Either way, add the energy to it  -- adc values will be added at digitization
-      hit->addEnergy(neffelectrons);
+      // add the energy to the hit -- adc values will be added at digitization
+      add_energy(hitsetit->second, hitkey, neffelectrons);
 
       tpc_truth_clusterer.addhitset(hitsetkey, hitkey, neffelectrons);
 
       // repeat for the single_hitsetcontainer
-      // See if this hit already exists
-      TrkrHit *single_hit = nullptr;
-      single_hit = single_hitsetit->second->getHit(hitkey);
-      if (!single_hit)
-      {
-        // create a new one
-        single_hit = new TrkrHitv2();
-        single_hitsetit->second->addHitSpecificKey(hitkey, single_hit);
-      }
-      // Either way, add the energy to it  -- adc values will be added at digitization
-      single_hit->addEnergy(neffelectrons);
+      add_energy(single_hitsetit->second, hitkey, neffelectrons);
 
       /*
       if (Verbosity() > 0)
@@ -11,6 +11,7 @@
 #include <array>
 #include <climits>
 #include <cmath>
+#include <cstddef>
 #include <string>  // for string
 #include <vector>
 #include <map>
@@ -43,11 +44,11 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
   void SetUseLangauGEMGain(const int flagLangau) { m_useLangau = flagLangau; }
   void SetLangauParsFileName(const std::string &name) { m_tpc_langau_pars_file = name; }
 
-  // otherwise warning of inconsistent overload since only one MapToPadPlane methow is overridden
-  using PHG4TpcPadPlane::MapToPadPlane;
-
   void MapToPadPlane(TpcClusterBuilder &tpc_truth_clusterer, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer, TrkrHitTruthAssoc * /*hittruthassoc*/, const double x_gem, const double y_gem, const double t_gem, const unsigned int side, PHG4HitContainer::ConstIterator hiter, TNtuple * /*ntpad*/, TNtuple * /*nthit*/) override;
 
+  //! map a set of drifted electrons from the same g4hit, re-using the layer lookup and geometry of the previous electron
+  void MapToPadPlane(TpcClusterBuilder &tpc_truth_clusterer, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer, TrkrHitTruthAssoc * /*hittruthassoc*/, const double *x_gem, const double *y_gem, const double *t_gem, const unsigned int *side, const std::size_t nelectrons, PHG4HitContainer::ConstIterator hiter, TNtuple * /*ntpad*/, TNtuple * /*nthit*/) override;
+
   void SetDefaultParameters() override;
   void UpdateInternalParameters() override;
  
@@ -75,6 +76,15 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
   
   double check_phi(const unsigned int side, const double phi, const double radius);
 
+  //! move electron out of dead areas and find its readout layer, checking hint first. Sets the g4hit layer. nullptr if not in any layer
+  PHG4TpcGeom *find_layer(double &rad_gem, PHG4HitContainer::ConstIterator hiter, PHG4TpcGeom *hint = nullptr);
+
+  //! load geometry of the layer used by map_electron
+  void select_layer(PHG4TpcGeom *layergeom);
+
+  //! amplify one electron in the selected layer and distribute its charge to the pads
+  void map_electron(TpcClusterBuilder &tpc_truth_clusterer, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer, double phi, const double rad_gem, const double t_gem, const unsigned int side);
+
   void makeChannelMask(hitMaskTpc& aMask, const std::string& dbName, const std::string& totalChannelsToMask);
 
   PHG4TpcGeomContainer *GeomContainer = nullptr;
@@ -145,6 +155,12 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
   bool m_maskFromFile {false};
   std::string m_deadChannelMapName; 
   std::string m_hotChannelMapName; 
+
+  //! per electron scratch buffers
+  std::vector<int> m_pad_phibin;
+  std::vector<double> m_pad_phibin_share;
+  std::vector<int> m_adc_tbin;
+  std::vector<double> m_adc_tbin_share;
 };
 
 #endif
@@ -15,6 +15,7 @@
 #include <phool/PHIODataNode.h>
 #include <phool/PHNodeIterator.h>
 #include <phool/PHRandomSeed.h>
+#include <phool/PHThreadPool.h>
 #include <phool/getClass.h>
 #include <phool/phool.h>
 
@@ -44,6 +45,12 @@
 #include <iostream>
 #include <map>
 
+namespace
+{
+  // channels are finished in blocks of this size, one block per thread pool task
+  const int channels_per_block = 512;
+}  // namespace
+
 double CaloWaveformSim::template_function(double *x, double *par)
 {
   Double_t v1 = par[0] * h_template->Interpolate(x[0] - par[1]) + par[2];
@@ -58,6 +65,10 @@ CaloWaveformSim::CaloWaveformSim(const std::string &name)
 CaloWaveformSim::~CaloWaveformSim()
 {
   gsl_rng_free(m_RandomGenerator);
+  for (auto *rng : m_BlockRandomGenerators)
+  {
+    gsl_rng_free(rng);
+  }
   delete cdbttree;
   delete cdbttree_MC;
   delete cdbttree_time;
@@ -91,6 +102,18 @@ int CaloWaveformSim::InitRun(PHCompositeNode *topNode)
   h_template->SetDirectory(nullptr);
   ft->Close();
 
+  // tabulate the template, hits are then deposited without going through TF1 and TProfile for every sample
+  const int ntemplatebins = h_template->GetNbinsX();
+  m_template_x.resize(ntemplatebins);
+  m_template_y.resize(ntemplatebins);
+  for (int ibin = 0; ibin < ntemplatebins; ++ibin)
+  {
+    m_template_x[ibin] = h_template->GetBinCenter(ibin + 1);
+    m_template_y[ibin] = h_template->GetBinContent(ibin + 1);
+  }
+  m_template_uniform = !h_template->GetXaxis()->IsVariableBinSize();
+  m_template_inv_binwidth = 1. / h_template->GetXaxis()->GetBinWidth(1);
+
   // Detector-specific setup
   if (m_dettype == CaloTowerDefs::CEMC)
   {
@@ -286,8 +309,32 @@ int CaloWaveformSim::InitRun(PHCompositeNode *topNode)
     }
   }
 
+  // template peak position in the sampling window, the same for all events
+  TF1 f_peak(
+      "f_peak", [this](double *x, double *par)
+      { return this->template_function(x, par); },
+      0, m_nsamples, 3);
+  f_peak.SetParameters(1.0, 0.0, 0.0);
+  m_template_peak = f_peak.GetMaximumX();
+
   // Prepare waveform buffers
-  m_waveforms.assign(m_nchannels, std::vector<float>(m_nsamples));
+  m_waveforms.assign(static_cast<size_t>(m_nchannels) * m_nsamples, 0.F);
+
+  // one noise generator per block of channels, reseeded every event from m_RandomGenerator
+  const int nblocks = (m_nchannels + channels_per_block - 1) / channels_per_block;
+  while (static_cast<int>(m_BlockRandomGenerators.size()) < nblocks)
+  {
+    m_BlockRandomGenerators.push_back(gsl_rng_alloc(gsl_rng_mt19937));
+  }
+  if (!m_threadPool)
+  {
+    m_threadPool = std::make_unique<PHThreadPool>(m_num_threads);
+  }
+  if (Verbosity() > 0)
+  {
+    std::cout << "CaloWaveformSim::InitRun template peak at " << m_template_peak
+              << ", worker threads: " << m_threadPool->size() << std::endl;
+  }
 
   // Create node tree and finish
   CreateNodeTree(topNode);
@@ -329,26 +376,11 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
   }
 
   // initialize the waveform
-  for (auto &waveform : m_waveforms)
-  {
-    for (auto &sample : waveform)
-    {
-      sample = 0.;
-    }
-  }
-  // waveform TH1
-  TF1 *f_fit = new TF1(
-      "f_fit", [this](double *x, double *par)
-      { return this->template_function(x, par); },
-      0, m_nsamples, 3);
-  f_fit->SetParameter(0, 1.0);
-  f_fit->SetParameter(1, 0.0);
-  float template_peak = f_fit->GetMaximumX();
-  float shift_of_shift = m_timeshiftwidth * gsl_rng_uniform(m_RandomGenerator);
+  std::fill(m_waveforms.begin(), m_waveforms.end(), 0.F);
 
-  float _shiftval = m_peakpos + shift_of_shift - template_peak;
+  float shift_of_shift = m_timeshiftwidth * gsl_rng_uniform(m_RandomGenerator);
 
-  f_fit->SetParameters(1, _shiftval, 0);
+  float _shiftval = m_peakpos + shift_of_shift - m_template_peak;
 
   // get G4Hits
   std::string nodename = "G4HIT_" + m_detector;
@@ -381,6 +413,12 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
     maphitetaphi(hit, etabin, phibin, correction);
     unsigned int key = encode_tower(etabin, phibin);
     unsigned int tower_index = decode_tower(key);
+    if (tower_index >= static_cast<unsigned int>(m_nchannels))
+    {
+      std::cout << PHWHERE << " tower index " << tower_index << " out of range, number of channels: " << m_nchannels << std::endl;
+      gSystem->Exit(1);
+      exit(1);
+    }
     float calibconst = cdbttree->GetFloatValue(key, m_fieldname);
     float e_vis = hit->get_light_yield();
     e_vis *= correction;
@@ -430,7 +468,7 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
       float meantime = cdbttree_time->GetFloatValue(key, m_fieldname_time);
       float MCmeantime = cdbttree_MC_time->GetFloatValue(key, m_MC_fieldname_time);
       assert(m_peakpos == 6);  // the MC mean time is derived when m_peakpos is set to 6
-      _shiftval = m_peakpos + shift_of_shift - template_peak + meantime - MCmeantime;
+      _shiftval = m_peakpos + shift_of_shift - m_template_peak + meantime - MCmeantime;
     }
 
     float t0 = hit->get_t(0) / m_sampletime;
@@ -447,11 +485,7 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
     edepMap[hit->get_hit_id()] += hitEdep;
     showerMap[showerID] += hitEdep;
 
-    f_fit->SetParameters(ADC, _shiftval + t0, 0.);
-    for (int i = 0; i < m_nsamples; i++)
-    {
-      m_waveforms.at(tower_index).at(i) += f_fit->Eval(i);
-    }
+    add_template(&m_waveforms[tower_index * m_nsamples], ADC, _shiftval + t0);
   }
 
   if (m_use_sipm_occupancy && m_dettype == CaloTowerDefs::CEMC)
@@ -468,7 +502,7 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
         photon_count = std::max(0., photon_count + gsl_ran_gaussian(m_RandomGenerator, sigma));
       }
 
-      if (photon_count_mean <= 0. || photon_count <= 0. || tower_index >= m_waveforms.size())
+      if (photon_count_mean <= 0. || photon_count <= 0. || tower_index >= static_cast<unsigned int>(m_nchannels))
       {
         continue;
       }
@@ -479,9 +513,10 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
       const double occupancy_ratio =
           std::max(0., std::min(1., expected_active_pixels / photon_count));
       const double photon_stat_fac = photon_count / photon_count_mean;
+      float *waveform = &m_waveforms[tower_index * m_nsamples];
       for (int isample = 0; isample < m_nsamples; ++isample)
       {
-        m_waveforms.at(tower_index).at(isample) *= occupancy_ratio * photon_stat_fac;
+        waveform[isample] *= occupancy_ratio * photon_stat_fac;
       }
     }
   }
@@ -501,9 +536,85 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
     }
   }
 
+  if (m_noiseType == NoiseType::NOISE_GAUSSIAN)
+  {
+    // block seeds are drawn in order, so that the noise does not depend on the number of threads
+    for (auto *rng : m_BlockRandomGenerators)
+    {
+      gsl_rng_set(rng, gsl_rng_get(m_RandomGenerator));
+    }
+  }
+
+  auto finish_block = [this](const std::size_t block, const unsigned int /*worker*/)
+  {
+    const int first = block * channels_per_block;
+    finish_channels(first, std::min(first + channels_per_block, m_nchannels), m_BlockRandomGenerators[block]);
+  };
+
+  // channels are independent. Verbose pedestal printout is kept in order by running serially
+  const int nblocks = (m_nchannels + channels_per_block - 1) / channels_per_block;
+  if (m_threadPool && Verbosity() <= 1)
+  {
+    m_threadPool->parallel_for(nblocks, finish_block);
+  }
+  else
+  {
+    for (int block = 0; block < nblocks; ++block)
+    {
+      finish_block(block, 0);
+    }
+  }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+double CaloWaveformSim::template_value(double x) const
+{
+  // same as TH1::Interpolate: constant beyond the first and last bin centers, linear in between
+  if (x <= m_template_x.front())
+  {
+    return m_template_y.front();
+  }
+  if (x >= m_template_x.back())
+  {
+    return m_template_y.back();
+  }
+  int ibin = 0;
+  if (m_template_uniform)
+  {
+    ibin = std::min(static_cast<int>((x - m_template_x.front()) * m_template_inv_binwidth), static_cast<int>(m_template_x.size()) - 2);
+  }
+  else
+  {
+    ibin = std::upper_bound(m_template_x.begin(), m_template_x.end(), x) - m_template_x.begin() - 1;
+  }
+  return m_template_y[ibin] + (x - m_template_x[ibin]) * ((m_template_y[ibin + 1] - m_template_y[ibin]) / (m_template_x[ibin + 1] - m_template_x[ibin]));
+}
+
+void CaloWaveformSim::add_template(float *waveform, float amplitude, float shift) const
+{
+  for (int i = 0; i < m_nsamples; i++)
+  {
+    waveform[i] += amplitude * template_value(static_cast<double>(i) - shift);
+  }
+}
+
+void CaloWaveformSim::finish_channels(int first, int last, gsl_rng *rng)
+{
+  // noise for all samples of the block in one go
+  std::vector<double> noise;
+  if (m_noiseType == NoiseType::NOISE_GAUSSIAN)
+  {
+    noise.resize(static_cast<size_t>(last - first) * m_nsamples);
+    for (auto &value : noise)
+    {
+      value = gsl_ran_gaussian(rng, m_gaussian_noise);
+    }
+  }
+
   std::vector<float> waveform_pedestal_vector(m_nsamples);
-  for (int i = 0; i < m_nchannels; i++)
+  for (int i = first; i < last; i++)
   {
+    float *waveform = &m_waveforms[static_cast<size_t>(i) * m_nsamples];
     if (m_noiseType == NoiseType::NOISE_TREE)
     {
       TowerInfo *pedestal_tower = m_PedestalContainer->get_tower_at_channel(i);
@@ -511,8 +622,8 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
       float pedestal_mean = 0;
       for (int j = 0; j < m_nsamples; j++)
       {
-        waveform_pedestal_vector.at(j) = (j < pedestalsamples) ? pedestal_tower->get_waveform_value(j) : pedestal_tower->get_waveform_value(pedestalsamples - 1);
-        pedestal_mean += waveform_pedestal_vector.at(j);
+        waveform_pedestal_vector[j] = (j < pedestalsamples) ? pedestal_tower->get_waveform_value(j) : pedestal_tower->get_waveform_value(pedestalsamples - 1);
+        pedestal_mean += waveform_pedestal_vector[j];
         // it should be around 5000+, dead channels have zero's but who knows what else is out there in the future
         if (Verbosity() > 1 && pedestal_tower->get_waveform_value(j) < 1000)
         {
@@ -525,44 +636,43 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
       {
         // only modify the waveform_pedestal_vector if it is > 0, otherwise there is something wrong with the pedestal
         // (for dead channels all samples of the waveform are zero). Doing it this way will also catch single zero samples
-        if (waveform_pedestal_vector.at(j) != 0)
+        if (waveform_pedestal_vector[j] != 0)
         {
-          waveform_pedestal_vector.at(j) = (waveform_pedestal_vector.at(j) - pedestal_mean) * m_pedestal_scale + pedestal_mean;
+          waveform_pedestal_vector[j] = (waveform_pedestal_vector[j] - pedestal_mean) * m_pedestal_scale + pedestal_mean;
         }
       }
-    }
-    for (int j = 0; j < m_nsamples; j++)
-    {
-      if (m_noiseType == NoiseType::NOISE_TREE)
+      for (int j = 0; j < m_nsamples; j++)
       {
-	// set samples which have zero pedestal (dead channels in real data) to zero
-	// they are supposed to be masked out later, so this is just a safeguard in case
-	// that changes or doesn't work
-        if (waveform_pedestal_vector.at(j) == 0)
-        {
-          m_waveforms.at(i).at(j) = 0;
-        }
-        else
-        {
-          m_waveforms.at(i).at(j) += waveform_pedestal_vector.at(j);
-        }
+        // set samples which have zero pedestal (dead channels in real data) to zero
+        // they are supposed to be masked out later, so this is just a safeguard in case
+        // that changes or doesn't work
+        waveform[j] = (waveform_pedestal_vector[j] == 0) ? 0 : waveform[j] + waveform_pedestal_vector[j];
       }
-      if (m_noiseType == NoiseType::NOISE_GAUSSIAN)
+    }
+    else if (m_noiseType == NoiseType::NOISE_GAUSSIAN)
+    {
+      const double *channel_noise = &noise[static_cast<size_t>(i - first) * m_nsamples];
+      for (int j = 0; j < m_nsamples; j++)
       {
-        m_waveforms.at(i).at(j) += gsl_ran_gaussian(m_RandomGenerator, m_gaussian_noise);
+        waveform[j] += channel_noise[j];
       }
-      if (m_noiseType == NoiseType::NOISE_NONE)
+    }
+    else if (m_noiseType == NoiseType::NOISE_NONE)
+    {
+      for (int j = 0; j < m_nsamples; j++)
       {
-        m_waveforms.at(i).at(j) += m_fixpedestal;
+        waveform[j] += m_fixpedestal;
       }
-      // saturate at 2^14 - 1 and make sure values are >= 0
-      auto &sample = m_waveforms.at(i).at(j);
-      sample = std::clamp(sample, 0.F, 16383.F);
-      m_CaloWaveformContainer->get_tower_at_channel(i)->set_waveform_value(j, m_waveforms.at(i).at(j));
+    }
+
+    // saturate at 2^14 - 1 and make sure values are >= 0
+    TowerInfo *tower = m_CaloWaveformContainer->get_tower_at_channel(i);
+    for (int j = 0; j < m_nsamples; j++)
+    {
+      waveform[j] = std::clamp(waveform[j], 0.F, 16383.F);
+      tower->set_waveform_value(j, waveform[j]);
     }
   }
-  delete f_fit;
-  return Fun4AllReturnCodes::EVENT_OK;
 }
 
 void CaloWaveformSim::maphitetaphi(PHG4Hit *g4hit, unsigned short &etabin, unsigned short &phibin, float &correction)
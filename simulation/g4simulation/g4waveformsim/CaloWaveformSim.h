@@ -20,10 +20,12 @@
 #include <gsl/gsl_rng.h>
 
 #include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
 class PHCompositeNode;
+class PHThreadPool;
 class TProfile;
 class PHG4Hit;
 class PHG4CylinderCellGeom_Spacalv1;
@@ -155,6 +157,9 @@ class CaloWaveformSim : public SubsysReco
   void set_fixpedestal(int fixpedestal) { m_fixpedestal = fixpedestal; }
   void set_gaussian_noise(int gaussian_noise) { m_gaussian_noise = gaussian_noise; }
 
+  // number of threads used for the per channel noise and pedestal (0: serial, negative: number of hardware threads)
+  void set_num_threads(int nthreads) { m_num_threads = nthreads; }
+
   // Light collection model access
   LightCollectionModel &get_light_collection_model() { return light_collection_model; }
 
@@ -166,6 +171,15 @@ class CaloWaveformSim : public SubsysReco
                     float &correction);
   double template_function(double *x, double *par);
 
+  // template value at x, same as h_template->Interpolate(x) but from the tabulated template
+  double template_value(double x) const;
+
+  // add amplitude * template(i - shift) to the samples of a waveform
+  void add_template(float *waveform, float amplitude, float shift) const;
+
+  // add noise/pedestal, clamp and store the waveforms of channels [first, last)
+  void finish_channels(int first, int last, gsl_rng *rng);
+
   // function pointers for use different decoders for hcals and cemc
   unsigned int (*encode_tower)(unsigned int, unsigned int){TowerInfoDefs::encode_emcal};
   unsigned int (*decode_tower)(unsigned int){TowerInfoDefs::decode_emcal};
@@ -229,7 +243,20 @@ class CaloWaveformSim : public SubsysReco
   float m_peakpos{6.};
   float m_pedestal_scale{1.};
 
-  std::vector<std::vector<float>> m_waveforms;
+  // waveforms of all channels, m_nsamples consecutive samples per channel, reused across events
+  std::vector<float> m_waveforms;
+
+  // tabulated template: bin centers and contents of h_template, and its peak position
+  std::vector<double> m_template_x;
+  std::vector<float> m_template_y;
+  double m_template_inv_binwidth{0};
+  bool m_template_uniform{true};
+  float m_template_peak{0};
+
+  // channels are finished in blocks, each block with its own noise generator
+  int m_num_threads{0};
+  std::unique_ptr<PHThreadPool> m_threadPool;
+  std::vector<gsl_rng *> m_BlockRandomGenerators;
 
   LightCollectionModel light_collection_model;
 